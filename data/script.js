@@ -68,6 +68,7 @@ const autoTriggerText = document.getElementById('auto-trigger-text');
 
 // --- State ---
 const SIMULATION_MODE = window.location.protocol.startsWith('file');
+const VIEWER_STREAM = new URLSearchParams(window.location.search).has('viewer');
 let socket;
 let settings = {};
 
@@ -91,6 +92,7 @@ let userRole = 'viewer';
 let currentUsername = 'Viewer';
 
 // Timer state
+const SYNC_MAX_CORRECTION_MS = 2000;   // Larger clock offset corrections are ignored
 let currentTimerStatus = 'IDLE';
 let pauseAfterNextActive = false;
 let continuousMode = false;
@@ -102,6 +104,13 @@ let audioContext = null;
 // Button debounce
 let buttonsEnabled = true;
 
+// Remote diagnostic log: entries accumulate from incremental batches
+const REMOTE_LOG_MAX_LINES = 500;
+let remoteLogEntries = [];
+let remoteLogTrace = [];
+let remoteLogSeq = 0;          // Server cursor after the last batch
+let remoteLogOpen = false;     // Subscribed while the settings page is shown
+
 // --- Utility Functions ---
 
 function escapeHtml(text) {
@@ -221,6 +230,18 @@ function clientTimerLoop() {
     }
 }
 
+// Round end on this browser's clock. The server pings each client to
+// estimate its clock offset (browser minus server, mod 2^32) and sends it
+// with sync frames, so the frame's transit time is taken out. Without an
+// estimate, or with one that implies seconds of delay (the browser clock
+// was changed since), count from arrival.
+function syncEndTime(data, now) {
+    const arrival = now + data.mainTimerRemaining;
+    if (data.clockOffsetMs === undefined || data.serverMillis === undefined) return arrival;
+    const end = now + ((data.serverMillis + data.clockOffsetMs + data.mainTimerRemaining - now) | 0);
+    return Math.abs(end - arrival) > SYNC_MAX_CORRECTION_MS ? arrival : end;
+}
+
 function stopClientTimer() {
     if (animationFrameId) {
         cancelAnimationFrame(animationFrameId);
@@ -245,11 +266,14 @@ function showSettingsPage(show) {
     if (qrPage) qrPage.classList.add('hidden');
     if (show && userRole === 'admin') {
         sendWebSocketMessage({ action: 'get_helloclub_settings' });
-        sendWebSocketMessage({ action: 'get_remote_log' });
+        openRemoteLog();
+    } else {
+        closeRemoteLog();
     }
 }
 
 function showUserManagementPage(show) {
+    closeRemoteLog();
     mainPage.classList.toggle('hidden', show);
     settingsPage.classList.add('hidden');
     userManagementPage.classList.toggle('hidden', !show);
@@ -262,6 +286,7 @@ function showUserManagementPage(show) {
 }
 
 function showHelpPage(show) {
+    closeRemoteLog();
     mainPage.classList.toggle('hidden', show);
     settingsPage.classList.add('hidden');
     userManagementPage.classList.add('hidden');
@@ -269,6 +294,47 @@ function showHelpPage(show) {
     if (qrPage) qrPage.classList.add('hidden');
 }
 
+// --- Remote Diagnostic Log ---
+
+// Fetch everything the device holds, then receive new entries as they are logged
+function openRemoteLog() {
+    remoteLogEntries = [];
+    remoteLogSeq = 0;
+    remoteLogOpen = true;
+    sendWebSocketMessage({ action: 'get_remote_log', subscribe: true });
+}
+
+function closeRemoteLog() {
+    if (!remoteLogOpen) return;
+    remoteLogOpen = false;
+    sendWebSocketMessage({ action: 'remote_log_unsubscribe' });
+}
+
+function formatLogTime(ms) {
+    const secs = Math.floor(ms / 1000);
+    const mins = Math.floor(secs / 60);
+    const hrs = Math.floor(mins / 60);
+    return hrs > 0
+        ? `${hrs}h${String(mins % 60).padStart(2,'0')}m${String(secs % 60).padStart(2,'0')}s`
+        : mins > 0
+            ? `${mins}m${String(secs % 60).padStart(2,'0')}s`
+            : `${secs}s`;
+}
+
+function renderRemoteLog() {
+    const container = document.getElementById('remote-log-container');
+    if (!container) return;
+    // Trace records (formatted on request) interleaved by time
+    const entries = remoteLogEntries.concat(remoteLogTrace).sort((a, b) => a.t - b.t);
+    if (entries.length === 0) {
+        container.textContent = '(no log entries yet)';
+        return;
+    }
+    const atBottom = container.scrollHeight - container.scrollTop - container.clientHeight < 20;
+    container.textContent = entries.map(e => `[${formatLogTime(e.t)}] ${e.m}`).join('\n');
+    if (atBottom) container.scrollTop = container.scrollHeight;
+}
+
 // --- UI Updates ---
 
 function updateUIForRole() {
@@ -284,6 +350,7 @@ function updateUIForRole() {
     if (loginLogoutBtn) {
         const span = loginLogoutBtn.querySelector('span');
         if (span) span.textContent = (userRole === 'viewer') ? 'Login' : 'Logout';
+        loginLogoutBtn.classList.toggle('hidden', VIEWER_STREAM);
     }
     updatePauseAfterNextVisibility();
 }
@@ -431,7 +498,10 @@ function updateNTPStatus(data) {
             }
             timeElement.textContent = data.time;
         }
-        let tooltip = 'Time synced via NTP';
+        let tooltip = data.source === 'rtc' ? 'Time kept across restart, waiting for NTP' : 'Time synced via NTP';
+        if (data.source === 'ntp' && data.lastSyncAge >= 0) {
+            tooltip += `\nLast sync ${Math.round(data.lastSyncAge / 60)} min ago, corrected ${data.offsetMs} ms`;
+        }
         if (data.timezone) {
             tooltip += `\nTimezone: ${data.timezone}`;
             const timezoneSelect = document.getElementById('timezone-select');
@@ -482,6 +552,7 @@ function renderUpcomingEvents(events, lastSync) {
 // --- QR Code ---
 
 function showQrPage() {
+    closeRemoteLog();
     sendWebSocketMessage({ action: 'get_qr_config' });
     mainPage.classList.add('hidden');
     settingsPage.classList.add('hidden');
@@ -769,6 +840,8 @@ function initializeEventListeners() {
             const defaultDuration = durInput ? parseInt(durInput.value) : 21;
             const payload = { action: 'save_helloclub_settings', enabled, defaultDuration };
             if (apiKey && apiKey !== '***configured***') payload.apiKey = apiKey;
+            const webhookSecret = document.getElementById('hc-webhook-secret')?.value.trim();
+            if (webhookSecret) payload.webhookSecret = webhookSecret === '-' ? '' : webhookSecret;
             sendWebSocketMessage(payload);
         });
     }
@@ -787,9 +860,7 @@ function initializeEventListeners() {
     // Remote diagnostic log refresh
     const refreshLogBtn = document.getElementById('refresh-log-btn');
     if (refreshLogBtn) {
-        refreshLogBtn.addEventListener('click', () => {
-            sendWebSocketMessage({ action: 'get_remote_log' });
-        });
+        refreshLogBtn.addEventListener('click', openRemoteLog);
     }
 
     // Sync now
@@ -913,309 +984,343 @@ function connectWebSocket() {
         console.error('WebSocket error:', error);
     };
 
-    socket.onmessage = (event) => {
-        const data = JSON.parse(event.data);
-
-        switch (data.event) {
-            case 'auth_required':
-                loginModal.classList.remove('hidden');
-                break;
-
-            case 'auth_success':
-            case 'viewer_mode':
-                userRole = data.role || 'viewer';
-                currentUsername = data.username || 'Viewer';
-                loginModal.classList.add('hidden');
-                updateUIForRole();
-                if (data.event === 'auth_success') {
-                    showTemporaryMessage(`Welcome, ${escapeHtml(currentUsername)}!`, "success");
-                }
-                break;
-
-            case 'login_prompt':
-                // Server greeting on connect — show login modal
-                loginModal.classList.remove('hidden');
-                break;
-
-            case 'session_timeout':
-                userRole = 'viewer';
-                currentUsername = 'Viewer';
-                updateUIForRole();
-                loginModal.classList.remove('hidden');
-                showTemporaryMessage(data.message || "Session expired", "error");
-                break;
-
-            case 'auth_failed':
-                showTemporaryMessage(data.message || "Authentication failed", "error");
-                loginModal.classList.remove('hidden');
-                break;
-
-            case 'pause_after_next_changed':
-                if (typeof data.pauseAfterNext !== 'undefined') {
-                    updatePauseAfterNextUI(data.pauseAfterNext);
-                }
-                break;
-
-            case 'operators_list':
-                renderOperatorsList(data.operators || []);
-                break;
-
-            case 'operator_added':
-                showTemporaryMessage(`Operator "${escapeHtml(data.username)}" added`, "success");
-                if (newOperatorUsernameInput) newOperatorUsernameInput.value = '';
-                if (newOperatorPasswordInput) newOperatorPasswordInput.value = '';
-                loadOperators();
-                break;
-
-            case 'operator_removed':
-                showTemporaryMessage(`Operator "${escapeHtml(data.username)}" removed`, "success");
-                loadOperators();
-                break;
-
-            case 'password_changed':
-                showTemporaryMessage("Password changed successfully", "success");
-                if (changeOldPasswordInput) changeOldPasswordInput.value = '';
-                if (changeNewPasswordInput) changeNewPasswordInput.value = '';
-                break;
-
-            case 'timezone_changed':
-                showTemporaryMessage(`Timezone updated to ${data.timezone}`, "success");
-                const tzSelect = document.getElementById('timezone-select');
-                if (tzSelect) tzSelect.dataset.currentTimezone = data.timezone;
-                break;
-
-            case 'factory_reset_complete':
-                showTemporaryMessage("Factory reset complete. Please refresh page.", "success");
-                setTimeout(() => window.location.reload(), 2000);
-                break;
-
-            case 'ntp_status':
-                updateNTPStatus(data);
-                break;
-
-            case 'upcoming_events':
-                renderUpcomingEvents(data.events || [], data.lastSync);
-                break;
+    socket.onmessage = (event) => handleServerMessage(JSON.parse(event.data));
+}
 
-            case 'helloclub_settings':
-                const hcApiKeyInput = document.getElementById('hc-api-key');
-                const hcEnabledInput = document.getElementById('hc-enabled');
-                const hcStatusEl = document.getElementById('hc-api-status');
-                if (hcApiKeyInput) {
-                    hcApiKeyInput.placeholder = data.apiKey === '***configured***'
-                        ? 'API key is set (leave blank to keep)'
-                        : 'Paste API key here';
-                    hcApiKeyInput.value = '';
-                }
-                if (hcEnabledInput) hcEnabledInput.checked = data.enabled || false;
-                const hcDefaultDurInput = document.getElementById('hc-default-duration');
-                if (hcDefaultDurInput && data.defaultDuration) hcDefaultDurInput.value = data.defaultDuration;
-                if (hcStatusEl) {
-                    hcStatusEl.textContent = data.apiKey === '***configured***'
-                        ? 'API key: configured'
-                        : 'API key: not set';
-                }
-                break;
+// Read-only display over Server-Sent Events (index.html?viewer): no login,
+// no commands and no WebSocket slot. Sync frames carry no clock offset, so
+// the round end counts from arrival. EventSource reconnects by itself.
+function connectEventStream() {
+    updateUIForRole();
+    showLoadingOverlay('Connecting to timer...');
+    const source = new EventSource('/events');
+    source.onopen = () => {
+        hideLoadingOverlay();
+        updateConnectionStatus(true);
+    };
+    source.onerror = () => {
+        updateConnectionStatus(false);
+        stopClientTimer();
+    };
+    source.onmessage = (event) => handleServerMessage(JSON.parse(event.data));
+}
 
-            case 'helloclub_settings_saved':
-                showTemporaryMessage(data.message || 'Hello Club settings saved', 'success');
-                // Refresh to show updated status
-                sendWebSocketMessage({ action: 'get_helloclub_settings' });
-                break;
+// WebSocket messages and viewer stream events
+function handleServerMessage(data) {
+    switch (data.event) {
+        case 'auth_required':
+            loginModal.classList.remove('hidden');
+            break;
 
-            case 'helloclub_refresh_result':
-                if (data.success) {
-                    showTemporaryMessage(data.message || `Synced ${data.eventCount || 0} events from Hello Club`, "success");
-                    if (data.debug) console.log("HC Sync Debug:\n" + data.debug);
-                } else {
-                    showTemporaryMessage(data.message || data.error || 'Hello Club sync failed', "error");
-                    if (data.debug) console.log("HC Sync Debug:\n" + data.debug);
-                }
-                break;
+        case 'auth_success':
+        case 'viewer_mode':
+            userRole = data.role || 'viewer';
+            currentUsername = data.username || 'Viewer';
+            loginModal.classList.add('hidden');
+            updateUIForRole();
+            if (data.event === 'auth_success') {
+                showTemporaryMessage(`Welcome, ${escapeHtml(currentUsername)}!`, "success");
+                // Reconnected with the log open: the server forgot the subscription
+                if (remoteLogOpen && userRole === 'admin') openRemoteLog();
+            }
+            break;
 
-            case 'event_auto_started':
-                showTemporaryMessage(`Auto-started: ${escapeHtml(data.eventName)}`, "success");
-                break;
+        case 'login_prompt':
+            // Server greeting on connect — show login modal
+            loginModal.classList.remove('hidden');
+            break;
 
-            case 'event_auto_resumed':
-                showTemporaryMessage(`Resumed after reboot: ${escapeHtml(data.eventName)} (round ${data.currentRound})`, "success");
-                break;
+        case 'session_timeout':
+            userRole = 'viewer';
+            currentUsername = 'Viewer';
+            updateUIForRole();
+            loginModal.classList.remove('hidden');
+            showTemporaryMessage(data.message || "Session expired", "error");
+            break;
 
-            case 'event_cutoff':
-                showTemporaryMessage(data.message || "Session ended - booking time expired", "error");
-                break;
+        case 'auth_failed':
+            showTemporaryMessage(data.message || "Authentication failed", "error");
+            loginModal.classList.remove('hidden');
+            break;
 
-            case 'qr_config': {
-                renderQrCodes(data);
-                // Populate settings form
-                const qrSsidInput = document.getElementById('qr-wifi-ssid');
-                const qrPassInput = document.getElementById('qr-wifi-password');
-                const qrEncInput = document.getElementById('qr-wifi-encryption');
-                const qrSsidHint = document.getElementById('qr-connected-ssid-hint');
-                if (qrSsidInput) qrSsidInput.value = data.ssidOverride || '';
-                if (qrPassInput) qrPassInput.value = data.password || '';
-                if (qrEncInput && data.encryption) qrEncInput.value = data.encryption;
-                if (qrSsidHint && data.connectedSsid) {
-                    qrSsidHint.textContent = `Connected network: ${data.connectedSsid}`;
-                }
-                break;
+        case 'pause_after_next_changed':
+            if (typeof data.pauseAfterNext !== 'undefined') {
+                updatePauseAfterNextUI(data.pauseAfterNext);
             }
-
-            case 'qr_settings_saved':
-                showTemporaryMessage('QR settings saved', 'success');
-                break;
-
-            case 'remote_log': {
-                const container = document.getElementById('remote-log-container');
-                if (container && data.entries) {
-                    if (data.entries.length === 0) {
-                        container.textContent = '(no log entries yet)';
-                    } else {
-                        container.textContent = data.entries.map(e => {
-                            const secs = Math.floor(e.t / 1000);
-                            const mins = Math.floor(secs / 60);
-                            const hrs = Math.floor(mins / 60);
-                            const ts = hrs > 0
-                                ? `${hrs}h${String(mins % 60).padStart(2,'0')}m${String(secs % 60).padStart(2,'0')}s`
-                                : mins > 0
-                                    ? `${mins}m${String(secs % 60).padStart(2,'0')}s`
-                                    : `${secs}s`;
-                            return `[${ts}] ${e.m}`;
-                        }).join('\n');
-                        container.scrollTop = container.scrollHeight;
-                    }
-                }
-                break;
+            break;
+
+        case 'operators_list':
+            renderOperatorsList(data.operators || []);
+            break;
+
+        case 'operator_added':
+            showTemporaryMessage(`Operator "${escapeHtml(data.username)}" added`, "success");
+            if (newOperatorUsernameInput) newOperatorUsernameInput.value = '';
+            if (newOperatorPasswordInput) newOperatorPasswordInput.value = '';
+            loadOperators();
+            break;
+
+        case 'operator_removed':
+            showTemporaryMessage(`Operator "${escapeHtml(data.username)}" removed`, "success");
+            loadOperators();
+            break;
+
+        case 'password_changed':
+            showTemporaryMessage("Password changed successfully", "success");
+            if (changeOldPasswordInput) changeOldPasswordInput.value = '';
+            if (changeNewPasswordInput) changeNewPasswordInput.value = '';
+            break;
+
+        case 'timezone_changed':
+            showTemporaryMessage(`Timezone updated to ${data.timezone}`, "success");
+            const tzSelect = document.getElementById('timezone-select');
+            if (tzSelect) tzSelect.dataset.currentTimezone = data.timezone;
+            break;
+
+        case 'factory_reset_complete':
+            showTemporaryMessage("Factory reset complete. Please refresh page.", "success");
+            setTimeout(() => window.location.reload(), 2000);
+            break;
+
+        case 'ntp_status':
+            updateNTPStatus(data);
+            break;
+
+        case 'upcoming_events':
+            renderUpcomingEvents(data.events || [], data.lastSync);
+            break;
+
+        case 'helloclub_settings':
+            const hcApiKeyInput = document.getElementById('hc-api-key');
+            const hcEnabledInput = document.getElementById('hc-enabled');
+            const hcStatusEl = document.getElementById('hc-api-status');
+            if (hcApiKeyInput) {
+                hcApiKeyInput.placeholder = data.apiKey === '***configured***'
+                    ? 'API key is set (leave blank to keep)'
+                    : 'Paste API key here';
+                hcApiKeyInput.value = '';
             }
+            if (hcEnabledInput) hcEnabledInput.checked = data.enabled || false;
+            const hcDefaultDurInput = document.getElementById('hc-default-duration');
+            if (hcDefaultDurInput && data.defaultDuration) hcDefaultDurInput.value = data.defaultDuration;
+            const hcWebhookInput = document.getElementById('hc-webhook-secret');
+            if (hcWebhookInput) {
+                hcWebhookInput.placeholder = data.webhookSecret === '***configured***'
+                    ? 'Secret is set (leave blank to keep, "-" to turn off)'
+                    : 'Optional — enables push updates';
+                hcWebhookInput.value = '';
+            }
+            if (hcStatusEl) {
+                hcStatusEl.textContent = (data.apiKey === '***configured***'
+                    ? 'API key: configured'
+                    : 'API key: not set') +
+                    (data.webhookSecret === '***configured***'
+                        ? ` · Webhook: ${data.pushLive ? 'live' : 'waiting'} (${data.pushCount || 0} pushes)`
+                        : '') +
+                    (data.startCount
+                        ? ` · Last auto-start: ${data.lastStartLateMs} ms late`
+                        : '');
+            }
+            break;
+
+        case 'helloclub_settings_saved':
+            showTemporaryMessage(data.message || 'Hello Club settings saved', 'success');
+            // Refresh to show updated status
+            sendWebSocketMessage({ action: 'get_helloclub_settings' });
+            break;
+
+        case 'helloclub_refresh_result':
+            if (data.success) {
+                showTemporaryMessage(data.message || `Synced ${data.eventCount || 0} events from Hello Club`, "success");
+                if (data.debug) console.log("HC Sync Debug:\n" + data.debug);
+            } else {
+                showTemporaryMessage(data.message || data.error || 'Hello Club sync failed', "error");
+                if (data.debug) console.log("HC Sync Debug:\n" + data.debug);
+            }
+            break;
+
+        case 'event_auto_started':
+            showTemporaryMessage(`Auto-started: ${escapeHtml(data.eventName)}`, "success");
+            break;
+
+        case 'event_auto_resumed':
+            showTemporaryMessage(`Resumed after reboot: ${escapeHtml(data.eventName)} (round ${data.currentRound})`, "success");
+            break;
+
+        case 'event_cutoff':
+            showTemporaryMessage(data.message || "Session ended - booking time expired", "error");
+            break;
+
+        case 'qr_config': {
+            renderQrCodes(data);
+            // Populate settings form
+            const qrSsidInput = document.getElementById('qr-wifi-ssid');
+            const qrPassInput = document.getElementById('qr-wifi-password');
+            const qrEncInput = document.getElementById('qr-wifi-encryption');
+            const qrSsidHint = document.getElementById('qr-connected-ssid-hint');
+            if (qrSsidInput) qrSsidInput.value = data.ssidOverride || '';
+            if (qrPassInput) qrPassInput.value = data.password || '';
+            if (qrEncInput && data.encryption) qrEncInput.value = data.encryption;
+            if (qrSsidHint && data.connectedSsid) {
+                qrSsidHint.textContent = `Connected network: ${data.connectedSsid}`;
+            }
+            break;
+        }
 
-            case 'error':
-                hideLoadingOverlay();
-                showTemporaryMessage(data.message || "An error occurred", "error");
-                break;
-
-            // --- Timer events ---
-            case 'start':
-            case 'new_round':
-                serverEndTime = Date.now() + data.gameDuration;
-                displayEndTime = serverEndTime; // Snap on fresh start
-                isClientTimerPaused = false;
-                currentTimerStatus = 'RUNNING';
-                updatePauseBtnLabel(false);
-                startClientTimer();
-                if (data.continuousMode !== undefined) continuousMode = data.continuousMode;
-                roundCounterElement.textContent = formatRoundCounter(data.currentRound, data.numRounds);
-                enableDisplay.className = 'status-active';
-                updatePauseAfterNextVisibility();
-                if (data.pauseAfterNext !== undefined) updatePauseAfterNextUI(data.pauseAfterNext);
-                if (data.activeEventEndTime !== undefined) updateEventWindowDisplay(data.activeEventName, data.activeEventEndTime);
-                break;
-
-            case 'sync': {
-                // Update the target — the animation loop will smoothly converge
-                serverEndTime = Date.now() + data.mainTimerRemaining;
+        case 'qr_settings_saved':
+            showTemporaryMessage('QR settings saved', 'success');
+            break;
+
+        case 'remote_log': {
+            if (!data.entries) break;
+            if (data.seq < remoteLogSeq) remoteLogEntries = []; // Device restarted
+            if (data.lost > 0) {
+                const last = remoteLogEntries[remoteLogEntries.length - 1];
+                const t = data.entries.length ? data.entries[0].t : (last ? last.t : 0);
+                remoteLogEntries.push({ t, m: `(${data.lost} entries overwritten before they were sent)` });
+            }
+            remoteLogEntries.push(...data.entries);
+            if (remoteLogEntries.length > REMOTE_LOG_MAX_LINES) {
+                remoteLogEntries.splice(0, remoteLogEntries.length - REMOTE_LOG_MAX_LINES);
+            }
+            remoteLogSeq = data.seq;
+            if (data.trace) remoteLogTrace = data.trace;
+            renderRemoteLog();
+            break;
+        }
 
-                // Snap displayEndTime on first sync (fresh page load) so
-                // the animation loop starts with a valid remaining time
-                if (displayEndTime === 0) {
-                    displayEndTime = serverEndTime;
-                }
-
-                isClientTimerPaused = (data.status === 'PAUSED');
-                currentTimerStatus = data.status;
-                updatePauseBtnLabel(isClientTimerPaused);
-
-                if (!isClientTimerPaused && data.status === 'RUNNING') {
-                    startClientTimer();
-                } else {
-                    stopClientTimer();
-                    displayEndTime = serverEndTime;
-                    mainTimerDisplay.textContent = formatTime(data.mainTimerRemaining);
-                }
-
-                if (data.continuousMode !== undefined) continuousMode = data.continuousMode;
-                roundCounterElement.textContent = formatRoundCounter(data.currentRound, data.numRounds);
-                enableDisplay.className = (data.status === 'RUNNING' || data.status === 'PAUSED') ? 'status-active' : 'status-idle';
-                updatePauseAfterNextVisibility();
-                if (data.pauseAfterNext !== undefined) updatePauseAfterNextUI(data.pauseAfterNext);
-                if (data.activeEventEndTime !== undefined) updateEventWindowDisplay(data.activeEventName, data.activeEventEndTime);
-                break;
+        case 'time_ping':
+            // Clock offset estimation: answer at once with our clock
+            socket.send(JSON.stringify({ action: 'time_pong', t: data.t, c: Date.now() % 4294967296 }));
+            break;
+
+        case 'error':
+            hideLoadingOverlay();
+            showTemporaryMessage(data.message || "An error occurred", "error");
+            break;
+
+        // --- Timer events ---
+        case 'start':
+        case 'new_round':
+            serverEndTime = Date.now() + data.gameDuration;
+            displayEndTime = serverEndTime; // Snap on fresh start
+            isClientTimerPaused = false;
+            currentTimerStatus = 'RUNNING';
+            updatePauseBtnLabel(false);
+            startClientTimer();
+            if (data.continuousMode !== undefined) continuousMode = data.continuousMode;
+            roundCounterElement.textContent = formatRoundCounter(data.currentRound, data.numRounds);
+            enableDisplay.className = 'status-active';
+            updatePauseAfterNextVisibility();
+            if (data.pauseAfterNext !== undefined) updatePauseAfterNextUI(data.pauseAfterNext);
+            if (data.activeEventEndTime !== undefined) updateEventWindowDisplay(data.activeEventName, data.activeEventEndTime);
+            break;
+
+        case 'sync': {
+            // Update the target — the animation loop will smoothly converge
+            serverEndTime = syncEndTime(data, Date.now());
+
+            // Snap displayEndTime on first sync (fresh page load) so
+            // the animation loop starts with a valid remaining time
+            if (displayEndTime === 0) {
+                displayEndTime = serverEndTime;
             }
 
-            case 'pause':
-                isClientTimerPaused = true;
-                currentTimerStatus = 'PAUSED';
-                stopClientTimer();
-                if (data.mainTimerRemaining !== undefined) {
-                    serverEndTime = Date.now() + data.mainTimerRemaining;
-                    displayEndTime = serverEndTime;
-                    mainTimerDisplay.textContent = formatTime(data.mainTimerRemaining);
-                } else {
-                    mainTimerDisplay.textContent = formatTime(Math.max(0, displayEndTime - Date.now()));
-                }
-                if (data.currentRound !== undefined) {
-                    roundCounterElement.textContent = formatRoundCounter(data.currentRound, data.numRounds);
-                }
-                updatePauseBtnLabel(true);
-                updatePauseAfterNextUI(false);
-                updatePauseAfterNextVisibility();
-                break;
+            isClientTimerPaused = (data.status === 'PAUSED');
+            currentTimerStatus = data.status;
+            updatePauseBtnLabel(isClientTimerPaused);
 
-            case 'resume':
-                isClientTimerPaused = false;
-                currentTimerStatus = 'RUNNING';
-                if (data.mainTimerRemaining !== undefined) {
-                    serverEndTime = Date.now() + data.mainTimerRemaining;
-                    displayEndTime = serverEndTime;
-                }
-                updatePauseBtnLabel(false);
+            if (!isClientTimerPaused && data.status === 'RUNNING') {
                 startClientTimer();
-                updatePauseAfterNextVisibility();
-                break;
-
-            case 'reset':
-            case 'finished':
+            } else {
                 stopClientTimer();
-                serverEndTime = 0;
-                displayEndTime = 0;
-                currentTimerStatus = 'IDLE';
-                continuousMode = false;
-                updatePauseBtnLabel(false);
-                mainTimerDisplay.textContent = formatTime(0);
-                enableDisplay.className = 'status-idle';
-                updatePauseAfterNextUI(false);
-                updatePauseAfterNextVisibility();
-                updateEventWindowDisplay(null, 0);
-                break;
+                displayEndTime = serverEndTime;
+                mainTimerDisplay.textContent = formatTime(data.mainTimerRemaining);
+            }
 
-            case 'settings':
-                settings = data.settings;
-                gameDurationInput.value = settings.gameDuration / 60000;
-                numRoundsInput.value = settings.numRounds;
-                sirenLengthInput.value = settings.sirenLength;
-                sirenPauseInput.value = settings.sirenPause;
-                break;
+            if (data.continuousMode !== undefined) continuousMode = data.continuousMode;
+            roundCounterElement.textContent = formatRoundCounter(data.currentRound, data.numRounds);
+            enableDisplay.className = (data.status === 'RUNNING' || data.status === 'PAUSED') ? 'status-active' : 'status-idle';
+            updatePauseAfterNextVisibility();
+            if (data.pauseAfterNext !== undefined) updatePauseAfterNextUI(data.pauseAfterNext);
+            if (data.activeEventEndTime !== undefined) updateEventWindowDisplay(data.activeEventName, data.activeEventEndTime);
+            break;
+        }
 
-            case 'state':
-                serverEndTime = Date.now() + (data.state.mainTimer || 0);
+        case 'pause':
+            isClientTimerPaused = true;
+            currentTimerStatus = 'PAUSED';
+            stopClientTimer();
+            if (data.mainTimerRemaining !== undefined) {
+                serverEndTime = Date.now() + data.mainTimerRemaining;
                 displayEndTime = serverEndTime;
-                if (data.state.status !== 'RUNNING') {
-                    mainTimerDisplay.textContent = formatTime(data.state.mainTimer);
-                }
-                currentTimerStatus = data.state.status || 'IDLE';
-                if (data.state.continuousMode !== undefined) continuousMode = data.state.continuousMode;
-                roundCounterElement.textContent = formatRoundCounter(data.state.currentRound || 1, data.state.numRounds || 3);
-                enableDisplay.className = (data.state.status === 'RUNNING' || data.state.status === 'PAUSED') ? 'status-active' : 'status-idle';
-                if (data.state.time) {
-                    const serverDate = parseServerTime(data.state.time);
-                    if (serverDate) serverTimeOffset = serverDate.getTime() - Date.now();
-                }
-                updatePauseAfterNextVisibility();
-                if (data.state.pauseAfterNext !== undefined) updatePauseAfterNextUI(data.state.pauseAfterNext);
-                if (data.state.activeEventEndTime !== undefined) updateEventWindowDisplay(data.state.activeEventName, data.state.activeEventEndTime);
-                updateAutoTriggerDisplay(data.state);
-                break;
-        }
-    };
+                mainTimerDisplay.textContent = formatTime(data.mainTimerRemaining);
+            } else {
+                mainTimerDisplay.textContent = formatTime(Math.max(0, displayEndTime - Date.now()));
+            }
+            if (data.currentRound !== undefined) {
+                roundCounterElement.textContent = formatRoundCounter(data.currentRound, data.numRounds);
+            }
+            updatePauseBtnLabel(true);
+            updatePauseAfterNextUI(false);
+            updatePauseAfterNextVisibility();
+            break;
+
+        case 'resume':
+            isClientTimerPaused = false;
+            currentTimerStatus = 'RUNNING';
+            if (data.mainTimerRemaining !== undefined) {
+                serverEndTime = Date.now() + data.mainTimerRemaining;
+                displayEndTime = serverEndTime;
+            }
+            updatePauseBtnLabel(false);
+            startClientTimer();
+            updatePauseAfterNextVisibility();
+            break;
+
+        case 'reset':
+        case 'finished':
+            stopClientTimer();
+            serverEndTime = 0;
+            displayEndTime = 0;
+            currentTimerStatus = 'IDLE';
+            continuousMode = false;
+            updatePauseBtnLabel(false);
+            mainTimerDisplay.textContent = formatTime(0);
+            enableDisplay.className = 'status-idle';
+            updatePauseAfterNextUI(false);
+            updatePauseAfterNextVisibility();
+            updateEventWindowDisplay(null, 0);
+            break;
+
+        case 'settings':
+            settings = data.settings;
+            gameDurationInput.value = settings.gameDuration / 60000;
+            numRoundsInput.value = settings.numRounds;
+            sirenLengthInput.value = settings.sirenLength;
+            sirenPauseInput.value = settings.sirenPause;
+            break;
+
+        case 'state':
+            serverEndTime = Date.now() + (data.state.mainTimer || 0);
+            displayEndTime = serverEndTime;
+            if (data.state.status !== 'RUNNING') {
+                mainTimerDisplay.textContent = formatTime(data.state.mainTimer);
+            }
+            currentTimerStatus = data.state.status || 'IDLE';
+            if (data.state.continuousMode !== undefined) continuousMode = data.state.continuousMode;
+            roundCounterElement.textContent = formatRoundCounter(data.state.currentRound || 1, data.state.numRounds || 3);
+            enableDisplay.className = (data.state.status === 'RUNNING' || data.state.status === 'PAUSED') ? 'status-active' : 'status-idle';
+            if (data.state.time) {
+                const serverDate = parseServerTime(data.state.time);
+                if (serverDate) serverTimeOffset = serverDate.getTime() - Date.now();
+            }
+            updatePauseAfterNextVisibility();
+            if (data.state.pauseAfterNext !== undefined) updatePauseAfterNextUI(data.state.pauseAfterNext);
+            if (data.state.activeEventEndTime !== undefined) updateEventWindowDisplay(data.state.activeEventName, data.state.activeEventEndTime);
+            updateAutoTriggerDisplay(data.state);
+            break;
+    }
 }
 
 // --- Global handlers for onclick ---
@@ -1237,7 +1342,11 @@ window.handleLoginLogout = function() {
 // --- Init ---
 if (!SIMULATION_MODE) {
     initializeEventListeners();
-    connectWebSocket();
+    if (VIEWER_STREAM) {
+        connectEventStream();
+    } else {
+        connectWebSocket();
+    }
 } else {
     console.log("Running in Simulation Mode");
     initializeEventListeners();
@@ -0,0 +1,119 @@
+#include "beacon.h"
+#include <WiFiUdp.h>
+#include "clockdisc.h"
+#include "config.h"
+#include "timesvc.h"
+#include "wifijoin.h"
+
+static const uint8_t FLAG_PAUSE_AFTER_NEXT = 0x01;
+static const uint8_t FLAG_CONTINUOUS = 0x02;
+static const uint8_t FLAG_DEADLINE = 0x04;
+
+static WiFiUDP udp;
+static IPAddress destination;
+static bool addressParsed = false;
+
+static uint32_t changes = 0;
+static uint32_t sent = 0;
+static uint32_t errors = 0;
+
+// Last state sent. While running the mark is the round end on
+// clockMillis(), otherwise the time remaining; either stays put until
+// something happens to the timer.
+static uint8_t lastState = 0xFF;
+static uint8_t lastFlags = 0;
+static uint16_t lastRound = 0;
+static uint16_t lastRounds = 0;
+static uint32_t lastDuration = 0;
+static uint32_t lastMark = 0;
+static unsigned long lastSentAt = 0;
+static int repeatsLeft = 0;
+
+static void put16(uint8_t* p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static void put32(uint8_t* p, uint32_t v) {
+    put16(p, v);
+    put16(p + 2, v >> 16);
+}
+
+static void put64(uint8_t* p, uint64_t v) {
+    put32(p, (uint32_t)v);
+    put32(p + 4, (uint32_t)(v >> 32));
+}
+
+static void send(const Timer& timer, uint8_t state, uint8_t flags) {
+    uint32_t remaining = timer.getMainTimerRemaining();
+    int64_t deadline = 0;
+    if (state == RUNNING && timeValid()) {
+        deadline = timeNowMs() + remaining;
+        flags |= FLAG_DEADLINE;
+    }
+
+    uint8_t packet[BEACON_PACKET_SIZE] = {};
+    memcpy(packet, "BTB1", 4);
+    packet[4] = state;
+    packet[5] = flags;
+    put16(packet + 6, timer.getCurrentRound());
+    put16(packet + 8, timer.getNumRounds());
+    put32(packet + 12, changes);
+    put32(packet + 16, remaining);
+    put32(packet + 20, timer.getGameDuration());
+    put64(packet + 24, (uint64_t)deadline);
+
+    if (udp.beginPacket(destination, BEACON_PORT) && udp.write(packet, sizeof(packet)) == sizeof(packet) &&
+        udp.endPacket()) {
+        sent++;
+    } else {
+        errors++;
+    }
+}
+
+void beaconLoop(const Timer& timer) {
+    if (!ENABLE_BEACON || !wifiJoinConnected()) {
+        return;
+    }
+    if (!addressParsed) {
+        destination.fromString(BEACON_ADDRESS);
+        addressParsed = true;
+    }
+
+    unsigned long now = millis();
+    uint8_t state = timer.getState();
+    uint8_t flags = (timer.getPauseAfterNext() ? FLAG_PAUSE_AFTER_NEXT : 0) |
+                    (timer.getContinuousMode() ? FLAG_CONTINUOUS : 0);
+    uint16_t round = timer.getCurrentRound();
+    uint16_t rounds = timer.getNumRounds();
+    uint32_t duration = timer.getGameDuration();
+    uint32_t remaining = timer.getMainTimerRemaining();
+    uint32_t mark = state == RUNNING ? clockMillis() + remaining : remaining;
+    int32_t moved = (int32_t)(mark - lastMark);
+
+    if (state != lastState || flags != lastFlags || round != lastRound || rounds != lastRounds ||
+        duration != lastDuration || moved > BEACON_DEADLINE_SLACK_MS || moved < -BEACON_DEADLINE_SLACK_MS) {
+        lastState = state;
+        lastFlags = flags;
+        lastRound = round;
+        lastRounds = rounds;
+        lastDuration = duration;
+        lastMark = mark;
+        changes++;
+        repeatsLeft = BEACON_REPEATS;
+    } else if (repeatsLeft > 0 && now - lastSentAt >= BEACON_REPEAT_MS) {
+        repeatsLeft--;
+    } else if (now - lastSentAt < BEACON_HEARTBEAT_MS) {
+        return;
+    }
+
+    send(timer, state, flags);
+    lastSentAt = now;
+}
+
+String beaconStatsJson() {
+    char buf[96];
+    snprintf(buf, sizeof(buf), "{\"enabled\":%s,\"changes\":%u,\"sent\":%u,\"errors\":%u}",
+             ENABLE_BEACON ? "true" : "false", (unsigned)changes, (unsigned)sent, (unsigned)errors);
+    return String(buf);
+}
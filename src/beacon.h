@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+#include "timer.h"
+
+// =============================================================================
+// Timer Beacon — timer state over UDP for LAN displays (ENABLE_BEACON)
+// =============================================================================
+//
+// Wall displays and scoreboards can follow the timer without a WebSocket.
+// One datagram to BEACON_ADDRESS:BEACON_PORT (multicast or broadcast)
+// reaches all of them, so unlike ws.textAll() the cost does not grow with
+// the number of listeners and is not capped by MAX_WEBSOCKET_CLIENTS.
+// A packet goes out when the state, round or deadline changes, again
+// BEACON_REPEATS times against loss, and every BEACON_HEARTBEAT_MS while
+// nothing changes. Sent only while the station is connected.
+//
+// Packet, 32 bytes little-endian:
+//    0  "BTB1"
+//    4  u8  state: 0 idle, 1 running, 2 paused, 3 finished
+//    5  u8  flags: 1 pause after next, 2 continuous mode, 4 deadline valid
+//    6  u16 current round
+//    8  u16 rounds
+//   10  u16 reserved (0)
+//   12  u32 change counter; repeats and heartbeats carry the same value
+//   16  u32 main timer remaining (ms) when sent
+//   20  u32 round duration (ms)
+//   24  u64 round end, Unix ms; valid while running on NTP time
+//
+// Host listener: test-server/beacon-listen.js.
+
+constexpr size_t BEACON_PACKET_SIZE = 32;
+
+// Main loop, after timer.update()
+void beaconLoop(const Timer& timer);
+
+String beaconStatsJson();
@@ -0,0 +1,265 @@
+#include "bootlog.h"
+#include "config.h"
+#include "SPIFFS.h"
+#include <atomic>
+#include <memory>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "seriallog.h"
+
+#define BOOT_LOG_LEGACY_PATH "/bootlog.txt"
+
+static File logFile;                        // Kept open by the writer
+static BootLogHeader header;
+static SemaphoreHandle_t fileMutex = nullptr;
+static QueueHandle_t queue = nullptr;
+static std::atomic<uint32_t> pending(0);    // Queued or being written
+static std::atomic<uint32_t> dropped(0);    // Not yet added to header.dropped
+
+static size_t recordOffset(uint16_t slot) {
+    return sizeof(BootLogHeader) + (size_t)slot * sizeof(BootLogRecord);
+}
+
+static bool readRecord(File& f, uint16_t slot, BootLogRecord& rec) {
+    return f.seek(recordOffset(slot)) &&
+           f.read((uint8_t*)&rec, sizeof(rec)) == sizeof(rec);
+}
+
+static bool writeHeader() {
+    return logFile.seek(0) &&
+           logFile.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+}
+
+static bool openLog() {
+    if (!SPIFFS.exists(BOOT_LOG_PATH)) {
+        return false;
+    }
+    logFile = SPIFFS.open(BOOT_LOG_PATH, "r+");
+    if (!logFile) {
+        return false;
+    }
+    bool valid = logFile.size() == recordOffset(BOOT_LOG_RECORDS) &&
+                 logFile.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                 header.magic == BOOT_LOG_MAGIC &&
+                 header.version == BOOT_LOG_VERSION &&
+                 header.recordSize == sizeof(BootLogRecord) &&
+                 header.capacity == BOOT_LOG_RECORDS &&
+                 header.head < BOOT_LOG_RECORDS &&
+                 header.count <= BOOT_LOG_RECORDS;
+    if (!valid) {
+        logFile.close();
+    }
+    return valid;
+}
+
+// Preallocate the whole ring so later writes never grow the file
+static bool createLog() {
+    logFile = SPIFFS.open(BOOT_LOG_PATH, "w+");
+    if (!logFile) {
+        return false;
+    }
+    header = {};
+    header.magic = BOOT_LOG_MAGIC;
+    header.version = BOOT_LOG_VERSION;
+    header.recordSize = sizeof(BootLogRecord);
+    header.capacity = BOOT_LOG_RECORDS;
+    header.nextSeq = 1;   // Preallocated slots read as seq 0
+
+    BootLogRecord blank = {};
+    bool ok = writeHeader();
+    for (int i = 0; ok && i < BOOT_LOG_RECORDS; i++) {
+        ok = logFile.write((const uint8_t*)&blank, sizeof(blank)) == sizeof(blank);
+    }
+    logFile.flush();
+    if (!ok) {
+        logFile.close();
+    }
+    return ok;
+}
+
+// The header is written after each batch of records, so a crash can leave
+// it behind the records. Pick those up: they carry the expected seq.
+static void recoverHead() {
+    bool advanced = false;
+    BootLogRecord rec;
+    for (int i = 0; i < BOOT_LOG_RECORDS; i++) {
+        if (!readRecord(logFile, header.head, rec) || rec.seq != header.nextSeq) {
+            break;
+        }
+        header.head = (header.head + 1) % BOOT_LOG_RECORDS;
+        header.nextSeq++;
+        if (header.count < BOOT_LOG_RECORDS) header.count++;
+        advanced = true;
+    }
+    if (advanced) {
+        writeHeader();
+        logFile.flush();
+    }
+}
+
+static void bootLogWriterTask(void* param) {
+    for (;;) {
+        BootLogRecord rec;
+        if (xQueueReceive(queue, &rec, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        uint32_t written = 0;
+        xSemaphoreTake(fileMutex, portMAX_DELAY);
+        do {
+            rec.seq = header.nextSeq++;
+            if (logFile.seek(recordOffset(header.head))) {
+                logFile.write((const uint8_t*)&rec, sizeof(rec));
+            }
+            header.head = (header.head + 1) % BOOT_LOG_RECORDS;
+            if (header.count < BOOT_LOG_RECORDS) header.count++;
+            written++;
+        } while (xQueueReceive(queue, &rec, 0) == pdTRUE);
+
+        // One header update per batch
+        header.dropped += dropped.exchange(0);
+        writeHeader();
+        logFile.flush();
+        xSemaphoreGive(fileMutex);
+
+        pending -= written;
+    }
+}
+
+void bootLogInit() {
+    SPIFFS.remove(BOOT_LOG_LEGACY_PATH);
+
+    if (!openLog() && !createLog()) {
+        serialLog.println("[LOG] Boot log file unavailable, logging to serial only");
+        return;
+    }
+    recoverHead();
+
+    fileMutex = xSemaphoreCreateMutex();
+    queue = xQueueCreate(BOOT_LOG_QUEUE_DEPTH, sizeof(BootLogRecord));
+    if (!fileMutex || !queue ||
+        xTaskCreatePinnedToCore(bootLogWriterTask, "bootLog", BOOT_LOG_WRITER_STACK_SIZE, nullptr,
+                                BOOT_LOG_WRITER_PRIORITY, nullptr, BOOT_LOG_WRITER_CORE) != pdPASS) {
+        serialLog.println("[LOG] Boot log writer failed to start");
+        queue = nullptr;
+    }
+}
+
+void bootLog(const char* fmt, ...) {
+    BootLogRecord rec;
+    rec.seq = 0;   // Assigned by the writer, in file order
+    rec.ms = millis();
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(rec.text, sizeof(rec.text), fmt, args);
+    va_end(args);
+
+    serialLog.print("[LOG] ");
+    serialLog.println(rec.text);
+
+    if (!queue) {
+        return;
+    }
+    pending++;
+    if (xQueueSend(queue, &rec, 0) != pdTRUE) {
+        pending--;
+        dropped++;
+    }
+}
+
+void bootLogFlush(unsigned long timeoutMs) {
+    unsigned long start = millis();
+    while (pending > 0 && millis() - start < timeoutMs) {
+        delay(10);
+    }
+}
+
+void bootLogClear() {
+    if (!fileMutex) {
+        return;
+    }
+    xSemaphoreTake(fileMutex, portMAX_DELAY);
+    header.count = 0;   // head and nextSeq carry on
+    header.dropped = 0;
+    writeHeader();
+    logFile.flush();
+    xSemaphoreGive(fileMutex);
+}
+
+namespace {
+// State of one /log download: a snapshot of the ring when the request came
+// in, read back one record per line
+struct LogStream {
+    File file;
+    uint16_t slot;
+    uint32_t seq;         // Expected seq of the record at slot
+    uint32_t remaining;
+    char line[BOOT_LOG_TEXT_LEN + 32];
+    size_t len = 0;
+    size_t pos = 0;
+};
+
+bool nextLine(LogStream& s) {
+    while (s.remaining > 0) {
+        BootLogRecord rec;
+        xSemaphoreTake(fileMutex, portMAX_DELAY);
+        bool ok = readRecord(s.file, s.slot, rec);
+        xSemaphoreGive(fileMutex);
+
+        uint32_t expected = s.seq++;
+        s.slot = (s.slot + 1) % BOOT_LOG_RECORDS;
+        s.remaining--;
+        if (!ok || rec.seq != expected) {
+            continue; // Overwritten since the download started
+        }
+        rec.text[BOOT_LOG_TEXT_LEN - 1] = '\0';
+        s.len = snprintf(s.line, sizeof(s.line), "[%lu ms] %s\n", (unsigned long)rec.ms, rec.text);
+        s.len = min(s.len, sizeof(s.line) - 1);
+        s.pos = 0;
+        return true;
+    }
+    return false;
+}
+} // namespace
+
+AsyncWebServerResponse* bootLogResponse(AsyncWebServerRequest* request) {
+    if (!fileMutex) {
+        return request->beginResponse(200, "text/plain", "No boot log found.");
+    }
+
+    auto s = std::make_shared<LogStream>();
+    xSemaphoreTake(fileMutex, portMAX_DELAY);
+    s->remaining = header.count;
+    s->slot = (header.head + BOOT_LOG_RECORDS - header.count % BOOT_LOG_RECORDS) % BOOT_LOG_RECORDS;
+    s->seq = header.nextSeq - header.count;
+    uint32_t lost = header.dropped;
+    xSemaphoreGive(fileMutex);
+
+    if (s->remaining == 0) {
+        return request->beginResponse(200, "text/plain", "No boot log found.");
+    }
+    s->file = SPIFFS.open(BOOT_LOG_PATH, "r");
+    if (!s->file) {
+        return request->beginResponse(500, "text/plain", "Boot log unreadable.");
+    }
+    if (lost > 0) {
+        s->len = snprintf(s->line, sizeof(s->line), "--- %u record(s) dropped (writer queue full) ---\n", lost);
+    }
+
+    return request->beginChunkedResponse("text/plain",
+        [s](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            size_t n = 0;
+            while (n < maxLen) {
+                if (s->pos == s->len && !nextLine(*s)) {
+                    break;
+                }
+                size_t chunk = min(maxLen - n, s->len - s->pos);
+                memcpy(buffer + n, s->line + s->pos, chunk);
+                n += chunk;
+                s->pos += chunk;
+            }
+            return n;
+        });
+}
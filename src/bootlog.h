@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+// =============================================================================
+// Boot Log — circular file of fixed-size records on SPIFFS
+// =============================================================================
+//
+// BOOT_LOG_PATH is preallocated once: a header followed by BOOT_LOG_RECORDS
+// records. The header holds the next slot to write and the sequence number
+// of the record that goes there; the oldest record is overwritten in place,
+// so the file never grows and is never rewritten.
+//
+// bootLog() only formats a record and queues it. A low-priority task writes
+// queued records and then the header, once per batch.
+
+constexpr uint32_t BOOT_LOG_MAGIC = 0x474C5442;   // "BTLG"
+constexpr uint16_t BOOT_LOG_VERSION = 1;
+constexpr int BOOT_LOG_TEXT_LEN = 120;
+
+struct BootLogHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint16_t capacity;
+    uint16_t head;        // Slot the next record goes to
+    uint32_t count;       // Valid records (≤ capacity)
+    uint32_t nextSeq;     // Sequence number of the next record
+    uint32_t dropped;     // Records lost to a full queue since the file was created
+};
+
+struct BootLogRecord {
+    uint32_t seq;
+    uint32_t ms;          // millis() when logged
+    char text[BOOT_LOG_TEXT_LEN];
+};
+
+static_assert(sizeof(BootLogRecord) == 128, "boot log record size is part of the file format");
+
+// Open or create the log file and start the writer task (after SPIFFS.begin())
+void bootLogInit();
+void bootLog(const char* fmt, ...);
+
+// Wait up to timeoutMs for queued records to reach flash (before a restart)
+void bootLogFlush(unsigned long timeoutMs = 500);
+void bootLogClear();
+
+// Decoded log as text/plain, streamed one record at a time
+AsyncWebServerResponse* bootLogResponse(AsyncWebServerRequest* request);
@@ -0,0 +1,148 @@
+#include "bootprof.h"
+#include <Preferences.h>
+#include "esp_system.h"
+#include "rom/crc.h"
+#include "config.h"
+#include "nvsstore.h"
+
+static const char* NVS_NS = "bootprof";
+static const char* NVS_KEY = "hist";
+static const uint32_t HISTORY_MAGIC = 0x50544F42 + (uint32_t)BOOT_PHASE_COUNT;   // "BOTP", per phase set
+
+static const char* const PHASE_NAMES[BOOT_PHASE_COUNT] = {
+    "init", "selfTest", "spiffs", "settings", "users", "helloclub", "server",
+    "setup", "wifi", "ota", "mdns", "ntp", "recovery"
+};
+
+struct BootProfHistory {
+    uint32_t magic;
+    uint8_t head;                        // Slot the next boot goes to
+    uint8_t count;
+    uint32_t nextBoot;
+    BootProfRecord records[BOOT_PROF_HISTORY];
+    uint32_t crc;                        // Over everything before it
+};
+
+static BootProfRecord current;
+static BootProfHistory history;
+static bool loaded = false;
+static int savedSlot = -1;               // This boot's slot once stored
+static bool dirty = false;               // A phase ended after it was stored
+
+static uint32_t historyCrc(const BootProfHistory& h) {
+    return crc32_le(0, (const uint8_t*)&h, offsetof(BootProfHistory, crc));
+}
+
+static void loadHistory() {
+    bool ok = false;
+    Preferences prefs;
+    if (prefs.begin(NVS_NS, true)) {
+        ok = prefs.getBytesLength(NVS_KEY) == sizeof(history) &&
+             prefs.getBytes(NVS_KEY, &history, sizeof(history)) == sizeof(history);
+        prefs.end();
+    }
+    if (!ok || history.magic != HISTORY_MAGIC || history.crc != historyCrc(history) ||
+        history.head >= BOOT_PROF_HISTORY || history.count > BOOT_PROF_HISTORY) {
+        memset(&history, 0, sizeof(history));
+        history.magic = HISTORY_MAGIC;
+        history.nextBoot = 1;
+    }
+}
+
+static void saveHistory() {
+    history.records[savedSlot] = current;
+    history.crc = historyCrc(history);
+    nvsStore.putBytes(NVS_NS, NVS_KEY, &history, sizeof(history));
+}
+
+void bootProfBegin() {
+    memset(&current, 0, sizeof(current));
+    current.resetReason = (uint8_t)esp_reset_reason();
+    current.started = current.done = 1 << BOOT_PHASE_INIT;
+    current.durMs[BOOT_PHASE_INIT] = millis();
+    bootPhaseBegin(BOOT_PHASE_SETUP);
+}
+
+void bootPhaseBegin(BootPhase phase) {
+    uint16_t bit = 1 << phase;
+    if (current.started & bit) {
+        return;
+    }
+    current.startMs[phase] = millis();
+    current.started |= bit;
+}
+
+void bootPhaseEnd(BootPhase phase) {
+    uint16_t bit = 1 << phase;
+    if (!(current.started & bit) || (current.done & bit)) {
+        return;
+    }
+    current.durMs[phase] = millis() - current.startMs[phase];
+    current.done |= bit;
+    if (savedSlot >= 0) {
+        dirty = true;
+    }
+}
+
+void bootProfLoop() {
+    if (!loaded) {
+        loadHistory();
+        current.boot = history.nextBoot;
+        loaded = true;
+    }
+    if (savedSlot < 0) {
+        if (millis() < BOOT_PROF_SAVE_MS) {
+            return;
+        }
+        savedSlot = history.head;
+        history.head = (history.head + 1) % BOOT_PROF_HISTORY;
+        if (history.count < BOOT_PROF_HISTORY) {
+            history.count++;
+        }
+        history.nextBoot++;
+        saveHistory();
+    } else if (dirty) {
+        dirty = false;
+        saveHistory();
+    }
+}
+
+static void appendRecord(String& json, const BootProfRecord& r) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "{\"boot\":%u,\"reset\":%u,\"phases\":{", (unsigned)r.boot, r.resetReason);
+    json += buf;
+    bool first = true;
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+        uint16_t bit = 1 << i;
+        if (!(r.started & bit)) {
+            continue;
+        }
+        snprintf(buf, sizeof(buf), "%s\"%s\":[%u,%ld]", first ? "" : ",", PHASE_NAMES[i],
+                 (unsigned)r.startMs[i], (r.done & bit) ? (long)r.durMs[i] : -1L);
+        json += buf;
+        first = false;
+    }
+    json += "}}";
+}
+
+String bootProfJson() {
+    String json;
+    json.reserve(200 + 300 * BOOT_PROF_HISTORY);
+    json += "{\"current\":";
+    appendRecord(json, current);
+    json += ",\"history\":[";
+    bool first = true;
+    for (int i = 1; i <= history.count; i++) {
+        int slot = (history.head - i + BOOT_PROF_HISTORY) % BOOT_PROF_HISTORY;
+        if (slot == savedSlot) {
+            continue;    // Same as current
+        }
+        if (!first) {
+            json += ",";
+        }
+        appendRecord(json, history.records[slot]);
+        first = false;
+    }
+    json += "]}";
+    return json;
+}
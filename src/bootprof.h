@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+
+// =============================================================================
+// Boot Profiler — per-phase boot timings, last boots kept in NVS
+// =============================================================================
+//
+// setup() and the first network events mark the start and end of each boot
+// phase with bootPhaseBegin()/bootPhaseEnd(); times are millis() since the
+// application started. BOOT_PHASE_INIT is everything before setup(): the
+// bootloader and the global constructors (Settings alone reads NVS three
+// times there).
+//
+// The record of this boot joins a ring of the last BOOT_PROF_HISTORY boots
+// in NVS once the device has been up BOOT_PROF_SAVE_MS; phases that end
+// later (a slow WiFi join, the first NTP sync) update it in place. Both the
+// running boot and the history are under "boot" in GET /diag.
+
+enum BootPhase : uint8_t {
+    BOOT_PHASE_INIT,          // Reset to setup() (bootloader, constructors)
+    BOOT_PHASE_SELF_TEST,
+    BOOT_PHASE_SPIFFS,        // Mount and boot log
+    BOOT_PHASE_SETTINGS,      // NVS store, siren and timer settings
+    BOOT_PHASE_USERS,         // UserManager::begin (may re-save on migration)
+    BOOT_PHASE_HELLOCLUB,     // Hello Club settings and cached events
+    BOOT_PHASE_SERVER,        // Routes, WebSocket, server.begin()
+    BOOT_PHASE_SETUP,         // The whole of setup()
+    BOOT_PHASE_WIFI,          // Join started to first connection
+    BOOT_PHASE_OTA,
+    BOOT_PHASE_MDNS,
+    BOOT_PHASE_NTP,           // First NTP request to first sync
+    BOOT_PHASE_RECOVERY,      // Mid-event boot recovery check
+    BOOT_PHASE_COUNT
+};
+
+struct BootProfRecord {
+    uint32_t boot;                       // Boot number, counts up across the ring
+    uint16_t started;                    // Bit per phase begun
+    uint16_t done;                       // Bit per phase ended
+    uint8_t resetReason;                 // esp_reset_reason_t
+    uint32_t startMs[BOOT_PHASE_COUNT];
+    uint32_t durMs[BOOT_PHASE_COUNT];
+};
+
+// First thing in setup(): closes BOOT_PHASE_INIT, opens BOOT_PHASE_SETUP
+void bootProfBegin();
+
+// Each phase is timed once per boot; repeated or unmatched calls are ignored
+void bootPhaseBegin(BootPhase phase);
+void bootPhaseEnd(BootPhase phase);
+
+// Main loop: load the history, then store this boot (see above)
+void bootProfLoop();
+
+// {"current":{...},"history":[{...}, newest first]}; each record is
+// {"boot":n,"reset":code,"phases":{"spiffs":[startMs,durMs],...}} with
+// durMs -1 for a phase still running and phases never begun left out
+String bootProfJson();
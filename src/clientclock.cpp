@@ -0,0 +1,53 @@
+#include "clientclock.h"
+
+bool ClientClock::pingDue(uint32_t now) const {
+    if (outstanding && now - pingAt < CLIENT_CLOCK_PONG_TIMEOUT_MS) {
+        return false;
+    }
+    if (!pinged) {
+        return true;
+    }
+    // Fill the filter quickly after connecting, then keep it fresh
+    uint32_t interval = count < CLIENT_CLOCK_SAMPLES ? CLIENT_CLOCK_FAST_PING_MS : CLIENT_CLOCK_PING_MS;
+    return now - pingAt >= interval;
+}
+
+void ClientClock::pingSent(uint32_t now) {
+    pingAt = now;
+    outstanding = true;
+    pinged = true;
+}
+
+bool ClientClock::pong(uint32_t sentAt, uint32_t clientMs, uint32_t now) {
+    if (!outstanding || sentAt != pingAt) {
+        return false;
+    }
+    outstanding = false;
+
+    uint32_t rtt = now - sentAt;
+    ring[next].rtt = rtt;
+    ring[next].offset = (int32_t)(clientMs - (sentAt + rtt / 2));
+    next = (next + 1) % CLIENT_CLOCK_SAMPLES;
+    if (count < CLIENT_CLOCK_SAMPLES) {
+        count++;
+    }
+
+    best = 0;
+    for (uint8_t i = 1; i < count; i++) {
+        if (ring[i].rtt < ring[best].rtt) {
+            best = i;
+        }
+    }
+    return true;
+}
+
+String ClientClock::json(uint32_t clientId) const {
+    char buf[112];
+    if (!valid()) {
+        snprintf(buf, sizeof(buf), "{\"id\":%u,\"samples\":0}", (unsigned)clientId);
+    } else {
+        snprintf(buf, sizeof(buf), "{\"id\":%u,\"samples\":%u,\"rttMs\":%u,\"offsetMs\":%ld,\"errorMs\":%u}",
+                 (unsigned)clientId, (unsigned)count, (unsigned)rttMs(), (long)offsetMs(), (unsigned)errorMs());
+    }
+    return String(buf);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+// =============================================================================
+// Client Clock — each browser's clock offset from clockMillis()
+// =============================================================================
+//
+// A sync frame gives the time remaining at serverMillis. A display that
+// counts from the frame's arrival runs late by however long the frame took,
+// so displays on different links disagree at the siren.
+//
+// The loop pings each client (time_ping, t = clockMillis()) and the browser
+// answers with its own clock (time_pong, c = Date.now() mod 2^32). One
+// exchange gives rtt = arrival − t and offset = c − (t + rtt/2). Queueing
+// only ever adds delay, so, like NTP's clock filter, the offset is taken
+// from the exchange with the smallest RTT of the last CLIENT_CLOCK_SAMPLES;
+// half that RTT bounds its error. Sync frames carry the client's offset so
+// it can place the round end on its own clock.
+//
+// Browser times are taken mod 2^32, so offsets wrap like millis().
+
+class ClientClock {
+public:
+    // Main loop: no ping outstanding (or it timed out) and one is due
+    bool pingDue(uint32_t now) const;
+    void pingSent(uint32_t now);
+
+    // WebSocket handler: reply to the ping sent at sentAt, stamped clientMs
+    // by the browser and received at now. False if it is not the
+    // outstanding ping.
+    bool pong(uint32_t sentAt, uint32_t clientMs, uint32_t now);
+
+    bool valid() const { return count > 0; }
+    int32_t offsetMs() const { return ring[best].offset; }   // Browser minus server
+    uint32_t rttMs() const { return ring[best].rtt; }
+    uint32_t errorMs() const { return ring[best].rtt / 2; }
+    uint8_t samples() const { return count; }
+
+    String json(uint32_t clientId) const;
+
+private:
+    struct Sample {
+        uint32_t rtt;
+        int32_t offset;
+    };
+
+    Sample ring[CLIENT_CLOCK_SAMPLES] = {};
+    uint8_t count = 0;
+    uint8_t next = 0;
+    uint8_t best = 0;           // Lowest RTT in the ring
+    uint32_t pingAt = 0;
+    bool outstanding = false;
+    bool pinged = false;
+};
@@ -0,0 +1,161 @@
+#include "clockdisc.h"
+#include <atomic>
+#include "config.h"
+#include "remotelog.h"
+
+static const int MAX_SAMPLES = 8;         // Hourly syncs: covers the 6 h baseline
+static const uint32_t REBASE_MS = 0x80000000UL; // e wraps at 2^32 ms (49.7 days)
+
+// clockMillis() = baseDisc + e + e·ratePpb/1e9, e = millis() - baseLocal.
+// Changed only by the loop task: the new set is written to the inactive
+// slot and then published, so readers on other tasks never see a half-
+// written set.
+struct Params {
+    uint32_t baseLocal;
+    uint32_t baseDisc;
+    int32_t ratePpb;
+};
+
+struct Sample {
+    uint32_t local;
+    int64_t wall;
+};
+
+static Params params[2] = {{0, 0, 0}, {0, 0, 0}};
+static std::atomic<uint8_t> active(0);
+
+static Sample samples[MAX_SAMPLES];
+static int sampleCount = 0;
+static bool haveRef = false;
+static int64_t refOffset = 0;             // Wall ms minus disciplined ms
+static int32_t driftCorrPpb = 0;          // Rate correction for the measured drift
+static int32_t slewPpb = 0;
+static uint32_t slewEnd = 0;
+static bool slewing = false;
+
+static ClockDiscStats stats = {false, 0, 0, 0, 0, 0, 0};
+
+static uint32_t discAt(const Params& p, uint32_t local) {
+    uint32_t e = local - p.baseLocal;
+    return p.baseDisc + e + (uint32_t)((int64_t)e * p.ratePpb / 1000000000);
+}
+
+// Rebase at local so the clock stays continuous, then change the rate
+static void setRate(uint32_t local, int32_t ratePpb) {
+    uint8_t cur = active.load();
+    Params next;
+    next.baseDisc = discAt(params[cur], local);
+    next.baseLocal = local;
+    next.ratePpb = ratePpb;
+    params[cur ^ 1] = next;
+    active.store(cur ^ 1);
+}
+
+static void startSlew(uint32_t local, int32_t errMs) {
+    slewing = errMs != 0;
+    slewPpb = errMs > 0 ? CLOCK_DISC_SLEW_PPM * 1000 : errMs < 0 ? -CLOCK_DISC_SLEW_PPM * 1000 : 0;
+    uint32_t absErr = errMs < 0 ? -errMs : errMs;
+    slewEnd = local + (uint32_t)((uint64_t)absErr * 1000000 / CLOCK_DISC_SLEW_PPM);
+    stats.slewMs = errMs;
+}
+
+uint32_t clockMillis() {
+    return discAt(params[active.load()], millis());
+}
+
+void clockDiscSample(uint32_t localMs, int64_t wallMs) {
+    stats.samples++;
+    uint32_t disc = discAt(params[active.load()], localMs);
+
+    if (!haveRef) {
+        haveRef = true;
+        refOffset = wallMs - disc;
+        samples[0] = {localMs, wallMs};
+        sampleCount = 1;
+        return;
+    }
+
+    int32_t phaseErr = (int32_t)((uint32_t)(wallMs - refOffset) - disc);
+    if (phaseErr > CLOCK_DISC_STEP_MS || phaseErr < -CLOCK_DISC_STEP_MS) {
+        // The wall clock jumped: earlier samples are on another time base
+        remoteLog("Clock: Wall clock stepped %ld ms, reference moved", (long)phaseErr);
+        refOffset = wallMs - disc;
+        samples[0] = {localMs, wallMs};
+        sampleCount = 1;
+        stats.steps++;
+        stats.phaseErrMs = 0;
+        startSlew(localMs, 0);
+        setRate(localMs, driftCorrPpb);
+        return;
+    }
+
+    if (sampleCount == MAX_SAMPLES) {
+        memmove(samples, samples + 1, sizeof(Sample) * (MAX_SAMPLES - 1));
+        sampleCount--;
+    }
+    samples[sampleCount++] = {localMs, wallMs};
+    while (sampleCount > 2 && wallMs - samples[0].wall > CLOCK_DISC_MAX_BASELINE_MS) {
+        memmove(samples, samples + 1, sizeof(Sample) * (sampleCount - 1));
+        sampleCount--;
+    }
+
+    int64_t baseline = wallMs - samples[0].wall;
+    if (baseline >= CLOCK_DISC_MIN_BASELINE_MS) {
+        int64_t elapsedLocal = (uint32_t)(localMs - samples[0].local);
+        int64_t drift = (elapsedLocal - baseline) * 1000000000 / baseline;
+        if (drift > CLOCK_DISC_MAX_DRIFT_PPM * 1000LL || drift < -CLOCK_DISC_MAX_DRIFT_PPM * 1000LL) {
+            remoteLog("Clock: Drift %ld ppb out of range, sample dropped", (long)drift);
+            sampleCount--;
+            return;
+        }
+        if (!stats.locked) {
+            remoteLog("Clock: Drift %ld ppb over %lu s", (long)drift, (unsigned long)(baseline / 1000));
+        }
+        stats.locked = true;
+        stats.driftPpb = (int32_t)drift;
+        stats.baselineMs = (uint32_t)baseline;
+        // Disciplined rate = wall/local = 1/(1 + drift)
+        driftCorrPpb = (int32_t)(-drift * 1000000000 / (1000000000 + drift));
+    }
+
+    stats.phaseErrMs = phaseErr;
+    startSlew(localMs, phaseErr);
+    setRate(localMs, driftCorrPpb + slewPpb);
+}
+
+void clockDiscLoop() {
+    uint32_t now = millis();
+    // Without NTP nothing else rebases: keep e (and e·ratePpb) from wrapping
+    const Params& cur = params[active.load()];
+    if (now - cur.baseLocal >= REBASE_MS) {
+        setRate(now, cur.ratePpb);
+    }
+
+    if (!slewing) {
+        return;
+    }
+    int32_t left = (int32_t)(slewEnd - now);
+    if (left > 0) {
+        stats.slewMs = (int32_t)((int64_t)left * slewPpb / 1000000000);
+        return;
+    }
+    slewing = false;
+    slewPpb = 0;
+    stats.slewMs = 0;
+    setRate(now, driftCorrPpb);
+}
+
+const ClockDiscStats& clockDiscStats() {
+    return stats;
+}
+
+String clockDiscJson() {
+    char buf[160];
+    snprintf(buf, sizeof(buf),
+             "{\"locked\":%s,\"driftPpm\":%.3f,\"samples\":%u,\"baselineS\":%u,"
+             "\"phaseErrMs\":%ld,\"slewMs\":%ld,\"steps\":%u}",
+             stats.locked ? "true" : "false", stats.driftPpb / 1000.0, (unsigned)stats.samples,
+             (unsigned)(stats.baselineMs / 1000), (long)stats.phaseErrMs, (long)stats.slewMs,
+             (unsigned)stats.steps);
+    return String(buf);
+}
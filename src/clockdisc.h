@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+
+// =============================================================================
+// Clock Discipline — the match timer's millisecond clock, steered to NTP
+// =============================================================================
+//
+// millis() counts the crystal, which is typically 10–50 ppm off: over a
+// three-hour club night that is up to half a second, so round ends drift
+// away from startTime + k·duration in wall time while the event cutoff and
+// boot recovery use NTP time.
+//
+// clockMillis() is millis() corrected by the measured drift. Each NTP sync
+// gives clockDiscSample() a (millis, wall time) pair. Drift is measured
+// against the oldest sample within CLOCK_DISC_MAX_BASELINE_MS, once the
+// baseline is at least CLOCK_DISC_MIN_BASELINE_MS; until then the clock
+// runs uncorrected. Phase error is slewed out at CLOCK_DISC_SLEW_PPM, so
+// clockMillis() never steps and never runs backwards. A wall clock step
+// larger than CLOCK_DISC_STEP_MS (first sync after a restart) moves the
+// reference instead of being slewed.
+//
+// Samples and clockDiscLoop() run on the loop task; clockMillis() may be
+// read from any task.
+
+struct ClockDiscStats {
+    bool locked;                // Drift measured
+    int32_t driftPpb;           // Crystal rate error, + = millis() runs fast
+    uint32_t samples;
+    uint32_t baselineMs;        // Span the drift is measured over
+    int32_t phaseErrMs;         // Last sample: wall time minus disciplined clock
+    int32_t slewMs;             // Phase correction still to apply
+    uint32_t steps;             // Wall clock steps that moved the reference
+};
+
+// Disciplined millis(); wraps like millis()
+uint32_t clockMillis();
+
+// NTP-fresh pair: millis() and the wall clock in ms, read together
+void clockDiscSample(uint32_t localMs, int64_t wallMs);
+
+// Main loop: end a finished slew, and rebase the clock before
+// millis() - base wraps (weeks without an NTP sync)
+void clockDiscLoop();
+
+const ClockDiscStats& clockDiscStats();
+String clockDiscJson();
@@ -44,6 +44,11 @@ constexpr unsigned long MAX_SIREN_PAUSE_MS = 10000;              // Maximum paus
 constexpr unsigned long WIFI_CONNECT_TIMEOUT_MS = 10000;         // 10 seconds per network
 constexpr unsigned long CAPTIVE_PORTAL_TIMEOUT_SEC = 300;        // 5 minutes captive portal timeout
 constexpr int WIFI_CONNECT_RETRIES = 5;                          // Number of retry attempts
+constexpr unsigned long WIFI_DIRECT_JOIN_TIMEOUT_MS = 4000;      // Cached AP/channel join before scanning (see wifijoin.h)
+constexpr unsigned long WIFI_RETRY_INTERVAL_MS = 300000;         // Retry known networks after all failed (5 min)
+constexpr unsigned long WIFI_LINK_CHECK_MS = 30000;              // Link check once connected
+constexpr unsigned long WIFI_FORCE_RECONNECT_MS = 120000;        // Force reconnect if auto-reconnect hasn't worked
+constexpr unsigned long PORTAL_CLOSE_DELAY_MS = 30000;           // Setup AP stays up after the station connects
 
 // Captive portal settings
 constexpr const char* AP_SSID = "BadmintonTimerSetup";          // Access point SSID
@@ -67,6 +72,32 @@ constexpr unsigned long MAX_RECONNECT_DELAY_MS = 30000;          // Maximum reco
 // Maximum number of simultaneous WebSocket clients
 constexpr size_t MAX_WEBSOCKET_CLIENTS = 10;                     // Limit concurrent connections
 
+// Server-Sent Events stream for read-only viewers (/events). Every stream
+// is a TCP connection, and lwIP allows 16 in all (WebSockets, HTTP, Hello Club)
+constexpr size_t MAX_SSE_CLIENTS = 12;                           // Limit concurrent viewer streams
+constexpr unsigned long SSE_KEEPALIVE_MS = 30000;                // Keep idle streams open
+constexpr uint32_t SSE_RETRY_MS = 3000;                          // Browser reconnect delay after a drop
+
+// Per-client clock offset estimation (time_ping / time_pong)
+constexpr unsigned long CLIENT_CLOCK_PING_MS = 15000;            // Ping each client every 15 seconds
+constexpr unsigned long CLIENT_CLOCK_FAST_PING_MS = 1000;        // Every second until the filter is full
+constexpr unsigned long CLIENT_CLOCK_PONG_TIMEOUT_MS = 5000;     // Unanswered ping is given up
+constexpr int CLIENT_CLOCK_SAMPLES = 8;                          // Min-RTT filter window (2 minutes)
+
+// =============================================================================
+// Timer Beacon Configuration (ENABLE_BEACON)
+// =============================================================================
+
+// One UDP datagram per update, whatever the number of listening displays.
+// Use a broadcast address (e.g. 255.255.255.255) where the access point
+// drops multicast.
+constexpr const char* BEACON_ADDRESS = "239.255.66.77";          // Multicast group (site-local)
+constexpr uint16_t BEACON_PORT = 5077;                           // Destination UDP port
+constexpr unsigned long BEACON_HEARTBEAT_MS = 10000;             // Unchanged state resent every 10 s
+constexpr unsigned long BEACON_REPEAT_MS = 200;                  // Changes are sent again after 200 ms...
+constexpr int BEACON_REPEATS = 2;                                // ...twice, against packet loss
+constexpr long BEACON_DEADLINE_SLACK_MS = 50;                    // Deadline moves beyond this count as a change
+
 // =============================================================================
 // JSON Configuration
 // =============================================================================
@@ -90,6 +121,10 @@ constexpr const char* PREF_KEY_SIREN_LENGTH = "sirenLength";
 constexpr const char* PREF_KEY_SIREN_PAUSE = "sirenPause";
 constexpr const char* PREF_KEY_HC_DEFAULT_DURATION = "hcDefDur";
 
+// Write coalescing (nvsstore.h): dirty keys are committed together this long
+// after the first change; flush() commits immediately
+constexpr unsigned long NVS_COMMIT_DELAY_MS = 2000;
+
 // =============================================================================
 // System Configuration
 // =============================================================================
@@ -130,13 +165,107 @@ constexpr int MIN_PASSWORD_LENGTH = 5;                           // Minimum pass
 // Polling intervals
 constexpr unsigned long HELLOCLUB_POLL_INTERVAL_MS = 3600000;    // Poll every 1 hour
 constexpr unsigned long HELLOCLUB_RETRY_INTERVAL_MS = 300000;    // Retry in 5 minutes on failure
-constexpr int HELLOCLUB_DAYS_AHEAD = 7;                          // Look ahead 7 days
-constexpr int HELLOCLUB_MAX_CACHED_EVENTS = 20;                  // Max cached events
+constexpr unsigned long HELLOCLUB_IDLE_POLL_INTERVAL_MS = 10800000; // Back off to 3 hours when nothing is scheduled
+constexpr unsigned long HELLOCLUB_PRE_EVENT_WINDOW_MS = 3600000; // Poll densely in the hour before an event
+constexpr unsigned long HELLOCLUB_PRE_EVENT_INTERVAL_MS = 600000; // Every 10 minutes inside that window
+constexpr unsigned long HELLOCLUB_FETCH_GUARD_MS = 60000;        // No TLS fetch within 60s of a round end or event start
+constexpr unsigned long HELLOCLUB_FETCH_MAX_DEFER_MS = 900000;   // Guard gives way after 15 min (short rounds are all guard)
+constexpr int HELLOCLUB_DAYS_AHEAD = 7;                          // Look ahead 7 days (the cache never spans more)
+constexpr int HELLOCLUB_MAX_CACHED_EVENTS = 120;                 // Max cached events (a week of a busy multi-court club)
+constexpr int HELLOCLUB_MAX_API_EVENTS = 400;                    // Pagination safety cap (events before timer: filtering)
+constexpr int HELLOCLUB_MAX_BROADCAST_EVENTS = 20;               // Max events sent in upcoming_events
 constexpr unsigned long HELLOCLUB_TRIGGER_WINDOW_MS = 120000;    // 2 minute trigger window
 
+// timer: tag directive limits (out-of-range values are ignored)
+constexpr int HELLOCLUB_MAX_WARMUP_MIN = 30;                     // warmup <n>
+constexpr int HELLOCLUB_MAX_BREAK_SEC = 600;                     // break <n>
+constexpr int HELLOCLUB_MAX_SIREN_BLASTS = 5;                    // siren <n>
+constexpr int HELLOCLUB_MAX_COURT = 99;                          // court <n>
+
 // API retry settings
 constexpr int HELLOCLUB_REQUEST_TIMEOUT_MS = 5000;               // 5 second timeout (reduced for faster failure)
 
+// API endpoint. Override for offline testing against test-server/fake-helloclub.js:
+//   build_flags = -DHELLOCLUB_API_BASE_URL=\"http://192.168.1.50:3001\"
+// An http:// URL uses a plain WiFiClient (no TLS, no CA check)
+#ifndef HELLOCLUB_API_BASE_URL
+#define HELLOCLUB_API_BASE_URL "https://api.helloclub.com"
+#endif
+
+// Webhook push receiver (POST /hc/webhook, HMAC-signed by a LAN relay)
+constexpr size_t HELLOCLUB_WEBHOOK_MAX_BODY = 4096;              // Bytes — one event, description included
+constexpr long HELLOCLUB_WEBHOOK_MAX_SKEW_SEC = 300;             // Reject signatures older/newer than 5 minutes
+constexpr int HELLOCLUB_PUSH_QUEUE_DEPTH = 8;                    // Changes buffered between web server and main loop
+constexpr unsigned long HELLOCLUB_PUSH_FRESH_MS = 21600000;      // Relay counts as live for 6h after its last push/ping
+
+// Background fetch worker (one long-lived FreeRTOS task)
+constexpr unsigned long HELLOCLUB_WORKER_STACK_SIZE = 8192;      // Bytes — SSL needs ~6KB
+constexpr unsigned int HELLOCLUB_WORKER_PRIORITY = 1;            // Low — don't starve WiFi
+constexpr int HELLOCLUB_WORKER_CORE = 0;                         // Protocol core (main loop runs on core 1)
+constexpr size_t HELLOCLUB_API_KEY_MAX_LEN = 128;                // Chars — each fetch request carries a copy
+constexpr int HELLOCLUB_CONTROL_QUEUE_DEPTH = 4;                 // Refresh/settings requests buffered for the main loop
+
+// =============================================================================
+// Time Service Configuration
+// =============================================================================
+
+// SNTP client in the lwIP task, local time cached per second (see timesvc.h)
+constexpr const char* NTP_SERVER = "pool.ntp.org";
+constexpr unsigned long TIME_SYNC_INTERVAL_MS = 3600000;         // Poll hourly once synced
+constexpr unsigned long TIME_SYNC_TIMEOUT_MS = 10000;            // Request counted as failed after this
+constexpr unsigned long TIME_SYNC_RETRY_MS = 60000;              // Next request after a failure
+constexpr time_t RTC_MIN_VALID_EPOCH = 1704067200;               // 2024-01-01: older clock time is unset
+
+// Match timer clock disciplined against NTP (see clockdisc.h)
+constexpr uint32_t CLOCK_DISC_MIN_BASELINE_MS = 1800000;         // Measure drift over at least 30 min
+constexpr uint32_t CLOCK_DISC_MAX_BASELINE_MS = 21600000;        // Oldest sample used: 6 hours
+constexpr int32_t CLOCK_DISC_MAX_DRIFT_PPM = 500;                // Larger estimates are bad samples
+constexpr int32_t CLOCK_DISC_SLEW_PPM = 200;                     // Phase correction rate (0.2 ms/s)
+constexpr int32_t CLOCK_DISC_STEP_MS = 2000;                     // Larger phase errors are clock steps
+
+// =============================================================================
+// Boot Log Configuration
+// =============================================================================
+
+// Circular file of fixed-size records on SPIFFS (see bootlog.h)
+constexpr const char* BOOT_LOG_PATH = "/bootlog.bin";
+constexpr int BOOT_LOG_RECORDS = 64;                             // 64 × 128 B = 8KB ring
+constexpr int BOOT_LOG_QUEUE_DEPTH = 16;                         // Records buffered for the writer
+constexpr unsigned long BOOT_LOG_WRITER_STACK_SIZE = 3072;       // Bytes
+constexpr unsigned int BOOT_LOG_WRITER_PRIORITY = 1;             // Low — flash writes can wait
+constexpr int BOOT_LOG_WRITER_CORE = 0;                          // Protocol core (main loop runs on core 1)
+
+// =============================================================================
+// Boot Profiler Configuration
+// =============================================================================
+
+// Per-phase boot timings, last boots kept in NVS (see bootprof.h)
+constexpr int BOOT_PROF_HISTORY = 8;                             // Boots kept (8 × 116 B)
+constexpr unsigned long BOOT_PROF_SAVE_MS = 60000;               // Record this boot once up this long
+
+// =============================================================================
+// Serial Log Configuration
+// =============================================================================
+
+// Console output is queued and written to the UART by a background task (see seriallog.h)
+constexpr uint32_t SERIAL_LOG_SLOTS = 64;                        // Power of two
+constexpr int SERIAL_LOG_SLOT_SIZE = 64;                         // Bytes per slot (4KB ring)
+constexpr int SERIAL_LOG_PRINTF_MAX = 256;                       // Longer printf output is truncated
+constexpr unsigned long SERIAL_LOG_IDLE_MS = 5;                  // Drain task sleep when the ring is empty
+constexpr unsigned long SERIAL_LOG_TASK_STACK_SIZE = 2048;       // Bytes
+constexpr unsigned int SERIAL_LOG_TASK_PRIORITY = 1;             // Low — below WiFi and async_tcp
+constexpr int SERIAL_LOG_TASK_CORE = 0;                          // Protocol core (main loop runs on core 1)
+
+// =============================================================================
+// Trace Log Configuration
+// =============================================================================
+
+// Binary trace ring, formatted only when read (see trace.h)
+constexpr size_t TRACE_BUFFER_SIZE = 8192;                       // Bytes (~600 records of 2-3 args)
+constexpr uint8_t TRACE_MAX_FORMATS = 128;                       // Distinct TRACE() call sites
+constexpr int TRACE_JSON_MAX = 100;                              // Newest records in /diag and get_remote_log
+constexpr int TRACE_LINE_LEN = 120;                              // Formatted line length
+
 // =============================================================================
 // Debug Configuration
 // =============================================================================
@@ -147,9 +276,10 @@ constexpr int HELLOCLUB_REQUEST_TIMEOUT_MS = 5000;               // 5 second tim
 #endif
 
 #if DEBUG_MODE
-    #define DEBUG_PRINT(x) Serial.print(x)
-    #define DEBUG_PRINTLN(x) Serial.println(x)
-    #define DEBUG_PRINTF(fmt, ...) Serial.printf(fmt, ##__VA_ARGS__)
+    #include "seriallog.h"
+    #define DEBUG_PRINT(x) serialLog.print(x)
+    #define DEBUG_PRINTLN(x) serialLog.println(x)
+    #define DEBUG_PRINTF(fmt, ...) serialLog.printf(fmt, ##__VA_ARGS__)
 #else
     #define DEBUG_PRINT(x)
     #define DEBUG_PRINTLN(x)
@@ -165,6 +295,7 @@ constexpr bool ENABLE_WATCHDOG = true;                           // Enable watch
 constexpr bool ENABLE_SELF_TEST = true;                          // Enable boot self-test
 constexpr bool ENABLE_OTA = true;                                // Enable OTA updates
 constexpr bool ENABLE_MDNS = true;                               // Enable mDNS discovery
+constexpr bool ENABLE_BEACON = false;                            // Enable the UDP timer beacon
 
 // =============================================================================
 // Version Information
@@ -0,0 +1,117 @@
+#include "hcevents.h"
+#include "config.h"
+#include <unordered_map>
+
+// Combined id + startTime key for the carry-over hash join
+static uint64_t eventKey(const CachedEvent& evt) {
+    return evt.idHash ^ ((uint64_t)evt.startTime * 0x9E3779B97F4A7C15ULL);
+}
+
+uint64_t hcHashId(const char* id) {
+    uint64_t hash = 0xcbf29ce484222325ULL;  // FNV-1a offset basis
+    for (const char* p = id; *p; p++) {
+        hash ^= (uint8_t)*p;
+        hash *= 0x100000001b3ULL;           // FNV-1a prime
+    }
+    return hash;
+}
+
+void hcCopyField(char* dst, size_t dstLen, const char* src) {
+    size_t n = strnlen(src, dstLen - 1);
+    memcpy(dst, src, n);
+    memset(dst + n, 0, dstLen - n);
+}
+
+time_t hcPlayEnd(const CachedEvent& evt) {
+    time_t rounds = evt.numRounds > 0 ? evt.numRounds : 1;
+    return evt.startTime + rounds * evt.durationMin * 60;
+}
+
+bool hcBuildEvent(const char* id, const char* name, const char* startDate, const char* endDate,
+                  const TimerTag& tag, CachedEvent& evt) {
+    evt = {};
+    hcCopyField(evt.id, sizeof(evt.id), id);
+    hcCopyField(evt.name, sizeof(evt.name), name);
+    evt.idHash = hcHashId(evt.id);
+    evt.startTime = hcParseIsoEpoch(startDate);
+    evt.durationMin = tag.durationMin;
+    evt.numRounds = tag.numRounds;
+    evt.breakSec = tag.breakSec;
+    evt.warmupMin = tag.warmupMin;
+    evt.sirenBlasts = tag.sirenBlasts;
+    evt.court = tag.court;
+    evt.oneMinuteWarning = tag.oneMinuteWarning;
+    if (evt.startTime == 0) {
+        return false;
+    }
+    evt.endTime = hcParseIsoEpoch(endDate);
+    if (evt.endTime < evt.startTime) {
+        evt.endTime = hcPlayEnd(evt);
+    }
+    return true;
+}
+
+bool hcApplyChange(std::vector<CachedEvent>& events, const HcEventChange& change) {
+    if (change.op == HC_CHANGE_PING) return false;
+
+    size_t match = events.size();
+    size_t sameId = 0;
+    size_t onlyOccurrence = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+        if (events[i].idHash != change.evt.idHash) continue;
+        sameId++;
+        onlyOccurrence = i;
+        if (events[i].startTime == change.evt.startTime) match = i;
+    }
+    if (match == events.size() && change.op == HC_CHANGE_UPSERT && sameId == 1) {
+        match = onlyOccurrence;
+    }
+
+    bool wasTriggered = false;
+    bool wasMissLogged = false;
+    bool changed = false;
+    if (match < events.size()) {
+        bool sameStart = events[match].startTime == change.evt.startTime;
+        wasTriggered = events[match].triggered && sameStart;
+        wasMissLogged = events[match].missLogged && sameStart;
+        events.erase(events.begin() + match);
+        changed = true;
+    }
+
+    if (change.op == HC_CHANGE_UPSERT) {
+        if (events.size() >= (size_t)HELLOCLUB_MAX_CACHED_EVENTS) {
+            if (change.evt.startTime >= events.back().startTime) {
+                return changed;
+            }
+            events.pop_back();
+        }
+        CachedEvent evt = change.evt;
+        evt.triggered = wasTriggered ? 1 : 0;
+        evt.missLogged = wasMissLogged ? 1 : 0;
+        events.push_back(evt);
+        changed = true;
+    }
+    return changed;
+}
+
+void hcCarryTriggered(const std::vector<CachedEvent>& live, std::vector<CachedEvent>& staged) {
+    // Index only the flagged events, then probe once per staged event
+    std::unordered_map<uint64_t, const CachedEvent*> flaggedIndex;
+    for (const auto& existing : live) {
+        if (existing.triggered || existing.missLogged) {
+            flaggedIndex.emplace(eventKey(existing), &existing);
+        }
+    }
+    if (flaggedIndex.empty()) {
+        return;
+    }
+    for (auto& evt : staged) {
+        auto it = flaggedIndex.find(eventKey(evt));
+        if (it != flaggedIndex.end() &&
+            it->second->idHash == evt.idHash &&
+            it->second->startTime == evt.startTime) {
+            evt.triggered = it->second->triggered;
+            evt.missLogged = it->second->missLogged;
+        }
+    }
+}
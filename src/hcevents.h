@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+#include <vector>
+#include "hcparse.h"
+
+// =============================================================================
+// Hello Club Events — the cached event record and whole-cache operations
+// =============================================================================
+//
+// No JSON, NVS or networking here, so the native tests build these
+// against the real record. HelloClubClient owns the live cache (kept in
+// startTime order) and calls them on the main loop.
+
+// Cached event from Hello Club API — fixed-size POD, no heap allocations.
+// Fields ordered largest-first so the struct has no interior padding
+// (72 bytes with 32-bit time_t, 80 with 64-bit).
+struct CachedEvent {
+    uint64_t idHash;        // hcHashId(id) — match key with startTime
+    time_t startTime;       // UTC epoch
+    time_t endTime;         // UTC epoch — from HC booking slot
+    uint16_t durationMin;   // Game duration (from timer: tag or default)
+    uint16_t breakSec;      // timer: tag directives (see TimerTag)
+    uint8_t numRounds;      // Rounds (from timer: tag or default)
+    uint8_t warmupMin;
+    uint8_t sirenBlasts;
+    uint8_t court;
+    uint8_t triggered : 1;  // Already auto-started
+    uint8_t oneMinuteWarning : 1;
+    uint8_t missLogged : 1; // "Window missed" already logged (not persisted)
+    uint8_t reserved : 5;
+    char id[13];            // HC event ID (first 12 chars, NUL-terminated)
+    char name[33];          // Event name (max 32 chars, NUL-terminated)
+};
+static_assert(sizeof(CachedEvent) <= 80, "CachedEvent grew — check NVS/RAM budget");
+
+// One pushed change from the webhook endpoint (POD — passed through a FreeRTOS queue)
+enum HcChangeOp : uint8_t {
+    HC_CHANGE_PING,         // Keep-alive from the relay, no cache change
+    HC_CHANGE_UPSERT,       // Event created or updated (with a timer: tag)
+    HC_CHANGE_DELETE        // Event deleted, or its timer: tag removed
+};
+
+struct HcEventChange {
+    HcChangeOp op;
+    CachedEvent evt;        // DELETE: only id/idHash/startTime are set
+};
+
+// 64-bit FNV-1a hash of an event id (used for id matching instead of strcmp)
+uint64_t hcHashId(const char* id);
+
+// Copy a C string into a fixed field, truncating and NUL-terminating
+void hcCopyField(char* dst, size_t dstLen, const char* src);
+
+// End of play by the timer: tag (all rounds, or one round in continuous
+// mode). Short bookings can end well before this.
+time_t hcPlayEnd(const CachedEvent& evt);
+
+// Fill a cache entry from an API event's fields and its timer: tag.
+// Returns false if startDate doesn't parse. An endDate that doesn't parse
+// (or is before the start) is replaced by hcPlayEnd(), so the event is
+// neither purged the moment it's cached nor kept forever.
+bool hcBuildEvent(const char* id, const char* name, const char* startDate, const char* endDate,
+                  const TimerTag& tag, CachedEvent& evt);
+
+// Apply one pushed change to a cache in startTime order, leaving it to the
+// caller to re-sort. Occurrences of a recurring event share an id, so a
+// change applies to the one with the same id and startTime. An upsert with
+// no such match replaces the event's only occurrence (its start moved) and
+// otherwise adds a new one; a moved occurrence of a recurring event is
+// left for the next poll to drop. The triggered flag survives only an
+// update at the same start, as does missLogged. A full cache keeps its earliest events, as a
+// fetch would. Returns true if the cache changed.
+bool hcApplyChange(std::vector<CachedEvent>& events, const HcEventChange& change);
+
+// Copy triggered (and missLogged) flags from the live cache onto a fetch
+// result. A flag carries over only if id and startTime both match, so
+// occurrences of a recurring event (same id) don't cross-contaminate. Hash
+// join over the flagged events: O(live + staged).
+void hcCarryTriggered(const std::vector<CachedEvent>& live, std::vector<CachedEvent>& staged);
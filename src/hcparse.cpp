@@ -0,0 +1,305 @@
+#include "hcparse.h"
+#include "config.h"
+
+// =============================================================================
+// timer: tag tokenizer — one pass over the raw description, no allocations
+// =============================================================================
+
+enum TagTokenKind : uint8_t {
+    TAG_END,        // End of the tag line (newline or NUL)
+    TAG_NUMBER,
+    TAG_WORD,       // Letters, with inner hyphens ("warm-up")
+    TAG_COLON,
+    TAG_EQUALS
+};
+
+struct TagToken {
+    TagTokenKind kind;
+    uint8_t len;            // TAG_WORD: length in chars (capped at 255)
+    uint16_t number;        // TAG_NUMBER: value, saturating at 9999
+    const char* text;       // TAG_WORD: start of the word (not NUL-terminated)
+};
+
+static inline char lowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+static inline bool isTagDigit(char c) { return c >= '0' && c <= '9'; }
+
+static inline bool isTagAlpha(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// Case-insensitive match of a word token against a lowercase literal
+static bool wordIs(const TagToken& tok, const char* lit) {
+    if (tok.kind != TAG_WORD) return false;
+    for (uint8_t i = 0; i < tok.len; i++, lit++) {
+        if (*lit == '\0' || lowerAscii(tok.text[i]) != *lit) return false;
+    }
+    return *lit == '\0';
+}
+
+static bool isMinutesUnit(const TagToken& tok) {
+    return wordIs(tok, "m") || wordIs(tok, "min") || wordIs(tok, "mins") ||
+           wordIs(tok, "minute") || wordIs(tok, "minutes");
+}
+
+static bool isSecondsUnit(const TagToken& tok) {
+    return wordIs(tok, "s") || wordIs(tok, "sec") || wordIs(tok, "secs") ||
+           wordIs(tok, "second") || wordIs(tok, "seconds");
+}
+
+static bool isRoundsUnit(const TagToken& tok) {
+    return wordIs(tok, "round") || wordIs(tok, "rounds");
+}
+
+static bool isWarningWord(const TagToken& tok) {
+    return wordIs(tok, "warn") || wordIs(tok, "warning");
+}
+
+class TagLexer {
+public:
+    explicit TagLexer(const char* start) : p(start) {}
+
+    TagToken next() {
+        TagToken tok = {TAG_END, 0, 0, nullptr};
+
+        // Anything that can't start a token is a separator (spaces, commas, ...)
+        while (*p && *p != '\n' && !isTagDigit(*p) && !isTagAlpha(*p) && *p != ':' && *p != '=') {
+            p++;
+        }
+        if (*p == '\0' || *p == '\n') {
+            return tok;
+        }
+
+        if (isTagDigit(*p)) {
+            uint32_t value = 0;
+            while (isTagDigit(*p)) {
+                if (value < 9999) value = value * 10 + (uint32_t)(*p - '0');
+                p++;
+            }
+            tok.kind = TAG_NUMBER;
+            tok.number = (uint16_t)(value > 9999 ? 9999 : value);
+        } else if (isTagAlpha(*p)) {
+            tok.kind = TAG_WORD;
+            tok.text = p;
+            while (isTagAlpha(*p) || (*p == '-' && isTagAlpha(p[1]))) {
+                p++;
+            }
+            size_t len = (size_t)(p - tok.text);
+            tok.len = (uint8_t)(len > 255 ? 255 : len);
+        } else {
+            tok.kind = (*p == ':') ? TAG_COLON : TAG_EQUALS;
+            p++;
+        }
+        return tok;
+    }
+
+    TagToken peek() {
+        const char* saved = p;
+        TagToken tok = next();
+        p = saved;
+        return tok;
+    }
+
+    // Directive argument: optional '=' or ':' then a number
+    bool readNumber(uint16_t& value) {
+        TagToken tok = peek();
+        if (tok.kind == TAG_EQUALS || tok.kind == TAG_COLON) {
+            next();
+            tok = peek();
+        }
+        if (tok.kind != TAG_NUMBER) return false;
+        next();
+        value = tok.number;
+        return true;
+    }
+
+    // Consume the next token if it is the given kind of word
+    bool skipIf(bool (*match)(const TagToken&)) {
+        if (!match(peek())) return false;
+        next();
+        return true;
+    }
+
+private:
+    const char* p;
+};
+
+// Case-insensitive search for "timer:" — returns the char after the colon
+static const char* findTimerTag(const char* s) {
+    static const char TAG[] = "timer:";
+    for (; *s; s++) {
+        size_t i = 0;
+        while (TAG[i] && lowerAscii(s[i]) == TAG[i]) i++;
+        if (TAG[i] == '\0') return s + i;
+    }
+    return nullptr;
+}
+
+static bool isBlastsUnit(const TagToken& tok) {
+    return wordIs(tok, "x") || wordIs(tok, "blast") || wordIs(tok, "blasts");
+}
+
+bool hcParseTimerTag(const char* description, uint16_t defaultDurationMin, TimerTag& tag) {
+    const char* value = description ? findTimerTag(description) : nullptr;
+    if (!value) {
+        return false; // No timer tag = don't cache this event
+    }
+
+    // "timer:" alone or "timer: enabled" -> defaults, continuous mode
+    tag = TimerTag();
+    tag.durationMin = defaultDurationMin;
+    tag.numRounds = 0; // 0 = continuous (rounds repeat until event ends)
+
+    TagLexer lex(value);
+    for (TagToken tok = lex.next(); tok.kind != TAG_END; tok = lex.next()) {
+        uint16_t n;
+
+        if (tok.kind == TAG_NUMBER) {
+            TagToken unit = lex.peek();
+            if (unit.kind == TAG_COLON) {
+                // "12:3" — duration:rounds
+                lex.next();
+                if (tok.number >= MIN_GAME_DURATION_MIN && tok.number <= MAX_GAME_DURATION_MIN) {
+                    tag.durationMin = tok.number;
+                }
+                if (lex.peek().kind == TAG_NUMBER) {
+                    uint16_t rounds = lex.next().number;
+                    if (rounds <= MAX_ROUNDS) tag.numRounds = (uint8_t)rounds;
+                }
+            } else if (isMinutesUnit(unit)) {
+                lex.next();
+                if (tok.number == 1 && lex.skipIf(isWarningWord)) {
+                    tag.oneMinuteWarning = true;  // "1min warning", not a 1-minute round
+                } else if (tok.number >= MIN_GAME_DURATION_MIN && tok.number <= MAX_GAME_DURATION_MIN) {
+                    tag.durationMin = tok.number;
+                }
+            } else if (isRoundsUnit(unit)) {
+                lex.next();
+                if (tok.number <= MAX_ROUNDS) tag.numRounds = (uint8_t)tok.number;
+            }
+            // A bare number with no unit is ignored
+            continue;
+        }
+
+        if (wordIs(tok, "warmup") || wordIs(tok, "warm-up")) {
+            if (lex.readNumber(n)) {
+                lex.skipIf(isMinutesUnit);
+                if (n >= 1 && n <= HELLOCLUB_MAX_WARMUP_MIN) tag.warmupMin = (uint8_t)n;
+            }
+        } else if (wordIs(tok, "break")) {
+            if (lex.readNumber(n)) {
+                uint32_t sec = n * 60UL;  // Minutes unless given in seconds
+                if (lex.skipIf(isSecondsUnit)) {
+                    sec = n;
+                } else {
+                    lex.skipIf(isMinutesUnit);
+                }
+                if (sec >= 1 && sec <= HELLOCLUB_MAX_BREAK_SEC) tag.breakSec = (uint16_t)sec;
+            }
+        } else if (wordIs(tok, "siren") || wordIs(tok, "sirens")) {
+            if (lex.readNumber(n)) {
+                lex.skipIf(isBlastsUnit);
+                if (n >= 1 && n <= HELLOCLUB_MAX_SIREN_BLASTS) tag.sirenBlasts = (uint8_t)n;
+            }
+        } else if (wordIs(tok, "court")) {
+            if (lex.readNumber(n) && n >= 1 && n <= HELLOCLUB_MAX_COURT) {
+                tag.court = (uint8_t)n;
+            }
+        } else if (isWarningWord(tok)) {
+            tag.oneMinuteWarning = true;
+        }
+        // "enabled" and any other word: nothing to do
+    }
+
+    return true;
+}
+
+// =============================================================================
+// ISO 8601 date-times
+// =============================================================================
+
+// Read exactly `digits` decimal digits at *p; advances *p on success
+static bool readFixedDigits(const char*& p, int digits, int& out) {
+    int value = 0;
+    for (int i = 0; i < digits; i++) {
+        if (!isTagDigit(p[i])) return false;
+        value = value * 10 + (p[i] - '0');
+    }
+    p += digits;
+    out = value;
+    return true;
+}
+
+static bool isLeapYear(int y) {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+static int daysInMonth(int y, int m) {
+    static const uint8_t DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (m == 2 && isLeapYear(y)) ? 29 : DAYS[m - 1];
+}
+
+// Days since 1970-01-01 without mktime (which uses local TZ and gets DST
+// wrong on ESP32). Shift Mar=0 so the leap day falls at year end.
+static long daysFromCivil(int year, int mon, int day) {
+    int y = year;
+    int m = mon;
+    if (m <= 2) { y--; m += 12; }
+    m -= 3; // Mar=0 .. Feb=11
+
+    return 365L * (y - 1970)
+         + (y - 1968) / 4 - (y - 1900) / 100 + (y - 1600) / 400
+         + (153 * m + 2) / 5 + day - 1
+         + 59;
+}
+
+time_t hcParseIsoEpoch(const char* iso) {
+    if (!iso) return 0;
+    const char* p = iso;
+    int year, mon, day, hour, min, sec = 0;
+
+    if (!readFixedDigits(p, 4, year) || *p++ != '-') return 0;
+    if (!readFixedDigits(p, 2, mon) || *p++ != '-') return 0;
+    if (!readFixedDigits(p, 2, day)) return 0;
+    if (*p != 'T' && *p != 't' && *p != ' ') return 0;
+    p++;
+    if (!readFixedDigits(p, 2, hour) || *p++ != ':') return 0;
+    if (!readFixedDigits(p, 2, min)) return 0;
+    if (*p == ':') {
+        p++;
+        if (!readFixedDigits(p, 2, sec)) return 0;
+        if (*p == '.' || *p == ',') {
+            p++;
+            if (!isTagDigit(*p)) return 0;
+            while (isTagDigit(*p)) p++;
+        }
+    }
+
+    if (year < 1970 || mon < 1 || mon > 12 || day < 1 || day > daysInMonth(year, mon)) return 0;
+    if (hour > 23 || min > 59 || sec > 60) return 0;
+    if (sec == 60) sec = 59;  // Leap second: hold at :59 rather than roll over
+
+    long offsetSec = 0;
+    if (*p == 'Z' || *p == 'z') {
+        p++;
+    } else if (*p == '+' || *p == '-') {
+        int sign = (*p++ == '-') ? -1 : 1;
+        int offH, offM = 0;
+        if (!readFixedDigits(p, 2, offH)) return 0;
+        if (*p == ':') {
+            p++;
+            if (!readFixedDigits(p, 2, offM)) return 0;
+        } else if (isTagDigit(*p) && !readFixedDigits(p, 2, offM)) {
+            return 0;
+        }
+        if (offH > 14 || offM > 59) return 0;
+        offsetSec = sign * (offH * 3600L + offM * 60L);
+    }
+    if (*p != '\0') return 0;
+
+    long long epoch = daysFromCivil(year, mon, day) * 86400LL
+                    + hour * 3600L + min * 60L + sec - offsetSec;
+    return epoch > 0 ? (time_t)epoch : 0;
+}
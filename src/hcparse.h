@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+
+// =============================================================================
+// Hello Club Parsing — timer: tags and ISO 8601 dates, without allocating
+// =============================================================================
+//
+// Pointer-walking parsers over text straight from the API (and webhook
+// pushes), so every read must stop at the terminating NUL. No JSON or
+// networking here: the native tests fuzz the tag parser under
+// AddressSanitizer and sweep the date parser across DST transitions.
+
+// Directives parsed from an event description's timer: tag.
+// Zero means "not given" for every optional field.
+struct TimerTag {
+    uint16_t durationMin;   // Round length (1-120, default from settings)
+    uint16_t breakSec;      // Break between rounds
+    uint8_t numRounds;      // 1-20, 0 = continuous
+    uint8_t warmupMin;      // Warm-up before round 1
+    uint8_t sirenBlasts;    // Blasts at each round end
+    uint8_t court;          // Court number
+    bool oneMinuteWarning;  // Short blast with one minute left in each round
+};
+
+// Parse the timer: tag from an event description in a single pass.
+// Returns true if a timer: tag was found; a round length that isn't given
+// is defaultDurationMin.
+//
+//   timer: [enabled] <directive>...          (rest of that line, any case)
+//     20min | 20 minutes                     round length (1-120)
+//     3 rounds | 0 rounds                    round count (0 = continuous)
+//     12:3                                   shorthand for 12min 3 rounds
+//     warmup 5 | warm-up=5min                warm-up length (1-30 min)
+//     break 2 | break 90s                    break between rounds (min, or s)
+//     siren 3 | sirens=3                     blasts at round end (1-5)
+//     court 4                                court number (1-99)
+//     warn | 1min warning                    one-minute warning
+//
+// Unknown words and out-of-range values are ignored.
+bool hcParseTimerTag(const char* description, uint16_t defaultDurationMin, TimerTag& tag);
+
+// Parse an ISO 8601 date-time to UTC epoch, applying any offset.
+//   YYYY-MM-DD[T ]hh:mm[:ss[.fff]][Z|±hh[:mm]|±hhmm]
+// No zone designator is read as UTC; fractions are truncated. Returns 0 for
+// anything malformed or out of range. Computed from the civil date, not
+// mktime(), so the local TZ and its DST rules never come into it.
+time_t hcParseIsoEpoch(const char* iso);
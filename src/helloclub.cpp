@@ -1,8 +1,14 @@
 #include "helloclub.h"
 #include "config.h"
 #include "remotelog.h"
+#include "nvsstore.h"
+#include "trace.h"
+#include "timesvc.h"
 #include <WiFiClientSecure.h>
 #include <time.h>
+#include <algorithm>
+#include "rom/crc.h"
+#include "mbedtls/md.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
@@ -58,10 +64,14 @@ const char* rootCACertificate = \
 
 const char* HelloClubClient::NVS_NAMESPACE = "helloclub";
 const char* HelloClubClient::NVS_EVENTS_KEY = "events";
+const char* HelloClubClient::NVS_RECORDS_KEY = "ev_bin";
+const char* HelloClubClient::NVS_TRIGGERED_KEY = "ev_trig";
+
+// Triggered blob for the full cache: records CRC, then one bit per record
+static const size_t NVS_TRIGGERED_BYTES = sizeof(uint32_t) + (HELLOCLUB_MAX_CACHED_EVENTS + 7) / 8;
 
 HelloClubClient::HelloClubClient()
     : apiKey("")
-    , lastError("")
     , lastSyncTime(0)
     , defaultDurationMin(12)
     , defaultNumRounds(3)
@@ -77,9 +87,10 @@ void HelloClubClient::setDefaults(uint16_t defaultDuration, uint8_t defaultRound
     defaultNumRounds = defaultRounds;
 }
 
-bool HelloClubClient::makeRequest(const String& endpoint, const String& params,
-                                   DynamicJsonDocument& responseDoc, const JsonDocument& filter) {
-    if (apiKey.isEmpty()) {
+bool HelloClubClient::makeRequest(const char* apiKey, const String& endpoint, const String& params,
+                                   DynamicJsonDocument& responseDoc, const JsonDocument& filter,
+                                   String& lastError) {
+    if (!apiKey || !*apiKey) {
         lastError = "API key not configured";
         return false;
     }
@@ -87,7 +98,7 @@ bool HelloClubClient::makeRequest(const String& endpoint, const String& params,
     const int MAX_RETRIES = 2;          // Reduced to minimize blocking time
     const int RETRY_DELAYS[] = {500, 1000};  // Short delays to avoid freezing main loop
 
-    String url = baseUrl + endpoint;
+    String url = String(HELLOCLUB_API_BASE_URL) + endpoint;
     if (!params.isEmpty()) {
         url += "?" + params;
     }
@@ -95,8 +106,12 @@ bool HelloClubClient::makeRequest(const String& endpoint, const String& params,
     for (int attempt = 0; attempt < MAX_RETRIES; attempt++) {
         DEBUG_PRINTF("HelloClub API (attempt %d/%d): %s\n", attempt + 1, MAX_RETRIES, url.c_str());
 
-        WiFiClientSecure client;
-        client.setCACert(rootCACertificate);
+        // Plain HTTP only when the build points at a local stand-in
+        WiFiClientSecure secureClient;
+        WiFiClient plainClient;
+        bool useTls = url.startsWith("https://");
+        if (useTls) secureClient.setCACert(rootCACertificate);
+        WiFiClient& client = useTls ? secureClient : plainClient;
 
         HTTPClient http;
 
@@ -179,120 +194,30 @@ bool HelloClubClient::makeRequest(const String& endpoint, const String& params,
     return false;
 }
 
-bool HelloClubClient::parseTimerTag(const String& description, uint16_t& duration, uint8_t& rounds) {
-    // Look for "timer:" in description (case-insensitive)
-    String lower = description;
-    lower.toLowerCase();
-
-    int tagPos = lower.indexOf("timer:");
-    if (tagPos == -1) {
-        return false; // No timer tag = don't cache this event
-    }
-
-    // Extract the value after "timer:"
-    String value = description.substring(tagPos + 6);
-    value.trim();
-
-    // Truncate at newline or end
-    int nlPos = value.indexOf('\n');
-    if (nlPos > 0) value = value.substring(0, nlPos);
-    value.trim();
-
-    // "timer:enabled" or "timer:" -> use defaults, continuous mode
-    if (value.startsWith("enabled") || value.isEmpty()) {
-        duration = defaultDurationMin;
-        rounds = 0; // 0 = continuous (rounds repeat until event ends)
-        return true;
-    }
-
-    // "timer: 15min" -> custom duration, continuous unless rounds specified
-    duration = defaultDurationMin;
-    rounds = 0; // 0 = continuous by default
-
-    // Work with lowercased value (not the full description 'lower')
-    // to keep indices consistent after trim/truncation
-    String lowerValue = value;
-    lowerValue.toLowerCase();
-
-    // Parse Xmin
-    int minPos = lowerValue.indexOf("min");
-    if (minPos > 0) {
-        String numStr = "";
-        for (int i = minPos - 1; i >= 0; i--) {
-            char c = lowerValue.charAt(i);
-            if (c >= '0' && c <= '9') {
-                numStr = String(c) + numStr;
-            } else {
-                break;
-            }
-        }
-        if (numStr.length() > 0) {
-            int val = numStr.toInt();
-            if (val >= 1 && val <= 120) {
-                duration = val;
-            }
-        }
-    }
-
-    // Parse Xrounds (optional — if omitted, continuous mode)
-    int roundPos = lowerValue.indexOf("round");
-    if (roundPos > 0) {
-        String numStr = "";
-        for (int i = roundPos - 1; i >= 0; i--) {
-            char c = lowerValue.charAt(i);
-            if (c >= '0' && c <= '9') {
-                numStr = String(c) + numStr;
-            } else {
-                break;
-            }
-        }
-        if (numStr.length() > 0) {
-            int val = numStr.toInt();
-            if (val >= 1 && val <= 20) {
-                rounds = val; // Non-zero = fixed round count
-            }
-        }
-    }
-
-    return true;
+static inline char lowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
 }
 
-time_t HelloClubClient::parseISOToEpoch(const String& isoDate) {
-    if (isoDate.length() < 19) {
-        return 0;
-    }
-
-    int year = isoDate.substring(0, 4).toInt();
-    int mon  = isoDate.substring(5, 7).toInt();
-    int day  = isoDate.substring(8, 10).toInt();
-    int hour = isoDate.substring(11, 13).toInt();
-    int min  = isoDate.substring(14, 16).toInt();
-    int sec  = isoDate.substring(17, 19).toInt();
-
-    // Convert to UTC epoch without relying on mktime (which uses local TZ
-    // and gets DST wrong on ESP32). Algorithm: days since 1970-01-01.
-    // Months Jan=1..Dec=12; shift Mar=1 so leap day falls at year end.
-    int y = year;
-    int m = mon;
-    if (m <= 2) { y--; m += 12; }
-    m -= 3; // Mar=0 .. Feb=11
-
-    // Days from epoch to date (calibrated: 1970-01-01 = 0)
-    long days = 365L * (y - 1970)
-              + (y - 1968) / 4 - (y - 1900) / 100 + (y - 1600) / 400
-              + (153 * m + 2) / 5 + day - 1
-              + 59;
-
-    return (time_t)(days * 86400L + hour * 3600L + min * 60L + sec);
+bool HelloClubClient::fetchAndCacheEvents(int daysAhead, const char* apiKey) {
+    // Fill the back buffer (owned by this task), then publish it whole.
+    // Clearing keeps the vector's capacity, so steady-state syncs don't allocate.
+    SyncResult& out = sync.back();
+    out.events.clear();
+    out.error = "";
+    out.debug = "";
+    out.totalFromApi = 0;
+    out.success = fetchInto(out, daysAhead, apiKey);
+
+    bool success = out.success;  // `out` belongs to the consumer once published
+    sync.publish();  // An unconsumed older result is simply superseded
+    return success;
 }
 
-bool HelloClubClient::fetchAndCacheEvents(int daysAhead, Timezone& tz) {
-    lastError = "";
-
-    // Calculate date range using ezTime (C time(nullptr) may not be NTP-synced)
-    time_t now = UTC.now();
-    if (now < 1000000000) { // Before ~2001 = NTP not synced
-        lastError = "NTP time not synced yet";
+bool HelloClubClient::fetchInto(SyncResult& out, int daysAhead, const char* apiKey) {
+    // Date range from the system clock (SNTP, or kept across a reset)
+    time_t now = timeNow();
+    if (!timeValid()) {
+        out.error = "NTP time not synced yet";
         remoteLog("HC fetch: NTP not synced (now=%ld)", (long)now);
         return false;
     }
@@ -308,11 +233,10 @@ bool HelloClubClient::fetchAndCacheEvents(int daysAhead, Timezone& tz) {
     char toDate[30];
     strftime(toDate, sizeof(toDate), "%Y-%m-%dT%H:%M:%SZ", &timeinfo);
 
-    lastSyncDebug = "";
-    lastSyncDebug.reserve(512);
+    out.debug.reserve(512);
     char syncBuf[128];
     snprintf(syncBuf, sizeof(syncBuf), "Query: %s to %s\n", fromDate, toDate);
-    lastSyncDebug += syncBuf;
+    out.debug += syncBuf;
 
     // JSON filter — only keep the fields we need (saves ~90% memory)
     StaticJsonDocument<256> filter;
@@ -324,10 +248,17 @@ bool HelloClubClient::fetchAndCacheEvents(int daysAhead, Timezone& tz) {
 
     // Paginate: fetch PAGE_SIZE events at a time to stay within ESP32 RAM
     const int PAGE_SIZE = 5;
-    totalEventsFromApi = 0;
-    std::vector<CachedEvent> newEvents;
+    std::vector<CachedEvent>& newEvents = out.events;
+
+    for (int offset = 0; offset < HELLOCLUB_MAX_API_EVENTS; offset += PAGE_SIZE) {  // Safety cap
+        if (cancelRequested) {
+            // Nothing is staged — the live cache stays as it was
+            out.error = "Fetch cancelled";
+            out.debug += "Cancelled\n";
+            remoteLog("HC fetch: cancelled at offset %d", offset);
+            return false;
+        }
 
-    for (int offset = 0; offset < 100; offset += PAGE_SIZE) {  // Safety cap at 100
         String params = "fromDate=" + String(fromDate);
         params += "&toDate=" + String(toDate);
         params += "&sort=startDate";
@@ -336,10 +267,10 @@ bool HelloClubClient::fetchAndCacheEvents(int daysAhead, Timezone& tz) {
 
         // Small doc — filter strips everything except our 5 fields
         DynamicJsonDocument responseDoc(8192);
-        if (!makeRequest("/event", params, responseDoc, filter)) {
+        if (!makeRequest(apiKey, "/event", params, responseDoc, filter, out.error)) {
             if (offset == 0) {
                 // First page failed — report error
-                lastSyncDebug += "Page 1 failed: " + lastError + "\n";
+                out.debug += "Page 1 failed: " + out.error + "\n";
                 return false;
             }
             // Later pages failing is OK — we got some events
@@ -361,45 +292,39 @@ bool HelloClubClient::fetchAndCacheEvents(int daysAhead, Timezone& tz) {
         }
 
         int pageCount = eventsArray.size();
-        totalEventsFromApi += pageCount;
+        out.totalFromApi += pageCount;
         DEBUG_PRINTF("HelloClub: Page offset=%d returned %d events\n", offset, pageCount);
 
         for (JsonObject eventObj : eventsArray) {
-            String description = eventObj["description"] | "";
-            String name = eventObj["name"] | "unnamed";
+            const char* description = eventObj["description"] | "";
+            const char* name = eventObj["name"] | "unnamed";
 
             // Capture debug info using fixed buffer to avoid String fragmentation
-            if (lastSyncDebug.length() < 400) {
+            if (out.debug.length() < 400) {
                 char debugLine[96];
                 snprintf(debugLine, sizeof(debugLine), "%.30s | %.50s\n",
-                    name.c_str(),
-                    description.length() > 0 ? description.c_str() : "(no desc)");
-                lastSyncDebug += debugLine;
+                    name,
+                    description[0] ? description : "(no desc)");
+                out.debug += debugLine;
             }
 
-            uint16_t duration;
-            uint8_t rounds;
-            if (!parseTimerTag(description, duration, rounds)) {
+            TimerTag tag;
+            if (!parseTimerTag(description, tag)) {
                 continue; // Skip events without timer: tag
             }
 
-            if (newEvents.size() >= HC_MAX_EVENTS) {
+            if (newEvents.size() >= HELLOCLUB_MAX_CACHED_EVENTS) {
                 break;
             }
 
             CachedEvent evt;
-            String fullId = eventObj["id"] | "";
-            evt.id = fullId.substring(0, 12);
-            evt.name = name.substring(0, 40);
-            evt.startTime = parseISOToEpoch(eventObj["startDate"] | "");
-            evt.endTime = parseISOToEpoch(eventObj["endDate"] | "");
-            evt.durationMin = duration;
-            evt.numRounds = rounds;
-
-            evt.triggered = false;
+            if (!buildCachedEvent(eventObj, tag, evt)) {
+                DEBUG_PRINTF("  Skipped %s: bad startDate\n", evt.name);
+                continue;
+            }
             newEvents.push_back(evt);
             DEBUG_PRINTF("  Cached: %s %dmin %drounds\n",
-                         evt.name.c_str(), evt.durationMin, evt.numRounds);
+                         evt.name, evt.durationMin, evt.numRounds);
         }
 
         // If we got fewer than PAGE_SIZE, that's the last page
@@ -408,53 +333,166 @@ bool HelloClubClient::fetchAndCacheEvents(int daysAhead, Timezone& tz) {
         }
 
         // Don't exceed max cached events
-        if (newEvents.size() >= HC_MAX_EVENTS) {
+        if (newEvents.size() >= HELLOCLUB_MAX_CACHED_EVENTS) {
             break;
         }
     }
 
     char summaryBuf[80];
     snprintf(summaryBuf, sizeof(summaryBuf), "Total: %d events, %d with timer: tag\n",
-        totalEventsFromApi, (int)newEvents.size());
-    lastSyncDebug += summaryBuf;
-
-    // Stage the results — don't modify `events` directly as this may run
-    // on a background task while the main loop reads `events`
-    stagedEvents = newEvents;
-    stagedReady = true;
+        out.totalFromApi, (int)newEvents.size());
+    out.debug += summaryBuf;
 
+    // Don't touch `events` here — this runs on the worker while the main loop
+    // reads it. The caller publishes `out` for applyStagedEvents().
     DEBUG_PRINTF("HelloClub: Fetched %d events with timer: tag (from %d total), staged for apply\n",
-                 (int)newEvents.size(), totalEventsFromApi);
+                 (int)newEvents.size(), out.totalFromApi);
     return true;
 }
 
+bool HelloClubClient::buildCachedEvent(JsonObjectConst obj, const TimerTag& tag, CachedEvent& evt) const {
+    return hcBuildEvent(obj["id"] | "", obj["name"] | "unnamed", obj["startDate"] | "",
+                        obj["endDate"] | "", tag, evt);
+}
+
 bool HelloClubClient::applyStagedEvents() {
-    if (!stagedReady) return false;
-    stagedReady = false;
+    // Take the published buffer, leaving the previous front for the producer
+    if (!sync.take()) return false;
+    SyncResult& result = sync.front();
+    if (!result.success) {
+        return false;  // Error/debug now visible via getters; cache unchanged
+    }
+    std::vector<CachedEvent>& stagedEvents = result.events;
 
     // Preserve triggered state from existing cache (safe: runs on main loop)
-    // Match on both id AND startTime so recurring events don't cross-contaminate
-    for (auto& staged : stagedEvents) {
-        for (const auto& existing : events) {
-            if (existing.id == staged.id && existing.startTime == staged.startTime) {
-                staged.triggered = existing.triggered;
-                break;
-            }
-        }
-    }
+    hcCarryTriggered(events, stagedEvents);
 
-    events = stagedEvents;
-    stagedEvents.clear();
+    // Swap, not copy: the old cache goes back to the producer with the buffer
+    events.swap(stagedEvents);
+    reindex();
     lastSyncTime = millis();
     saveToNVS();
 
-    remoteLog("HC fetch: %d total, %d with timer tag", totalEventsFromApi, (int)events.size());
+    remoteLog("HC fetch: %d total, %d with timer tag", result.totalFromApi, (int)events.size());
     for (const auto& e : events) {
-        remoteLog("HC evt: \"%s\" start=%ld trig=%d", e.name.c_str(), (long)e.startTime, e.triggered ? 1 : 0);
+        TRACE("HC evt: \"%s\" start=%ld trig=%d", e.name, (long)e.startTime, e.triggered ? 1 : 0);
     }
     return true;
 }
 
+// =============================================================================
+// Webhook push — single-event changes applied between polls
+// =============================================================================
+
+// A delete names one occurrence: the event id and its start time
+static bool deleteChange(const char* id, const char* startDate, HcEventChange& change) {
+    change.op = HC_CHANGE_DELETE;
+    hcCopyField(change.evt.id, sizeof(change.evt.id), id);
+    change.evt.idHash = hcHashId(change.evt.id);
+    change.evt.startTime = hcParseIsoEpoch(startDate);
+    return change.evt.startTime != 0;
+}
+
+bool HelloClubClient::parseEventChange(const char* body, size_t len, HcEventChange& change,
+                                       const char*& error) const {
+    StaticJsonDocument<256> filter;
+    filter["type"] = true;
+    filter["id"] = true;
+    filter["startDate"] = true;
+    JsonObject f = filter.createNestedObject("event");
+    f["id"] = true;
+    f["name"] = true;
+    f["description"] = true;
+    f["startDate"] = true;
+    f["endDate"] = true;
+
+    // Filtered strings are copied out of the body (at most its length,
+    // quotes make room for the NULs), plus the two objects
+    DynamicJsonDocument doc(HELLOCLUB_WEBHOOK_MAX_BODY + JSON_OBJECT_SIZE(4) + JSON_OBJECT_SIZE(5));
+    if (deserializeJson(doc, body, len, DeserializationOption::Filter(filter))) {
+        error = "Invalid JSON";
+        return false;
+    }
+
+    const char* type = doc["type"] | "";
+    JsonObjectConst obj = doc["event"];
+    const char* id = obj["id"] | (doc["id"] | "");
+    const char* startDate = obj["startDate"] | (doc["startDate"] | "");
+    change = {};
+
+    if (strcmp(type, "ping") == 0) {
+        change.op = HC_CHANGE_PING;
+        return true;
+    }
+    if (!id[0]) {
+        error = "Missing event id";
+        return false;
+    }
+
+    if (strcmp(type, "event.deleted") == 0) {
+        if (!deleteChange(id, startDate, change)) {
+            error = "Bad startDate";
+            return false;
+        }
+        return true;
+    }
+    if (strcmp(type, "event.created") != 0 && strcmp(type, "event.updated") != 0) {
+        error = "Unknown type";
+        return false;
+    }
+
+    TimerTag tag;
+    if (!parseTimerTag(obj["description"] | "", tag)) {
+        // timer: tag removed (or never there) — drop any cached copy
+        if (!deleteChange(id, startDate, change)) {
+            error = "Bad startDate";
+            return false;
+        }
+        return true;
+    }
+    if (!buildCachedEvent(obj, tag, change.evt)) {
+        error = "Bad startDate";
+        return false;
+    }
+    change.op = HC_CHANGE_UPSERT;
+    return true;
+}
+
+bool HelloClubClient::applyEventChange(const HcEventChange& change) {
+    if (!hcApplyChange(events, change)) return false;
+    reindex();
+    saveToNVS();
+    return true;
+}
+
+bool HelloClubClient::verifySignature(const String& secret, const char* timestamp,
+                                      const uint8_t* body, size_t len, const char* signatureHex) {
+    if (secret.isEmpty() || !timestamp || !signatureHex) return false;
+    if (strncmp(signatureHex, "sha256=", 7) == 0) signatureHex += 7;
+    if (strlen(signatureHex) != 64) return false;
+
+    uint8_t mac[32];
+    mbedtls_md_context_t ctx;
+    mbedtls_md_init(&ctx);
+    bool ok = mbedtls_md_setup(&ctx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 1) == 0 &&
+              mbedtls_md_hmac_starts(&ctx, (const uint8_t*)secret.c_str(), secret.length()) == 0 &&
+              mbedtls_md_hmac_update(&ctx, (const uint8_t*)timestamp, strlen(timestamp)) == 0 &&
+              mbedtls_md_hmac_update(&ctx, (const uint8_t*)".", 1) == 0 &&
+              mbedtls_md_hmac_update(&ctx, body, len) == 0 &&
+              mbedtls_md_hmac_finish(&ctx, mac) == 0;
+    mbedtls_md_free(&ctx);
+    if (!ok) return false;
+
+    // Constant time: no early exit on the first differing byte
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    uint8_t diff = 0;
+    for (int i = 0; i < 32; i++) {
+        diff |= (uint8_t)(lowerAscii(signatureHex[2 * i]) ^ HEX_DIGITS[mac[i] >> 4]);
+        diff |= (uint8_t)(lowerAscii(signatureHex[2 * i + 1]) ^ HEX_DIGITS[mac[i] & 0x0F]);
+    }
+    return diff == 0;
+}
+
 void HelloClubClient::loadFromNVS() {
     Preferences prefs;
     if (!prefs.begin(NVS_NAMESPACE, true)) {
@@ -462,22 +500,112 @@ void HelloClubClient::loadFromNVS() {
         return;
     }
 
-    String json = prefs.getString(NVS_EVENTS_KEY, "[]");
+    bool loaded = loadRecordsFromNVS(prefs);
+    bool migrated = false;
+    if (!loaded && prefs.isKey(NVS_EVENTS_KEY)) {
+        migrated = loadLegacyJsonFromNVS(prefs);
+    }
     prefs.end();
+    reindex();
+
+    // Rewrite legacy JSON cache in the binary format (also drops the old key)
+    if (migrated) {
+        DEBUG_PRINTLN("HelloClub: Migrating JSON event cache to binary records");
+        saveToNVS();
+    }
+
+    DEBUG_PRINTF("HelloClub: Loaded %d cached events from NVS\n", (int)events.size());
+}
+
+bool HelloClubClient::loadRecordsFromNVS(Preferences& prefs) {
+    size_t len = prefs.getBytesLength(NVS_RECORDS_KEY);
+    if (len < sizeof(NvsEventHeader)) {
+        return false;
+    }
+
+    std::vector<uint8_t> blob(len);
+    prefs.getBytes(NVS_RECORDS_KEY, blob.data(), len);
+
+    NvsEventHeader hdr;
+    memcpy(&hdr, blob.data(), sizeof(hdr));
+    size_t recordBytes = len - sizeof(NvsEventHeader);
+    const uint8_t* recordData = blob.data() + sizeof(NvsEventHeader);
+
+    // Version 1 records are a prefix of the current layout
+    size_t recordSize = (hdr.version == 1) ? NVS_RECORD_SIZE_V1 : sizeof(NvsEventRecord);
+    if (hdr.magic != NVS_EVENTS_MAGIC || hdr.version < 1 || hdr.version > NVS_EVENTS_VERSION ||
+        hdr.count > HELLOCLUB_MAX_CACHED_EVENTS ||
+        recordBytes != (size_t)hdr.count * recordSize) {
+        DEBUG_PRINTF("HelloClub: NVS event cache header invalid (v%u, %u records, %u bytes)\n",
+                     hdr.version, hdr.count, (unsigned)len);
+        return false;
+    }
+    if (crc32_le(0, recordData, recordBytes) != hdr.crc) {
+        DEBUG_PRINTLN("HelloClub: NVS event cache CRC mismatch, ignoring");
+        return false;
+    }
+
+    // Triggered bitmap is optional — a missing one, or one written for other
+    // records (power cut or failed write between the two), means nothing
+    // triggered
+    uint8_t trig[NVS_TRIGGERED_BYTES] = {0};
+    const uint8_t* bits = trig + sizeof(uint32_t);
+    size_t trigLen = prefs.getBytesLength(NVS_TRIGGERED_KEY);
+    if (trigLen == sizeof(uint32_t) + (size_t)(hdr.count + 7) / 8) {
+        prefs.getBytes(NVS_TRIGGERED_KEY, trig, trigLen);
+        uint32_t bitsCrc;
+        memcpy(&bitsCrc, trig, sizeof(bitsCrc));
+        if (bitsCrc != hdr.crc) {
+            DEBUG_PRINTLN("HelloClub: NVS triggered bitmap is for other records, ignoring");
+            memset(trig, 0, sizeof(trig));
+        }
+    }
+    recordsCrc = hdr.crc;
+
+    events.clear();
+    events.reserve(hdr.count);
+    for (uint16_t i = 0; i < hdr.count; i++) {
+        NvsEventRecord rec = {};
+        memcpy(&rec, recordData + i * recordSize, recordSize);
+
+        // CachedEvent fields are one byte longer than the record's, so the
+        // zero-initialised struct keeps its NUL terminator
+        CachedEvent evt = {};
+        memcpy(evt.id, rec.id, sizeof(rec.id));
+        memcpy(evt.name, rec.name, sizeof(rec.name));
+        evt.idHash = hashId(evt.id);
+        evt.startTime = (time_t)rec.startTime;
+        evt.endTime = (time_t)rec.endTime;
+        evt.durationMin = rec.durationMin;
+        evt.numRounds = rec.numRounds;
+        evt.breakSec = rec.breakSec;
+        evt.warmupMin = rec.warmupMin;
+        evt.sirenBlasts = rec.sirenBlasts;
+        evt.court = rec.court;
+        evt.oneMinuteWarning = rec.flags & 0x01;
+        evt.triggered = (bits[i / 8] >> (i % 8)) & 1;
+        events.push_back(evt);
+    }
+    return true;
+}
+
+bool HelloClubClient::loadLegacyJsonFromNVS(Preferences& prefs) {
+    String json = prefs.getString(NVS_EVENTS_KEY, "[]");
 
     DynamicJsonDocument doc(4096);
     DeserializationError error = deserializeJson(doc, json);
     if (error) {
         DEBUG_PRINTF("HelloClub: Failed to parse NVS cache: %s\n", error.c_str());
-        return;
+        return false;
     }
 
     events.clear();
     JsonArray arr = doc.as<JsonArray>();
     for (JsonObject obj : arr) {
-        CachedEvent evt;
-        evt.id = obj["i"].as<String>();
-        evt.name = obj["n"].as<String>();
+        CachedEvent evt = {};
+        hcCopyField(evt.id, sizeof(evt.id), obj["i"] | "");
+        hcCopyField(evt.name, sizeof(evt.name), obj["n"] | "");
+        evt.idHash = hashId(evt.id);
         evt.startTime = obj["s"].as<time_t>();
         evt.endTime = obj["e"].as<time_t>();
         evt.durationMin = obj["d"].as<uint16_t>();
@@ -485,58 +613,86 @@ void HelloClubClient::loadFromNVS() {
         evt.triggered = obj["t"].as<bool>();
         events.push_back(evt);
     }
-
-    DEBUG_PRINTF("HelloClub: Loaded %d cached events from NVS\n", events.size());
+    return true;
 }
 
 void HelloClubClient::saveToNVS() {
-    DynamicJsonDocument doc(4096);
-    JsonArray arr = doc.to<JsonArray>();
-
-    for (const auto& evt : events) {
-        JsonObject obj = arr.createNestedObject();
-        obj["i"] = evt.id;
-        obj["n"] = evt.name;
-        obj["s"] = (long)evt.startTime;
-        obj["e"] = (long)evt.endTime;
-        obj["d"] = evt.durationMin;
-        obj["r"] = evt.numRounds;
-        obj["t"] = evt.triggered;
+    size_t count = min(events.size(), (size_t)HELLOCLUB_MAX_CACHED_EVENTS);
+    size_t recordBytes = count * sizeof(NvsEventRecord);
+    std::vector<uint8_t> blob(sizeof(NvsEventHeader) + recordBytes);
+    uint8_t* recordData = blob.data() + sizeof(NvsEventHeader);
+
+    for (size_t i = 0; i < count; i++) {
+        const CachedEvent& evt = events[i];
+        NvsEventRecord rec;
+        memcpy(rec.id, evt.id, sizeof(rec.id));
+        memcpy(rec.name, evt.name, sizeof(rec.name));
+        rec.startTime = (uint32_t)evt.startTime;
+        rec.endTime = (uint32_t)evt.endTime;
+        rec.durationMin = evt.durationMin;
+        rec.numRounds = evt.numRounds;
+        rec.flags = evt.oneMinuteWarning ? 0x01 : 0;
+        rec.warmupMin = evt.warmupMin;
+        rec.sirenBlasts = evt.sirenBlasts;
+        rec.court = evt.court;
+        rec.reserved = 0;
+        rec.breakSec = evt.breakSec;
+        memcpy(recordData + i * sizeof(NvsEventRecord), &rec, sizeof(rec));
     }
 
-    String json;
-    serializeJson(doc, json);
+    NvsEventHeader hdr;
+    hdr.magic = NVS_EVENTS_MAGIC;
+    hdr.version = NVS_EVENTS_VERSION;
+    hdr.count = (uint16_t)count;
+    hdr.crc = crc32_le(0, recordData, recordBytes);
+    memcpy(blob.data(), &hdr, sizeof(hdr));
+    recordsCrc = hdr.crc;
+
+    // Staged with the triggered bitmap so both commit in the same batch; a
+    // purge or refresh that leaves the cache unchanged writes nothing
+    nvsStore.putBytes(NVS_NAMESPACE, NVS_RECORDS_KEY, blob.data(), blob.size());
+    nvsStore.remove(NVS_NAMESPACE, NVS_EVENTS_KEY);
+    DEBUG_PRINTF("HelloClub: Saved %d events to NVS (%d bytes)\n", (int)count, (int)blob.size());
+
+    saveTriggeredToNVS();
+}
 
-    Preferences prefs;
-    if (prefs.begin(NVS_NAMESPACE, false)) {
-        prefs.putString(NVS_EVENTS_KEY, json);
-        prefs.end();
-        DEBUG_PRINTF("HelloClub: Saved %d events to NVS (%d bytes)\n", events.size(), json.length());
+void HelloClubClient::saveTriggeredToNVS() {
+    size_t count = min(events.size(), (size_t)HELLOCLUB_MAX_CACHED_EVENTS);
+    uint8_t trig[NVS_TRIGGERED_BYTES] = {0};
+    memcpy(trig, &recordsCrc, sizeof(recordsCrc));
+    uint8_t* bits = trig + sizeof(uint32_t);
+    for (size_t i = 0; i < count; i++) {
+        if (events[i].triggered) {
+            bits[i / 8] |= (1 << (i % 8));
+        }
     }
+
+    nvsStore.putBytes(NVS_NAMESPACE, NVS_TRIGGERED_KEY, trig, sizeof(uint32_t) + (count + 7) / 8);
 }
 
 RecoveryResult HelloClubClient::checkMidEventRecovery() {
     RecoveryResult result;
     result.shouldRecover = false;
 
-    time_t now = UTC.now();
+    time_t now = timeNow();
     if (now < 1000000000) {
         return result; // NTP not synced
     }
 
     CachedEvent* bestEvent = nullptr;
 
-    remoteLog("Recovery scan: %d events, now=%ld", (int)events.size(), (long)now);
-    for (auto& evt : events) {
+    // Walk back from the newest event that has started — the first one still
+    // in play is the one with the latest startTime (most relevant)
+    size_t started = lowerBound(now + 1);
+    remoteLog("Recovery scan: %d events (%d started), now=%ld",
+              (int)events.size(), (int)started, (long)now);
+    for (size_t i = started; i-- > 0; ) {
+        CachedEvent& evt = events[i];
+
         // Only recover events that were actually auto-started before the reboot
         if (!evt.triggered) {
-            remoteLog("Recovery skip \"%s\": never triggered", evt.name.c_str());
-            continue;
-        }
-
-        // Must have started
-        if (now < evt.startTime) {
-            remoteLog("Recovery skip \"%s\": not started yet (start=%ld)", evt.name.c_str(), (long)evt.startTime);
+            TRACE("Recovery skip \"%s\": never triggered", evt.name);
             continue;
         }
 
@@ -557,15 +713,13 @@ RecoveryResult HelloClubClient::checkMidEventRecovery() {
         }
 
         if ((unsigned long)elapsed >= totalPlaySec) {
-            remoteLog("Recovery skip \"%s\": all rounds done (elapsed=%lds total=%lus)",
-                      evt.name.c_str(), (long)elapsed, totalPlaySec);
+            TRACE("Recovery skip \"%s\": all rounds done (elapsed=%lds total=%lus)",
+                      evt.name, (long)elapsed, totalPlaySec);
             continue; // All rounds finished
         }
 
-        // Pick the event with the latest startTime (most relevant)
-        if (!bestEvent || evt.startTime > bestEvent->startTime) {
-            bestEvent = &evt;
-        }
+        bestEvent = &evt;
+        break;
     }
 
     if (!bestEvent) {
@@ -586,44 +740,105 @@ RecoveryResult HelloClubClient::checkMidEventRecovery() {
     result.remainingMs = remainingInRoundSec * 1000UL;
     result.eventEndTime = bestEvent->endTime;
     result.eventStartTime = bestEvent->startTime;
+    result.sirenBlasts = bestEvent->sirenBlasts;
+    result.oneMinuteWarning = bestEvent->oneMinuteWarning;
 
     DEBUG_PRINTF("Recovery check: event '%s' round %d, %lu sec remaining\n",
-                 bestEvent->name.c_str(), currentRound, remainingInRoundSec);
+                 bestEvent->name, currentRound, remainingInRoundSec);
 
     return result;
 }
 
-CachedEvent* HelloClubClient::checkAutoTrigger(Timezone& tz) {
-    time_t now = UTC.now();
-
-    for (auto& evt : events) {
-        if (evt.triggered) {
-            remoteLog("HC evt \"%s\": already triggered", evt.name.c_str());
-            continue;
+CachedEvent* HelloClubClient::checkAutoTrigger() {
+    time_t now = timeNow();
+    long windowSec = HELLOCLUB_TRIGGER_WINDOW_MS / 1000;
+
+    // Move the cursor past events that can no longer trigger: already
+    // started, or whose window closed while the timer was busy. Events are
+    // in startTime order, so everything behind the cursor stays done. The
+    // cursor rewinds after every sync; each miss is logged once.
+    while (triggerCursor < events.size()) {
+        CachedEvent& evt = events[triggerCursor];
+        if (!evt.triggered && now <= evt.startTime + windowSec) {
+            break;
+        }
+        if (!evt.triggered && !evt.missLogged) {
+            evt.missLogged = 1;
+            remoteLog("HC evt \"%s\": window missed (start=%ld now=%ld)",
+                      evt.name, (long)evt.startTime, (long)now);
         }
+        triggerCursor++;
+    }
 
-        long delta = (long)(now - evt.startTime);
-        long windowSec = HELLOCLUB_TRIGGER_WINDOW_MS / 1000;
+    if (triggerCursor >= events.size()) {
+        return nullptr;
+    }
 
-        // Check if now is within the trigger window (startTime to startTime + 2 min)
-        if (now >= evt.startTime && now <= evt.startTime + windowSec) {
-            remoteLog("HC evt \"%s\": IN WINDOW delta=%lds", evt.name.c_str(), delta);
-            return &evt;
-        } else {
-            remoteLog("HC evt \"%s\": start=%ld now=%ld delta=%lds",
-                      evt.name.c_str(), (long)evt.startTime, (long)now, delta);
-        }
+    // Check if now is within the trigger window (startTime to startTime + 2 min)
+    CachedEvent& evt = events[triggerCursor];
+    if (now < evt.startTime) {
+        return nullptr;
+    }
+
+    if (windowLoggedIdx != triggerCursor) {
+        windowLoggedIdx = triggerCursor;
+        TRACE("HC evt \"%s\": IN WINDOW delta=%lds", evt.name, (long)(now - evt.startTime));
+    }
+    return &evt;
+}
+
+bool HelloClubClient::alignedStart(const CachedEvent& evt, int64_t lateMs,
+                                   unsigned int& round, unsigned long& remainingMs) {
+    uint64_t roundMs = (uint64_t)evt.durationMin * 60000ULL;
+    if (roundMs == 0) {
+        return false;
+    }
+    uint64_t elapsed = lateMs > 0 ? (uint64_t)lateMs : 0;
+    uint64_t done = elapsed / roundMs;
+    if (evt.numRounds > 0 && done >= evt.numRounds) {
+        return false;
     }
+    round = (unsigned int)done + 1;
+    remainingMs = (unsigned long)(roundMs - elapsed % roundMs);
+    return true;
+}
+
+size_t HelloClubClient::lowerBound(time_t t) const {
+    auto it = std::lower_bound(events.begin(), events.end(), t,
+        [](const CachedEvent& evt, time_t value) { return evt.startTime < value; });
+    return (size_t)(it - events.begin());
+}
+
+void HelloClubClient::reindex() {
+    // Stable so same-start events (multi-court) keep API order
+    std::stable_sort(events.begin(), events.end(),
+        [](const CachedEvent& a, const CachedEvent& b) { return a.startTime < b.startTime; });
+    triggerCursor = 0;
+    windowLoggedIdx = SIZE_MAX;
+}
 
+const CachedEvent* HelloClubClient::getNextEvent(time_t after) const {
+    for (size_t i = lowerBound(after); i < events.size(); i++) {
+        if (!events[i].triggered) {
+            return &events[i];
+        }
+    }
     return nullptr;
 }
 
-void HelloClubClient::markTriggered(const String& id, time_t startTime) {
-    for (auto& evt : events) {
-        if (evt.id == id && evt.startTime == startTime) {
-            evt.triggered = true;
-            DEBUG_PRINTF("HelloClub: Marked event '%s' as triggered\n", evt.name.c_str());
-            saveToNVS();
+time_t HelloClubClient::getNextEventStart(time_t after) const {
+    const CachedEvent* next = getNextEvent(after);
+    return next ? next->startTime : 0;
+}
+
+void HelloClubClient::markTriggered(const char* id, time_t startTime) {
+    uint64_t idHash = hashId(id);
+    for (size_t i = lowerBound(startTime); i < events.size() && events[i].startTime == startTime; i++) {
+        CachedEvent& evt = events[i];
+        if (evt.idHash == idHash) {
+            evt.triggered = 1;
+            DEBUG_PRINTF("HelloClub: Marked event '%s' as triggered\n", evt.name);
+            saveTriggeredToNVS();
             return;
         }
     }
@@ -631,13 +846,14 @@ void HelloClubClient::markTriggered(const String& id, time_t startTime) {
 
 void HelloClubClient::clearAllTriggered() {
     for (auto& evt : events) {
-        evt.triggered = false;
+        evt.triggered = 0;
     }
-    saveToNVS();
+    reindex();
+    saveTriggeredToNVS();
 }
 
-void HelloClubClient::purgeExpired(Timezone& tz) {
-    time_t now = UTC.now();
+void HelloClubClient::purgeExpired() {
+    time_t now = timeNow();
     size_t before = events.size();
 
     // Keep events for 5 minutes after their endTime if they haven't been triggered yet.
@@ -645,29 +861,32 @@ void HelloClubClient::purgeExpired(Timezone& tz) {
     // grace period, the event gets purged before checkAutoTrigger can see it.
     const time_t PURGE_GRACE_SEC = 300; // 5 minutes
 
-    events.erase(
-        std::remove_if(events.begin(), events.end(),
-            [now, PURGE_GRACE_SEC](const CachedEvent& evt) {
-                // For triggered events, calculate actual play end time
-                // (short bookings may have endTime << actual play time)
-                if (evt.triggered) {
-                    time_t playEnd = evt.startTime;
-                    if (evt.numRounds > 0) {
-                        playEnd += (time_t)evt.numRounds * evt.durationMin * 60;
-                    } else {
-                        playEnd += (time_t)evt.durationMin * 60;
-                    }
-                    time_t effectiveEnd = (evt.endTime > playEnd) ? evt.endTime : playEnd;
-                    return effectiveEnd + PURGE_GRACE_SEC < now;
-                }
-                // Not triggered — keep for grace period after endTime
-                return evt.endTime + PURGE_GRACE_SEC < now;
-            }),
-        events.end()
-    );
+    // An event can't expire before startTime + grace, and those all sit at the
+    // front of the sorted cache — only that prefix needs checking
+    size_t candidates = lowerBound(now - PURGE_GRACE_SEC);
+    auto candidatesEnd = events.begin() + candidates;
+    auto expired = [now, PURGE_GRACE_SEC](const CachedEvent& evt) {
+        // For triggered events, calculate actual play end time
+        // (short bookings may have endTime << actual play time)
+        if (evt.triggered) {
+            time_t playEnd = hcPlayEnd(evt);
+            time_t effectiveEnd = (evt.endTime > playEnd) ? evt.endTime : playEnd;
+            return effectiveEnd + PURGE_GRACE_SEC < now;
+        }
+        // Not triggered — keep for grace period after endTime
+        return evt.endTime + PURGE_GRACE_SEC < now;
+    };
+
+    // Removal keeps the order, so no re-sort: the cursor just moves back by
+    // the events purged from behind it
+    size_t behindCursor = (size_t)std::count_if(
+        events.begin(), events.begin() + min(triggerCursor, candidates), expired);
+    events.erase(std::remove_if(events.begin(), candidatesEnd, expired), candidatesEnd);
 
     if (events.size() < before) {
-        DEBUG_PRINTF("HelloClub: Purged %d expired events\n", before - events.size());
+        DEBUG_PRINTF("HelloClub: Purged %d expired events\n", (int)(before - events.size()));
+        windowLoggedIdx = (windowLoggedIdx == triggerCursor) ? triggerCursor - behindCursor : SIZE_MAX;
+        triggerCursor -= behindCursor;
         saveToNVS();
     }
 }
@@ -5,19 +5,42 @@
 #include <ArduinoJson.h>
 #include <Preferences.h>
 #include <vector>
-#include <ezTime.h>
-
-// Cached event from Hello Club API
-struct CachedEvent {
-    String id;              // HC event ID (first 12 chars)
-    String name;            // Event name (max 40 chars)
-    time_t startTime;       // UTC epoch
-    time_t endTime;         // UTC epoch — from HC booking slot
-    uint16_t durationMin;   // Game duration (from timer: tag or default)
-    uint8_t numRounds;      // Rounds (from timer: tag or default)
-    bool triggered;         // Already auto-started
+#include <atomic>
+#include "hcevents.h"
+#include "hcparse.h"
+#include "triplebuffer.h"
+
+// NVS event cache layout: one versioned blob (header + fixed-size records,
+// CRC over the records) plus a separate triggered bitmap so marking an event
+// only rewrites a few bytes instead of the whole cache. The two are separate
+// writes, so the bitmap starts with the CRC of the records it indexes and is
+// ignored unless that matches.
+struct __attribute__((packed)) NvsEventHeader {
+    uint32_t magic;         // NVS_EVENTS_MAGIC
+    uint16_t version;       // NVS_EVENTS_VERSION
+    uint16_t count;         // Number of records following the header
+    uint32_t crc;           // CRC32 of the record array
 };
 
+// Version 2 appends the tag directives; a version 1 record is the first
+// NVS_RECORD_SIZE_V1 bytes of this layout (flags was reserved, always 0)
+struct __attribute__((packed)) NvsEventRecord {
+    char id[12];            // Not NUL-terminated when all 12 chars are used
+    char name[32];          // Not NUL-terminated when all 32 chars are used
+    uint32_t startTime;     // UTC epoch
+    uint32_t endTime;       // UTC epoch
+    uint16_t durationMin;
+    uint8_t numRounds;
+    uint8_t flags;          // Bit 0: one-minute warning
+    uint8_t warmupMin;
+    uint8_t sirenBlasts;
+    uint8_t court;
+    uint8_t reserved;
+    uint16_t breakSec;
+};
+static_assert(sizeof(NvsEventRecord) == 62, "NvsEventRecord layout is persisted — bump NVS_EVENTS_VERSION");
+static const size_t NVS_RECORD_SIZE_V1 = 56;
+
 // Result from mid-event boot recovery check
 struct RecoveryResult {
     bool shouldRecover;
@@ -29,22 +52,50 @@ struct RecoveryResult {
     unsigned long remainingMs;  // milliseconds remaining in current round
     time_t eventEndTime;
     time_t eventStartTime;
+    uint8_t sirenBlasts;        // From timer: tag (0 = firmware default)
+    bool oneMinuteWarning;
 };
 
 class HelloClubClient {
 public:
     HelloClubClient();
 
+    // Main loop only (the worker gets its own copy with each fetch)
     void setApiKey(const String& apiKey);
     void setDefaults(uint16_t defaultDuration, uint8_t defaultRounds);
 
-    // Fetch events with timer: tag from HC API into staging area
+    // Fetch events with timer: tag from HC API and publish the result (events,
+    // error, debug) to the staging buffers. Producer side — worker task only;
+    // apiKey is the caller's copy, never the main loop's.
     // Returns true if fetch succeeded. Call applyStagedEvents() on main loop to apply.
-    bool fetchAndCacheEvents(int daysAhead, Timezone& tz);
+    bool fetchAndCacheEvents(int daysAhead, const char* apiKey);
 
-    // Apply staged events from background fetch to the live cache (call from main loop only)
+    // Take the latest published sync result (call from main loop only).
+    // Returns true if its events replaced the live cache; a failed result
+    // only updates getLastError()/getLastSyncDebug().
     bool applyStagedEvents();
 
+    // Parse a webhook body ({"type":"event.updated","event":{...}}) into a
+    // change. Every change but a ping needs the occurrence's startDate.
+    // Touches no cache state, so it is safe from the web server task.
+    bool parseEventChange(const char* body, size_t len, HcEventChange& change,
+                          const char*& error) const;
+
+    // Apply one pushed change to the live cache (call from main loop only),
+    // matching the occurrence by id and startTime (see hcApplyChange()).
+    // Returns true if the cache changed (it is then re-sorted and saved).
+    bool applyEventChange(const HcEventChange& change);
+
+    // Check an X-HC-Signature header: hex HMAC-SHA256 over "<timestamp>.<body>"
+    // (optionally prefixed "sha256="). Constant-time compare.
+    static bool verifySignature(const String& secret, const char* timestamp,
+                                const uint8_t* body, size_t len, const char* signatureHex);
+
+    // Ask an in-flight fetch to stop at the next page boundary (any task)
+    void requestCancel() { cancelRequested = true; }
+    void clearCancel() { cancelRequested = false; }
+    bool isCancelRequested() const { return cancelRequested; }
+
     // Load cached events from NVS (for boot without internet)
     void loadFromNVS();
 
@@ -52,11 +103,21 @@ public:
     void saveToNVS();
 
     // Check if any event should auto-trigger now
-    // Returns pointer to event if trigger should fire, nullptr otherwise
-    CachedEvent* checkAutoTrigger(Timezone& tz);
+    // Returns pointer to event if trigger should fire, nullptr otherwise.
+    // O(1) amortised: a cursor tracks the next untriggered event.
+    CachedEvent* checkAutoTrigger();
+
+    // Round and time left for an event started lateMs after its startTime, so
+    // round boundaries fall on startTime + k*duration (as boot recovery assumes).
+    // Returns false if every round is already over.
+    static bool alignedStart(const CachedEvent& evt, int64_t lateMs,
+                             unsigned int& round, unsigned long& remainingMs);
 
     // Mark event as triggered and save (matches on id + startTime for recurring events)
-    void markTriggered(const String& id, time_t startTime);
+    void markTriggered(const char* id, time_t startTime);
+
+    // 64-bit FNV-1a hash of an event id (used for id matching instead of strcmp)
+    static uint64_t hashId(const char* id) { return hcHashId(id); }
 
     // Clear all triggered flags (for debugging)
     void clearAllTriggered();
@@ -65,57 +126,96 @@ public:
     RecoveryResult checkMidEventRecovery();
 
     // Purge expired events (endTime < now)
-    void purgeExpired(Timezone& tz);
+    void purgeExpired();
 
-    // Get all cached events (for WebSocket broadcast)
+    // Get all cached events, sorted by startTime (for WebSocket broadcast)
     const std::vector<CachedEvent>& getCachedEvents() const { return events; }
 
+    // Earliest untriggered event with startTime >= after (nullptr if none)
+    const CachedEvent* getNextEvent(time_t after) const;
+
+    // Earliest startTime >= after among untriggered events (0 if none)
+    time_t getNextEventStart(time_t after) const;
+
     // Get number of cached events
     int getEventCount() const { return (int)events.size(); }
 
     // Get last sync time (millis)
     unsigned long getLastSyncTime() const { return lastSyncTime; }
 
-    // Get last error
-    String getLastError() const { return lastError; }
+    // Get last error (from the last applied sync result — main loop only)
+    const String& getLastError() const { return sync.front().error; }
 
     // Get total events from last API response (before timer: tag filtering)
-    int getTotalEventsFromApi() const { return totalEventsFromApi; }
+    int getTotalEventsFromApi() const { return sync.front().totalFromApi; }
 
     // Get debug info from last sync (event names + descriptions for troubleshooting)
-    String getLastSyncDebug() const { return lastSyncDebug; }
+    const String& getLastSyncDebug() const { return sync.front().debug; }
 
     // Check if API key is configured
     bool isConfigured() const { return !apiKey.isEmpty(); }
+    const String& getApiKey() const { return apiKey; }
 
 private:
+    // One complete sync outcome, handed from worker to main loop as a unit
+    struct SyncResult {
+        std::vector<CachedEvent> events;
+        String error;
+        String debug;
+        int totalFromApi = 0;
+        bool success = false;
+    };
+
     String apiKey;
-    String lastError;
     unsigned long lastSyncTime;
     uint16_t defaultDurationMin;
     uint8_t defaultNumRounds;
-    int totalEventsFromApi = 0;
-    String lastSyncDebug;
-    std::vector<CachedEvent> events;
+    std::vector<CachedEvent> events;   // Kept sorted by startTime (see reindex())
+    uint32_t recordsCrc = 0;           // CRC of the saved records (matches `events`)
+    size_t triggerCursor = 0;          // No event before this index can still trigger
+    size_t windowLoggedIdx = SIZE_MAX; // Event whose IN WINDOW was last logged
+
+    // Staging area for background fetch: the worker fills sync.back() and
+    // publishes it; the main loop takes it as sync.front() (see triplebuffer.h)
+    TripleBuffer<SyncResult> sync;
+    std::atomic<bool> cancelRequested{false};
 
-    // Staging area for background fetch (written on background task, read on main loop)
-    std::vector<CachedEvent> stagedEvents;
-    volatile bool stagedReady = false;
+    // Run the paged fetch into `out` (worker task only)
+    bool fetchInto(SyncResult& out, int daysAhead, const char* apiKey);
 
-    static const int HC_MAX_EVENTS = 20;
+    static const uint32_t NVS_EVENTS_MAGIC = 0x56454348; // "HCEV"
+    static const uint16_t NVS_EVENTS_VERSION = 2;
     static const char* NVS_NAMESPACE;
-    static const char* NVS_EVENTS_KEY;
+    static const char* NVS_EVENTS_KEY;      // Legacy JSON cache (migrated on load)
+    static const char* NVS_RECORDS_KEY;
+    static const char* NVS_TRIGGERED_KEY;
 
-    const String baseUrl = "https://api.helloclub.com";
+    // Load the binary record cache; returns false if missing or corrupt
+    bool loadRecordsFromNVS(Preferences& prefs);
 
-    // Make HTTP request with retry and JSON filter
-    bool makeRequest(const String& endpoint, const String& params,
-                     DynamicJsonDocument& responseDoc, const JsonDocument& filter);
+    // Load the pre-binary JSON cache (one-time migration)
+    bool loadLegacyJsonFromNVS(Preferences& prefs);
+
+    // Rewrite only the triggered bitmap (records unchanged)
+    void saveTriggeredToNVS();
 
-    // Parse timer: tag from event description
-    // Returns true if timer: tag found; sets duration and rounds
-    bool parseTimerTag(const String& description, uint16_t& duration, uint8_t& rounds);
+    // Sort events by startTime and rewind the trigger cursor (after any bulk change)
+    void reindex();
 
-    // Parse ISO 8601 date to time_t (UTC epoch)
-    time_t parseISOToEpoch(const String& isoDate);
+    // Index of the first event with startTime >= t (binary search)
+    size_t lowerBound(time_t t) const;
+
+    // Make HTTP request with retry and JSON filter
+    bool makeRequest(const char* apiKey, const String& endpoint, const String& params,
+                     DynamicJsonDocument& responseDoc, const JsonDocument& filter,
+                     String& error);
+
+    // Parse the timer: tag with the configured default round length (see hcparse.h)
+    bool parseTimerTag(const char* description, TimerTag& tag) const {
+        return hcParseTimerTag(description, defaultDurationMin, tag);
+    }
+
+    // Fill a cache entry from an API event object (fetch and webhook).
+    // Returns false if its startDate doesn't parse (see hcBuildEvent()).
+    bool buildCachedEvent(JsonObjectConst obj, const TimerTag& tag, CachedEvent& evt) const;
 };
@@ -4,11 +4,10 @@
 #include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
 #include "SPIFFS.h"
-#include <ezTime.h>
 #include <Preferences.h>
-#include "ESPAsyncWiFiManager.h"
 #include <ArduinoOTA.h>
 #include <map>
+#include <memory>
 #include "esp_task_wdt.h"
 #include "wifi_credentials.h"
 #include "config.h"
@@ -18,50 +17,18 @@
 #include "users.h"
 #include "helloclub.h"
 #include "remotelog.h"
+#include "nvsstore.h"
+#include "bootlog.h"
+#include "trace.h"
 #include "esp_system.h"
-
-// ==========================================================================
-// --- Boot Logger (persists to SPIFFS across reboots) ---
-// ==========================================================================
-
-#define BOOT_LOG_PATH "/bootlog.txt"
-#define BOOT_LOG_MAX_SIZE 8192
-
-void bootLogInit() {
-    File f = SPIFFS.open(BOOT_LOG_PATH, "r");
-    if (f && f.size() > BOOT_LOG_MAX_SIZE) {
-        String content = f.readString();
-        f.close();
-        int cutPoint = content.indexOf('\n', content.length() / 2);
-        if (cutPoint > 0) {
-            File fw = SPIFFS.open(BOOT_LOG_PATH, "w");
-            if (fw) {
-                fw.print("--- LOG TRIMMED ---\n");
-                fw.print(content.substring(cutPoint + 1));
-                fw.close();
-            }
-        }
-    } else if (f) {
-        f.close();
-    }
-}
-
-void bootLog(const char* fmt, ...) {
-    char buf[256];
-    va_list args;
-    va_start(args, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, args);
-    va_end(args);
-
-    Serial.print("[LOG] ");
-    Serial.println(buf);
-
-    File f = SPIFFS.open(BOOT_LOG_PATH, "a");
-    if (f) {
-        f.printf("[%lu ms] %s\n", millis(), buf);
-        f.close();
-    }
-}
+#include "seriallog.h"
+#include "wifijoin.h"
+#include "portal.h"
+#include "bootprof.h"
+#include "timesvc.h"
+#include "beacon.h"
+#include "clientclock.h"
+#include "clockdisc.h"
 
 const char* getResetReasonStr() {
     esp_reset_reason_t reason = esp_reset_reason();
@@ -91,12 +58,14 @@ UserManager userManager;
 HelloClubClient helloClubClient;
 
 // Timezone
-Timezone myTZ;
 
 // Web Server & WebSocket
 AsyncWebServer server(80);
 AsyncWebSocket ws("/ws");
-DNSServer dns;
+
+// Read-only viewers: Server-Sent Events, no inbound messages and no
+// per-client session state
+AsyncEventSource events("/events");
 
 // WebSocket Authentication
 std::map<uint32_t, UserRole> authenticatedClients;
@@ -114,9 +83,43 @@ const unsigned long RATE_LIMIT_WINDOW = 1000;
 std::map<uint32_t, unsigned long> clientLastActivity;
 const unsigned long SESSION_TIMEOUT = 30 * 60 * 1000;
 
+// Remote Log Streaming: admins reading the diagnostic log. cursor is the
+// next sequence number to send. The WebSocket handler (AsyncTCP task) only
+// queues requests; the main loop owns the map and applies them.
+struct RemoteLogReader {
+    uint32_t cursor;
+    bool subscribed;    // Push new entries every RLOG_PUSH_INTERVAL_MS
+    bool requested;     // Explicit get_remote_log not yet answered
+    bool backlog;       // Last batch was full: send the next one right away
+};
+std::map<uint32_t, RemoteLogReader> remoteLogReaders;
+
+struct RemoteLogRequest {
+    uint32_t clientId;
+    uint32_t since;
+    int8_t subscribe;   // 1 on, 0 off, -1 unchanged
+    bool request;       // get_remote_log (false: unsubscribe only)
+};
+QueueHandle_t remoteLogRequestQueue = nullptr;
+
+// Clock offset estimates, one per connected client. The WebSocket handler
+// (AsyncTCP task) adds and removes clients and records pongs; the main loop
+// sends pings and reads offsets. Every access holds clientClocksMutex, only
+// for the map itself: never across a send, which takes AsyncTCP's own locks.
+std::map<uint32_t, ClientClock> clientClocks;
+SemaphoreHandle_t clientClocksMutex = nullptr;
+
+struct ClientClocksLock {
+    ClientClocksLock() { if (clientClocksMutex) xSemaphoreTake(clientClocksMutex, portMAX_DELAY); }
+    ~ClientClocksLock() { if (clientClocksMutex) xSemaphoreGive(clientClocksMutex); }
+};
+
 // Periodic Sync
 unsigned long lastSyncBroadcast = 0;
 
+// Network services (OTA, mDNS, timezone) start on the first WiFi connection
+bool networkServicesStarted = false;
+
 // NTP Sync Status Tracking
 bool lastNTPSyncStatus = false;
 unsigned long lastNTPStatusCheck = 0;
@@ -127,22 +130,88 @@ unsigned long factoryResetButtonPressStart = 0;
 bool factoryResetButtonPressed = false;
 bool factoryResetInProgress = false;
 
-// Hello Club Integration
+// Hello Club Integration. helloClubApiKey and hcWebhookSecret belong to the
+// web server task (settings handlers, webhook); the main loop learns a new
+// key through hcControlQueue.
 String helloClubApiKey = "";
 bool helloClubEnabled = false;
 unsigned long lastHelloClubPoll = 0;
 bool lastHelloClubPollFailed = false;
+bool hcPollDeferred = false;            // Due poll held back by the guard window...
+unsigned long hcPollDeferredSince = 0;  // ...since this millis()
+
+// Background fetch worker (FreeRTOS) — one long-lived task on core 0.
+// The main loop posts a request, the worker posts back a result; at most one
+// request is outstanding, tracked by hcFetchPending (main loop only).
+enum HcFetchRequest : uint8_t {
+    HC_FETCH_POLL,      // Scheduled poll
+    HC_FETCH_REFRESH    // Manual refresh from the admin UI
+};
+
+// What the worker gets: the request and its own copy of the API key
+struct HcFetchJob {
+    HcFetchRequest request;
+    char apiKey[HELLOCLUB_API_KEY_MAX_LEN + 1];
+};
 
-// Background fetch task (FreeRTOS)
-volatile bool hcFetchInProgress = false;
-volatile bool hcFetchResultReady = false;
-volatile bool hcFetchResultSuccess = false;
-TaskHandle_t hcFetchTaskHandle = nullptr;
+struct HcFetchResult {
+    HcFetchRequest request;
+    bool success;
+    bool cancelled;
+    uint32_t durationMs;    // Wall time of the fetch on the worker
+};
+
+QueueHandle_t hcRequestQueue = nullptr;
+QueueHandle_t hcResultQueue = nullptr;
+TaskHandle_t hcWorkerTaskHandle = nullptr;
+bool hcFetchPending = false;
+bool hcRefreshQueued = false;   // Manual refresh asked for while a fetch was outstanding
+
+// Refresh and settings changes from the WebSocket handler (AsyncTCP task),
+// applied by the main loop, which owns the fetch state above
+enum HcControlOp : uint8_t {
+    HC_CONTROL_REFRESH,     // helloclub_refresh — reply to clientId
+    HC_CONTROL_SETTINGS     // save_helloclub_settings — new key and defaults
+};
+
+struct HcControlRequest {
+    HcControlOp op;
+    uint32_t clientId;
+    uint16_t defaultDuration;
+    char apiKey[HELLOCLUB_API_KEY_MAX_LEN + 1];
+};
+QueueHandle_t hcControlQueue = nullptr;
+uint32_t hcFetchCount = 0;
+uint32_t hcLastFetchMs = 0;
+uint32_t hcMaxFetchMs = 0;
+
+// Webhook push: the web server task verifies and parses each notification and
+// queues the change; the main loop applies it to the cache. Changes applied
+// while a fetch is in flight are replayed over that fetch's (older) result.
+String hcWebhookSecret = "";
+QueueHandle_t hcPushQueue = nullptr;
+HcEventChange hcPushReplay[HELLOCLUB_PUSH_QUEUE_DEPTH];
+int hcPushReplayCount = 0;
+uint32_t hcPushCount = 0;
+unsigned long hcLastPushMs = 0;
+
+// Auto-start deadline: the next event's startTime converted to a millis()
+// value, so loop() can start the timer on time instead of at the next
+// 30-second schedule check
+bool hcStartArmed = false;
+unsigned long hcStartDeadline = 0;
+time_t hcStartArmedFor = 0;
+time_t hcStartFiredFor = 0;
+long hcLastStartLateMs = 0;     // How late the last auto-start was (ms)
+uint32_t hcStartCount = 0;
 
 // Event Window Enforcement
 time_t activeEventEndTime = 0;
 String activeEventName = "";
 String activeEventId = "";
+uint8_t activeEventSirenBlasts = 0;      // timer: tag "siren N" (0 = default)
+bool activeEventWarn = false;           // timer: tag "warn"
+unsigned int activeEventWarnedRound = 0;
 
 // Boot Recovery
 bool bootRecoveryAttempted = false;
@@ -151,8 +220,12 @@ bool bootRecoveryAttempted = false;
 // --- Function Declarations ---
 // ==========================================================================
 
-bool connectToKnownWiFi();
+void broadcast(const String& json);
 void sendEvent(const String& type);
+String stateJson();
+String settingsJson();
+String syncJson(AsyncWebSocketClient *client);
+String ntpStatusJson();
 void sendStateUpdate(AsyncWebSocketClient *client = nullptr);
 void sendSettingsUpdate(AsyncWebSocketClient *client = nullptr);
 void sendSync(AsyncWebSocketClient *client);
@@ -160,17 +233,33 @@ void sendError(AsyncWebSocketClient *client, const String& message);
 void sendAuthRequest(AsyncWebSocketClient *client);
 void sendNTPStatus(AsyncWebSocketClient *client = nullptr);
 void checkAndBroadcastNTPStatus();
+void serviceRemoteLogReaders();
 void sendUpcomingEvents(AsyncWebSocketClient *client = nullptr);
 void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocketClient *client);
 void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len);
+void onEventsConnect(AsyncEventSourceClient *client);
 void setupOTA();
+void startNetworkServices();
 void setupWatchdog();
 void runSelfTest();
 String getFormattedTime12Hour();
 void loadHelloClubSettings();
 void saveHelloClubSettings();
 void checkHelloClubPoll();
-void hcFetchTask(void* param);
+void checkHelloClubControl();
+unsigned long getHelloClubPollInterval();
+bool inFetchGuardWindow();
+void hcWorkerTask(void* param);
+void startHelloClubWorker();
+bool requestHelloClubFetch(HcFetchRequest request);
+void startQueuedHelloClubRefresh();
+void cancelHelloClubFetch();
+void handleHelloClubWebhook(AsyncWebServerRequest *request);
+void checkHelloClubPush();
+void replayHelloClubPushes();
+bool helloClubPushLive();
+void armHelloClubStart();
+void runHelloClubAutoTrigger();
 bool sirenAllowed();
 
 // ==========================================================================
@@ -178,7 +267,9 @@ bool sirenAllowed();
 // ==========================================================================
 
 void setup() {
+    bootProfBegin();
     Serial.begin(SERIAL_BAUD_RATE);
+    serialLog.begin();
     DEBUG_PRINTLN("\n\n=================================");
     DEBUG_PRINTF("ESP32 Badminton Timer v%s\n", FIRMWARE_VERSION);
     DEBUG_PRINTF("Build: %s %s\n", BUILD_DATE, BUILD_TIME);
@@ -191,9 +282,12 @@ void setup() {
     DEBUG_PRINTLN("Factory reset button configured (hold BOOT button for 10 seconds)");
 
     if (ENABLE_SELF_TEST) {
+        bootPhaseBegin(BOOT_PHASE_SELF_TEST);
         runSelfTest();
+        bootPhaseEnd(BOOT_PHASE_SELF_TEST);
     }
 
+    bootPhaseBegin(BOOT_PHASE_SPIFFS);
     if (!SPIFFS.begin(true)) {
         DEBUG_PRINTLN("SPIFFS mount failed! Restarting in 5 seconds...");
         delay(SPIFFS_RESTART_DELAY_MS);
@@ -207,198 +301,107 @@ void setup() {
     bootLog("Firmware: v%s (%s %s)", FIRMWARE_VERSION, BUILD_DATE, BUILD_TIME);
     bootLog("Reset reason: %s", getResetReasonStr());
     bootLog("Free heap: %u bytes", ESP.getFreeHeap());
+    bootPhaseEnd(BOOT_PHASE_SPIFFS);
 
+    bootPhaseBegin(BOOT_PHASE_SETTINGS);
+    nvsStore.begin();
     siren.begin();
     settings.load(timer, siren);
+    bootPhaseEnd(BOOT_PHASE_SETTINGS);
+
+    bootPhaseBegin(BOOT_PHASE_USERS);
     userManager.begin();
+    bootPhaseEnd(BOOT_PHASE_USERS);
+
+    bootPhaseBegin(BOOT_PHASE_HELLOCLUB);
     loadHelloClubSettings();
 
     // Set HC client defaults from settings and load cached events
     helloClubClient.setDefaults(settings.getHcDefaultDuration(), DEFAULT_NUM_ROUNDS);
     helloClubClient.loadFromNVS();
+    startHelloClubWorker();
+    bootPhaseEnd(BOOT_PHASE_HELLOCLUB);
 
-    bootLog("WiFi: Starting connection attempts");
-
-    if (!connectToKnownWiFi()) {
-        bootLog("WiFi: Known networks failed, starting custom captive portal");
-
-        bootLog("Portal: Scanning networks before starting AP...");
-        int numNetworks = WiFi.scanNetworks();
-        int displayCount = min(numNetworks, 10); // Cap at 10 to limit RAM usage
-        String networkListHtml = "";
-        networkListHtml.reserve(displayCount * 100);
-        for (int i = 0; i < numNetworks; i++) {
-            String ssid = WiFi.SSID(i);
-            int rssi = WiFi.RSSI(i);
-            bool isOpen = (WiFi.encryptionType(i) == WIFI_AUTH_OPEN);
-            if (i < displayCount) {
-                networkListHtml += "<div class='net' onclick=\"document.getElementById('s').value='" + ssid + "'\">";
-                networkListHtml += ssid + " (" + String(rssi) + " dBm)";
-                if (isOpen) networkListHtml += " [open]";
-                networkListHtml += "</div>";
-            }
-            bootLog("  Found: '%s' RSSI:%d %s", ssid.c_str(), rssi, isOpen ? "OPEN" : "ENCRYPTED");
-        }
-        WiFi.scanDelete();
-
-        WiFi.mode(WIFI_AP);
-        delay(100);
-        WiFi.softAPConfig(IPAddress(192, 168, 4, 1), IPAddress(192, 168, 4, 1), IPAddress(255, 255, 255, 0));
-        WiFi.softAP("BadmintonTimerSetup");
-        bootLog("Portal: AP started, IP: %s", WiFi.softAPIP().toString().c_str());
-
-        dns.start(53, "*", IPAddress(192, 168, 4, 1));
-        bootLog("Portal: DNS captive redirect active");
-
-        String configPage = R"rawhtml(
-<!DOCTYPE html><html><head>
-<meta name='viewport' content='width=device-width,initial-scale=1'>
-<title>Badminton Timer WiFi Setup</title>
-<style>
-body{font-family:sans-serif;margin:20px;background:#1a1a2e;color:#eee}
-h2{color:#e94560}
-.net{padding:10px;margin:5px 0;background:#16213e;border-radius:5px;cursor:pointer}
-.net:hover{background:#0f3460}
-input{width:100%;padding:10px;margin:5px 0;box-sizing:border-box;border-radius:5px;border:1px solid #555;background:#16213e;color:#eee;font-size:16px}
-button{width:100%;padding:12px;background:#e94560;color:#fff;border:none;border-radius:5px;font-size:18px;cursor:pointer;margin-top:10px}
-button:hover{background:#c73e54}
-.status{padding:10px;margin:10px 0;background:#16213e;border-radius:5px}
-</style></head><body>
-<h2>Badminton Timer WiFi Setup</h2>
-<div class='status'>Select a network or type the SSID manually</div>
-)rawhtml";
-        configPage += networkListHtml;
-        configPage += R"rawhtml(
-<form action='/save' method='POST'>
-<label>SSID:</label><input id='s' name='s' required>
-<label>Password (leave blank for open):</label><input name='p' type='password'>
-<button type='submit'>Connect</button>
-</form></body></html>
-)rawhtml";
-
-        server.on("/", HTTP_GET, [configPage](AsyncWebServerRequest *request){
-            bootLog("Portal: Config page served to client");
-            request->send(200, "text/html", configPage);
-        });
-
-        server.onNotFound([](AsyncWebServerRequest *request){
-            bootLog("Portal: Redirecting %s -> /", request->url().c_str());
-            request->redirect("http://192.168.4.1/");
-        });
-
-        volatile bool portalDone = false;
-        String savedSSID, savedPassword;
-
-        server.on("/save", HTTP_POST, [&portalDone, &savedSSID, &savedPassword](AsyncWebServerRequest *request){
-            if (request->hasParam("s", true)) {
-                savedSSID = request->getParam("s", true)->value();
-                savedPassword = request->hasParam("p", true) ? request->getParam("p", true)->value() : "";
-                bootLog("Portal: User submitted SSID='%s'", savedSSID.c_str());
-                request->send(200, "text/html",
-                    "<html><body style='font-family:sans-serif;background:#1a1a2e;color:#eee;text-align:center;padding:40px'>"
-                    "<h2>Connecting...</h2><p>The device will restart and connect to " + savedSSID + "</p>"
-                    "<p>If it fails, the setup portal will reappear.</p></body></html>");
-                portalDone = true;
-            } else {
-                request->send(400, "text/plain", "Missing SSID");
-            }
-        });
-
-        server.begin();
-        bootLog("Portal: Web server started, waiting for user...");
-
-        unsigned long portalStart = millis();
-        while (!portalDone && millis() - portalStart < 300000) {
-            dns.processNextRequest();
-            esp_task_wdt_reset();
-            delay(10);
-        }
-
-        server.end();
-        dns.stop();
-
-        if (portalDone && savedSSID.length() > 0) {
-            bootLog("Portal: Trying to connect to '%s'...", savedSSID.c_str());
-            WiFi.mode(WIFI_STA);
-            delay(200);
-            if (savedPassword.length() > 0) {
-                WiFi.begin(savedSSID.c_str(), savedPassword.c_str());
-            } else {
-                WiFi.begin(savedSSID.c_str());
-            }
-
-            unsigned long start = millis();
-            while (WiFi.status() != WL_CONNECTED && millis() - start < 15000) {
-                esp_task_wdt_reset();
-                delay(500);
-                Serial.print(".");
-            }
-            Serial.println();
-
-            if (WiFi.status() == WL_CONNECTED) {
-                bootLog("Portal: Connected to '%s' IP: %s", savedSSID.c_str(), WiFi.localIP().toString().c_str());
-            } else {
-                bootLog("Portal: Failed to connect to '%s', restarting", savedSSID.c_str());
-                delay(2000);
-                ESP.restart();
-            }
-        } else {
-            bootLog("Portal: TIMEOUT after 5 min, restarting");
-            delay(2000);
-            ESP.restart();
-        }
-    }
-
-    // Captive portal success responses
-    server.on("/generate_204", HTTP_GET, [](AsyncWebServerRequest *request){ request->send(204); });
-    server.on("/gen_204", HTTP_GET, [](AsyncWebServerRequest *request){ request->send(204); });
-    server.on("/hotspot-detect.html", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
-    });
-    server.on("/library/test/success.html", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(200, "text/html", "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>");
-    });
-    server.on("/connecttest.txt", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(200, "text/plain", "Microsoft Connect Test");
-    });
-    server.on("/ncsi.txt", HTTP_GET, [](AsyncWebServerRequest *request){
-        request->send(200, "text/plain", "Microsoft NCSI");
-    });
-
-    bootLog("WiFi: CONNECTED to '%s' IP: %s RSSI: %d dBm",
-        WiFi.SSID().c_str(), WiFi.localIP().toString().c_str(), WiFi.RSSI());
-
-    Serial.println("Connected to WiFi!");
-    Serial.print("IP Address: ");
-    Serial.println(WiFi.localIP());
+    // Timer and siren are live from here on. The clock survives a reset, so
+    // mid-event recovery need not wait for WiFi and NTP.
+    timeBegin(settings.getTimezone());
 
     if (ENABLE_WATCHDOG) {
         setupWatchdog();
         bootLog("Watchdog: Enabled (%lu sec timeout)", WATCHDOG_TIMEOUT_SEC);
     }
 
-    setupOTA();
-
-    if (!MDNS.begin("badminton-timer")) {
-        Serial.println("Error setting up MDNS responder!");
+    // WiFi joins in the background (wifiJoinLoop); the captive portal opens
+    // on its own if no known network can be joined (portalLoop)
+    bootLog("WiFi: Starting connection attempts");
+    static std::vector<WifiNetwork> knownNetworks;
+    for (size_t i = 0; i < known_networks_count; i++) {
+        knownNetworks.push_back({known_networks[i].ssid, known_networks[i].password});
     }
-    MDNS.addService("http", "tcp", 80);
+    bootPhaseBegin(BOOT_PHASE_WIFI);
+    wifiJoinBegin(knownNetworks.data(), knownNetworks.size());
+
+    bootPhaseBegin(BOOT_PHASE_SERVER);
+    portalBegin(server);
 
     server.on("/log", HTTP_GET, [](AsyncWebServerRequest *request){
-        if (SPIFFS.exists(BOOT_LOG_PATH)) {
-            request->send(SPIFFS, BOOT_LOG_PATH, "text/plain");
-        } else {
-            request->send(200, "text/plain", "No boot log found.");
-        }
+        request->send(bootLogResponse(request));
+    });
+
+    // Raw trace ring for test-server/decode-trace.js
+    server.on("/trace.bin", HTTP_GET, [](AsyncWebServerRequest *request){
+        auto dump = std::make_shared<std::vector<uint8_t>>();
+        traceDump(*dump);
+        request->send(request->beginResponse("application/octet-stream", dump->size(),
+            [dump](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+                size_t n = min(maxLen, dump->size() - index);
+                memcpy(buffer, dump->data() + index, n);
+                return n;
+            }));
     });
 
     server.on("/log/clear", HTTP_GET, [](AsyncWebServerRequest *request){
-        SPIFFS.remove(BOOT_LOG_PATH);
+        bootLogClear();
         request->send(200, "text/plain", "Boot log cleared.");
     });
 
     server.on("/diag", HTTP_GET, [](AsyncWebServerRequest *request){
+        // Remote log and newest trace records, NVS write counters (flash
+        // wear estimate), console bytes lost to a full serial log ring, how
+        // long the boot-time WiFi join took, per-phase boot timings, each
+        // WebSocket client's clock offset estimate and UDP beacon counters
         String json = remoteLogGetAllJson();
+        json.remove(json.length() - 1);
+        json += ",\"trace\":";
+        json += traceGetJson(TRACE_JSON_MAX);
+        json += ",\"nvs\":";
+        json += nvsStore.statsJson();
+        json += ",\"wifi\":";
+        json += wifiJoinStatsJson();
+        json += ",\"time\":";
+        json += timeStatsJson();
+        json += ",\"clock\":";
+        json += clockDiscJson();
+        json += ",\"clients\":[";
+        {
+            ClientClocksLock lock;
+            bool firstClient = true;
+            for (auto& entry : clientClocks) {
+                if (!firstClient) json += ",";
+                json += entry.second.json(entry.first);
+                firstClient = false;
+            }
+        }
+        json += "]";
+        json += ",\"beacon\":";
+        json += beaconStatsJson();
+        json += ",\"boot\":";
+        json += bootProfJson();
+        json += ",\"serial\":{\"queued\":";
+        json += String(serialLog.queued());
+        json += ",\"dropped\":";
+        json += String(serialLog.dropped());
+        json += "}}";
         request->send(200, "application/json", json);
     });
 
@@ -410,13 +413,19 @@ button:hover{background:#c73e54}
 
     server.on("/favicon.ico", HTTP_GET, [](AsyncWebServerRequest *request){ request->send(204); });
 
-    String configuredTimezone = settings.getTimezone();
-    myTZ.setLocation(configuredTimezone);
-    Serial.printf("Timezone configured: %s\n", configuredTimezone.c_str());
-
-    // Throttle NTP polling — default ezTime polls every 30 min which can
-    // block the main loop during UDP round-trips. Set to 60 min.
-    setInterval(3600);
+    // Hello Club change notifications. The body arrives in chunks; collect it
+    // into _tempObject (freed by the request) and handle it once complete.
+    server.on("/hc/webhook", HTTP_POST, handleHelloClubWebhook, nullptr,
+        [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+            if (total > HELLOCLUB_WEBHOOK_MAX_BODY) return;
+            if (index == 0) {
+                request->_tempObject = malloc(total + 1);
+            }
+            if (request->_tempObject && index + len <= total) {
+                memcpy((uint8_t*)request->_tempObject + index, data, len);
+                ((char*)request->_tempObject)[index + len] = '\0';
+            }
+        });
 
     server.on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
         AsyncWebServerResponse *response = request->beginResponse(SPIFFS, "/index.html", "text/html");
@@ -425,9 +434,16 @@ button:hover{background:#c73e54}
     });
     server.serveStatic("/", SPIFFS, "/").setCacheControl("no-cache");
 
+    remoteLogRequestQueue = xQueueCreate(RLOG_REQUEST_QUEUE_DEPTH, sizeof(RemoteLogRequest));
+    clientClocksMutex = xSemaphoreCreateMutex();
     ws.onEvent(onWsEvent);
     server.addHandler(&ws);
+    events.onConnect(onEventsConnect);
+    server.addHandler(&events);
     server.begin();
+    bootPhaseEnd(BOOT_PHASE_SERVER);
+    bootPhaseEnd(BOOT_PHASE_SETUP);
+    bootLog("Boot: Setup complete at %lu ms, WiFi joining in background", millis());
 }
 
 // ==========================================================================
@@ -481,11 +497,17 @@ void loop() {
                 settings.save(timer, siren);
                 timer.reset();
 
+                wifiJoinForget();
+
                 // Clear Hello Club settings
+                nvsStore.discard("helloclub");
                 Preferences prefs;
                 prefs.begin("helloclub", false);
                 prefs.clear();
                 prefs.end();
+                if (!nvsStore.flush()) {
+                    DEBUG_PRINTLN("Factory reset: NVS commit failed, some settings may survive");
+                }
 
                 DEBUG_PRINTLN("Factory reset complete. Restarting in 3 seconds...");
                 delay(3000);
@@ -512,45 +534,35 @@ void loop() {
         }
     }
 
-    // WiFi reconnection monitoring — check every 30 seconds
-    static unsigned long lastWiFiCheck = 0;
-    static unsigned long wifiDownSince = 0;
-    if (millis() - lastWiFiCheck >= 30000) {
-        lastWiFiCheck = millis();
-        if (WiFi.status() != WL_CONNECTED) {
-            if (wifiDownSince == 0) {
-                wifiDownSince = millis();
-                DEBUG_PRINTLN("WiFi: Connection lost, waiting for auto-reconnect...");
-                bootLog("WiFi: Connection lost");
-            }
-            unsigned long downTime = millis() - wifiDownSince;
-            // If auto-reconnect hasn't worked after 2 minutes, force a reconnect
-            if (downTime > 120000) {
-                DEBUG_PRINTLN("WiFi: Auto-reconnect failed, forcing reconnect...");
-                bootLog("WiFi: Forcing reconnect after %lu sec", downTime / 1000);
-                WiFi.disconnect(true);
-                delay(200);
-                WiFi.reconnect();
-                wifiDownSince = millis(); // Reset timer for next attempt
-            }
-        } else if (wifiDownSince > 0) {
-            unsigned long downTime = millis() - wifiDownSince;
-            DEBUG_PRINTF("WiFi: Reconnected after %lu seconds\n", downTime / 1000);
-            bootLog("WiFi: Reconnected after %lu sec", downTime / 1000);
-            wifiDownSince = 0;
-        }
+    // WiFi join / link watch and captive portal — never block
+    wifiJoinLoop();
+    portalLoop();
+    if (!networkServicesStarted && wifiJoinConnected()) {
+        startNetworkServices();
     }
 
-    events(); // ezTime
-    ArduinoOTA.handle();
+    timeLoop();
+    clockDiscLoop();
+    if (timeSyncStats().syncs > 0) {
+        bootPhaseEnd(BOOT_PHASE_NTP);
+    }
+    if (networkServicesStarted) {
+        ArduinoOTA.handle();
+    }
     ws.cleanupClients();
 
     checkAndBroadcastNTPStatus();
+    serviceRemoteLogReaders();
     siren.update();
+    bootProfLoop();
+    // No batched flash commit while the siren sounds or a round end / event
+    // start is close; flush() callers still write through
+    nvsStore.loop(siren.isActive() || inFetchGuardWindow());
 
     // Boot recovery: if we rebooted mid-event, resume the timer
     if (!bootRecoveryAttempted && helloClubEnabled && lastNTPSyncStatus) {
         bootRecoveryAttempted = true;
+        bootPhaseBegin(BOOT_PHASE_RECOVERY);
 
         // Check if operator manually cancelled before the reboot
         String cancelledId = "";
@@ -585,12 +597,9 @@ void loop() {
                   lastRecoveredKey.isEmpty() ? "none" : lastRecoveredKey.c_str());
         if (recovery.shouldRecover && recovery.eventId != cancelledId && recoveryKey != lastRecoveredKey) {
             // Persist composite key immediately so if we crash during recovery, we won't retry
-            {
-                Preferences recPrefs;
-                if (recPrefs.begin("helloclub", false)) {
-                    recPrefs.putString("last_recov", recoveryKey);
-                    recPrefs.end();
-                }
+            nvsStore.putString("helloclub", "last_recov", recoveryKey);
+            if (!nvsStore.flush("helloclub")) {
+                remoteLog("Boot recovery: last_recov not saved, retrying in background");
             }
 
             DEBUG_PRINTF("Boot recovery: %s round %u, %lu ms remaining\n",
@@ -615,6 +624,9 @@ void loop() {
             activeEventEndTime = (recovery.eventEndTime > minEnd) ? recovery.eventEndTime : minEnd;
             activeEventName = recovery.eventName;
             activeEventId = recovery.eventId;
+            activeEventSirenBlasts = recovery.sirenBlasts;
+            activeEventWarn = recovery.oneMinuteWarning;
+            activeEventWarnedRound = 0;
 
             // Broadcast recovery notification
             StaticJsonDocument<512> recDoc;
@@ -626,7 +638,7 @@ void loop() {
             recDoc["eventEndTime"] = (long)recovery.eventEndTime;
             String output;
             serializeJson(recDoc, output);
-            ws.textAll(output);
+            broadcast(output);
 
             sendStateUpdate();
             bootLog("Boot recovery: resumed %s round %u", recovery.eventName.c_str(), recovery.currentRound);
@@ -637,6 +649,7 @@ void loop() {
             DEBUG_PRINTF("Boot recovery: skipped %s (manually cancelled)\n", recovery.eventId.c_str());
             bootLog("Boot recovery: skipped %s (cancelled)", recovery.eventId.c_str());
         }
+        bootPhaseEnd(BOOT_PHASE_RECOVERY);
     }
 
     // Session timeout check (every 60 seconds)
@@ -653,7 +666,7 @@ void loop() {
                 if (authenticatedClients.find(clientId) != authenticatedClients.end() &&
                     authenticatedClients[clientId] != VIEWER) {
 
-                    Serial.printf("Session timeout for client #%u\n", clientId);
+                    serialLog.printf("Session timeout for client #%u\n", clientId);
                     authenticatedClients[clientId] = VIEWER;
                     authenticatedUsernames.erase(clientId);
 
@@ -675,6 +688,24 @@ void loop() {
         }
     }
 
+    // Pushed Hello Club changes and admin requests — applied as soon as they arrive
+    checkHelloClubPush();
+    checkHelloClubControl();
+
+    // Auto-start deadline — checked every pass so the timer starts on the
+    // event's start time rather than at the next 30-second check
+    if (hcStartArmed && (long)(millis() - hcStartDeadline) >= 0) {
+        hcStartArmed = false;
+        // millis() and NTP can disagree by a few ms; only fire once it's due
+        if (timeNowMs() >= (int64_t)hcStartArmedFor * 1000) {
+            hcStartFiredFor = hcStartArmedFor;
+            if (helloClubEnabled) {
+                runHelloClubAutoTrigger();
+            }
+        }
+        armHelloClubStart();
+    }
+
     // Hello Club polling (every 30 seconds check if it's time to poll)
     static unsigned long lastHCCheck = 0;
     if (millis() - lastHCCheck >= SCHEDULE_CHECK_INTERVAL_MS) {
@@ -693,81 +724,36 @@ void loop() {
             // Check trigger BEFORE purging — short bookings (endTime ≈ startTime)
             // would be purged before the trigger check could see them
             int evtCount = helloClubClient.getEventCount();
-            bool ntpOk = timeStatus();
-            time_t now = UTC.now();
+            bool ntpOk = timeValid();
+            time_t now = timeNow();
             TimerState ts = timer.getState();
 
-            remoteLog("HC check: enabled=%d ntp=%d events=%d timer=%s now=%ld",
-                      helloClubEnabled ? 1 : 0, ntpOk ? 1 : 0, evtCount,
-                      ts == IDLE ? "IDLE" : ts == FINISHED ? "FINISHED" : ts == RUNNING ? "RUNNING" : "PAUSED",
-                      (long)now);
-
-            CachedEvent* evt = helloClubClient.checkAutoTrigger(myTZ);
-            if (evt && (ts == IDLE || ts == FINISHED)) {
-                remoteLog("HC AUTO-START: \"%s\" dur=%dmin rounds=%d",
-                          evt->name.c_str(), evt->durationMin, evt->numRounds);
-
-                timer.setGameDuration(evt->durationMin * 60000UL);
-                if (evt->numRounds > 0) {
-                    timer.setNumRounds(evt->numRounds);
-                    timer.setContinuousMode(false);
-                } else {
-                    timer.setContinuousMode(true);
-                }
-                timer.start();
-
-                helloClubClient.markTriggered(evt->id, evt->startTime);
-
-                // Set event window — for short bookings where endTime ≈ startTime,
-                // use the actual timer duration instead so the cutoff doesn't
-                // immediately kill the timer
-                time_t minEndTime = evt->startTime;
-                if (evt->numRounds > 0) {
-                    minEndTime += (time_t)evt->numRounds * evt->durationMin * 60;
-                } else {
-                    minEndTime += (time_t)evt->durationMin * 60;
-                }
-                activeEventEndTime = (evt->endTime > minEndTime) ? evt->endTime : minEndTime;
-                activeEventName = evt->name;
-                activeEventId = evt->id;
-
-                // Clear any stale cancel flag (new event starting)
-                {
-                    Preferences cancelPrefs;
-                    if (cancelPrefs.begin("helloclub", false)) {
-                        cancelPrefs.remove("evt_cancel");
-                        cancelPrefs.end();
-                    }
-                }
-
-                // Broadcast auto-start notification
-                StaticJsonDocument<512> startDoc;
-                startDoc["event"] = "event_auto_started";
-                startDoc["eventName"] = evt->name;
-                startDoc["durationMin"] = evt->durationMin;
-                startDoc["eventEndTime"] = (long)activeEventEndTime;
-                String output;
-                serializeJson(startDoc, output);
-                ws.textAll(output);
-
-                sendStateUpdate();
-                remoteLog("Timer auto-started by HC event");
-            } else if (evt && ts != IDLE && ts != FINISHED) {
-                remoteLog("HC trigger BLOCKED: timer in %s state",
-                          ts == RUNNING ? "RUNNING" : "PAUSED");
-            } else if (!evt && evtCount > 0) {
-                remoteLog("HC trigger: no event in window (%d cached)", evtCount);
+            // Only log the check when its inputs change — every 30s is noise
+            static int lastLoggedCount = -1;
+            static bool lastLoggedNtp = false;
+            static TimerState lastLoggedState = IDLE;
+            if (evtCount != lastLoggedCount || ntpOk != lastLoggedNtp || ts != lastLoggedState) {
+                lastLoggedCount = evtCount;
+                lastLoggedNtp = ntpOk;
+                lastLoggedState = ts;
+                remoteLog("HC check: enabled=%d ntp=%d events=%d timer=%s now=%ld",
+                          helloClubEnabled ? 1 : 0, ntpOk ? 1 : 0, evtCount,
+                          ts == IDLE ? "IDLE" : ts == FINISHED ? "FINISHED" : ts == RUNNING ? "RUNNING" : "PAUSED",
+                          (long)now);
             }
 
+            runHelloClubAutoTrigger();
+
             // Purge expired events AFTER trigger check
-            helloClubClient.purgeExpired(myTZ);
+            helloClubClient.purgeExpired();
         }
+        armHelloClubStart();
     }
 
     // Event window enforcement — hard cutoff
     if (activeEventEndTime > 0 &&
         (timer.getState() == RUNNING || timer.getState() == PAUSED)) {
-        time_t now = UTC.now();
+        time_t now = timeNow();
         if (now >= activeEventEndTime) {
             timer.reset();
             siren.stop();
@@ -778,7 +764,7 @@ void loop() {
             cutoffDoc["eventName"] = activeEventName;
             String output;
             serializeJson(cutoffDoc, output);
-            ws.textAll(output);
+            broadcast(output);
 
             DEBUG_PRINTF("Event cutoff: %s\n", activeEventName.c_str());
             activeEventEndTime = 0;
@@ -789,6 +775,14 @@ void loop() {
         }
     }
 
+    // One-minute warning requested by the active HC event's timer: tag
+    if (activeEventEndTime > 0 && activeEventWarn && timer.getState() == RUNNING &&
+        timer.getGameDuration() > 60000 && timer.getMainTimerRemaining() <= 60000 &&
+        activeEventWarnedRound != timer.getCurrentRound()) {
+        activeEventWarnedRound = timer.getCurrentRound();
+        if (sirenAllowed()) siren.start(1);
+    }
+
     // Update timer state
     if (timer.update()) {
         if (timer.hasRoundEnded()) {
@@ -797,8 +791,10 @@ void loop() {
                 sendEvent("finished");
                 DEBUG_PRINTLN("Match completed! All rounds finished.");
             } else {
-                // Round ended — siren fires
-                if (sirenAllowed()) siren.start(2);
+                // Round ended — siren fires (HC events may set their own pattern)
+                int blasts = (activeEventEndTime > 0 && activeEventSirenBlasts > 0)
+                    ? activeEventSirenBlasts : 2;
+                if (sirenAllowed()) siren.start(blasts);
 
                 if (timer.getState() == PAUSED) {
                     // pauseAfterNext triggered — tell clients we're paused
@@ -809,7 +805,7 @@ void loop() {
                     pauseDoc["numRounds"] = timer.getNumRounds();
                     String output;
                     serializeJson(pauseDoc, output);
-                    ws.textAll(output);
+                    broadcast(output);
                 } else {
                     // Normal next round
                     StaticJsonDocument<256> roundDoc;
@@ -821,13 +817,56 @@ void loop() {
                     roundDoc["continuousMode"] = timer.getContinuousMode();
                     String output;
                     serializeJson(roundDoc, output);
-                    ws.textAll(output);
+                    broadcast(output);
                 }
             }
             sendStateUpdate();
         }
     }
 
+    // Idle viewer streams would otherwise carry nothing between state changes
+    static unsigned long lastEventsKeepalive = 0;
+    if (millis() - lastEventsKeepalive >= SSE_KEEPALIVE_MS) {
+        lastEventsKeepalive = millis();
+        if (events.count() > 0) {
+            events.send("{}", "keepalive");
+        }
+    }
+
+    // LAN displays: one UDP packet per change or heartbeat
+    beaconLoop(timer);
+
+    // Clock offset pings, each client as it falls due: pick them under the
+    // lock, send outside it
+    std::vector<uint32_t> pingIds;
+    {
+        ClientClocksLock lock;
+        uint32_t now = clockMillis();
+        for (auto& entry : clientClocks) {
+            if (entry.second.pingDue(now)) {
+                pingIds.push_back(entry.first);
+            }
+        }
+    }
+    for (uint32_t id : pingIds) {
+        AsyncWebSocketClient *pingClient = ws.client(id);
+        if (!pingClient || !pingClient->canSend()) {
+            continue;
+        }
+        uint32_t now = clockMillis();
+        {
+            ClientClocksLock lock;
+            auto clock = clientClocks.find(id);
+            if (clock == clientClocks.end()) {
+                continue;   // Disconnected meanwhile
+            }
+            clock->second.pingSent(now);    // Before the send: the pong can't beat it
+        }
+        char ping[48];
+        snprintf(ping, sizeof(ping), "{\"event\":\"time_ping\",\"t\":%lu}", (unsigned long)now);
+        pingClient->text(ping);
+    }
+
     // Periodic sync broadcast
     if (timer.getState() == RUNNING) {
         unsigned long now = millis();
@@ -842,61 +881,31 @@ void loop() {
 // --- Core Functions ---
 // ==========================================================================
 
-bool connectToKnownWiFi() {
-    Serial.println("Trying to connect to a known WiFi network...");
-    WiFi.mode(WIFI_STA);
-    WiFi.setAutoReconnect(true);
+// Once per boot, on the first WiFi connection
+void startNetworkServices() {
+    networkServicesStarted = true;
+    bootPhaseEnd(BOOT_PHASE_WIFI);
 
-    bootLog("WiFi: Scanning for networks...");
-    int numFound = WiFi.scanNetworks();
-    bootLog("WiFi: Scan found %d networks", numFound);
-    for (int i = 0; i < numFound; i++) {
-        bootLog("  %d: '%s' RSSI:%d Ch:%d %s", i + 1,
-            WiFi.SSID(i).c_str(), WiFi.RSSI(i), WiFi.channel(i),
-            WiFi.encryptionType(i) == WIFI_AUTH_OPEN ? "OPEN" : "ENCRYPTED");
-    }
-    WiFi.scanDelete();
-
-    for (size_t i = 0; i < known_networks_count; i++) {
-        const WiFiCredential& cred = known_networks[i];
-        bootLog("WiFi: Trying '%s' (attempt 1/1)", cred.ssid);
-
-        WiFi.disconnect(true);
-        delay(200);
-
-        if (strlen(cred.password) > 0) {
-            WiFi.begin(cred.ssid, cred.password);
-        } else {
-            WiFi.begin(cred.ssid);
-        }
+    bootLog("WiFi: CONNECTED to '%s' IP: %s RSSI: %d dBm",
+        WiFi.SSID().c_str(), WiFi.localIP().toString().c_str(), WiFi.RSSI());
+    serialLog.println("Connected to WiFi!");
+    serialLog.print("IP Address: ");
+    serialLog.println(WiFi.localIP());
 
-        unsigned long startAttemptTime = millis();
-        while (WiFi.status() != WL_CONNECTED && millis() - startAttemptTime < 15000) {
-            esp_task_wdt_reset();
-            delay(500);
-            Serial.print(".");
-        }
-        Serial.println();
+    bootPhaseBegin(BOOT_PHASE_OTA);
+    setupOTA();
+    bootPhaseEnd(BOOT_PHASE_OTA);
 
-        if (WiFi.status() == WL_CONNECTED) {
-            bootLog("WiFi: Connected to '%s' IP: %s", cred.ssid, WiFi.localIP().toString().c_str());
-            return true;
-        } else {
-            int status = WiFi.status();
-            const char* statusStr;
-            switch(status) {
-                case WL_NO_SSID_AVAIL: statusStr = "NO_SSID_AVAIL"; break;
-                case WL_CONNECT_FAILED: statusStr = "CONNECT_FAILED"; break;
-                case WL_CONNECTION_LOST: statusStr = "CONNECTION_LOST"; break;
-                case WL_DISCONNECTED: statusStr = "DISCONNECTED"; break;
-                case WL_IDLE_STATUS: statusStr = "IDLE"; break;
-                default: statusStr = "UNKNOWN"; break;
-            }
-            bootLog("WiFi: '%s' FAILED - status: %d (%s)", cred.ssid, status, statusStr);
-            WiFi.disconnect(true);
-        }
+    bootPhaseBegin(BOOT_PHASE_MDNS);
+    if (!MDNS.begin(MDNS_HOSTNAME)) {
+        serialLog.println("Error setting up MDNS responder!");
     }
-    return false;
+    MDNS.addService("http", "tcp", 80);
+    bootPhaseEnd(BOOT_PHASE_MDNS);
+
+    // The clock may only be the one kept across a reset: sync now
+    bootPhaseBegin(BOOT_PHASE_NTP);
+    timeStartSync();
 }
 
 // ==========================================================================
@@ -904,12 +913,12 @@ bool connectToKnownWiFi() {
 // ==========================================================================
 
 String getFormattedTime12Hour() {
-    return myTZ.dateTime("h:i:s a");
+    return timeLocal().clock12;
 }
 
 bool sirenAllowed() {
     if (activeEventEndTime == 0) return true;
-    time_t now = UTC.now();
+    time_t now = timeNow();
     return now < activeEventEndTime;
 }
 
@@ -917,15 +926,25 @@ bool sirenAllowed() {
 // --- WebSocket Communication ---
 // ==========================================================================
 
+// Every notification goes to all WebSocket clients and viewer streams.
+// The JSON is serialized once; the event source frames it once and queues
+// the same buffer to each stream.
+void broadcast(const String& json) {
+    ws.textAll(json);
+    if (events.count() > 0) {
+        events.send(json.c_str());
+    }
+}
+
 void sendEvent(const String& type) {
     StaticJsonDocument<256> doc;
     doc["event"] = type;
     String output;
     serializeJson(doc, output);
-    ws.textAll(output);
+    broadcast(output);
 }
 
-void sendStateUpdate(AsyncWebSocketClient *client) {
+String stateJson() {
     StaticJsonDocument<512> doc;
     doc["event"] = "state";
     JsonObject state = doc.createNestedObject("state");
@@ -950,16 +969,7 @@ void sendStateUpdate(AsyncWebSocketClient *client) {
     // Include next auto-trigger event info
     if (helloClubEnabled && helloClubClient.isConfigured()) {
         state["autoEnabled"] = true;
-        const auto& cachedEvents = helloClubClient.getCachedEvents();
-        time_t now = UTC.now();
-        const CachedEvent* nextEvt = nullptr;
-        for (const auto& evt : cachedEvents) {
-            if (!evt.triggered && evt.startTime > now) {
-                if (!nextEvt || evt.startTime < nextEvt->startTime) {
-                    nextEvt = &evt;
-                }
-            }
-        }
+        const CachedEvent* nextEvt = helloClubClient.getNextEvent(timeNow() + 1);
         if (nextEvt) {
             state["nextEventName"] = nextEvt->name;
             state["nextEventStart"] = (long)nextEvt->startTime;
@@ -968,14 +978,18 @@ void sendStateUpdate(AsyncWebSocketClient *client) {
 
     String output;
     serializeJson(doc, output);
+    return output;
+}
+
+void sendStateUpdate(AsyncWebSocketClient *client) {
     if (client) {
-        client->text(output);
+        client->text(stateJson());
     } else {
-        ws.textAll(output);
+        broadcast(stateJson());
     }
 }
 
-void sendSettingsUpdate(AsyncWebSocketClient *client) {
+String settingsJson() {
     StaticJsonDocument<512> doc;
     doc["event"] = "settings";
     JsonObject settingsObj = doc.createNestedObject("settings");
@@ -986,18 +1000,30 @@ void sendSettingsUpdate(AsyncWebSocketClient *client) {
 
     String output;
     serializeJson(doc, output);
+    return output;
+}
+
+void sendSettingsUpdate(AsyncWebSocketClient *client) {
     if (client) {
-        client->text(output);
+        client->text(settingsJson());
     } else {
-        ws.textAll(output);
+        broadcast(settingsJson());
     }
 }
 
-void sendSync(AsyncWebSocketClient *client) {
+// With a WebSocket client, the frame carries that client's clock offset
+String syncJson(AsyncWebSocketClient *client) {
     StaticJsonDocument<512> syncDoc;
     syncDoc["event"] = "sync";
     syncDoc["mainTimerRemaining"] = timer.getMainTimerRemaining();
-    syncDoc["serverMillis"] = millis();
+    syncDoc["serverMillis"] = clockMillis();
+    if (client) {
+        ClientClocksLock lock;
+        auto clock = clientClocks.find(client->id());
+        if (clock != clientClocks.end() && clock->second.valid()) {
+            syncDoc["clockOffsetMs"] = clock->second.offsetMs();
+        }
+    }
     syncDoc["currentRound"] = timer.getCurrentRound();
     syncDoc["numRounds"] = timer.getNumRounds();
     syncDoc["status"] = (timer.getState() == PAUSED) ? "PAUSED" : "RUNNING";
@@ -1010,11 +1036,32 @@ void sendSync(AsyncWebSocketClient *client) {
 
     String output;
     serializeJson(syncDoc, output);
+    return output;
+}
 
+void sendSync(AsyncWebSocketClient *client) {
     if (client) {
-        client->text(output);
-    } else {
-        ws.textAll(output);
+        client->text(syncJson(client));
+        return;
+    }
+    // Each WebSocket client gets its own clock offset; viewer streams share
+    // one frame without
+    std::vector<uint32_t> ids;
+    {
+        ClientClocksLock lock;
+        ids.reserve(clientClocks.size());
+        for (auto& entry : clientClocks) {
+            ids.push_back(entry.first);
+        }
+    }
+    for (uint32_t id : ids) {
+        AsyncWebSocketClient *syncClient = ws.client(id);
+        if (syncClient) {
+            syncClient->text(syncJson(syncClient));
+        }
+    }
+    if (events.count() > 0) {
+        events.send(syncJson(nullptr).c_str());
     }
 }
 
@@ -1042,54 +1089,122 @@ void sendAuthRequest(AsyncWebSocketClient *client) {
     client->text(output);
 }
 
-void sendNTPStatus(AsyncWebSocketClient *client) {
+String ntpStatusJson() {
     StaticJsonDocument<512> doc;
     doc["event"] = "ntp_status";
 
-    bool synced = (myTZ.year() > 2020 && myTZ.year() < 2100 &&
-                   myTZ.month() >= 1 && myTZ.month() <= 12 &&
-                   myTZ.day() >= 1 && myTZ.day() <= 31);
+    bool synced = timeValid();
 
     doc["synced"] = synced;
     doc["time"] = synced ? getFormattedTime12Hour() : "Not synced";
 
     if (synced) {
         doc["timezone"] = settings.getTimezone();
-        doc["dateTime"] = myTZ.dateTime("Y-m-d H:i:s");
-        doc["autoSyncInterval"] = 30;
+        doc["dateTime"] = timeLocal().dateTime;
+        doc["autoSyncInterval"] = TIME_SYNC_INTERVAL_MS / 60000;
+
+        const TimeSyncStats& sync = timeSyncStats();
+        doc["source"] = sync.source;
+        doc["offsetMs"] = sync.offsetMs;
+        doc["rttMs"] = sync.rttMs;
+        doc["lastSyncAge"] = sync.lastSyncMs ? (long)((millis() - sync.lastSyncMs) / 1000) : -1L;
     }
 
     String output;
     serializeJson(doc, output);
+    return output;
+}
 
+void sendNTPStatus(AsyncWebSocketClient *client) {
     if (client) {
-        client->text(output);
+        client->text(ntpStatusJson());
     } else {
-        ws.textAll(output);
+        broadcast(ntpStatusJson());
     }
 }
 
 void checkAndBroadcastNTPStatus() {
     unsigned long now = millis();
 
-    if (now - lastNTPStatusCheck < NTP_CHECK_INTERVAL) {
+    if (lastNTPStatusCheck != 0 && now - lastNTPStatusCheck < NTP_CHECK_INTERVAL) {
         return;
     }
 
     lastNTPStatusCheck = now;
 
-    bool currentSyncStatus = (myTZ.year() > 2020 && myTZ.year() < 2100 &&
-                              myTZ.month() >= 1 && myTZ.month() <= 12 &&
-                              myTZ.day() >= 1 && myTZ.day() <= 31);
+    bool currentSyncStatus = timeValid();
 
     if (currentSyncStatus != lastNTPSyncStatus) {
         lastNTPSyncStatus = currentSyncStatus;
         remoteLog("NTP sync: %s time=%s", currentSyncStatus ? "OK" : "LOST",
-                  currentSyncStatus ? myTZ.dateTime("Y-m-d H:i:s").c_str() : "n/a");
+                  currentSyncStatus ? timeLocal().dateTime : "n/a");
         sendNTPStatus(nullptr);
     }
 }
 
+void serviceRemoteLogReaders() {
+    RemoteLogRequest req;
+    while (remoteLogRequestQueue && xQueueReceive(remoteLogRequestQueue, &req, 0) == pdTRUE) {
+        if (req.request) {
+            RemoteLogReader& reader = remoteLogReaders[req.clientId];
+            reader.cursor = req.since;
+            reader.requested = true;
+            if (req.subscribe >= 0) {
+                reader.subscribed = req.subscribe != 0;
+            }
+        } else {
+            auto it = remoteLogReaders.find(req.clientId);
+            if (it != remoteLogReaders.end()) {
+                it->second.subscribed = false;
+            }
+        }
+    }
+    if (remoteLogReaders.empty()) {
+        return;
+    }
+    static char buf[RLOG_JSON_BUF_SIZE];
+    static unsigned long lastPush = 0;
+    bool pushDue = millis() - lastPush >= RLOG_PUSH_INTERVAL_MS;
+    if (pushDue) {
+        lastPush = millis();
+    }
+    uint32_t seq = remoteLogGetSeq();
+
+    for (auto it = remoteLogReaders.begin(); it != remoteLogReaders.end(); ) {
+        RemoteLogReader& reader = it->second;
+        AsyncWebSocketClient *client = ws.client(it->first);
+        auto role = authenticatedClients.find(it->first);
+        if (!client || role == authenticatedClients.end() || role->second < ADMIN ||
+            (!reader.subscribed && !reader.requested && !reader.backlog)) {
+            it = remoteLogReaders.erase(it);
+            continue;
+        }
+        bool due = reader.requested || reader.backlog ||
+                   (reader.subscribed && pushDue && reader.cursor != seq);
+        if (!due || !client->canSend()) {
+            ++it;
+            continue;
+        }
+
+        size_t len = remoteLogWriteJson(buf, sizeof(buf), reader.cursor, &reader.backlog);
+        if (reader.requested) {
+            // Answer to an explicit request: newest trace records ride along
+            reader.requested = false;
+            String output;
+            output.reserve(len + 2048);
+            buf[len - 1] = '\0';
+            output = buf;
+            output += ",\"trace\":";
+            output += traceGetJson(TRACE_JSON_MAX);
+            output += "}";
+            client->text(output);
+        } else {
+            client->text(buf, len);
+        }
+        ++it;
+    }
+}
+
 void sendUpcomingEvents(AsyncWebSocketClient *client) {
     const auto& events = helloClubClient.getCachedEvents();
 
@@ -1098,8 +1213,11 @@ void sendUpcomingEvents(AsyncWebSocketClient *client) {
     doc["lastSync"] = helloClubClient.getLastSyncTime();
     doc["enabled"] = helloClubEnabled;
 
+    // Cache holds up to HELLOCLUB_DAYS_AHEAD days of events — only send the soonest
+    // (cache is kept in startTime order)
     JsonArray eventsArr = doc.createNestedArray("events");
     for (const auto& evt : events) {
+        if (eventsArr.size() >= HELLOCLUB_MAX_BROADCAST_EVENTS) break;
         JsonObject obj = eventsArr.createNestedObject();
         obj["id"] = evt.id;
         obj["name"] = evt.name;
@@ -1108,6 +1226,12 @@ void sendUpcomingEvents(AsyncWebSocketClient *client) {
         obj["durationMin"] = evt.durationMin;
         obj["numRounds"] = evt.numRounds;
         obj["triggered"] = evt.triggered;
+        // Optional timer: tag directives — only sent when set
+        if (evt.warmupMin) obj["warmupMin"] = evt.warmupMin;
+        if (evt.breakSec) obj["breakSec"] = evt.breakSec;
+        if (evt.sirenBlasts) obj["sirenBlasts"] = evt.sirenBlasts;
+        if (evt.court) obj["court"] = evt.court;
+        if (evt.oneMinuteWarning) obj["oneMinuteWarning"] = true;
     }
 
     String output;
@@ -1116,11 +1240,14 @@ void sendUpcomingEvents(AsyncWebSocketClient *client) {
     if (client) {
         client->text(output);
     } else {
-        ws.textAll(output);
+        broadcast(output);
     }
 }
 
 void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocketClient *client) {
+    // Arrival time for clock offset pongs, before any parsing
+    uint32_t receivedAt = clockMillis();
+
     // Rate limiting
     unsigned long now = millis();
     uint32_t clientId = client->id();
@@ -1139,23 +1266,33 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocket
     rateLimit.messageCount++;
 
     if (rateLimit.messageCount > MAX_MESSAGES_PER_SECOND) {
-        Serial.printf("Rate limit exceeded for client #%u (%d msgs/sec)\n", clientId, rateLimit.messageCount);
+        serialLog.printf("Rate limit exceeded for client #%u (%d msgs/sec)\n", clientId, rateLimit.messageCount);
         sendError(client, "ERR_RATE_LIMIT: Too many requests. Please slow down.");
         return;
     }
 
-    clientLastActivity[clientId] = now;
-
     StaticJsonDocument<1024> doc;
     DeserializationError error = deserializeJson(doc, data, len);
     if (error) {
-        Serial.println(F("deserializeJson() failed"));
+        serialLog.println(F("deserializeJson() failed"));
         sendError(client, "ERR_INVALID_JSON: Invalid message format");
         return;
     }
 
     String action = doc["action"];
 
+    // Clock offset reply: automatic, so not session activity
+    if (action == "time_pong") {
+        ClientClocksLock lock;
+        auto clock = clientClocks.find(clientId);
+        if (clock != clientClocks.end()) {
+            clock->second.pong(doc["t"] | 0u, doc["c"] | 0u, receivedAt);
+        }
+        return;
+    }
+
+    clientLastActivity[clientId] = now;
+
     UserRole clientRole = VIEWER;
     if (authenticatedClients.find(client->id()) != authenticatedClients.end()) {
         clientRole = authenticatedClients[client->id()];
@@ -1255,7 +1392,7 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocket
             startDoc["pauseAfterNext"] = timer.getPauseAfterNext();
             String output;
             serializeJson(startDoc, output);
-            ws.textAll(output);
+            broadcast(output);
         }
     } else if (action == "pause") {
         if (timer.getState() == RUNNING) {
@@ -1265,7 +1402,7 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocket
             pauseDoc["mainTimerRemaining"] = timer.getMainTimerRemaining();
             String pauseOut;
             serializeJson(pauseDoc, pauseOut);
-            ws.textAll(pauseOut);
+            broadcast(pauseOut);
         } else if (timer.getState() == PAUSED) {
             timer.resume();
             StaticJsonDocument<256> resumeDoc;
@@ -1273,16 +1410,15 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocket
             resumeDoc["mainTimerRemaining"] = timer.getMainTimerRemaining();
             String resumeOut;
             serializeJson(resumeDoc, resumeOut);
-            ws.textAll(resumeOut);
+            broadcast(resumeOut);
         }
     } else if (action == "reset") {
         // If resetting during an active HC event, persist cancel flag
         // so boot recovery won't re-trigger this event
         if (!activeEventId.isEmpty()) {
-            Preferences cancelPrefs;
-            if (cancelPrefs.begin("helloclub", false)) {
-                cancelPrefs.putString("evt_cancel", activeEventId);
-                cancelPrefs.end();
+            nvsStore.putString("helloclub", "evt_cancel", activeEventId);
+            if (!nvsStore.flush("helloclub")) {
+                remoteLog("Reset: cancel flag for %s not saved, retrying in background", activeEventId.c_str());
             }
             DEBUG_PRINTF("Reset during event %s — cancel flag saved\n", activeEventId.c_str());
         }
@@ -1301,7 +1437,7 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocket
         panDoc["enabled"] = enabled;
         String output;
         serializeJson(panDoc, output);
-        ws.textAll(output);
+        broadcast(output);
 
     } else if (action == "save_settings") {
         JsonObject settingsObj = doc["settings"];
@@ -1345,9 +1481,14 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocket
             return;
         }
 
+        if (!timeZoneKnown(timezone)) {
+            sendError(client, "Unknown timezone");
+            return;
+        }
+
         if (settings.setTimezone(timezone)) {
-            myTZ.setLocation(timezone);
-            Serial.printf("Timezone changed to: %s\n", timezone.c_str());
+            timeSetZone(timezone);
+            serialLog.printf("Timezone changed to: %s\n", timezone.c_str());
 
             StaticJsonDocument<256> successDoc;
             successDoc["event"] = "timezone_changed";
@@ -1441,12 +1582,9 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocket
         activeEventName = "";
         activeEventId = "";
         // Clear cancel flag
-        {
-            Preferences cancelPrefs;
-            if (cancelPrefs.begin("helloclub", false)) {
-                cancelPrefs.remove("evt_cancel");
-                cancelPrefs.end();
-            }
+        nvsStore.remove("helloclub", "evt_cancel");
+        if (!nvsStore.flush()) {
+            remoteLog("Factory reset: NVS commit failed, retrying in background");
         }
 
         StaticJsonDocument<256> resetDoc;
@@ -1454,7 +1592,7 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocket
         resetDoc["message"] = "System reset to factory defaults";
         String output;
         serializeJson(resetDoc, output);
-        ws.textAll(output);
+        broadcast(output);
 
         for (auto it = authenticatedClients.begin(); it != authenticatedClients.end();) {
             if (it->second != VIEWER) {
@@ -1478,28 +1616,61 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocket
         settingsDoc["apiKey"] = helloClubApiKey.isEmpty() ? "" : "***configured***";
         settingsDoc["enabled"] = helloClubEnabled;
         settingsDoc["defaultDuration"] = settings.getHcDefaultDuration();
+        settingsDoc["fetchCount"] = hcFetchCount;
+        settingsDoc["lastFetchMs"] = hcLastFetchMs;
+        settingsDoc["maxFetchMs"] = hcMaxFetchMs;
+        settingsDoc["webhookSecret"] = hcWebhookSecret.isEmpty() ? "" : "***configured***";
+        settingsDoc["pushCount"] = hcPushCount;
+        settingsDoc["pushLive"] = helloClubPushLive();
+        settingsDoc["startCount"] = hcStartCount;
+        settingsDoc["lastStartLateMs"] = hcLastStartLateMs;
         String output;
         serializeJson(settingsDoc, output);
         client->text(output);
 
     } else if (action == "save_helloclub_settings") {
+        String newApiKey = helloClubApiKey;
         if (doc.containsKey("apiKey")) {
-            String newApiKey = doc["apiKey"].as<String>();
-            if (!newApiKey.isEmpty() && newApiKey != "***configured***") {
-                helloClubApiKey = newApiKey;
+            String key = doc["apiKey"].as<String>();
+            if (!key.isEmpty() && key != "***configured***") {
+                newApiKey = key;
             }
         }
-        if (doc.containsKey("enabled")) {
-            helloClubEnabled = doc["enabled"].as<bool>();
+        if (newApiKey.length() > HELLOCLUB_API_KEY_MAX_LEN) {
+            sendError(client, "API key too long");
+            return;
         }
+        uint16_t newDuration = settings.getHcDefaultDuration();
         if (doc.containsKey("defaultDuration")) {
             uint16_t dur = doc["defaultDuration"].as<uint16_t>();
             if (dur >= 1 && dur <= 120) {
-                settings.setHcDefaultDuration(dur);
-                helloClubClient.setDefaults(dur, DEFAULT_NUM_ROUNDS);
+                newDuration = dur;
             }
         }
 
+        // The main loop hands the key to the client and drops a fetch
+        // started with the old one; nothing changes unless it's queued
+        HcControlRequest req = {};
+        req.op = HC_CONTROL_SETTINGS;
+        req.clientId = client->id();
+        req.defaultDuration = newDuration;
+        strlcpy(req.apiKey, newApiKey.c_str(), sizeof(req.apiKey));
+        if (!hcControlQueue || xQueueSend(hcControlQueue, &req, 0) != pdTRUE) {
+            sendError(client, "Busy, try again");
+            return;
+        }
+
+        helloClubApiKey = newApiKey;
+        settings.setHcDefaultDuration(newDuration);
+        if (doc.containsKey("enabled")) {
+            helloClubEnabled = doc["enabled"].as<bool>();
+        }
+        if (doc.containsKey("webhookSecret")) {
+            String newSecret = doc["webhookSecret"].as<String>();
+            if (newSecret != "***configured***") {
+                hcWebhookSecret = newSecret;  // Empty turns the webhook off
+            }
+        }
         saveHelloClubSettings();
 
         StaticJsonDocument<256> successDoc;
@@ -1510,24 +1681,12 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocket
         client->text(output);
 
     } else if (action == "helloclub_refresh") {
-        // Route through background task instead of blocking the main loop
-        if (hcFetchInProgress) {
-            sendError(client, "Sync already in progress");
-        } else {
-            remoteLog("HC manual refresh requested");
-            hcFetchInProgress = true;
-            hcFetchResultReady = false;
-            lastHelloClubPoll = 0; // Force immediate poll acceptance
-            xTaskCreatePinnedToCore(
-                hcFetchTask, "hcFetch", 8192, nullptr, 1, &hcFetchTaskHandle, 0
-            );
-            StaticJsonDocument<256> ackDoc;
-            ackDoc["event"] = "helloclub_refresh_result";
-            ackDoc["success"] = true;
-            ackDoc["message"] = "Sync started, events will update shortly...";
-            String output;
-            serializeJson(ackDoc, output);
-            client->text(output);
+        // Started (and answered) by the main loop, which owns the fetch state
+        HcControlRequest req = {};
+        req.op = HC_CONTROL_REFRESH;
+        req.clientId = client->id();
+        if (!hcControlQueue || xQueueSend(hcControlQueue, &req, 0) != pdTRUE) {
+            sendError(client, "Busy, try again");
         }
 
     // --- QR Config ---
@@ -1570,20 +1729,49 @@ void handleWebSocketMessage(void *arg, uint8_t *data, size_t len, AsyncWebSocket
 
     // --- Remote Diagnostic Log ---
 
-    } else if (action == "get_remote_log") {
-        String logJson = remoteLogGetAllJson();
-        client->text(logJson);
+    } else if (action == "get_remote_log" || action == "remote_log_unsubscribe") {
+        // get_remote_log: entries from "since" onward (everything held if
+        // omitted), answered from the main loop in batches; "subscribe" turns
+        // pushes of new entries on or off and is left unchanged when absent
+        RemoteLogRequest req = {};
+        req.clientId = client->id();
+        req.request = action == "get_remote_log";
+        req.since = doc["since"] | 0u;
+        req.subscribe = !req.request ? 0 : doc.containsKey("subscribe") ? (doc["subscribe"] ? 1 : 0) : -1;
+        if (!remoteLogRequestQueue || xQueueSend(remoteLogRequestQueue, &req, 0) != pdTRUE) {
+            sendError(client, "Busy, try again");
+        }
     }
 }
 
 
+// A viewer stream gets the same snapshot a WebSocket viewer gets at connect,
+// without the login prompt, then every broadcast
+void onEventsConnect(AsyncEventSourceClient *client) {
+    if (events.count() > MAX_SSE_CLIENTS) {
+        client->close();
+        return;
+    }
+    client->send(settingsJson().c_str(), nullptr, 0, SSE_RETRY_MS);
+    if (timer.getState() == RUNNING || timer.getState() == PAUSED) {
+        client->send(syncJson(nullptr).c_str());
+    } else {
+        client->send(stateJson().c_str());
+    }
+    client->send(ntpStatusJson().c_str());
+}
+
 void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type, void *arg, uint8_t *data, size_t len) {
     switch(type) {
         case WS_EVT_CONNECT: {
-            Serial.printf("WebSocket client #%u connected from %s\n", client->id(), client->remoteIP().toString().c_str());
+            serialLog.printf("WebSocket client #%u connected from %s\n", client->id(), client->remoteIP().toString().c_str());
             authenticatedClients[client->id()] = VIEWER;
             clientRateLimits[client->id()] = {millis(), 0};
             clientLastActivity[client->id()] = millis();
+            {
+                ClientClocksLock lock;
+                clientClocks[client->id()] = ClientClock();
+            }
             StaticJsonDocument<256> loginDoc;
             loginDoc["event"] = "login_prompt";
             loginDoc["message"] = "Welcome! Login for full access or continue as viewer.";
@@ -1601,11 +1789,15 @@ void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventTyp
         }
 
         case WS_EVT_DISCONNECT:
-            Serial.printf("WebSocket client #%u disconnected\n", client->id());
+            serialLog.printf("WebSocket client #%u disconnected\n", client->id());
             authenticatedClients.erase(client->id());
             authenticatedUsernames.erase(client->id());
             clientRateLimits.erase(client->id());
             clientLastActivity.erase(client->id());
+            {
+                ClientClocksLock lock;
+                clientClocks.erase(client->id());
+            }
             break;
 
         case WS_EVT_DATA:
@@ -1613,7 +1805,7 @@ void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventTyp
             break;
 
         case WS_EVT_ERROR:
-            Serial.printf("WebSocket client #%u error\n", client->id());
+            serialLog.printf("WebSocket client #%u error\n", client->id());
             break;
 
         case WS_EVT_PONG:
@@ -1647,6 +1839,10 @@ void setupOTA() {
     })
     .onEnd([]() {
       DEBUG_PRINTLN("\nOTA Update complete");
+      // ArduinoOTA restarts right after this: no later retry
+      if (!nvsStore.flush()) {
+          DEBUG_PRINTLN("OTA: NVS commit failed, pending settings lost");
+      }
     })
     .onProgress([](unsigned int progress, unsigned int total) {
       DEBUG_PRINTF("Progress: %u%%\r", (progress / (total / 100)));
@@ -1739,38 +1935,409 @@ void loadHelloClubSettings() {
     if (prefs.begin("helloclub", true)) {
         helloClubApiKey = prefs.getString("apiKey", "");
         helloClubEnabled = prefs.getBool("enabled", false);
+        hcWebhookSecret = prefs.getString("whSecret", "");
         prefs.end();
 
         DEBUG_PRINTLN("Hello Club settings loaded:");
         DEBUG_PRINTF("  Enabled: %s\n", helloClubEnabled ? "Yes" : "No");
 
         helloClubClient.setApiKey(helloClubApiKey);
-        remoteLog("HC settings: enabled=%d key=%s",
+        remoteLog("HC settings: enabled=%d key=%s webhook=%s",
                   helloClubEnabled ? 1 : 0,
-                  helloClubApiKey.isEmpty() ? "none" : "set");
+                  helloClubApiKey.isEmpty() ? "none" : "set",
+                  hcWebhookSecret.isEmpty() ? "off" : "on");
     }
 }
 
 void saveHelloClubSettings() {
-    Preferences prefs;
-    if (prefs.begin("helloclub", false)) {
-        prefs.putString("apiKey", helloClubApiKey);
-        prefs.putBool("enabled", helloClubEnabled);
-        prefs.end();
+    nvsStore.putString("helloclub", "apiKey", helloClubApiKey);
+    nvsStore.putBool("helloclub", "enabled", helloClubEnabled);
+    nvsStore.putString("helloclub", "whSecret", hcWebhookSecret);
 
-        DEBUG_PRINTLN("Hello Club settings saved");
-        helloClubClient.setApiKey(helloClubApiKey);
+    DEBUG_PRINTLN("Hello Club settings saved");
+}
+
+// FreeRTOS task: long-lived Hello Club worker on the protocol core. Blocks on
+// the request queue, runs one fetch per request and posts the result back.
+// Every request gets exactly one result, cancelled or not, so the main loop
+// can always clear hcFetchPending.
+void hcWorkerTask(void* param) {
+    for (;;) {
+        HcFetchJob job;
+        if (xQueueReceive(hcRequestQueue, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        HcFetchResult result = {};
+        result.request = job.request;
+        unsigned long startMs = millis();
+        if (helloClubClient.isCancelRequested()) {
+            result.cancelled = true;
+        } else {
+            result.success = helloClubClient.fetchAndCacheEvents(HELLOCLUB_DAYS_AHEAD, job.apiKey);
+            result.cancelled = helloClubClient.isCancelRequested();
+        }
+        result.durationMs = millis() - startMs;
+
+        xQueueSend(hcResultQueue, &result, portMAX_DELAY);
+    }
+}
+
+void startHelloClubWorker() {
+    hcRequestQueue = xQueueCreate(1, sizeof(HcFetchJob));
+    hcResultQueue = xQueueCreate(1, sizeof(HcFetchResult));
+    hcPushQueue = xQueueCreate(HELLOCLUB_PUSH_QUEUE_DEPTH, sizeof(HcEventChange));
+    hcControlQueue = xQueueCreate(HELLOCLUB_CONTROL_QUEUE_DEPTH, sizeof(HcControlRequest));
+    if (!hcRequestQueue || !hcResultQueue) {
+        remoteLog("HC worker: queue allocation failed");
+        return;
+    }
+
+    // Created once at boot, before the heap is fragmented by WiFi/TLS buffers
+    if (xTaskCreatePinnedToCore(hcWorkerTask, "hcWorker", HELLOCLUB_WORKER_STACK_SIZE, nullptr,
+                                HELLOCLUB_WORKER_PRIORITY, &hcWorkerTaskHandle,
+                                HELLOCLUB_WORKER_CORE) != pdPASS) {
+        hcWorkerTaskHandle = nullptr;
+        remoteLog("HC worker: task creation failed");
+    }
+}
+
+// Post a fetch request to the worker (main loop only). Returns false if a
+// request is already outstanding or the worker isn't running. The queue
+// holds one request, so a refresh that arrives mid-fetch is remembered in
+// hcRefreshQueued instead (see startQueuedHelloClubRefresh()).
+bool requestHelloClubFetch(HcFetchRequest request) {
+    if (hcFetchPending || !hcWorkerTaskHandle) {
+        return false;
+    }
+
+    HcFetchJob job;
+    job.request = request;
+    strlcpy(job.apiKey, helloClubClient.getApiKey().c_str(), sizeof(job.apiKey));
+    helloClubClient.clearCancel();
+    if (xQueueSend(hcRequestQueue, &job, 0) != pdTRUE) {
+        return false;
     }
+    hcFetchPending = true;
+    return true;
 }
 
-// FreeRTOS task: runs Hello Club HTTP fetch on a background core
-void hcFetchTask(void* param) {
-    bool success = helloClubClient.fetchAndCacheEvents(HELLOCLUB_DAYS_AHEAD, myTZ);
-    hcFetchResultSuccess = success;
-    hcFetchResultReady = true;
-    hcFetchInProgress = false;
-    hcFetchTaskHandle = nullptr;
-    vTaskDelete(nullptr); // Self-delete
+void sendHelloClubRefreshResult(uint32_t clientId, bool success, const char* message) {
+    AsyncWebSocketClient *client = ws.client(clientId);
+    if (!client) {
+        return;
+    }
+    StaticJsonDocument<256> ackDoc;
+    ackDoc["event"] = "helloclub_refresh_result";
+    ackDoc["success"] = success;
+    ackDoc["message"] = message;
+    String output;
+    serializeJson(ackDoc, output);
+    client->text(output);
+}
+
+// Refresh and settings requests from the WebSocket handler (main loop only)
+void checkHelloClubControl() {
+    HcControlRequest req;
+    while (hcControlQueue && xQueueReceive(hcControlQueue, &req, 0) == pdTRUE) {
+        if (req.op == HC_CONTROL_SETTINGS) {
+            helloClubClient.setApiKey(req.apiKey);
+            helloClubClient.setDefaults(req.defaultDuration, DEFAULT_NUM_ROUNDS);
+            // A fetch already in flight was started with the old key/state — drop it
+            if (hcFetchPending) {
+                cancelHelloClubFetch();
+                lastHelloClubPoll = 0;
+            }
+        } else if (hcFetchPending) {
+            // The outstanding fetch may have read the API before the change
+            // being refreshed for — run another as soon as it completes
+            hcRefreshQueued = true;
+            remoteLog("HC manual refresh queued (fetch in progress)");
+            sendHelloClubRefreshResult(req.clientId, true,
+                                       "Sync in progress, refreshing again when it finishes...");
+        } else if (inFetchGuardWindow()) {
+            // Next poll check picks it up once the siren moment has passed
+            remoteLog("HC manual refresh deferred (guard window)");
+            lastHelloClubPoll = 0;
+            sendHelloClubRefreshResult(req.clientId, true,
+                                       "Sync deferred until after the siren, events will update shortly...");
+        } else {
+            remoteLog("HC manual refresh requested");
+            bool queued = requestHelloClubFetch(HC_FETCH_REFRESH);
+            sendHelloClubRefreshResult(req.clientId, queued,
+                                       queued ? "Sync started, events will update shortly..."
+                                              : "Sync worker unavailable");
+        }
+    }
+}
+
+// Run the manual refresh queued during the fetch that just completed
+// (main loop only). Near a siren it waits for the next poll check instead.
+void startQueuedHelloClubRefresh() {
+    if (!hcRefreshQueued) {
+        return;
+    }
+    hcRefreshQueued = false;
+    if (inFetchGuardWindow()) {
+        remoteLog("HC queued refresh deferred (guard window)");
+        lastHelloClubPoll = 0;
+        return;
+    }
+    if (requestHelloClubFetch(HC_FETCH_REFRESH)) {
+        remoteLog("HC queued refresh started");
+    }
+}
+
+// Stop the outstanding fetch at its next page boundary. The worker still
+// posts a (cancelled) result, which clears hcFetchPending as usual.
+void cancelHelloClubFetch() {
+    if (hcFetchPending) {
+        helloClubClient.requestCancel();
+        remoteLog("HC fetch: cancel requested");
+    }
+}
+
+// POST /hc/webhook — runs on the web server task. Verifies the HMAC, parses
+// the change and queues it for the main loop; never touches the cache here.
+// X-HC-Timestamp is epoch seconds; X-HC-Signature is hex HMAC-SHA256 of
+// "<timestamp>.<body>" with the webhook secret.
+void handleHelloClubWebhook(AsyncWebServerRequest *request) {
+    if (!helloClubEnabled || hcWebhookSecret.isEmpty()) {
+        request->send(404, "text/plain", "Webhook disabled");
+        return;
+    }
+    if (request->contentLength() > HELLOCLUB_WEBHOOK_MAX_BODY) {
+        request->send(413, "text/plain", "Body too large");
+        return;
+    }
+    const char* body = (const char*)request->_tempObject;
+    if (!body) {
+        request->send(400, "text/plain", "Missing body");
+        return;
+    }
+
+    const AsyncWebHeader* tsHeader = request->getHeader("X-HC-Timestamp");
+    const AsyncWebHeader* sigHeader = request->getHeader("X-HC-Signature");
+    if (!tsHeader || !sigHeader) {
+        request->send(401, "text/plain", "Missing signature");
+        return;
+    }
+    // Replay window — only enforceable once NTP has set the clock, so refuse
+    // (the relay retries) until then; the cache needs NTP to fetch anyway
+    if (!timeValid()) {
+        request->send(503, "text/plain", "Clock not set");
+        return;
+    }
+    long skew = (long)(timeNow() - (time_t)tsHeader->value().toInt());
+    if (skew > HELLOCLUB_WEBHOOK_MAX_SKEW_SEC || skew < -HELLOCLUB_WEBHOOK_MAX_SKEW_SEC) {
+        request->send(401, "text/plain", "Stale timestamp");
+        return;
+    }
+    if (!HelloClubClient::verifySignature(hcWebhookSecret, tsHeader->value().c_str(),
+                                          (const uint8_t*)body, request->contentLength(),
+                                          sigHeader->value().c_str())) {
+        request->send(401, "text/plain", "Bad signature");
+        return;
+    }
+
+    HcEventChange change;
+    const char* error = "";
+    if (!helloClubClient.parseEventChange(body, request->contentLength(), change, error)) {
+        request->send(400, "text/plain", error);
+        return;
+    }
+    // Full queue: tell the relay to retry rather than dropping the change
+    if (!hcPushQueue || xQueueSend(hcPushQueue, &change, 0) != pdTRUE) {
+        request->send(503, "text/plain", "Busy");
+        return;
+    }
+    request->send(202, "application/json", "{\"queued\":true}");
+}
+
+// Apply queued webhook changes (main loop only)
+void checkHelloClubPush() {
+    if (!hcPushQueue) {
+        return;
+    }
+
+    HcEventChange change;
+    bool changed = false;
+    while (xQueueReceive(hcPushQueue, &change, 0) == pdTRUE) {
+        hcPushCount++;
+        hcLastPushMs = millis();
+        if (change.op == HC_CHANGE_PING) {
+            continue;
+        }
+
+        if (helloClubClient.applyEventChange(change)) {
+            changed = true;
+        }
+        remoteLog("HC push: %s %s", change.op == HC_CHANGE_DELETE ? "delete" : "upsert", change.evt.id);
+
+        // The in-flight fetch may have read the API before this change
+        if (hcFetchPending && hcPushReplayCount < HELLOCLUB_PUSH_QUEUE_DEPTH) {
+            hcPushReplay[hcPushReplayCount++] = change;
+        }
+    }
+
+    if (changed) {
+        armHelloClubStart();
+        sendUpcomingEvents();
+        sendStateUpdate();
+    }
+}
+
+// Re-apply changes pushed during a fetch on top of that fetch's result
+void replayHelloClubPushes() {
+    for (int i = 0; i < hcPushReplayCount; i++) {
+        helloClubClient.applyEventChange(hcPushReplay[i]);
+    }
+    if (hcPushReplayCount > 0) {
+        remoteLog("HC push: replayed %d change(s) over fetch result", hcPushReplayCount);
+    }
+}
+
+// True while the relay has pushed or pinged recently
+bool helloClubPushLive() {
+    return hcPushCount > 0 && millis() - hcLastPushMs < HELLOCLUB_PUSH_FRESH_MS;
+}
+
+// Arm the auto-start deadline for the next untriggered event. Re-armed after
+// every schedule check and cache change, which also picks up NTP corrections.
+void armHelloClubStart() {
+    hcStartArmed = false;
+    if (!helloClubEnabled || !timeValid()) {
+        return;
+    }
+
+    int64_t nowMs = timeNowMs();
+    time_t after = (time_t)(nowMs / 1000);
+    if (after <= hcStartFiredFor) {
+        after = hcStartFiredFor + 1; // Already fired (started or blocked)
+    }
+    time_t next = helloClubClient.getNextEventStart(after);
+    if (next == 0) {
+        return;
+    }
+
+    int64_t untilMs = (int64_t)next * 1000 - nowMs;
+    hcStartDeadline = millis() + (unsigned long)(untilMs > 0 ? untilMs : 0);
+    hcStartArmedFor = next;
+    hcStartArmed = true;
+}
+
+// Start the timer for the event in its trigger window, if any. Called at the
+// armed deadline and from the 30-second check (catch-up after boot, or once
+// the timer frees up for an event whose start it was busy through).
+void runHelloClubAutoTrigger() {
+    TimerState ts = timer.getState();
+    CachedEvent* evt = helloClubClient.checkAutoTrigger();
+    if (evt && (ts == IDLE || ts == FINISHED)) {
+        remoteLog("HC AUTO-START: \"%s\" dur=%dmin rounds=%d",
+                  evt->name, evt->durationMin, evt->numRounds);
+
+        timer.setGameDuration(evt->durationMin * 60000UL);
+        if (evt->numRounds > 0) {
+            timer.setNumRounds(evt->numRounds);
+            timer.setContinuousMode(false);
+        } else {
+            timer.setContinuousMode(true);
+        }
+        // Start as if the timer had started exactly at startTime, so round
+        // boundaries land on startTime + k*duration however late we are
+        int64_t lateMs = timeNowMs() - (int64_t)evt->startTime * 1000;
+        unsigned int round = 1;
+        unsigned long remainingMs = 0;
+        if (!HelloClubClient::alignedStart(*evt, lateMs, round, remainingMs)) {
+            remoteLog("HC AUTO-START skipped: all rounds over (late=%ldms)", (long)lateMs);
+            helloClubClient.markTriggered(evt->id, evt->startTime);
+            return;
+        }
+        timer.startMidRound(round, remainingMs);
+        hcLastStartLateMs = (long)lateMs;
+        hcStartCount++;
+
+        helloClubClient.markTriggered(evt->id, evt->startTime);
+
+        // Set event window — for short bookings where endTime ≈ startTime,
+        // use the actual timer duration instead so the cutoff doesn't
+        // immediately kill the timer
+        time_t minEndTime = evt->startTime;
+        if (evt->numRounds > 0) {
+            minEndTime += (time_t)evt->numRounds * evt->durationMin * 60;
+        } else {
+            minEndTime += (time_t)evt->durationMin * 60;
+        }
+        activeEventEndTime = (evt->endTime > minEndTime) ? evt->endTime : minEndTime;
+        activeEventName = evt->name;
+        activeEventId = evt->id;
+        activeEventSirenBlasts = evt->sirenBlasts;
+        activeEventWarn = evt->oneMinuteWarning;
+        activeEventWarnedRound = 0;
+
+        // Clear any stale cancel flag (new event starting). Committed now
+        // together with the triggered bit: boot recovery depends on both.
+        nvsStore.remove("helloclub", "evt_cancel");
+        if (!nvsStore.flush("helloclub")) {
+            remoteLog("Auto-start: triggered flag not saved, retrying in background");
+        }
+
+        // Broadcast auto-start notification
+        StaticJsonDocument<512> startDoc;
+        startDoc["event"] = "event_auto_started";
+        startDoc["eventName"] = evt->name;
+        startDoc["durationMin"] = evt->durationMin;
+        startDoc["eventEndTime"] = (long)activeEventEndTime;
+        startDoc["startLateMs"] = hcLastStartLateMs;
+        String output;
+        serializeJson(startDoc, output);
+        broadcast(output);
+
+        sendStateUpdate();
+        remoteLog("Timer auto-started by HC event (round %u, %ldms late)", round, hcLastStartLateMs);
+    } else if (evt && ts != IDLE && ts != FINISHED) {
+        remoteLog("HC trigger BLOCKED: timer in %s state",
+                  ts == RUNNING ? "RUNNING" : "PAUSED");
+    }
+}
+
+// Pick the poll interval from what's coming up: dense polling in the hour
+// before a cached event (to catch late edits, unless the webhook relay is
+// live), back off when nothing is scheduled
+unsigned long getHelloClubPollInterval() {
+    if (lastHelloClubPollFailed) {
+        return HELLOCLUB_RETRY_INTERVAL_MS;
+    }
+
+    time_t now = timeNow();
+    time_t nextStart = helloClubClient.getNextEventStart(now);
+    if (nextStart == 0) {
+        return HELLOCLUB_IDLE_POLL_INTERVAL_MS;
+    }
+
+    // A live webhook relay already delivers late edits — no need to poll densely
+    if (!helloClubPushLive() &&
+        (unsigned long)(nextStart - now) * 1000UL <= HELLOCLUB_PRE_EVENT_WINDOW_MS) {
+        return HELLOCLUB_PRE_EVENT_INTERVAL_MS;
+    }
+    return HELLOCLUB_POLL_INTERVAL_MS;
+}
+
+// True if a round end or an event start is within HELLOCLUB_FETCH_GUARD_MS
+// (either side) — a fetch started now could stall the loop at the siren
+bool inFetchGuardWindow() {
+    if (timer.getState() == RUNNING) {
+        unsigned long remaining = timer.getMainTimerRemaining();
+        unsigned long elapsed = timer.getGameDuration() - remaining;
+        if (remaining <= HELLOCLUB_FETCH_GUARD_MS || elapsed <= HELLOCLUB_FETCH_GUARD_MS) {
+            return true;
+        }
+    }
+
+    time_t guardSec = HELLOCLUB_FETCH_GUARD_MS / 1000;
+    time_t now = timeNow();
+    time_t nextStart = helloClubClient.getNextEventStart(now - guardSec);
+    return nextStart > 0 && nextStart <= now + guardSec;
 }
 
 void checkHelloClubPoll() {
@@ -1778,53 +2345,89 @@ void checkHelloClubPoll() {
         return;
     }
 
-    if (!timeStatus()) {
+    if (!timeValid()) {
         remoteLog("HC poll: NTP not synced, skipping");
         return;
     }
 
-    // Check if background fetch completed — apply staged events on main loop
-    if (hcFetchResultReady) {
-        hcFetchResultReady = false;
-        unsigned long now = millis();
-        lastHelloClubPoll = now;
+    // Check if the worker finished — apply staged events on main loop
+    HcFetchResult result;
+    if (hcResultQueue && xQueueReceive(hcResultQueue, &result, 0) == pdTRUE) {
+        hcFetchPending = false;
+        hcFetchCount++;
+        hcLastFetchMs = result.durationMs;
+        if (result.durationMs > hcMaxFetchMs) {
+            hcMaxFetchMs = result.durationMs;
+        }
+        const char* kind = result.request == HC_FETCH_REFRESH ? "refresh" : "poll";
+
+        // A cancel that arrived after the worker posted still discards the result
+        if (result.cancelled || helloClubClient.isCancelRequested()) {
+            // Not a failure — poll again on the normal schedule
+            remoteLog("HC %s cancelled after %lums", kind, (unsigned long)result.durationMs);
+            hcPushReplayCount = 0;
+            startQueuedHelloClubRefresh();
+            return;
+        }
 
-        if (hcFetchResultSuccess) {
-            helloClubClient.applyStagedEvents();  // Safe: runs on main loop
+        lastHelloClubPoll = millis();
+        // Take the published result (events + error/debug) before reading it.
+        // Safe: runs on main loop
+        if (helloClubClient.applyStagedEvents()) {
+            replayHelloClubPushes();
+            armHelloClubStart();
+        }
+        hcPushReplayCount = 0;
+        if (result.success) {
             lastHelloClubPollFailed = false;
-            remoteLog("HC poll OK: %d events cached", helloClubClient.getEventCount());
+            remoteLog("HC %s OK: %d events cached (%lums)", kind,
+                      helloClubClient.getEventCount(), (unsigned long)result.durationMs);
             sendUpcomingEvents();
         } else {
             lastHelloClubPollFailed = true;
-            remoteLog("HC poll FAILED: %s", helloClubClient.getLastError().c_str());
+            remoteLog("HC %s FAILED after %lums: %s", kind, (unsigned long)result.durationMs,
+                      helloClubClient.getLastError().c_str());
         }
+        startQueuedHelloClubRefresh();
+        return;
+    }
+
+    // Don't start a new fetch if one is already outstanding
+    if (hcFetchPending) {
         return;
     }
 
-    // Don't start a new fetch if one is already running
-    if (hcFetchInProgress) {
+    // Offline (joining, or the router is down): cached events keep
+    // auto-starting; fetch again once the network is back
+    if (!wifiJoinConnected()) {
         return;
     }
 
     unsigned long now = millis();
-    unsigned long interval = lastHelloClubPollFailed ? HELLOCLUB_RETRY_INTERVAL_MS : HELLOCLUB_POLL_INTERVAL_MS;
+    unsigned long interval = getHelloClubPollInterval();
 
     if (lastHelloClubPoll > 0 && now - lastHelloClubPoll < interval) {
         return; // Not time yet
     }
 
-    remoteLog("HC poll: starting fetch...");
-    hcFetchInProgress = true;
-    hcFetchResultReady = false;
-
-    // Launch on core 0 (network core) — main loop runs on core 1
-    xTaskCreatePinnedToCore(
-        hcFetchTask,        // Task function
-        "hcFetch",          // Name
-        8192,               // Stack size (bytes) — SSL needs ~6KB
-        nullptr,            // Parameter
-        1,                  // Priority (low — don't starve WiFi)
-        &hcFetchTaskHandle, // Handle
-        0                   // Core 0 (protocol core)
-    );
+    // Keep the TLS handshake away from siren moments — try again next check.
+    // Rounds of two minutes or less are guarded end to end, so a poll held
+    // back for HELLOCLUB_FETCH_MAX_DEFER_MS goes ahead anyway.
+    if (inFetchGuardWindow()) {
+        if (!hcPollDeferred) {
+            hcPollDeferred = true;
+            hcPollDeferredSince = now;
+        }
+        if (now - hcPollDeferredSince < HELLOCLUB_FETCH_MAX_DEFER_MS) {
+            remoteLog("HC poll: deferred (round end or event start within guard)");
+            return;
+        }
+        remoteLog("HC poll: deferred %lus, fetching inside the guard",
+                  (now - hcPollDeferredSince) / 1000);
+    }
+
+    if (requestHelloClubFetch(HC_FETCH_POLL)) {
+        hcPollDeferred = false;
+        remoteLog("HC poll: starting fetch (interval %lus)...", interval / 1000);
+    }
 }
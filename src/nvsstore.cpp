@@ -0,0 +1,304 @@
+#include "nvsstore.h"
+#include "config.h"
+#include <Preferences.h>
+#include "rom/crc.h"
+
+NvsStore nvsStore;
+
+// Held across a commit so a stage from the web server task can't interleave
+// with it. nullptr before begin() — setup() is single-threaded until then.
+namespace {
+struct Lock {
+    SemaphoreHandle_t m;
+    explicit Lock(SemaphoreHandle_t mutex) : m(mutex) { if (m) xSemaphoreTake(m, portMAX_DELAY); }
+    ~Lock() { if (m) xSemaphoreGive(m); }
+};
+
+// NVS stores primitives in one 32-byte entry; strings and blobs take a
+// header entry plus their data in 32-byte entries (blobs add an index entry)
+uint32_t entriesFor(NvsType type, size_t len) {
+    switch (type) {
+        case NVS_STRING: return 1 + (uint32_t)(len + 1 + 31) / 32;
+        case NVS_BYTES:  return 2 + (uint32_t)(len + 31) / 32;
+        default:         return 1;
+    }
+}
+
+// Current flash contents of key, in the same byte form stage() uses
+bool readFlash(Preferences& prefs, const char* key, NvsType type, std::vector<uint8_t>& out) {
+    out.clear();
+    if (!prefs.isKey(key)) {
+        return false;
+    }
+    switch (type) {
+        case NVS_BOOL: {
+            uint8_t v = prefs.getBool(key) ? 1 : 0;
+            out.assign(&v, &v + 1);
+            break;
+        }
+        case NVS_U16: {
+            uint16_t v = prefs.getUShort(key);
+            out.assign((uint8_t*)&v, (uint8_t*)&v + sizeof(v));
+            break;
+        }
+        case NVS_U32: {
+            uint32_t v = prefs.getULong(key);
+            out.assign((uint8_t*)&v, (uint8_t*)&v + sizeof(v));
+            break;
+        }
+        case NVS_I32: {
+            int32_t v = prefs.getInt(key);
+            out.assign((uint8_t*)&v, (uint8_t*)&v + sizeof(v));
+            break;
+        }
+        case NVS_STRING: {
+            String v = prefs.getString(key);
+            out.assign((const uint8_t*)v.c_str(), (const uint8_t*)v.c_str() + v.length());
+            break;
+        }
+        case NVS_BYTES: {
+            out.resize(prefs.getBytesLength(key));
+            if (!out.empty()) {
+                prefs.getBytes(key, out.data(), out.size());
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+bool writeFlash(Preferences& prefs, const char* key, NvsType type, const std::vector<uint8_t>& v) {
+    switch (type) {
+        case NVS_BOOL:   return prefs.putBool(key, v[0] != 0) > 0;
+        case NVS_U16:    { uint16_t x; memcpy(&x, v.data(), sizeof(x)); return prefs.putUShort(key, x) > 0; }
+        case NVS_U32:    { uint32_t x; memcpy(&x, v.data(), sizeof(x)); return prefs.putULong(key, x) > 0; }
+        case NVS_I32:    { int32_t x; memcpy(&x, v.data(), sizeof(x)); return prefs.putInt(key, x) > 0; }
+        case NVS_STRING: {
+            String s;
+            s.concat((const char*)v.data(), v.size());
+            return prefs.putString(key, s) > 0 || v.empty(); // Returns the length
+        }
+        case NVS_BYTES:  return prefs.putBytes(key, v.data(), v.size()) > 0;
+    }
+    return false;
+}
+} // namespace
+
+void NvsStore::begin() {
+    if (!mutex) {
+        mutex = xSemaphoreCreateMutex();
+    }
+}
+
+void NvsStore::putBool(const char* ns, const char* key, bool value) {
+    uint8_t v = value ? 1 : 0;
+    stage(ns, key, NVS_BOOL, &v, sizeof(v), false);
+}
+
+void NvsStore::putUShort(const char* ns, const char* key, uint16_t value) {
+    stage(ns, key, NVS_U16, &value, sizeof(value), false);
+}
+
+void NvsStore::putULong(const char* ns, const char* key, uint32_t value) {
+    stage(ns, key, NVS_U32, &value, sizeof(value), false);
+}
+
+void NvsStore::putInt(const char* ns, const char* key, int32_t value) {
+    stage(ns, key, NVS_I32, &value, sizeof(value), false);
+}
+
+void NvsStore::putString(const char* ns, const char* key, const String& value) {
+    stage(ns, key, NVS_STRING, value.c_str(), value.length(), false);
+}
+
+void NvsStore::putBytes(const char* ns, const char* key, const void* data, size_t len) {
+    stage(ns, key, NVS_BYTES, data, len, false);
+}
+
+void NvsStore::remove(const char* ns, const char* key) {
+    stage(ns, key, NVS_BYTES, nullptr, 0, true);
+}
+
+NvsStore::Record& NvsStore::find(const char* ns, const char* key) {
+    for (Record& rec : records) {
+        if (strcmp(rec.ns, ns) == 0 && rec.key == key) {
+            return rec;
+        }
+    }
+    Record rec = {};
+    rec.ns = ns;
+    rec.key = key;
+    rec.type = NVS_BYTES;
+    records.push_back(rec);
+    return records.back();
+}
+
+void NvsStore::stage(const char* ns, const char* key, NvsType type,
+                     const void* data, size_t len, bool remove) {
+    Lock lock(mutex);
+    Record& rec = find(ns, key);
+    const uint8_t* bytes = (const uint8_t*)data;
+    if (type == NVS_BYTES && len == 0) {
+        remove = true; // Preferences can't store an empty blob
+    }
+    if (remove) {
+        type = rec.type; // Keep the type flash holds (if any)
+    }
+
+    // Same as the write already pending: nothing new
+    if (rec.dirty && rec.removed == remove && rec.type == type &&
+        rec.value.size() == len && (len == 0 || memcmp(rec.value.data(), bytes, len) == 0)) {
+        return;
+    }
+
+    // Back to what flash holds: cancel any pending write
+    if (rec.known) {
+        bool same = remove ? !rec.inFlash
+                           : (rec.inFlash && rec.type == type && rec.flashLen == len &&
+                              rec.flashCrc == crc32_le(0, bytes, len));
+        if (same) {
+            stats.skipped++;
+            if (rec.dirty) {
+                markClean(rec);
+            }
+            return;
+        }
+    }
+
+    rec.type = type;
+    rec.removed = remove;
+    rec.value.assign(bytes, bytes + len);
+    if (rec.dirty) {
+        stats.coalesced++;
+    } else {
+        rec.dirty = true;
+        if (dirtyCount++ == 0) {
+            dirtySince = millis();
+        }
+    }
+}
+
+void NvsStore::markClean(Record& rec) {
+    rec.dirty = false;
+    rec.value.clear();
+    rec.value.shrink_to_fit();
+    dirtyCount--;
+}
+
+bool NvsStore::flush(const char* ns) {
+    Lock lock(mutex);
+    return commitLocked(ns);
+}
+
+void NvsStore::loop(bool hold) {
+    if (hold || dirtyCount == 0 || millis() - dirtySince < NVS_COMMIT_DELAY_MS) {
+        return;
+    }
+    Lock lock(mutex);
+    commitLocked(nullptr);
+}
+
+bool NvsStore::commitLocked(const char* ns) {
+    if (dirtyCount == 0) {
+        return true;
+    }
+
+    unsigned long t0 = micros();
+    uint32_t written = 0;
+    bool ok = true;
+    std::vector<uint8_t> current;
+
+    // One Preferences session per namespace: the first dirty record of each
+    // namespace opens it and commits every dirty record that shares it
+    for (size_t i = 0; i < records.size(); i++) {
+        if (!records[i].dirty || (ns && strcmp(records[i].ns, ns) != 0)) {
+            continue;
+        }
+        const char* batchNs = records[i].ns;
+        Preferences prefs;
+        if (!prefs.begin(batchNs, false)) {
+            DEBUG_PRINTF("NVS: failed to open '%s', will retry\n", batchNs);
+            stats.failed++;
+            dirtySince = millis();
+            ok = false;
+            continue;
+        }
+
+        for (size_t j = i; j < records.size(); j++) {
+            Record& rec = records[j];
+            if (!rec.dirty || strcmp(rec.ns, batchNs) != 0) {
+                continue;
+            }
+            const char* key = rec.key.c_str();
+
+            // First write of this key since boot: learn what flash holds
+            if (!rec.known) {
+                rec.inFlash = readFlash(prefs, key, rec.type, current);
+                rec.flashLen = current.size();
+                rec.flashCrc = crc32_le(0, current.data(), current.size());
+                rec.known = true;
+            }
+
+            bool same = rec.removed ? !rec.inFlash
+                                    : (rec.inFlash && rec.flashLen == rec.value.size() &&
+                                       rec.flashCrc == crc32_le(0, rec.value.data(), rec.value.size()));
+            if (same) {
+                stats.skipped++;
+            } else if (!(rec.removed ? prefs.remove(key) : writeFlash(prefs, key, rec.type, rec.value))) {
+                // Keep the value staged; flash contents are now uncertain,
+                // so the retry re-reads them first
+                DEBUG_PRINTF("NVS: write %s/%s failed, will retry\n", batchNs, key);
+                stats.failed++;
+                rec.known = false;
+                dirtySince = millis();
+                ok = false;
+                continue;
+            } else {
+                rec.inFlash = !rec.removed;
+                rec.flashLen = rec.value.size();
+                rec.flashCrc = crc32_le(0, rec.value.data(), rec.value.size());
+                stats.keyWrites++;
+                stats.bytesWritten += rec.value.size();
+                stats.entriesWritten += rec.removed ? 0 : entriesFor(rec.type, rec.value.size());
+                written++;
+            }
+            markClean(rec);
+        }
+        prefs.end();
+    }
+
+    if (written > 0) {
+        uint32_t us = micros() - t0;
+        stats.commits++;
+        stats.lastCommitUs = us;
+        if (us > stats.maxCommitUs) {
+            stats.maxCommitUs = us;
+        }
+        DEBUG_PRINTF("NVS: committed %u key(s) in %u us\n", written, us);
+    }
+    return ok;
+}
+
+void NvsStore::discard(const char* ns) {
+    Lock lock(mutex);
+    for (size_t i = records.size(); i-- > 0; ) {
+        if (strcmp(records[i].ns, ns) == 0) {
+            if (records[i].dirty) {
+                dirtyCount--;
+            }
+            records.erase(records.begin() + i);
+        }
+    }
+}
+
+String NvsStore::statsJson() const {
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"commits\":%u,\"keyWrites\":%u,\"bytes\":%u,\"entries\":%u,"
+             "\"skipped\":%u,\"coalesced\":%u,\"failed\":%u,\"pending\":%d,"
+             "\"lastCommitUs\":%u,\"maxCommitUs\":%u}",
+             stats.commits, stats.keyWrites, stats.bytesWritten, stats.entriesWritten,
+             stats.skipped, stats.coalesced, stats.failed, dirtyCount,
+             stats.lastCommitUs, stats.maxCommitUs);
+    return String(buf);
+}
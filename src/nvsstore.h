@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// =============================================================================
+// NVS Store — write-coalescing persistence with dirty tracking
+// =============================================================================
+//
+// Modules stage values with put*() instead of opening Preferences themselves.
+// A value equal to what flash already holds is dropped; anything else is
+// marked dirty and committed by loop() NVS_COMMIT_DELAY_MS after the first
+// change, one Preferences session per namespace. flush() commits at once,
+// for keys that must survive a crash or restart straight after. A key whose
+// write fails stays dirty and is retried by the next loop() commit. A flash
+// commit can stall the loop, so the caller holds batched commits while the
+// siren is timing-critical; only flush() writes through a hold.
+//
+// Reads still go through Preferences (at boot, before anything is staged).
+// Namespace strings must outlive the store (literals or constants).
+
+enum NvsType : uint8_t {
+    NVS_BOOL,
+    NVS_U16,
+    NVS_U32,
+    NVS_I32,
+    NVS_STRING,
+    NVS_BYTES
+};
+
+struct NvsStats {
+    uint32_t commits;          // Commit batches that wrote at least one key
+    uint32_t keyWrites;        // Keys written or removed in flash
+    uint32_t bytesWritten;     // Payload bytes written
+    uint32_t entriesWritten;   // Estimated 32-byte NVS entries consumed (wear)
+    uint32_t skipped;          // Staged values flash already held
+    uint32_t coalesced;        // Changes folded into a still-pending write
+    uint32_t failed;           // put/remove calls (or namespace opens) that failed
+    uint32_t lastCommitUs;
+    uint32_t maxCommitUs;
+};
+
+class NvsStore {
+public:
+    void begin();
+
+    void putBool(const char* ns, const char* key, bool value);
+    void putUShort(const char* ns, const char* key, uint16_t value);
+    void putULong(const char* ns, const char* key, uint32_t value);
+    void putInt(const char* ns, const char* key, int32_t value);
+    void putString(const char* ns, const char* key, const String& value);
+    void putBytes(const char* ns, const char* key, const void* data, size_t len);
+    void remove(const char* ns, const char* key);
+
+    // Commit dirty keys now — all of them, or only those in ns. False if any
+    // failed to write; they stay pending and loop() retries them.
+    bool flush(const char* ns = nullptr);
+
+    // Forget pending writes and flash state for ns (before Preferences::clear())
+    void discard(const char* ns);
+
+    // Main loop: commit once the oldest change is NVS_COMMIT_DELAY_MS old,
+    // unless hold is set (the commit then waits for the first loop without it)
+    void loop(bool hold);
+
+    int pendingCount() const { return dirtyCount; }
+    const NvsStats& getStats() const { return stats; }
+    String statsJson() const;
+
+private:
+    struct Record {
+        const char* ns;
+        String key;
+        NvsType type;
+        std::vector<uint8_t> value;   // Staged value (freed once committed)
+        uint32_t flashCrc;            // CRC32 + length of what flash holds,
+        uint32_t flashLen;            //   valid when known
+        bool known;
+        bool inFlash;
+        bool removed;                 // Staged value is "key absent"
+        bool dirty;
+    };
+
+    std::vector<Record> records;
+    int dirtyCount = 0;
+    unsigned long dirtySince = 0;
+    NvsStats stats = {};
+    SemaphoreHandle_t mutex = nullptr;
+
+    Record& find(const char* ns, const char* key);
+    void stage(const char* ns, const char* key, NvsType type,
+               const void* data, size_t len, bool remove);
+    bool commitLocked(const char* ns);
+    void markClean(Record& rec);
+};
+
+extern NvsStore nvsStore;
@@ -0,0 +1,228 @@
+#include "portal.h"
+#include <WiFi.h>
+#include <DNSServer.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "bootlog.h"
+#include "config.h"
+#include "wifijoin.h"
+
+static const IPAddress PORTAL_IP(192, 168, 4, 1);
+static const char* PORTAL_URL = "http://192.168.4.1/setup";
+
+static DNSServer dns;
+static std::atomic<bool> active(false);   // Read by the handlers (web server task)
+static unsigned long closeAt = 0;
+
+// The /setup network list, rendered by portalLoop() from the scan results
+// (main loop only) and copied out by handleSetup() under netListMutex
+static SemaphoreHandle_t netListMutex = nullptr;
+static String netList;
+static uint32_t netListScan = 0;
+
+struct NetListLock {
+    NetListLock() { if (netListMutex) xSemaphoreTake(netListMutex, portMAX_DELAY); }
+    ~NetListLock() { if (netListMutex) xSemaphoreGive(netListMutex); }
+};
+
+// Filled by the /save handler (web server task), consumed by portalLoop()
+static String pendingSsid;
+static String pendingPassword;
+static std::atomic<bool> pending(false);
+
+static String htmlEscape(const String& s) {
+    String out;
+    out.reserve(s.length());
+    for (size_t i = 0; i < s.length(); i++) {
+        char c = s[i];
+        if (c == '<') out += "&lt;";
+        else if (c == '>') out += "&gt;";
+        else if (c == '&') out += "&amp;";
+        else if (c == '\'') out += "&#39;";
+        else if (c == '"') out += "&quot;";
+        else out += c;
+    }
+    return out;
+}
+
+static const char PAGE_HEAD[] = R"rawhtml(
+<!DOCTYPE html><html><head>
+<meta name='viewport' content='width=device-width,initial-scale=1'>
+<title>Badminton Timer WiFi Setup</title>
+<style>
+body{font-family:sans-serif;margin:20px;background:#1a1a2e;color:#eee}
+h2{color:#e94560}
+a{color:#e94560}
+.net{padding:10px;margin:5px 0;background:#16213e;border-radius:5px;cursor:pointer}
+.net:hover{background:#0f3460}
+input{width:100%;padding:10px;margin:5px 0;box-sizing:border-box;border-radius:5px;border:1px solid #555;background:#16213e;color:#eee;font-size:16px}
+button{width:100%;padding:12px;background:#e94560;color:#fff;border:none;border-radius:5px;font-size:18px;cursor:pointer;margin-top:10px}
+button:hover{background:#c73e54}
+.status{padding:10px;margin:10px 0;background:#16213e;border-radius:5px}
+</style></head><body>
+<h2>Badminton Timer WiFi Setup</h2>
+<div class='status'>The timer is running and can be used at <a href='/'>192.168.4.1</a> meanwhile.<br>
+Select a network or type the SSID manually.</div>
+)rawhtml";
+
+static const char PAGE_FORM[] = R"rawhtml(
+<form action='/save' method='POST'>
+<label>SSID:</label><input id='s' name='s' required>
+<label>Password (leave blank for open):</label><input name='p' type='password'>
+<button type='submit'>Connect</button>
+</form></body></html>
+)rawhtml";
+
+static void handleSetup(AsyncWebServerRequest *request) {
+    if (!active) {
+        request->redirect("/");
+        return;
+    }
+    bootLog("Portal: Config page served to client");
+    String page = PAGE_HEAD;
+    {
+        NetListLock lock;
+        page += netList;
+    }
+    page += PAGE_FORM;
+    request->send(200, "text/html", page);
+}
+
+static void handleSave(AsyncWebServerRequest *request) {
+    // Only while the setup AP is open: never lets a LAN client move the
+    // timer to another network
+    if (!active) {
+        request->send(403, "text/plain", "Setup portal is not active");
+        return;
+    }
+    if (!request->hasParam("s", true)) {
+        request->send(400, "text/plain", "Missing SSID");
+        return;
+    }
+    if (pending) {
+        request->send(409, "text/plain", "Already connecting, try again shortly");
+        return;
+    }
+    pendingSsid = request->getParam("s", true)->value();
+    pendingPassword = request->hasParam("p", true) ? request->getParam("p", true)->value() : "";
+    pending = true;
+    bootLog("Portal: User submitted SSID='%s'", pendingSsid.c_str());
+    request->send(200, "text/html",
+        "<html><body style='font-family:sans-serif;background:#1a1a2e;color:#eee;text-align:center;padding:40px'>"
+        "<h2>Connecting...</h2><p>The timer is joining " + htmlEscape(pendingSsid) + ".</p>"
+        "<p>If it works, this setup network closes shortly: reconnect your phone to "
+        + htmlEscape(pendingSsid) + " and open http://" + MDNS_HOSTNAME + ".local/</p>"
+        "<p>If it fails, this page will be available again.</p></body></html>");
+}
+
+// Connectivity probe: redirect to the setup page while the portal is open
+// (makes the phone show its sign-in sheet), otherwise answer as the OS
+// expects so it stays on the network
+static void probe(AsyncWebServerRequest *request, int code, const char* type, const char* body) {
+    if (active) {
+        request->redirect(PORTAL_URL);
+    } else {
+        request->send(code, type, body);
+    }
+}
+
+// Main loop: redo the /setup list after each scan
+static void renderNetList() {
+    String list;
+    for (const WifiScanEntry& net : wifiJoinScanResults()) {
+        String ssid = htmlEscape(net.ssid);
+        list += "<div class='net' onclick=\"document.getElementById('s').value=this.dataset.ssid\" data-ssid='";
+        list += ssid;
+        list += "'>";
+        list += ssid + " (" + String(net.rssi) + " dBm)";
+        if (net.open) list += " [open]";
+        list += "</div>";
+    }
+    netListScan = wifiJoinScanCount();
+    NetListLock lock;
+    netList = list;
+}
+
+void portalBegin(AsyncWebServer& server) {
+    static const char* APPLE_SUCCESS = "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>";
+
+    netListMutex = xSemaphoreCreateMutex();
+    server.on("/setup", HTTP_GET, handleSetup);
+    server.on("/save", HTTP_POST, handleSave);
+
+    server.on("/generate_204", HTTP_GET, [](AsyncWebServerRequest *request){ probe(request, 204, "text/plain", ""); });
+    server.on("/gen_204", HTTP_GET, [](AsyncWebServerRequest *request){ probe(request, 204, "text/plain", ""); });
+    server.on("/hotspot-detect.html", HTTP_GET, [](AsyncWebServerRequest *request){
+        probe(request, 200, "text/html", APPLE_SUCCESS);
+    });
+    server.on("/library/test/success.html", HTTP_GET, [](AsyncWebServerRequest *request){
+        probe(request, 200, "text/html", APPLE_SUCCESS);
+    });
+    server.on("/connecttest.txt", HTTP_GET, [](AsyncWebServerRequest *request){
+        probe(request, 200, "text/plain", "Microsoft Connect Test");
+    });
+    server.on("/ncsi.txt", HTTP_GET, [](AsyncWebServerRequest *request){
+        probe(request, 200, "text/plain", "Microsoft NCSI");
+    });
+
+    server.onNotFound([](AsyncWebServerRequest *request){
+        if (active) {
+            bootLog("Portal: Redirecting %s -> /setup", request->url().c_str());
+            request->redirect(PORTAL_URL);
+        } else {
+            request->send(404, "text/plain", "Not found");
+        }
+    });
+}
+
+static void openAp() {
+    WiFi.mode(WIFI_AP_STA);
+    WiFi.softAPConfig(PORTAL_IP, PORTAL_IP, IPAddress(255, 255, 255, 0));
+    WiFi.softAP(AP_SSID);
+    dns.start(53, "*", PORTAL_IP);
+    renderNetList();
+    active = true;
+    closeAt = 0;
+    bootLog("Portal: AP '%s' started, IP: %s", AP_SSID, WiFi.softAPIP().toString().c_str());
+}
+
+static void closeAp() {
+    dns.stop();
+    WiFi.softAPdisconnect(true);
+    WiFi.mode(WIFI_STA);
+    active = false;
+    bootLog("Portal: Closed, station connected to '%s'", WiFi.SSID().c_str());
+}
+
+void portalLoop() {
+    if (!active) {
+        if (wifiJoinState() == WIFI_JOIN_FAILED) {
+            bootLog("WiFi: Known networks failed, starting captive portal");
+            openAp();
+        }
+        return;
+    }
+
+    dns.processNextRequest();
+    if (wifiJoinScanCount() != netListScan) {
+        renderNetList();
+    }
+
+    if (pending) {
+        wifiJoinSubmit(pendingSsid.c_str(), pendingPassword.c_str());
+        pending = false;
+    }
+
+    if (!wifiJoinConnected()) {
+        closeAt = 0;
+    } else if (closeAt == 0) {
+        closeAt = millis() + PORTAL_CLOSE_DELAY_MS;
+    } else if ((long)(millis() - closeAt) >= 0) {
+        closeAp();
+    }
+}
+
+bool portalActive() {
+    return active;
+}
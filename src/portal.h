@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+// =============================================================================
+// Captive Portal — setup access point alongside the station, never blocking
+// =============================================================================
+//
+// When every known network has failed (wifiJoinState() == WIFI_JOIN_FAILED)
+// the portal opens the AP_SSID access point in AP+STA mode with a wildcard
+// DNS. Phones are sent to /setup to pick a network; the timer itself stays
+// usable at http://192.168.4.1/ meanwhile, and the station keeps retrying
+// the known networks in the background. An entered network is handed to
+// wifiJoinSubmit(). Once the station is connected the AP closes after
+// PORTAL_CLOSE_DELAY_MS, long enough for the phone to show the result.
+
+// Register /setup, /save, the OS connectivity probes and the not-found
+// redirect. They only act as a portal while it is open.
+void portalBegin(AsyncWebServer& server);
+
+// Main loop: open/close the AP, answer DNS, hand over submitted networks
+void portalLoop();
+
+bool portalActive();
@@ -1,70 +1,203 @@
 #include "remotelog.h"
 #include <Arduino.h>
+#include <atomic>
+#include "seriallog.h"
 
-static LogEntry entries[RLOG_MAX_ENTRIES];
-static int head = 0;       // Next write position
-static int count = 0;      // Current number of entries
-static uint32_t seq = 0;   // Global sequence counter
+struct Slot {
+    std::atomic<uint32_t> stamp;    // 0 = never written, BUSY, or seq + 1
+    LogEntry entry;
+};
+
+static Slot slots[RLOG_MAX_ENTRIES];
+static std::atomic<uint32_t> nextSeq(0);   // Next sequence number to hand out
 
 void remoteLogInit() {
-    head = 0;
-    count = 0;
-    seq = 0;
-    memset(entries, 0, sizeof(entries));
+    for (Slot& slot : slots) {
+        slot.stamp.store(0, std::memory_order_relaxed);
+        memset(&slot.entry, 0, sizeof(slot.entry));
+    }
+    nextSeq.store(0);
+}
+
+// Take the slot for seq, or return false if a newer entry already owns it
+// (this writer was lapped: the ring has moved on, nothing is lost that a
+// reader could still have seen). Waits while another writer is mid-entry.
+static bool claimSlot(Slot& slot, uint32_t seq) {
+    uint32_t cur = slot.stamp.load(std::memory_order_acquire);
+    for (int spins = 0; ; spins++) {
+        if (cur == RLOG_STAMP_BUSY) {
+            // The owner may be a lower-priority task on this core: let it run
+            if (spins > 100) delay(1);
+            cur = slot.stamp.load(std::memory_order_acquire);
+            continue;
+        }
+        if (cur != 0 && (int32_t)(cur - (seq + 1)) > 0) {
+            return false;
+        }
+        if (slot.stamp.compare_exchange_weak(cur, RLOG_STAMP_BUSY, std::memory_order_acquire)) {
+            return true;
+        }
+    }
 }
 
 void remoteLog(const char* fmt, ...) {
-    LogEntry& entry = entries[head];
+    LogEntry entry;
     entry.timestamp = millis();
 
+    // Format before claiming the slot to keep the busy window short
     va_list args;
     va_start(args, fmt);
     vsnprintf(entry.message, RLOG_MSG_LEN, fmt, args);
     va_end(args);
 
     // Also print to serial
-    Serial.printf("[RLOG %lu] %s\n", entry.timestamp, entry.message);
+    serialLog.printf("[RLOG %lu] %s\n", entry.timestamp, entry.message);
+
+    entry.seq = nextSeq.fetch_add(1);
+    Slot& slot = slots[entry.seq % RLOG_MAX_ENTRIES];
+    if (!claimSlot(slot, entry.seq)) {
+        return;
+    }
+    memcpy(&slot.entry, &entry, sizeof(entry));
+    slot.stamp.store(entry.seq + 1, std::memory_order_release);
+}
+
+enum ReadResult { READ_OK, READ_PENDING, READ_GONE };
 
-    head = (head + 1) % RLOG_MAX_ENTRIES;
-    if (count < RLOG_MAX_ENTRIES) count++;
-    seq++;
+// Copy the entry for seq (stamp checked before and after the copy). PENDING
+// means its writer has not finished yet; GONE means it was overwritten.
+static ReadResult readEntry(uint32_t seq, LogEntry& out) {
+    Slot& slot = slots[seq % RLOG_MAX_ENTRIES];
+    uint32_t before = slot.stamp.load(std::memory_order_acquire);
+    if (before != seq + 1) {
+        bool newer = before != RLOG_STAMP_BUSY && before != 0 && (int32_t)(before - (seq + 1)) > 0;
+        return newer ? READ_GONE : READ_PENDING;
+    }
+    memcpy(&out, &slot.entry, sizeof(out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.stamp.load(std::memory_order_relaxed) == before ? READ_OK : READ_GONE;
+}
+
+// Largest serialized entry: escaping at most doubles the message
+static const size_t ENTRY_JSON_MAX = 2 * RLOG_MSG_LEN + 48;
+
+// Write one entry as {"s":..,"t":..,"m":".."} (preceded by a comma unless
+// first). Returns the length, or 0 if it does not fit in size bytes + NUL.
+static size_t writeEntry(char* buf, size_t size, const LogEntry& entry, bool first) {
+    int n = snprintf(buf, size, "%s{\"s\":%lu,\"t\":%lu,\"m\":\"",
+                     first ? "" : ",", (unsigned long)entry.seq, (unsigned long)entry.timestamp);
+    if (n < 0 || (size_t)n >= size) {
+        return 0;
+    }
+    size_t len = n;
+    const char* end = (const char*)memchr(entry.message, '\0', RLOG_MSG_LEN);
+    if (!end) end = entry.message + RLOG_MSG_LEN - 1;
+    for (const char* p = entry.message; p < end; p++) {
+        char esc = 0;
+        switch (*p) {
+            case '"':  esc = '"'; break;
+            case '\\': esc = '\\'; break;
+            case '\n': esc = 'n'; break;
+            case '\r': esc = 'r'; break;
+            case '\t': esc = 't'; break;
+            default:
+                if ((uint8_t)*p < 0x20) continue;   // Other control characters are dropped
+        }
+        if (len + (esc ? 2 : 1) + 2 >= size) {
+            return 0;
+        }
+        if (esc) {
+            buf[len++] = '\\';
+            buf[len++] = esc;
+        } else {
+            buf[len++] = *p;
+        }
+    }
+    buf[len++] = '"';
+    buf[len++] = '}';
+    buf[len] = '\0';
+    return len;
+}
+
+size_t remoteLogWriteJson(char* buf, size_t size, uint32_t& cursor, bool* moreOut) {
+    static const char HEAD[] = "{\"event\":\"remote_log\",\"entries\":[";
+    static const size_t TAIL_MAX = sizeof("],\"seq\":4294967295,\"lost\":4294967295,\"more\":false}");
+
+    uint32_t end = nextSeq.load();
+    uint32_t oldest = end > (uint32_t)RLOG_MAX_ENTRIES ? end - RLOG_MAX_ENTRIES : 0;
+    uint32_t lost = 0;
+    if ((int32_t)(end - cursor) < 0) {
+        cursor = oldest;                   // Cursor from before a reboot
+    } else if ((int32_t)(cursor - oldest) < 0) {
+        lost = oldest - cursor;
+        cursor = oldest;
+    }
+
+    if (moreOut) *moreOut = false;
+    if (size < sizeof(HEAD) + TAIL_MAX) {
+        return 0;
+    }
+    size_t len = sizeof(HEAD) - 1;
+    memcpy(buf, HEAD, len);
+    size_t limit = size - TAIL_MAX;        // Entries stop short of the tail
+    bool first = true;
+    bool more = false;
+    LogEntry entry;
+    for (; cursor != end; cursor++) {
+        ReadResult r = readEntry(cursor, entry);
+        if (r == READ_PENDING) {
+            break;                         // Still being written: next batch
+        }
+        if (r == READ_GONE) {
+            lost++;
+            continue;
+        }
+        size_t n = writeEntry(buf + len, limit - len, entry, first);
+        if (n == 0) {
+            more = true;
+            break;
+        }
+        len += n;
+        first = false;
+    }
+    len += snprintf(buf + len, size - len, "],\"seq\":%lu,\"lost\":%lu,\"more\":%s}",
+                    (unsigned long)cursor, (unsigned long)lost, more ? "true" : "false");
+    if (moreOut) *moreOut = more;
+    return len;
 }
 
 String remoteLogGetAllJson() {
-    // Pre-allocate to avoid repeated reallocation/fragmentation
-    // Worst case: ~150 bytes per entry (JSON overhead + 100 char message)
+    uint32_t end = nextSeq.load();
+    uint32_t start = end > (uint32_t)RLOG_MAX_ENTRIES ? end - RLOG_MAX_ENTRIES : 0;
+
+    // Entries are serialized into a small stack buffer and appended whole
     String json;
-    json.reserve(50 + count * 150);
-    json = "{\"event\":\"remote_log\",\"seq\":";
-    json += String(seq);
-    json += ",\"entries\":[";
-
-    // Read from oldest to newest
-    int start = (count < RLOG_MAX_ENTRIES) ? 0 : head;
-    for (int i = 0; i < count; i++) {
-        int idx = (start + i) % RLOG_MAX_ENTRIES;
-        if (i > 0) json += ",";
-        json += "{\"t\":";
-        json += String(entries[idx].timestamp);
-        json += ",\"m\":\"";
-        // Escape quotes and backslashes in message
-        for (const char* p = entries[idx].message; *p; p++) {
-            if (*p == '"') json += "\\\"";
-            else if (*p == '\\') json += "\\\\";
-            else if (*p == '\n') json += "\\n";
-            else json += *p;
+    json.reserve(64 + (end - start) * 160);
+    json = "{\"event\":\"remote_log\",\"entries\":[";
+    char chunk[ENTRY_JSON_MAX];
+    bool first = true;
+    LogEntry entry;
+    uint32_t seq = start;
+    for (; seq != end; seq++) {
+        ReadResult r = readEntry(seq, entry);
+        if (r == READ_PENDING) break;
+        if (r == READ_GONE) continue;
+        if (writeEntry(chunk, sizeof(chunk), entry, first) > 0) {
+            json += chunk;
+            first = false;
         }
-        json += "\"}";
     }
-
-    json += "]}";
+    json += "],\"seq\":";
+    json += String(seq);
+    json += "}";
     return json;
 }
 
 uint32_t remoteLogGetSeq() {
-    return seq;
+    return nextSeq.load();
 }
 
 int remoteLogCount() {
-    return count;
+    uint32_t seq = nextSeq.load();
+    return seq < (uint32_t)RLOG_MAX_ENTRIES ? (int)seq : RLOG_MAX_ENTRIES;
 }
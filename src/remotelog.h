@@ -8,8 +8,20 @@
 
 constexpr int RLOG_MAX_ENTRIES = 40;
 constexpr int RLOG_MSG_LEN = 100;
+constexpr size_t RLOG_JSON_BUF_SIZE = 1536;          // One remote_log message (always fits one entry)
+constexpr unsigned long RLOG_PUSH_INTERVAL_MS = 1000; // Batching interval for subscribed clients
+constexpr int RLOG_REQUEST_QUEUE_DEPTH = 8;           // Reader requests buffered for the main loop
+
+// Safe to call from any task. A writer reserves a sequence number with one
+// atomic increment; its slot is seq % RLOG_MAX_ENTRIES. The slot's stamp is
+// set to RLOG_STAMP_BUSY while the entry is written and to seq + 1 once it is
+// complete, so readers skip entries that are half-written or were replaced
+// while being copied.
+
+constexpr uint32_t RLOG_STAMP_BUSY = 0xFFFFFFFF;
 
 struct LogEntry {
+    uint32_t seq;
     unsigned long timestamp;      // millis()
     char message[RLOG_MSG_LEN];
 };
@@ -17,5 +29,14 @@ struct LogEntry {
 void remoteLogInit();
 void remoteLog(const char* fmt, ...);
 String remoteLogGetAllJson();
+
+// Serialize entries from sequence number `cursor` onward into buf as
+//   {"event":"remote_log","entries":[...],"seq":<next cursor>,"lost":n,"more":bool}
+// without heap allocation. Entries already overwritten are counted in
+// "lost"; "more" (also returned through *more) is set when the next entry
+// did not fit. Advances cursor past the last entry written and returns the
+// length (0 if size is too small for even the envelope). Pass cursor 0 for
+// everything still held.
+size_t remoteLogWriteJson(char* buf, size_t size, uint32_t& cursor, bool* more = nullptr);
 uint32_t remoteLogGetSeq();
 int remoteLogCount();
@@ -0,0 +1,143 @@
+#include "seriallog.h"
+#include "config.h"
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static_assert((SERIAL_LOG_SLOTS & (SERIAL_LOG_SLOTS - 1)) == 0, "SERIAL_LOG_SLOTS must be a power of two");
+
+SerialLog serialLog;
+
+namespace {
+// A slot is free for position p when seq == p, holds data for the reader
+// when seq == p + 1, and is handed back as free for p + SLOTS
+struct Slot {
+    std::atomic<uint32_t> seq;
+    uint8_t len;
+    char data[SERIAL_LOG_SLOT_SIZE];
+};
+
+Slot slots[SERIAL_LOG_SLOTS];
+std::atomic<uint32_t> writePos(0);
+uint32_t readPos = 0;                     // Drain task only
+std::atomic<uint32_t> droppedBytes(0);
+std::atomic<uint32_t> queuedBytes(0);
+bool started = false;
+
+struct SlotInit {
+    SlotInit() {
+        for (uint32_t i = 0; i < SERIAL_LOG_SLOTS; i++) {
+            slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+} slotInit;
+
+// Claim the next free slot, or nullptr if the reader hasn't freed it yet
+Slot* reserve(uint32_t& pos) {
+    pos = writePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots[pos & (SERIAL_LOG_SLOTS - 1)];
+        int32_t diff = (int32_t)(slot.seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                return &slot;
+            }
+        } else if (diff < 0) {
+            return nullptr; // Full
+        } else {
+            pos = writePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void drainTask(void* param) {
+    char out[SERIAL_LOG_SLOT_SIZE * 4];
+    uint32_t reportedDrops = 0;
+
+    for (;;) {
+        size_t n = 0;
+        while (n + SERIAL_LOG_SLOT_SIZE <= sizeof(out)) {
+            Slot& slot = slots[readPos & (SERIAL_LOG_SLOTS - 1)];
+            if (slot.seq.load(std::memory_order_acquire) != readPos + 1) {
+                break;
+            }
+            memcpy(out + n, slot.data, slot.len);
+            n += slot.len;
+            slot.seq.store(readPos + SERIAL_LOG_SLOTS, std::memory_order_release);
+            readPos++;
+        }
+
+        if (n > 0) {
+            Serial.write((const uint8_t*)out, n);
+            continue;
+        }
+
+        uint32_t drops = droppedBytes.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            Serial.printf("[serial log: %u bytes dropped]\n", drops - reportedDrops);
+            reportedDrops = drops;
+        }
+        vTaskDelay(pdMS_TO_TICKS(SERIAL_LOG_IDLE_MS));
+    }
+}
+} // namespace
+
+void SerialLog::begin() {
+    if (started) {
+        return;
+    }
+    started = xTaskCreatePinnedToCore(drainTask, "serialLog", SERIAL_LOG_TASK_STACK_SIZE, nullptr,
+                                      SERIAL_LOG_TASK_PRIORITY, nullptr, SERIAL_LOG_TASK_CORE) == pdPASS;
+    if (!started) {
+        Serial.println("Serial log task failed to start");
+    }
+}
+
+size_t SerialLog::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t SerialLog::write(const uint8_t* data, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        uint32_t pos;
+        Slot* slot = reserve(pos);
+        if (!slot) {
+            droppedBytes.fetch_add(len - done, std::memory_order_relaxed);
+            break;
+        }
+        size_t chunk = min(len - done, (size_t)SERIAL_LOG_SLOT_SIZE);
+        memcpy(slot->data, data + done, chunk);
+        slot->len = chunk;
+        slot->seq.store(pos + 1, std::memory_order_release);
+        done += chunk;
+    }
+    queuedBytes.fetch_add(done, std::memory_order_relaxed);
+    // Report the full length: Print stops at a short write and the
+    // caller has nothing useful to do with the shortfall
+    return len;
+}
+
+size_t SerialLog::printf(const char* fmt, ...) {
+    char buf[SERIAL_LOG_PRINTF_MAX];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n <= 0) {
+        return 0;
+    }
+    size_t len = min((size_t)n, sizeof(buf) - 1);
+    if ((size_t)n > len && fmt[strlen(fmt) - 1] == '\n') {
+        buf[len - 1] = '\n'; // Truncated: keep the line break
+    }
+    return write((const uint8_t*)buf, len);
+}
+
+uint32_t SerialLog::dropped() const {
+    return droppedBytes.load(std::memory_order_relaxed);
+}
+
+uint32_t SerialLog::queued() const {
+    return queuedBytes.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+
+// =============================================================================
+// Serial Log — non-blocking console output
+// =============================================================================
+//
+// At 115200 baud a 100-character line holds the caller for ~9 ms. serialLog
+// is a Print whose writes only copy into a fixed ring of slots; a
+// low-priority task drains the ring to Serial. Any task may write (lock-free,
+// bounded MPMC ring with per-slot sequence numbers). When the ring is full
+// the text is dropped and counted rather than waited for.
+//
+// Writes longer than one slot are split; pieces from different tasks can
+// interleave only when they log at the same moment.
+
+class SerialLog : public Print {
+public:
+    // Start the drain task (right after Serial.begin(); earlier writes wait in the ring)
+    void begin();
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t len) override;
+    using Print::write;
+
+    // Formats on the caller's stack, then queues like write()
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    uint32_t dropped() const;   // Bytes lost to a full ring
+    uint32_t queued() const;    // Bytes accepted
+};
+
+extern SerialLog serialLog;
@@ -1,5 +1,6 @@
 #include "settings.h"
 #include "config.h"
+#include "nvsstore.h"
 
 Settings::Settings()
     : timezone(TIMEZONE_LOCATION)
@@ -42,24 +43,19 @@ bool Settings::load(Timer& timer, Siren& siren) {
 }
 
 bool Settings::save(const Timer& timer, const Siren& siren) {
-    if (!preferences.begin(PREFERENCES_NAMESPACE, false)) {
-        DEBUG_PRINTLN("Failed to open preferences for writing.");
-        return false;
-    }
-
-    preferences.putULong(PREF_KEY_GAME_DURATION, timer.getGameDuration());
-    preferences.putUInt(PREF_KEY_NUM_ROUNDS, timer.getNumRounds());
-
-    preferences.putULong(PREF_KEY_SIREN_LENGTH, siren.getBlastLength());
-    preferences.putULong(PREF_KEY_SIREN_PAUSE, siren.getBlastPause());
+    // Staged — unchanged values are dropped, the rest commit together
+    nvsStore.putULong(PREFERENCES_NAMESPACE, PREF_KEY_GAME_DURATION, timer.getGameDuration());
+    nvsStore.putULong(PREFERENCES_NAMESPACE, PREF_KEY_NUM_ROUNDS, timer.getNumRounds());
 
-    preferences.end();
+    nvsStore.putULong(PREFERENCES_NAMESPACE, PREF_KEY_SIREN_LENGTH, siren.getBlastLength());
+    nvsStore.putULong(PREFERENCES_NAMESPACE, PREF_KEY_SIREN_PAUSE, siren.getBlastPause());
 
     DEBUG_PRINTLN("Settings saved successfully");
     return true;
 }
 
 bool Settings::clear() {
+    nvsStore.discard(PREFERENCES_NAMESPACE);
     if (!preferences.begin(PREFERENCES_NAMESPACE, false)) {
         DEBUG_PRINTLN("Failed to open preferences for clearing.");
         return false;
@@ -91,14 +87,7 @@ void Settings::loadTimezone() {
 }
 
 void Settings::saveTimezone() {
-    if (!preferences.begin(PREFERENCES_NAMESPACE, false)) {
-        DEBUG_PRINTLN("Failed to open preferences for writing timezone.");
-        return;
-    }
-
-    preferences.putString("timezone", timezone);
-    preferences.end();
-
+    nvsStore.putString(PREFERENCES_NAMESPACE, "timezone", timezone);
     DEBUG_PRINTF("Timezone saved: %s\n", timezone.c_str());
 }
 
@@ -128,10 +117,7 @@ bool Settings::setTimezone(const String& tz) {
 bool Settings::setHcDefaultDuration(uint16_t minutes) {
     if (minutes < 1 || minutes > 120) return false;
     hcDefaultDuration = minutes;
-
-    if (!preferences.begin(PREFERENCES_NAMESPACE, false)) return false;
-    preferences.putUShort(PREF_KEY_HC_DEFAULT_DURATION, hcDefaultDuration);
-    preferences.end();
+    nvsStore.putUShort(PREFERENCES_NAMESPACE, PREF_KEY_HC_DEFAULT_DURATION, hcDefaultDuration);
 
     DEBUG_PRINTF("HC default duration set to: %d min\n", hcDefaultDuration);
     return true;
@@ -149,19 +135,13 @@ void Settings::loadQrSettings() {
 }
 
 bool Settings::saveQrSettings(const String& pass, const String& enc, const String& ssid) {
-    if (!preferences.begin(PREFERENCES_NAMESPACE, false)) {
-        DEBUG_PRINTLN("Failed to open preferences for writing QR settings.");
-        return false;
-    }
-
     guestWifiPass = pass;
     guestWifiEnc = enc;
     guestWifiSsid = ssid;
 
-    preferences.putString("guestWifiPass", guestWifiPass);
-    preferences.putString("guestWifiEnc", guestWifiEnc);
-    preferences.putString("guestWifiSsid", guestWifiSsid);
-    preferences.end();
+    nvsStore.putString(PREFERENCES_NAMESPACE, "guestWifiPass", guestWifiPass);
+    nvsStore.putString(PREFERENCES_NAMESPACE, "guestWifiEnc", guestWifiEnc);
+    nvsStore.putString(PREFERENCES_NAMESPACE, "guestWifiSsid", guestWifiSsid);
 
     DEBUG_PRINTLN("QR settings saved");
     return true;
@@ -1,5 +1,6 @@
 #include "siren.h"
 #include "config.h"
+#include "trace.h"
 
 Siren::Siren(int pin)
     : relayPin(pin)
@@ -70,7 +71,7 @@ void Siren::update() {
                 digitalWrite(relayPin, HIGH);
                 relayOn = true;
                 lastActionTime = now;
-                DEBUG_PRINTF("Siren blast %d\n", blastsRemaining);
+                TRACE("Siren blast %d", blastsRemaining);
             }
         } else {
             active = false;
@@ -83,7 +84,7 @@ void Siren::start(int blasts) {
         return; // Don't start a new sequence if one is running or invalid blast count
     }
 
-    DEBUG_PRINTF("Starting siren: %d blasts\n", blasts);
+    TRACE("Starting siren: %d blasts", blasts);
     blastsRemaining = blasts;
     active = true;
     relayOn = false;
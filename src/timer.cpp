@@ -1,5 +1,6 @@
 #include "timer.h"
 #include "config.h"
+#include "clockdisc.h"
 
 Timer::Timer()
     : state(IDLE)
@@ -23,7 +24,7 @@ bool Timer::update() {
         return false;
     }
 
-    unsigned long now = millis();
+    unsigned long now = clockMillis();
     unsigned long mainElapsed = calculateElapsed(mainTimerStart, now);
 
     mainTimerRemaining = (mainElapsed < gameDuration) ? (gameDuration - mainElapsed) : 0;
@@ -41,8 +42,10 @@ bool Timer::update() {
             state = PAUSED;                     // But don't start it
             pauseAfterNext = false;             // One-shot, auto-clear
         } else {
+            // Next round starts where this one ended, not when update() noticed,
+            // so round boundaries stay on start + k*duration
             currentRound++;
-            mainTimerStart = millis();
+            mainTimerStart += gameDuration;
         }
     }
 
@@ -53,7 +56,7 @@ void Timer::start() {
     if (state == IDLE || state == FINISHED) {
         state = RUNNING;
         currentRound = 1;
-        mainTimerStart = millis();
+        mainTimerStart = clockMillis();
         mainTimerRemaining = gameDuration;
         pauseAfterNext = false;
     }
@@ -67,11 +70,11 @@ void Timer::startMidRound(unsigned int round, unsigned long remainingMs) {
 
     // Back-calculate mainTimerStart so update() computes correct remaining
     unsigned long elapsed = gameDuration - remainingMs;
-    unsigned long now = millis();
+    unsigned long now = clockMillis();
     if (now >= elapsed) {
         mainTimerStart = now - elapsed;
     } else {
-        // Handle millis() wrap (same pattern as resume())
+        // Handle clockMillis() wrap (same pattern as resume())
         mainTimerStart = (0xFFFFFFFF - elapsed) + now + 1;
     }
 }
@@ -79,7 +82,7 @@ void Timer::startMidRound(unsigned int round, unsigned long remainingMs) {
 void Timer::pause() {
     if (state == RUNNING) {
         state = PAUSED;
-        unsigned long now = millis();
+        unsigned long now = clockMillis();
         unsigned long mainElapsed = calculateElapsed(mainTimerStart, now);
         mainTimerRemaining = (mainElapsed < gameDuration) ? (gameDuration - mainElapsed) : 0;
     }
@@ -88,7 +91,7 @@ void Timer::pause() {
 void Timer::resume() {
     if (state == PAUSED) {
         state = RUNNING;
-        unsigned long now = millis();
+        unsigned long now = clockMillis();
         unsigned long mainElapsed = gameDuration - mainTimerRemaining;
 
         if (now >= mainElapsed) {
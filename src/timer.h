@@ -10,6 +10,7 @@ enum TimerState {
     FINISHED
 };
 
+// Rounds are timed on clockMillis(), millis() steered to NTP (clockdisc.h)
 class Timer {
 public:
     Timer();
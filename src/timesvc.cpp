@@ -0,0 +1,206 @@
+#include "timesvc.h"
+#include <sys/time.h>
+#include <atomic>
+#include "esp_sntp.h"
+#include "bootlog.h"
+#include "clockdisc.h"
+#include "config.h"
+#include "wifijoin.h"
+
+struct ZoneRule {
+    const char* name;
+    const char* posix;
+};
+
+// The zones offered by the settings page (data/index.html)
+static const ZoneRule ZONES[] = {
+    {"Pacific/Auckland",    "NZST-12NZDT,M9.5.0,M4.1.0/3"},
+    {"Australia/Sydney",    "AEST-10AEDT,M10.1.0,M4.1.0/3"},
+    {"Australia/Melbourne", "AEST-10AEDT,M10.1.0,M4.1.0/3"},
+    {"Australia/Brisbane",  "AEST-10"},
+    {"Australia/Perth",     "AWST-8"},
+    {"Asia/Singapore",      "<+08>-8"},
+    {"Asia/Tokyo",          "JST-9"},
+    {"Asia/Hong_Kong",      "HKT-8"},
+    {"Asia/Shanghai",       "CST-8"},
+    {"Asia/Dubai",          "<+04>-4"},
+    {"Europe/London",       "GMT0BST,M3.5.0/1,M10.5.0"},
+    {"Europe/Paris",        "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Berlin",       "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Amsterdam",    "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"America/New_York",    "EST5EDT,M3.2.0,M11.1.0"},
+    {"America/Chicago",     "CST6CDT,M3.2.0,M11.1.0"},
+    {"America/Denver",      "MST7MDT,M3.2.0,M11.1.0"},
+    {"America/Los_Angeles", "PST8PDT,M3.2.0,M11.1.0"},
+    {"America/Toronto",     "EST5EDT,M3.2.0,M11.1.0"},
+    {"America/Vancouver",   "PST8PDT,M3.2.0,M11.1.0"},
+};
+
+static TimeLocal local;
+static TimeSyncStats stats = {"none", 0, 0, 0, 0, 0};
+static String zoneName;
+static bool syncStarted = false;
+static unsigned long requestedAt = 0;    // Outstanding request (0 = none)
+static unsigned long nextPollAt = 0;
+
+// Set by sntp_sync_time() in the lwIP task, consumed by timeLoop()
+static std::atomic<bool> replied(false);
+static std::atomic<int32_t> replyOffsetMs(0);
+static std::atomic<uint32_t> replyAt(0);
+
+static const char* findZone(const String& zone) {
+    for (const ZoneRule& z : ZONES) {
+        if (zone == z.name) {
+            return z.posix;
+        }
+    }
+    return nullptr;
+}
+
+// Replaces the SNTP client's default (weak) clock update, to measure the
+// correction before applying it. Runs in the lwIP task.
+void sntp_sync_time(struct timeval* tv) {
+    struct timeval before;
+    gettimeofday(&before, nullptr);
+    settimeofday(tv, nullptr);
+
+    int32_t offsetMs = 0;
+    if (before.tv_sec >= RTC_MIN_VALID_EPOCH) {
+        int64_t diff = ((int64_t)tv->tv_sec - before.tv_sec) * 1000 +
+                       ((int64_t)tv->tv_usec - before.tv_usec) / 1000;
+        offsetMs = diff > INT32_MAX ? INT32_MAX : diff < INT32_MIN ? INT32_MIN : (int32_t)diff;
+    }
+    replyOffsetMs = offsetMs;
+    replyAt = millis();
+    replied = true;
+    sntp_set_sync_status(SNTP_SYNC_STATUS_COMPLETED);
+}
+
+static void refreshLocal(time_t now) {
+    if (now < RTC_MIN_VALID_EPOCH) {
+        local.epoch = 0;
+        return;
+    }
+    struct tm tm;
+    localtime_r(&now, &tm);
+    local.tm = tm;
+    int hour12 = tm.tm_hour % 12 == 0 ? 12 : tm.tm_hour % 12;
+    snprintf(local.clock12, sizeof(local.clock12), "%02d:%02d:%02d %s",
+             hour12, tm.tm_min, tm.tm_sec, tm.tm_hour < 12 ? "am" : "pm");
+    strftime(local.dateTime, sizeof(local.dateTime), "%Y-%m-%d %H:%M:%S", &tm);
+    local.epoch = now;
+}
+
+void timeBegin(const String& zone) {
+    if (!timeSetZone(zone)) {
+        bootLog("Clock: Unknown timezone '%s', using %s", zone.c_str(), TIMEZONE_LOCATION);
+        timeSetZone(TIMEZONE_LOCATION);
+    }
+    time_t now = time(nullptr);
+    if (now < RTC_MIN_VALID_EPOCH) {
+        bootLog("Clock: No RTC time, waiting for NTP");
+        return;
+    }
+    stats.source = "rtc";
+    bootLog("Clock: Kept across reset (%ld)", (long)now);
+}
+
+void timeStartSync() {
+    if (syncStarted) {
+        return;
+    }
+    sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    sntp_setservername(0, NTP_SERVER);
+    sntp_set_sync_interval(TIME_SYNC_INTERVAL_MS);
+    sntp_init();
+    syncStarted = true;
+    requestedAt = millis() | 1;
+}
+
+void timeLoop() {
+    unsigned long now = millis();
+
+    if (replied) {
+        replied = false;
+        stats.offsetMs = replyOffsetMs;
+        stats.lastSyncMs = replyAt | 1;
+        if (requestedAt != 0) {
+            stats.rttMs = stats.lastSyncMs - requestedAt;
+        }
+        if (stats.syncs++ == 0) {
+            bootLog("Clock: NTP sync, offset %ld ms, %lu ms after request",
+                    (long)stats.offsetMs, (unsigned long)stats.rttMs);
+        }
+        stats.source = "ntp";
+        requestedAt = 0;
+        // The clock was just set: this pair is as close to NTP as it gets
+        clockDiscSample(millis(), timeNowMs());
+        nextPollAt = now + TIME_SYNC_INTERVAL_MS;
+    } else if (requestedAt != 0 && now - requestedAt >= TIME_SYNC_TIMEOUT_MS) {
+        stats.failures++;
+        requestedAt = 0;
+        nextPollAt = now + TIME_SYNC_RETRY_MS;
+    }
+
+    // The client keeps its own interval; restarting it sends a request now
+    // and lets the reply be timed
+    if (syncStarted && requestedAt == 0 && (long)(now - nextPollAt) >= 0 && wifiJoinConnected()) {
+        requestedAt = now | 1;
+        sntp_restart();
+    }
+
+    time_t t = time(nullptr);
+    if (t != local.epoch) {
+        refreshLocal(t);
+    }
+}
+
+bool timeSetZone(const String& zone) {
+    const char* posix = findZone(zone);
+    if (!posix) {
+        return false;
+    }
+    zoneName = zone;
+    setenv("TZ", posix, 1);
+    tzset();
+    refreshLocal(time(nullptr));
+    return true;
+}
+
+bool timeZoneKnown(const String& zone) {
+    return findZone(zone) != nullptr;
+}
+
+bool timeValid() {
+    return time(nullptr) >= RTC_MIN_VALID_EPOCH;
+}
+
+time_t timeNow() {
+    return time(nullptr);
+}
+
+int64_t timeNowMs() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+const TimeLocal& timeLocal() {
+    return local;
+}
+
+const TimeSyncStats& timeSyncStats() {
+    return stats;
+}
+
+String timeStatsJson() {
+    long ageSec = stats.lastSyncMs ? (long)((millis() - stats.lastSyncMs) / 1000) : -1;
+    char buf[220];
+    snprintf(buf, sizeof(buf),
+             "{\"source\":\"%s\",\"valid\":%s,\"zone\":\"%s\",\"syncs\":%u,\"failures\":%u,"
+             "\"offsetMs\":%ld,\"rttMs\":%u,\"lastSyncAgeS\":%ld}",
+             stats.source, timeValid() ? "true" : "false", zoneName.c_str(),
+             (unsigned)stats.syncs, (unsigned)stats.failures,
+             (long)stats.offsetMs, (unsigned)stats.rttMs, ageSec);
+    return String(buf);
+}
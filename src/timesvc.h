@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+
+// =============================================================================
+// Time Service — system clock set by the ESP-IDF SNTP client, cached local time
+// =============================================================================
+//
+// The system clock (time(), gettimeofday()) is the only clock. It keeps
+// running through software and watchdog resets, so a valid time at boot is
+// used at once (source "rtc"); SNTP corrects it once WiFi is up. The SNTP
+// client runs in the lwIP task: requests, DNS and replies never touch the
+// loop task, which only decides when to ask again.
+//
+// timeLoop() refreshes a local-time breakdown and its formatted strings
+// once per second; timeLocal() readers never format or convert. Timezones
+// are IANA names resolved from a built-in table of POSIX rules, so a zone
+// change needs no network either.
+
+struct TimeLocal {
+    time_t epoch;               // UTC second the breakdown is for (0 = clock not valid)
+    struct tm tm;               // Local time
+    char clock12[12];           // "hh:mm:ss am"
+    char dateTime[20];          // "YYYY-mm-dd HH:MM:SS"
+};
+
+struct TimeSyncStats {
+    const char* source;         // "none", "rtc" (kept across reset) or "ntp"
+    uint32_t syncs;             // Replies applied since boot
+    uint32_t failures;          // Requests with no reply in TIME_SYNC_TIMEOUT_MS
+    int32_t offsetMs;           // Last correction, NTP minus the local clock (0 if it was unset)
+    uint32_t rttMs;             // Last request to reply, DNS included
+    unsigned long lastSyncMs;   // millis() of the last reply (0 = none)
+};
+
+// Apply the timezone and accept the clock if it survived a reset (setup())
+void timeBegin(const String& zone);
+
+// Start SNTP once the station is connected; polls every TIME_SYNC_INTERVAL_MS
+void timeStartSync();
+
+// Main loop: apply replies, schedule polls, refresh the local-time cache
+void timeLoop();
+
+// Switch to an IANA zone from the table; false (and no change) if unknown
+bool timeSetZone(const String& zone);
+bool timeZoneKnown(const String& zone);
+
+// Clock holds a plausible time (from NTP or kept across a reset)
+bool timeValid();
+time_t timeNow();
+int64_t timeNowMs();
+
+const TimeLocal& timeLocal();
+const TimeSyncStats& timeSyncStats();
+String timeStatsJson();
@@ -0,0 +1,236 @@
+#include "trace.h"
+#include "config.h"
+#include "freertos/FreeRTOS.h"
+
+static uint8_t ring[TRACE_BUFFER_SIZE];
+static size_t tail = 0;              // Oldest record
+static size_t used = 0;
+static uint32_t count = 0;
+static uint32_t firstSeq = 0;        // Seq of the oldest record
+static uint32_t evicted = 0;
+static const char* formats[TRACE_MAX_FORMATS];
+static uint8_t formatCount = 0;
+static portMUX_TYPE traceMux = portMUX_INITIALIZER_UNLOCKED;
+
+uint8_t traceRegister(const char* fmt) {
+    uint8_t id = TRACE_ID_NONE;
+    portENTER_CRITICAL(&traceMux);
+    for (uint8_t i = 0; i < formatCount; i++) {
+        if (formats[i] == fmt) {
+            id = i;
+            break;
+        }
+    }
+    if (id == TRACE_ID_NONE && formatCount < TRACE_MAX_FORMATS) {
+        id = formatCount;
+        formats[formatCount++] = fmt;
+    }
+    portEXIT_CRITICAL(&traceMux);
+    return id;
+}
+
+static void copyIn(size_t at, const uint8_t* data, size_t len) {
+    size_t first = min(len, TRACE_BUFFER_SIZE - at);
+    memcpy(ring + at, data, first);
+    memcpy(ring, data + first, len - first);
+}
+
+void traceWrite(uint8_t id, const uint8_t* args, size_t len) {
+    uint8_t header[TRACE_RECORD_HEADER];
+    size_t total = TRACE_RECORD_HEADER + len;
+    header[0] = (uint8_t)total;
+    header[1] = id;
+
+    portENTER_CRITICAL(&traceMux);
+    while (TRACE_BUFFER_SIZE - used < total) {
+        uint8_t oldest = ring[tail];
+        tail = (tail + oldest) % TRACE_BUFFER_SIZE;
+        used -= oldest;
+        count--;
+        firstSeq++;
+        evicted++;
+    }
+    uint32_t ms = millis();
+    memcpy(header + 2, &ms, sizeof(ms));
+    size_t at = (tail + used) % TRACE_BUFFER_SIZE;
+    copyIn(at, header, TRACE_RECORD_HEADER);
+    copyIn((at + TRACE_RECORD_HEADER) % TRACE_BUFFER_SIZE, args, len);
+    used += total;
+    count++;
+    portEXIT_CRITICAL(&traceMux);
+}
+
+uint32_t traceCount() {
+    return count;
+}
+
+// Copy of the ring, oldest record first, made inside the critical section
+// so formatting can run outside it
+struct Snapshot {
+    std::vector<uint8_t> bytes;
+    uint32_t count;
+    uint32_t firstSeq;
+    uint32_t evicted;
+    uint8_t formatCount;
+};
+
+static void takeSnapshot(Snapshot& snap) {
+    snap.bytes.resize(TRACE_BUFFER_SIZE);   // Allocate before entering the critical section
+    portENTER_CRITICAL(&traceMux);
+    size_t first = min(used, TRACE_BUFFER_SIZE - tail);
+    memcpy(snap.bytes.data(), ring + tail, first);
+    memcpy(snap.bytes.data() + first, ring, used - first);
+    snap.bytes.resize(used);
+    snap.count = count;
+    snap.firstSeq = firstSeq;
+    snap.evicted = evicted;
+    snap.formatCount = formatCount;
+    portEXIT_CRITICAL(&traceMux);
+}
+
+// Format one record by walking its format string and taking each
+// conversion's argument from the record, one snprintf per conversion
+static size_t formatRecord(const uint8_t* rec, char* out, size_t outSize) {
+    const char* f = formats[rec[1]];
+    const uint8_t* a = rec + TRACE_RECORD_HEADER;
+    const uint8_t* end = rec + rec[0];
+    size_t n = 0;
+
+    while (*f && n + 1 < outSize) {
+        if (*f != '%') {
+            out[n++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            out[n++] = '%';
+            f += 2;
+            continue;
+        }
+
+        const char* start = f++;
+        while (*f && strchr("-+ #0", *f)) f++;
+        while (*f && (isdigit((unsigned char)*f) || *f == '.')) f++;
+        int longs = 0;
+        while (*f == 'l' || *f == 'h' || *f == 'z') {
+            if (*f == 'l') longs++;
+            f++;
+        }
+        char conv = *f ? *f++ : '\0';
+
+        char spec[16];
+        size_t specLen = min((size_t)(f - start), sizeof(spec) - 1);
+        memcpy(spec, start, specLen);
+        spec[specLen] = '\0';
+
+        char* dst = out + n;
+        size_t room = outSize - n;
+        int w = 0;
+        if (strchr("diuxXoc", conv) && conv) {
+            if (longs >= 2 && a + 8 <= end) {
+                int64_t v;
+                memcpy(&v, a, 8);
+                a += 8;
+                w = snprintf(dst, room, spec, (long long)v);
+            } else if (longs < 2 && a + 4 <= end) {
+                int32_t v;
+                memcpy(&v, a, 4);
+                a += 4;
+                w = longs ? snprintf(dst, room, spec, (long)v) : snprintf(dst, room, spec, (int)v);
+            } else {
+                w = snprintf(dst, room, "?");
+            }
+        } else if (strchr("feEgG", conv) && conv) {
+            if (a + 4 <= end) {
+                float v;
+                memcpy(&v, a, 4);
+                a += 4;
+                w = snprintf(dst, room, spec, (double)v);
+            } else {
+                w = snprintf(dst, room, "?");
+            }
+        } else if (conv == 's') {
+            if (a < end && a + 1 + *a <= end) {
+                char s[TRACE_STR_MAX + 1];
+                memcpy(s, a + 1, *a);
+                s[*a] = '\0';
+                a += 1 + *a;
+                w = snprintf(dst, room, spec, s);
+            } else {
+                w = snprintf(dst, room, "?");
+            }
+        } else {
+            w = snprintf(dst, room, "%s", spec);
+        }
+        n += min((size_t)max(w, 0), room - 1);
+    }
+    out[n] = '\0';
+    return n;
+}
+
+String traceGetJson(int maxEntries) {
+    Snapshot snap;
+    takeSnapshot(snap);
+
+    // Skip to the newest maxEntries records
+    size_t off = 0;
+    for (uint32_t skip = snap.count > (uint32_t)maxEntries ? snap.count - maxEntries : 0; skip > 0; skip--) {
+        off += snap.bytes[off];
+    }
+
+    String json;
+    json.reserve(2 + min(snap.count, (uint32_t)maxEntries) * 80);
+    json = "[";
+    char line[TRACE_LINE_LEN];
+    bool first = true;
+    while (off < snap.bytes.size()) {
+        const uint8_t* rec = snap.bytes.data() + off;
+        off += rec[0];
+        if (rec[1] >= snap.formatCount) {
+            continue;
+        }
+        formatRecord(rec, line, sizeof(line));
+        uint32_t ms;
+        memcpy(&ms, rec + 2, sizeof(ms));
+
+        if (!first) json += ",";
+        first = false;
+        json += "{\"t\":";
+        json += String(ms);
+        json += ",\"m\":\"";
+        for (const char* p = line; *p; p++) {
+            if (*p == '"') json += "\\\"";
+            else if (*p == '\\') json += "\\\\";
+            else if (*p == '\n') json += "\\n";
+            else json += *p;
+        }
+        json += "\"}";
+    }
+    json += "]";
+    return json;
+}
+
+void traceDump(std::vector<uint8_t>& out) {
+    Snapshot snap;
+    takeSnapshot(snap);
+
+    auto put32 = [&out](uint32_t v) {
+        const uint8_t* b = (const uint8_t*)&v;
+        out.insert(out.end(), b, b + 4);
+    };
+
+    out.clear();
+    out.reserve(32 + snap.bytes.size() + snap.formatCount * 32);
+    const char magic[] = "TRC1";
+    out.insert(out.end(), magic, magic + 4);
+    put32(millis());
+    put32(snap.firstSeq);
+    put32(snap.evicted);
+    out.push_back(snap.formatCount);
+    for (uint8_t i = 0; i < snap.formatCount; i++) {
+        size_t len = min(strlen(formats[i]), (size_t)255);
+        out.push_back((uint8_t)len);
+        out.insert(out.end(), formats[i], formats[i] + len);
+    }
+    put32(snap.bytes.size());
+    out.insert(out.end(), snap.bytes.begin(), snap.bytes.end());
+}
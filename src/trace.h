@@ -0,0 +1,123 @@
+#pragma once
+
+#include <Arduino.h>
+#include <type_traits>
+#include <vector>
+
+// =============================================================================
+// Trace Log — deferred-format binary ring
+// =============================================================================
+//
+// TRACE("fmt", args...) stores a format id, millis() and the raw argument
+// bytes; nothing is formatted until the log is read (/diag, get_remote_log).
+// Each call site registers its format string once (function-local static)
+// and the compiler checks the arguments against it like printf.
+//
+// Argument encoding, little-endian, decoded by walking the format string:
+//   int, long, enums, bool, char          → 4 bytes (int32)
+//   long long (%lld/%llu)                 → 8 bytes
+//   float / double                        → 4 bytes (float)
+//   const char*                           → 1 length byte + up to TRACE_STR_MAX bytes
+//
+// Record: [len u8][format id u8][millis u32][args]. The ring drops its oldest
+// records to make room. Host decoder: test-server/decode-trace.js.
+
+constexpr uint8_t TRACE_ID_NONE = 0xFF;
+constexpr int TRACE_RECORD_HEADER = 6;
+constexpr int TRACE_RECORD_MAX = 64;
+constexpr int TRACE_STR_MAX = 24;
+
+uint8_t traceRegister(const char* fmt);
+void traceWrite(uint8_t id, const uint8_t* args, size_t len);
+
+// Newest maxEntries records formatted as a JSON array of {"t","m"}
+String traceGetJson(int maxEntries);
+
+// Binary dump for the host decoder: "TRC1", millis, first seq, evicted
+// count, format table, then the records oldest first
+void traceDump(std::vector<uint8_t>& out);
+
+uint32_t traceCount();
+
+inline void traceFormatCheck(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+inline void traceFormatCheck(const char* fmt, ...) {}
+
+namespace trace_detail {
+
+struct Encoder {
+    uint8_t* p;
+    uint8_t* end;
+
+    void raw(const void* v, size_t n) {
+        if (p + n <= end) {
+            memcpy(p, v, n);
+            p += n;
+        } else {
+            p = end; // Out of room: the decoder prints the rest as "?"
+        }
+    }
+
+    // Keyed on long long rather than size so %ld is 4 bytes everywhere,
+    // matching the decoder (long is 32-bit on the ESP32)
+    template <typename T>
+    struct IsLongLong : std::integral_constant<bool,
+        std::is_same<T, long long>::value || std::is_same<T, unsigned long long>::value> {};
+
+    template <typename T>
+    typename std::enable_if<(std::is_integral<T>::value && !IsLongLong<T>::value) || std::is_enum<T>::value>::type
+    put(T v) {
+        int32_t x = (int32_t)v;
+        raw(&x, sizeof(x));
+    }
+
+    template <typename T>
+    typename std::enable_if<IsLongLong<T>::value>::type
+    put(T v) {
+        int64_t x = (int64_t)v;
+        raw(&x, sizeof(x));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    put(T v) {
+        float x = (float)v;
+        raw(&x, sizeof(x));
+    }
+
+    void put(const char* s) {
+        size_t n = s ? strnlen(s, TRACE_STR_MAX) : 0;
+        if (p + 1 + n > end) {
+            p = end;
+            return;
+        }
+        *p++ = (uint8_t)n;
+        raw(s, n);
+    }
+
+    void putAll() {}
+
+    template <typename T, typename... Rest>
+    void putAll(const T& v, const Rest&... rest) {
+        put(v);
+        putAll(rest...);
+    }
+};
+
+template <typename... Args>
+inline void record(uint8_t id, const Args&... args) {
+    if (id == TRACE_ID_NONE) {
+        return;
+    }
+    uint8_t buf[TRACE_RECORD_MAX - TRACE_RECORD_HEADER];
+    Encoder enc = {buf, buf + sizeof(buf)};
+    enc.putAll(args...);
+    traceWrite(id, buf, enc.p - buf);
+}
+
+} // namespace trace_detail
+
+#define TRACE(fmt, ...) do { \
+    static const uint8_t traceId_ = traceRegister(fmt); \
+    if (false) traceFormatCheck(fmt, ##__VA_ARGS__); \
+    trace_detail::record(traceId_, ##__VA_ARGS__); \
+} while (0)
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// =============================================================================
+// Triple Buffer — lock-free handoff of whole values from one producer task
+// to one consumer task
+// =============================================================================
+//
+// The producer owns back(), the consumer owns front(), and the third buffer
+// sits in the middle slot. publish() exchanges the filled back buffer into
+// the middle (superseding an unconsumed older value) and takes back
+// whichever buffer was there; take() exchanges the consumer's front buffer
+// for a freshly published middle one. Buffers change hands by index
+// exchange, so a value is never copied and never seen half-written, and
+// neither side ever waits.
+//
+// Each side reuses the buffers it gets back, so a T holding vectors or
+// Strings keeps its capacity and steady-state handoffs don't allocate.
+
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer only: the buffer to fill before publish()
+    T& back() { return buffers[backIdx]; }
+
+    // Producer only: hand back() to the consumer
+    void publish() {
+        // Release: the consumer's acquire sees everything written to back().
+        // Acquire: the buffer we take back is no longer read by the consumer.
+        uint8_t prev = middle.exchange(backIdx | FRESH, std::memory_order_acq_rel);
+        backIdx = prev & INDEX_MASK;
+    }
+
+    // Consumer only: make the latest published value front(). False (and
+    // front() unchanged) if nothing was published since the last take().
+    bool take() {
+        if (!(middle.load(std::memory_order_acquire) & FRESH)) return false;
+        uint8_t taken = middle.exchange(frontIdx, std::memory_order_acq_rel);
+        frontIdx = taken & INDEX_MASK;
+        return true;
+    }
+
+    // Consumer only: the last value taken
+    T& front() { return buffers[frontIdx]; }
+    const T& front() const { return buffers[frontIdx]; }
+
+private:
+    static const uint8_t INDEX_MASK = 0x03;
+    static const uint8_t FRESH = 0x80;      // Middle holds an unconsumed value
+
+    T buffers[3];
+    uint8_t backIdx = 0;                    // Producer only
+    uint8_t frontIdx = 1;                   // Consumer only
+    std::atomic<uint8_t> middle{2};
+};
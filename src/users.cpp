@@ -1,6 +1,8 @@
 #include "users.h"
 #include "config.h"
+#include "nvsstore.h"
 #include "mbedtls/sha256.h"
+#include "seriallog.h"
 
 // NVS keys
 const char* UserManager::PREF_NAMESPACE = "users";
@@ -22,7 +24,7 @@ void UserManager::begin() {
 void UserManager::load() {
     Preferences prefs;
     if (!prefs.begin(PREF_NAMESPACE, true)) {
-        Serial.println("Failed to open user preferences (read-only). Using defaults.");
+        serialLog.println("Failed to open user preferences (read-only). Using defaults.");
         setDefaults();
         save(); // Save defaults
         return;
@@ -36,7 +38,7 @@ void UserManager::load() {
     // A valid hash is exactly 64 hex characters (SHA-256)
     if (storedPass.length() == 0 || !isValidHash(storedPass)) {
         // First time or plaintext - hash the password
-        Serial.println("Migrating admin password to hashed format");
+        serialLog.println("Migrating admin password to hashed format");
         if (storedPass.length() == 0) {
             storedPass = "admin"; // Default password
         }
@@ -67,7 +69,7 @@ void UserManager::load() {
 
             // Migration: Check if password is already hashed (valid 64-char hex)
             if (!isValidHash(password)) {
-                Serial.printf("Migrating password for operator '%s' to hashed format\n", username.c_str());
+                serialLog.printf("Migrating password for operator '%s' to hashed format\n", username.c_str());
                 op.password = hashPassword(password);
                 needsMigration = true;
             } else {
@@ -87,34 +89,33 @@ void UserManager::load() {
         save();
     }
 
-    Serial.printf("Loaded %d operator(s) from NVS\n", operators.size());
+    serialLog.printf("Loaded %d operator(s) from NVS\n", operators.size());
 }
 
 void UserManager::save() {
-    Preferences prefs;
-    if (!prefs.begin(PREF_NAMESPACE, false)) {
-        Serial.println("Failed to open user preferences for writing.");
-        return;
-    }
+    // Every key is staged; only the ones that changed reach flash.
 
     // Save admin credentials (hash, not plaintext)
-    prefs.putString(PREF_ADMIN_USER, adminUsername);
-    prefs.putString(PREF_ADMIN_PASS, adminPasswordHash);
+    nvsStore.putString(PREF_NAMESPACE, PREF_ADMIN_USER, adminUsername);
+    nvsStore.putString(PREF_NAMESPACE, PREF_ADMIN_PASS, adminPasswordHash);
 
     // Save operators
-    prefs.putInt(PREF_OPERATOR_COUNT, operators.size());
+    nvsStore.putInt(PREF_NAMESPACE, PREF_OPERATOR_COUNT, operators.size());
 
     for (size_t i = 0; i < operators.size() && i < MAX_OPERATORS; i++) {
         String userKey = String(PREF_OPERATOR_PREFIX) + String(i) + "_user";
         String passKey = String(PREF_OPERATOR_PREFIX) + String(i) + "_pass";
 
-        prefs.putString(userKey.c_str(), operators[i].username);
-        prefs.putString(passKey.c_str(), operators[i].password);
+        nvsStore.putString(PREF_NAMESPACE, userKey.c_str(), operators[i].username);
+        nvsStore.putString(PREF_NAMESPACE, passKey.c_str(), operators[i].password);
     }
 
-    prefs.end();
+    // Credential changes must not be lost to a reboot
+    if (!nvsStore.flush(PREF_NAMESPACE)) {
+        serialLog.println("Operator changes not saved to NVS yet, retrying");
+    }
 
-    Serial.printf("Saved %d operator(s) to NVS\n", operators.size());
+    serialLog.printf("Saved %d operator(s) to NVS\n", operators.size());
 }
 
 void UserManager::setDefaults() {
@@ -122,51 +123,51 @@ void UserManager::setDefaults() {
     adminPasswordHash = hashPassword("admin");
     operators.clear();
 
-    Serial.println("User credentials reset to factory defaults");
+    serialLog.println("User credentials reset to factory defaults");
 }
 
 UserRole UserManager::authenticate(const String& username, const String& password) {
     // Check admin
     if (username == adminUsername && verifyPassword(password, adminPasswordHash)) {
-        Serial.println("User authenticated as ADMIN");
+        serialLog.println("User authenticated as ADMIN");
         return ADMIN;
     }
 
     // Check operators
     for (const auto& op : operators) {
         if (op.username == username && verifyPassword(password, op.password)) {
-            Serial.println("User authenticated as OPERATOR");
+            serialLog.println("User authenticated as OPERATOR");
             return OPERATOR;
         }
     }
 
     // Authentication failed
-    Serial.println("Authentication failed");
+    serialLog.println("Authentication failed");
     return VIEWER;
 }
 
 bool UserManager::addOperator(const String& username, const String& password) {
     // Check if max operators reached
     if (operators.size() >= MAX_OPERATORS) {
-        Serial.println("Cannot add operator: maximum limit reached");
+        serialLog.println("Cannot add operator: maximum limit reached");
         return false;
     }
 
     // Check for empty credentials
     if (username.length() == 0 || password.length() == 0) {
-        Serial.println("Cannot add operator: empty username or password");
+        serialLog.println("Cannot add operator: empty username or password");
         return false;
     }
 
     // Check minimum password length (security requirement)
     if (password.length() < MIN_PASSWORD_LENGTH) {
-        Serial.printf("Cannot add operator: password must be at least %d characters\n", MIN_PASSWORD_LENGTH);
+        serialLog.printf("Cannot add operator: password must be at least %d characters\n", MIN_PASSWORD_LENGTH);
         return false;
     }
 
     // Check if username already exists
     if (usernameExists(username)) {
-        Serial.println("Cannot add operator: username already exists");
+        serialLog.println("Cannot add operator: username already exists");
         return false;
     }
 
@@ -179,7 +180,7 @@ bool UserManager::addOperator(const String& username, const String& password) {
 
     save();
 
-    Serial.printf("Added operator '%s'\n", username.c_str());
+    serialLog.printf("Added operator '%s'\n", username.c_str());
     return true;
 }
 
@@ -189,25 +190,25 @@ bool UserManager::removeOperator(const String& username) {
         if (it->username == username) {
             operators.erase(it);
             save();
-            Serial.printf("Removed operator '%s'\n", username.c_str());
+            serialLog.printf("Removed operator '%s'\n", username.c_str());
             return true;
         }
     }
 
-    Serial.printf("Cannot remove operator: '%s' not found\n", username.c_str());
+    serialLog.printf("Cannot remove operator: '%s' not found\n", username.c_str());
     return false;
 }
 
 bool UserManager::changePassword(const String& username, const String& oldPassword, const String& newPassword) {
     // Check new password is not empty
     if (newPassword.length() == 0) {
-        Serial.println("Cannot change password: new password is empty");
+        serialLog.println("Cannot change password: new password is empty");
         return false;
     }
 
     // Check minimum password length (security requirement)
     if (newPassword.length() < MIN_PASSWORD_LENGTH) {
-        Serial.printf("Cannot change password: new password must be at least %d characters\n", MIN_PASSWORD_LENGTH);
+        serialLog.printf("Cannot change password: new password must be at least %d characters\n", MIN_PASSWORD_LENGTH);
         return false;
     }
 
@@ -216,10 +217,10 @@ bool UserManager::changePassword(const String& username, const String& oldPasswo
         if (verifyPassword(oldPassword, adminPasswordHash)) {
             adminPasswordHash = hashPassword(newPassword);  // Store new hash
             save();
-            Serial.printf("Password changed for admin user '%s'\n", username.c_str());
+            serialLog.printf("Password changed for admin user '%s'\n", username.c_str());
             return true;
         } else {
-            Serial.println("Cannot change password: incorrect old password");
+            serialLog.println("Cannot change password: incorrect old password");
             return false;
         }
     }
@@ -230,16 +231,16 @@ bool UserManager::changePassword(const String& username, const String& oldPasswo
             if (verifyPassword(oldPassword, op.password)) {
                 op.password = hashPassword(newPassword);  // Store new hash
                 save();
-                Serial.printf("Password changed for operator '%s'\n", username.c_str());
+                serialLog.printf("Password changed for operator '%s'\n", username.c_str());
                 return true;
             } else {
-                Serial.println("Cannot change password: incorrect old password");
+                serialLog.println("Cannot change password: incorrect old password");
                 return false;
             }
         }
     }
 
-    Serial.printf("Cannot change password: user '%s' not found\n", username.c_str());
+    serialLog.printf("Cannot change password: user '%s' not found\n", username.c_str());
     return false;
 }
 
@@ -268,12 +269,12 @@ bool UserManager::usernameExists(const String& username) {
 }
 
 bool UserManager::factoryReset() {
-    Serial.println("Performing factory reset...");
+    serialLog.println("Performing factory reset...");
 
     setDefaults();
     save();
 
-    Serial.println("Factory reset complete");
+    serialLog.println("Factory reset complete");
     return true;
 }
 
@@ -306,7 +307,7 @@ bool UserManager::verifyPassword(const String& password, const String& hash) {
 
     // If hashing failed, return false
     if (computedHash.length() == 0) {
-        Serial.println("Password verification failed: hashing error");
+        serialLog.println("Password verification failed: hashing error");
         return false;
     }
 
@@ -0,0 +1,417 @@
+#include "wifijoin.h"
+#include <WiFi.h>
+#include <Preferences.h>
+#include <algorithm>
+#include "rom/crc.h"
+#include "bootlog.h"
+#include "config.h"
+#include "nvsstore.h"
+
+static const char* NVS_NS = "wifijoin";
+static const char* NVS_KEY = "last";
+static const uint32_t CACHE_MAGIC = 0x4A464957;   // "WIFJ"
+static const size_t SCAN_RESULTS_MAX = 10;         // Kept for the portal list
+
+struct WifiCache {
+    uint32_t magic;
+    char ssid[33];
+    char password[65];
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t crc;             // Over everything before it
+};
+
+struct Candidate {
+    const char* ssid;
+    const char* password;
+    int32_t rssi;
+    int32_t channel;          // 0 with no BSSID: not seen, let the driver search
+    uint8_t bssid[6];
+    bool seen;
+};
+
+// Kept across software and watchdog resets; garbage after power loss,
+// hence the magic and CRC
+RTC_NOINIT_ATTR static WifiCache rtcCache;
+
+static const WifiNetwork* knownNetworks = nullptr;
+static size_t knownCount = 0;
+
+static WifiJoinState state = WIFI_JOIN_IDLE;
+static WifiCache cache;                  // Valid when cacheSource is set
+static const char* cacheSource = nullptr;
+static WifiCache submitted;              // Portal entry (ssid/password only)
+static bool joiningSubmitted = false;
+static std::vector<Candidate> candidates;
+static size_t nextCandidate = 0;
+static std::vector<WifiScanEntry> scanResults;
+static uint32_t scanCount = 0;
+
+static unsigned long cycleStart = 0;     // Start of this join cycle
+static unsigned long phaseStart = 0;
+static unsigned long attemptStart = 0;
+static unsigned long attemptTimeout = 0;
+static const char* attemptPassword = nullptr;
+static unsigned long failedAt = 0;
+static unsigned long lastLinkCheck = 0;
+static unsigned long linkDownSince = 0;
+
+static WifiJoinStats stats = {"failed", 0, 0, 0, 0, 0, 0};
+
+static uint32_t cacheCrc(const WifiCache& c) {
+    return crc32_le(0, (const uint8_t*)&c, offsetof(WifiCache, crc));
+}
+
+static bool cacheValid(const WifiCache& c) {
+    return c.magic == CACHE_MAGIC && c.ssid[0] != '\0' && c.channel > 0 && c.crc == cacheCrc(c);
+}
+
+static bool loadNvsCache(WifiCache& c) {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NS, true)) {
+        return false;
+    }
+    bool ok = prefs.getBytesLength(NVS_KEY) == sizeof(c) && prefs.getBytes(NVS_KEY, &c, sizeof(c)) == sizeof(c);
+    prefs.end();
+    return ok && cacheValid(c);
+}
+
+// Store the current connection. The NVS copy goes through nvsStore, which
+// skips the write when nothing changed.
+static void saveCache(const char* password) {
+    WifiCache c;
+    memset(&c, 0, sizeof(c));
+    c.magic = CACHE_MAGIC;
+    strlcpy(c.ssid, WiFi.SSID().c_str(), sizeof(c.ssid));
+    strlcpy(c.password, password ? password : "", sizeof(c.password));
+    const uint8_t* bssid = WiFi.BSSID();
+    if (bssid) {
+        memcpy(c.bssid, bssid, sizeof(c.bssid));
+    }
+    c.channel = (uint8_t)WiFi.channel();
+    c.crc = cacheCrc(c);
+
+    rtcCache = c;
+    cache = c;
+    cacheSource = "rtc";
+    nvsStore.putBytes(NVS_NS, NVS_KEY, &c, sizeof(c));
+}
+
+static const char* statusName(wl_status_t status) {
+    switch (status) {
+        case WL_NO_SSID_AVAIL: return "NO_SSID_AVAIL";
+        case WL_CONNECT_FAILED: return "CONNECT_FAILED";
+        case WL_CONNECTION_LOST: return "CONNECTION_LOST";
+        case WL_DISCONNECTED: return "DISCONNECTED";
+        case WL_IDLE_STATUS: return "IDLE";
+        default: return "UNKNOWN";
+    }
+}
+
+static const char* stateName(WifiJoinState s) {
+    switch (s) {
+        case WIFI_JOIN_IDLE: return "idle";
+        case WIFI_JOIN_DIRECT: return "direct";
+        case WIFI_JOIN_SCANNING: return "scanning";
+        case WIFI_JOIN_TRYING: return "trying";
+        case WIFI_JOIN_CONNECTED: return "connected";
+        case WIFI_JOIN_FAILED: return "failed";
+    }
+    return "unknown";
+}
+
+// One WiFi.begin(); bssid and channel pin the AP when known
+static void startAttempt(const char* ssid, const char* password, int32_t channel,
+                         const uint8_t* bssid, unsigned long timeoutMs) {
+    stats.attempts++;
+    attemptStart = millis();
+    attemptTimeout = timeoutMs;
+    attemptPassword = password;
+    WiFi.begin(ssid, (password && password[0]) ? password : nullptr, channel, bssid);
+}
+
+// 1 connected, -1 failed (rejected password or timed out), 0 still trying
+static int pollAttempt(const char* ssid) {
+    wl_status_t status = WiFi.status();
+    if (status == WL_CONNECTED) {
+        return 1;
+    }
+    if (status == WL_CONNECT_FAILED || millis() - attemptStart >= attemptTimeout) {
+        bootLog("WiFi: '%s' FAILED after %lu ms - status: %d (%s)",
+                ssid, millis() - attemptStart, status, statusName(status));
+        return -1;
+    }
+    return 0;
+}
+
+static void connected(const char* path) {
+    WiFi.setAutoReconnect(true);    // From here on short drops are the driver's
+    stats.path = path;
+    stats.totalMs = millis() - cycleStart;
+    state = WIFI_JOIN_CONNECTED;
+    linkDownSince = 0;
+    saveCache(attemptPassword);
+    bootLog("WiFi: Connected to '%s' via %s in %lu ms (direct %lu, scan %lu, join %lu, %d attempts)",
+            WiFi.SSID().c_str(), path, stats.totalMs,
+            stats.directMs, stats.scanMs, stats.scanJoinMs, stats.attempts);
+}
+
+// The failed attempt is stopped first: a scan started while the station is
+// still (re)connecting fails with WIFI_SCAN_FAILED
+static void startScan() {
+    bootLog("WiFi: Scanning for networks...");
+    phaseStart = millis();
+    WiFi.disconnect();
+    WiFi.scanDelete();
+    WiFi.scanNetworks(true);
+    state = WIFI_JOIN_SCANNING;
+}
+
+// Build the candidate list from the finished scan: each known network (and
+// a cached portal network) on the strongest AP seen for it, in config order,
+// then the ones not seen, unpinned
+static void collectScan(int found) {
+    stats.scanMs = millis() - phaseStart;
+    bootLog("WiFi: Scan found %d networks in %lu ms", found, stats.scanMs);
+
+    candidates.clear();
+    bool cachedIsKnown = false;
+    for (size_t k = 0; k < knownCount; k++) {
+        candidates.push_back({knownNetworks[k].ssid, knownNetworks[k].password, -127, 0, {0}, false});
+        cachedIsKnown |= cacheSource && strcmp(cache.ssid, knownNetworks[k].ssid) == 0;
+    }
+    if (cacheSource && !cachedIsKnown) {
+        // Network joined through the captive portal
+        candidates.push_back({cache.ssid, cache.password, -127, 0, {0}, false});
+    }
+
+    scanResults.clear();
+    for (int i = 0; i < found; i++) {
+        String ssid = WiFi.SSID(i);
+        int32_t rssi = WiFi.RSSI(i);
+        bool open = WiFi.encryptionType(i) == WIFI_AUTH_OPEN;
+        bootLog("  %d: '%s' RSSI:%d Ch:%d %s", i + 1, ssid.c_str(), rssi, WiFi.channel(i),
+                open ? "OPEN" : "ENCRYPTED");
+        for (Candidate& c : candidates) {
+            if (ssid == c.ssid && rssi > c.rssi) {
+                c.rssi = rssi;
+                c.channel = WiFi.channel(i);
+                memcpy(c.bssid, WiFi.BSSID(i), sizeof(c.bssid));
+                c.seen = true;
+            }
+        }
+        if (ssid.length() > 0) {
+            scanResults.push_back({ssid, rssi, open});
+        }
+    }
+    WiFi.scanDelete();
+
+    std::sort(scanResults.begin(), scanResults.end(),
+              [](const WifiScanEntry& a, const WifiScanEntry& b) { return a.rssi > b.rssi; });
+    if (scanResults.size() > SCAN_RESULTS_MAX) {
+        scanResults.resize(SCAN_RESULTS_MAX);
+    }
+    scanCount++;
+    std::stable_partition(candidates.begin(), candidates.end(), [](const Candidate& c) { return c.seen; });
+    nextCandidate = 0;
+    phaseStart = millis();
+    state = WIFI_JOIN_TRYING;
+}
+
+// Start the next candidate, or give up on this cycle
+static void tryNextCandidate() {
+    if (nextCandidate >= candidates.size()) {
+        stats.scanJoinMs = millis() - phaseStart;
+        stats.path = "failed";
+        state = WIFI_JOIN_FAILED;
+        failedAt = millis();
+        joiningSubmitted = false;
+        bootLog("WiFi: No network after %lu ms (%d attempts), retrying in %lu s",
+                millis() - cycleStart, stats.attempts, WIFI_RETRY_INTERVAL_MS / 1000);
+        return;
+    }
+    const Candidate& c = candidates[nextCandidate++];
+    bootLog("WiFi: Trying '%s'%s", c.ssid, c.seen ? "" : " (not seen in scan)");
+    startAttempt(c.ssid, c.password, c.seen ? c.channel : 0, c.seen ? c.bssid : nullptr,
+                 WIFI_CONNECT_TIMEOUT_MS);
+}
+
+// First step of a join cycle: the cached AP if there is one, else a scan
+static void startCycle() {
+    WiFi.setAutoReconnect(false);   // The join picks each attempt itself
+    cycleStart = millis();
+    stats.directMs = stats.scanMs = stats.scanJoinMs = stats.totalMs = 0;
+    stats.attempts = 0;
+    if (cacheSource) {
+        bootLog("WiFi: Direct join to '%s' ch %u (%s cache)", cache.ssid, cache.channel, cacheSource);
+        phaseStart = millis();
+        startAttempt(cache.ssid, cache.password, cache.channel, cache.bssid, WIFI_DIRECT_JOIN_TIMEOUT_MS);
+        state = WIFI_JOIN_DIRECT;
+    } else {
+        startScan();
+    }
+}
+
+void wifiJoinBegin(const WifiNetwork* known, size_t count) {
+    knownNetworks = known;
+    knownCount = count;
+
+    // Credentials live in the cache; keep the driver from rewriting its own
+    // copy in flash on every WiFi.begin()
+    WiFi.persistent(false);
+    WiFi.mode(WIFI_STA);
+
+    if (cacheValid(rtcCache)) {
+        cache = rtcCache;
+        cacheSource = "rtc";
+    } else if (loadNvsCache(cache)) {
+        rtcCache = cache;
+        cacheSource = "nvs";
+    }
+    startCycle();
+}
+
+// Connected: let auto-reconnect handle short drops, force a reconnect if
+// the link stays down for WIFI_FORCE_RECONNECT_MS
+static void watchLink() {
+    if (millis() - lastLinkCheck < WIFI_LINK_CHECK_MS) {
+        return;
+    }
+    lastLinkCheck = millis();
+    if (WiFi.status() != WL_CONNECTED) {
+        if (linkDownSince == 0) {
+            linkDownSince = millis();
+            DEBUG_PRINTLN("WiFi: Connection lost, waiting for auto-reconnect...");
+            bootLog("WiFi: Connection lost");
+        }
+        unsigned long downTime = millis() - linkDownSince;
+        if (downTime > WIFI_FORCE_RECONNECT_MS) {
+            DEBUG_PRINTLN("WiFi: Auto-reconnect failed, forcing reconnect...");
+            bootLog("WiFi: Forcing reconnect after %lu sec", downTime / 1000);
+            WiFi.disconnect();
+            WiFi.reconnect();
+            linkDownSince = millis();   // Reset timer for next attempt
+        }
+    } else if (linkDownSince > 0) {
+        unsigned long downTime = millis() - linkDownSince;
+        DEBUG_PRINTF("WiFi: Reconnected after %lu seconds\n", downTime / 1000);
+        bootLog("WiFi: Reconnected after %lu sec", downTime / 1000);
+        linkDownSince = 0;
+    }
+}
+
+void wifiJoinLoop() {
+    switch (state) {
+        case WIFI_JOIN_IDLE:
+            break;
+
+        case WIFI_JOIN_DIRECT: {
+            int r = pollAttempt(cache.ssid);
+            if (r != 0) {
+                stats.directMs = millis() - phaseStart;
+            }
+            if (r > 0) {
+                connected(cacheSource);
+            } else if (r < 0) {
+                startScan();
+            }
+            break;
+        }
+
+        case WIFI_JOIN_SCANNING: {
+            int found = WiFi.scanComplete();
+            if (found == WIFI_SCAN_RUNNING) {
+                break;
+            }
+            collectScan(found < 0 ? 0 : found);
+            tryNextCandidate();
+            break;
+        }
+
+        case WIFI_JOIN_TRYING: {
+            int r = pollAttempt(joiningSubmitted ? submitted.ssid : candidates[nextCandidate - 1].ssid);
+            if (r > 0) {
+                stats.scanJoinMs = millis() - phaseStart;
+                connected(joiningSubmitted ? "portal" : "scan");
+                joiningSubmitted = false;
+            } else if (r < 0) {
+                if (joiningSubmitted) {
+                    nextCandidate = candidates.size();   // Only the portal entry
+                }
+                tryNextCandidate();
+            }
+            break;
+        }
+
+        case WIFI_JOIN_CONNECTED:
+            watchLink();
+            break;
+
+        case WIFI_JOIN_FAILED:
+            if (millis() - failedAt >= WIFI_RETRY_INTERVAL_MS) {
+                stats.retries++;
+                bootLog("WiFi: Retrying known networks (retry %u)", stats.retries);
+                startCycle();
+            }
+            break;
+    }
+}
+
+void wifiJoinSubmit(const char* ssid, const char* password) {
+    memset(&submitted, 0, sizeof(submitted));
+    strlcpy(submitted.ssid, ssid, sizeof(submitted.ssid));
+    strlcpy(submitted.password, password ? password : "", sizeof(submitted.password));
+    bootLog("WiFi: Trying '%s' (from portal)", submitted.ssid);
+
+    if (state == WIFI_JOIN_SCANNING) {
+        WiFi.scanDelete();
+    }
+    WiFi.setAutoReconnect(false);
+    cycleStart = phaseStart = millis();
+    stats.directMs = stats.scanMs = stats.scanJoinMs = stats.totalMs = 0;
+    stats.attempts = 0;
+    joiningSubmitted = true;
+    candidates.clear();
+    nextCandidate = 0;
+    startAttempt(submitted.ssid, submitted.password, 0, nullptr, WIFI_CONNECT_TIMEOUT_MS);
+    state = WIFI_JOIN_TRYING;
+}
+
+WifiJoinState wifiJoinState() {
+    return state;
+}
+
+bool wifiJoinConnected() {
+    return state == WIFI_JOIN_CONNECTED && WiFi.status() == WL_CONNECTED;
+}
+
+const std::vector<WifiScanEntry>& wifiJoinScanResults() {
+    return scanResults;
+}
+
+uint32_t wifiJoinScanCount() {
+    return scanCount;
+}
+
+void wifiJoinForget() {
+    memset(&rtcCache, 0, sizeof(rtcCache));
+    cacheSource = nullptr;
+    nvsStore.remove(NVS_NS, NVS_KEY);
+    if (!nvsStore.flush(NVS_NS)) {
+        DEBUG_PRINTLN("WiFi: cached credentials not removed yet, retrying");
+    }
+}
+
+const WifiJoinStats& wifiJoinStats() {
+    return stats;
+}
+
+String wifiJoinStatsJson() {
+    char buf[200];
+    snprintf(buf, sizeof(buf),
+             "{\"state\":\"%s\",\"path\":\"%s\",\"directMs\":%lu,\"scanMs\":%lu,\"scanJoinMs\":%lu,"
+             "\"totalMs\":%lu,\"attempts\":%d,\"retries\":%u}",
+             stateName(state), stats.path, stats.directMs, stats.scanMs, stats.scanJoinMs,
+             stats.totalMs, stats.attempts, (unsigned)stats.retries);
+    return String(buf);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+// =============================================================================
+// WiFi Join — background state machine, direct join first, scan on failure
+// =============================================================================
+//
+// The last network joined (SSID, password, BSSID, channel) is cached in RTC
+// memory, which survives a reset but not a power cut, and in NVS. The join
+// tries that AP directly on its channel, skipping the scan and the channel
+// sweep; after a reset the timer is back on the network in about a second.
+// Only if that fails does it scan and try the known networks in range, in
+// wifi_credentials.h order, each on the AP and channel the scan found.
+// Known networks the scan did not see (hidden SSIDs) are tried last.
+//
+// Nothing here blocks: wifiJoinBegin() starts the first step and
+// wifiJoinLoop(), called from the main loop, advances it. The timer and
+// siren run from boot whether or not a network is ever found. After every
+// candidate has failed the join starts over every WIFI_RETRY_INTERVAL_MS;
+// once connected, dropped connections are handled here too.
+
+enum WifiJoinState : uint8_t {
+    WIFI_JOIN_IDLE,
+    WIFI_JOIN_DIRECT,        // Joining the cached AP
+    WIFI_JOIN_SCANNING,      // Async scan after a failed direct join
+    WIFI_JOIN_TRYING,        // Trying candidates one at a time
+    WIFI_JOIN_CONNECTED,     // Joined (the link itself may be down, see loop)
+    WIFI_JOIN_FAILED         // Everything failed; waiting to retry
+};
+
+struct WifiNetwork {
+    const char* ssid;
+    const char* password;       // Empty for open networks
+};
+
+struct WifiScanEntry {
+    String ssid;
+    int32_t rssi;
+    bool open;
+};
+
+struct WifiJoinStats {
+    const char* path;           // "rtc", "nvs", "scan", "portal" or "failed"
+    unsigned long directMs;     // Direct join to the cached AP (0 if no cache)
+    unsigned long scanMs;       // Scan, only after a failed direct join
+    unsigned long scanJoinMs;   // Joining the networks the scan found
+    unsigned long totalMs;      // Begin (or retry) to connected
+    int attempts;               // WiFi.begin() calls
+    uint32_t retries;           // Full join cycles restarted after failing
+};
+
+// Station mode and the first join step. known must outlive the join.
+void wifiJoinBegin(const WifiNetwork* known, size_t count);
+
+// Main loop: advance the join, or watch the link once connected
+void wifiJoinLoop();
+
+// Join a network entered in the captive portal; cached if it works
+void wifiJoinSubmit(const char* ssid, const char* password);
+
+WifiJoinState wifiJoinState();
+bool wifiJoinConnected();
+
+// Networks seen by the last scan, strongest first (captive portal list).
+// Main loop only: the next scan rewrites it. wifiJoinScanCount() changes
+// with every scan collected.
+const std::vector<WifiScanEntry>& wifiJoinScanResults();
+uint32_t wifiJoinScanCount();
+
+// Drop the cached network (factory reset)
+void wifiJoinForget();
+
+const WifiJoinStats& wifiJoinStats();
+String wifiJoinStatsJson();
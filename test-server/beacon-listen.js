@@ -0,0 +1,107 @@
+/**
+ * Timer beacon listener
+ *
+ * Joins the timer's UDP beacon (ENABLE_BEACON in src/config.h) and prints
+ * each packet: state, round, time remaining and how far this machine's
+ * clock puts the round end from the deadline the timer announced. A stand-in
+ * for a wall display; mirrors src/beacon.h.
+ *
+ *   node beacon-listen.js                          # 239.255.66.77:5077
+ *   node beacon-listen.js --group 255.255.255.255  # broadcast beacon
+ *   node beacon-listen.js --port 5077 --all        # also print repeats/heartbeats
+ *
+ * Packet, 32 bytes little-endian: "BTB1", u8 state, u8 flags, u16 round,
+ * u16 rounds, u16 reserved, u32 change counter, u32 remaining ms,
+ * u32 round duration ms, u64 round end (Unix ms, valid with flag 4).
+ */
+
+const dgram = require('dgram');
+
+const STATES = ['IDLE', 'RUNNING', 'PAUSED', 'FINISHED'];
+const FLAG_PAUSE_AFTER_NEXT = 0x01;
+const FLAG_CONTINUOUS = 0x02;
+const FLAG_DEADLINE = 0x04;
+
+/** Decodes one beacon datagram; null if it is not one */
+function decodeBeacon(buf) {
+    if (buf.length < 32 || buf.toString('latin1', 0, 4) !== 'BTB1') return null;
+    const flags = buf.readUInt8(5);
+    return {
+        state: STATES[buf.readUInt8(4)] || `state ${buf.readUInt8(4)}`,
+        pauseAfterNext: (flags & FLAG_PAUSE_AFTER_NEXT) !== 0,
+        continuousMode: (flags & FLAG_CONTINUOUS) !== 0,
+        currentRound: buf.readUInt16LE(6),
+        numRounds: buf.readUInt16LE(8),
+        change: buf.readUInt32LE(12),
+        remainingMs: buf.readUInt32LE(16),
+        durationMs: buf.readUInt32LE(20),
+        deadlineMs: (flags & FLAG_DEADLINE) ? Number(buf.readBigUInt64LE(24)) : null,
+    };
+}
+
+function formatMs(ms) {
+    const s = Math.max(0, Math.round(ms / 1000));
+    return `${String(Math.floor(s / 60)).padStart(2, '0')}:${String(s % 60).padStart(2, '0')}`;
+}
+
+/** One line per packet, as a display would show it on receipt */
+function describeBeacon(b, nowMs) {
+    const round = b.continuousMode ? `round ${b.currentRound}` : `round ${b.currentRound}/${b.numRounds}`;
+    let line = `#${b.change} ${b.state.padEnd(8)} ${round} ${formatMs(b.remainingMs)}`;
+    if (b.pauseAfterNext) line += ' (pause after)';
+    if (b.deadlineMs !== null) {
+        // Remaining by our clock vs the packet's own figure: latency plus clock error
+        const local = b.deadlineMs - nowMs;
+        line += ` | ends ${new Date(b.deadlineMs).toISOString().slice(11, 23)}, ${local - b.remainingMs} ms vs packet`;
+    }
+    return line;
+}
+
+module.exports = { decodeBeacon, describeBeacon };
+
+// --- Standalone ---
+if (require.main === module) {
+    const args = process.argv.slice(2);
+    const opt = (name, def) => {
+        const i = args.indexOf(name);
+        return i >= 0 && i + 1 < args.length ? args[i + 1] : def;
+    };
+    const group = opt('--group', '239.255.66.77');
+    const port = parseInt(opt('--port', '5077'), 10);
+    const all = args.includes('--all');
+
+    const socket = dgram.createSocket({ type: 'udp4', reuseAddr: true });
+    let lastChange = null;
+    let received = 0;
+
+    socket.on('message', (msg, rinfo) => {
+        const b = decodeBeacon(msg);
+        if (!b) return;
+        received++;
+        if (lastChange !== null && b.change > lastChange + 1) {
+            console.log(`--- ${b.change - lastChange - 1} change(s) missed ---`);
+        }
+        if (all || b.change !== lastChange) {
+            console.log(`${new Date().toISOString().slice(11, 23)} ${rinfo.address} ${describeBeacon(b, Date.now())}`);
+        }
+        lastChange = b.change;
+    });
+
+    socket.on('error', (err) => {
+        console.error(`Beacon listener: ${err.message}`);
+        process.exit(1);
+    });
+
+    socket.bind(port, () => {
+        const first = parseInt(group.split('.')[0], 10);
+        if (first >= 224 && first <= 239) {
+            socket.addMembership(group);
+        }
+        console.log(`Listening for the timer beacon on ${group}:${port} (Ctrl+C to stop)`);
+    });
+
+    process.on('SIGINT', () => {
+        console.log(`\n${received} packet(s)`);
+        process.exit(0);
+    });
+}
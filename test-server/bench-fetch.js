@@ -0,0 +1,76 @@
+/**
+ * Hello Club fetch-pipeline benchmark
+ *
+ * Runs the firmware's paging/retry logic (hc-fetch-client.js) against the
+ * fake API (fake-helloclub.js) for 10, 100 and 1000 upcoming events under a
+ * few network conditions, and prints time-to-sync, request count, retries,
+ * bytes transferred and the estimated peak heap the ESP32 would need.
+ *
+ *   node bench-fetch.js                      all scenarios
+ *   node bench-fetch.js --scenario flaky     one scenario
+ *   node bench-fetch.js --events 100         one size
+ *
+ * Peak heap is an estimate (largest page payload + the 8 KB response
+ * document + the staged CachedEvent vector), not a host measurement.
+ */
+
+const { createFakeHelloClub } = require('./fake-helloclub');
+const { HcFetchClient, FIRMWARE } = require('./hc-fetch-client');
+
+const SIZES = [10, 100, 1000];
+
+const SCENARIOS = {
+    clean:     {},
+    slow:      { latencyMs: 150 },
+    chunked:   { chunked: true, chunkSize: 256, chunkDelayMs: 2 },
+    flaky:     { errorRate: 0.15, errorCodes: [429, 503] },
+    oversized: { oversizedAt: 10 }
+};
+
+function pad(value, width) {
+    return String(value).padStart(width);
+}
+
+async function run(scenarioName, size) {
+    // 1000 events over 7 days: one every 10 minutes, all inside the window
+    const fake = createFakeHelloClub({ events: size, spacingSec: 600, ...SCENARIOS[scenarioName] });
+    await fake.listen(0);
+    const client = new HcFetchClient(fake.url, 'test-key');
+    const result = await client.fetchEvents();
+    await fake.close();
+    return result;
+}
+
+async function main() {
+    const args = process.argv.slice(2);
+    const arg = (name) => {
+        const i = args.indexOf(`--${name}`);
+        return i === -1 ? null : args[i + 1];
+    };
+    const scenarios = arg('scenario') ? [arg('scenario')] : Object.keys(SCENARIOS);
+    const sizes = arg('events') ? [parseInt(arg('events'), 10)] : SIZES;
+
+    console.log(`Firmware limits: page ${FIRMWARE.PAGE_SIZE}, ${FIRMWARE.MAX_RETRIES} attempts, ` +
+        `cap ${FIRMWARE.MAX_API_EVENTS} API / ${FIRMWARE.MAX_CACHED_EVENTS} cached events\n`);
+    console.log('scenario   events | ok  sync ms  reqs  retry     bytes  heap est  fetched cached  error');
+    console.log('-------------------+--------------------------------------------------------------------');
+
+    for (const scenario of scenarios) {
+        if (!SCENARIOS[scenario]) {
+            console.error(`Unknown scenario: ${scenario}`);
+            process.exitCode = 1;
+            return;
+        }
+        for (const size of sizes) {
+            const r = await run(scenario, size);
+            console.log(
+                `${scenario.padEnd(10)}${pad(size, 7)} | ${r.success ? 'yes' : 'NO '}` +
+                `${pad(r.ms.toFixed(0), 9)}${pad(r.requests, 6)}${pad(r.retries, 7)}` +
+                `${pad(r.bytes, 10)}${pad(r.peakHeapEstimate, 10)}` +
+                `${pad(r.totalFromApi, 9)}${pad(r.events.length, 7)}  ${r.error}`
+            );
+        }
+    }
+}
+
+main();
@@ -0,0 +1,174 @@
+/**
+ * Trace log decoder
+ *
+ * Reads the binary trace ring from a timer's GET /trace.bin (or a saved
+ * copy) and prints it formatted, the same way the firmware formats it for
+ * /diag. Mirrors src/trace.h / src/trace.cpp.
+ *
+ *   node decode-trace.js http://192.168.1.50
+ *   curl -o trace.bin http://192.168.1.50/trace.bin && node decode-trace.js trace.bin
+ *
+ * Dump layout (little-endian): "TRC1", u32 millis at dump, u32 seq of the
+ * first record, u32 records evicted, u8 format count, formats as
+ * [u8 len][bytes], u32 record bytes, records oldest first.
+ * Record: [u8 len][u8 format id][u32 millis][args], arguments encoded by
+ * type and read back by walking the format string:
+ *   %d %i %u %x %X %o %c (and %ld...)  → 4 bytes
+ *   %lld %llu                          → 8 bytes
+ *   %f %e %g                           → 4-byte float
+ *   %s                                 → u8 length + bytes
+ */
+
+const fs = require('fs');
+const http = require('http');
+
+const RECORD_HEADER = 6;
+
+// Minimal printf for one conversion spec: flags, width, precision
+function formatOne(spec, conv, value) {
+    const m = /^%([-+ #0]*)(\d*)(?:\.(\d+))?/.exec(spec);
+    const flags = m[1];
+    const width = m[2] ? parseInt(m[2], 10) : 0;
+    const precision = m[3] !== undefined ? parseInt(m[3], 10) : undefined;
+
+    let s;
+    switch (conv) {
+        case 'd': case 'i': s = BigInt(value).toString(); break;
+        case 'u': s = (typeof value === 'bigint' ? BigInt.asUintN(64, value) : value >>> 0).toString(); break;
+        case 'x': s = (typeof value === 'bigint' ? BigInt.asUintN(64, value) : value >>> 0).toString(16); break;
+        case 'X': s = (typeof value === 'bigint' ? BigInt.asUintN(64, value) : value >>> 0).toString(16).toUpperCase(); break;
+        case 'o': s = (value >>> 0).toString(8); break;
+        case 'c': s = String.fromCharCode(value & 0xff); break;
+        case 'f': case 'F': s = value.toFixed(precision === undefined ? 6 : precision); break;
+        case 'e': case 'E': s = value.toExponential(precision === undefined ? 6 : precision); break;
+        case 'g': case 'G': s = String(Number(value.toPrecision(precision || 6))); break;
+        case 's': s = precision === undefined ? value : value.slice(0, precision); break;
+        default: return spec;
+    }
+    if (flags.includes('+') && /[dif]/i.test(conv) && !s.startsWith('-')) s = `+${s}`;
+    if (s.length < width) {
+        if (flags.includes('-')) s = s.padEnd(width);
+        else if (flags.includes('0') && conv !== 's') {
+            const sign = /^[-+]/.test(s) ? s[0] : '';
+            s = sign + s.slice(sign.length).padStart(width - sign.length, '0');
+        } else s = s.padStart(width);
+    }
+    return s;
+}
+
+/**
+ * Replicates formatRecord(): walks fmt and takes each conversion's
+ * argument from args (a Buffer). Missing arguments print as "?".
+ */
+function formatRecord(fmt, args) {
+    let out = '';
+    let a = 0;
+    const re = /%%|%[-+ #0]*\d*(?:\.\d+)?([lhz]*)([a-zA-Z]?)/g;
+    let last = 0;
+    let m;
+    while ((m = re.exec(fmt)) !== null) {
+        out += fmt.slice(last, m.index);
+        last = re.lastIndex;
+        if (m[0] === '%%') {
+            out += '%';
+            continue;
+        }
+        const longs = (m[1].match(/l/g) || []).length;
+        const conv = m[2];
+        if ('diuxXoc'.includes(conv) && conv) {
+            if (longs >= 2) {
+                if (a + 8 > args.length) { out += '?'; continue; }
+                out += formatOne(m[0], conv, args.readBigInt64LE(a));
+                a += 8;
+            } else {
+                if (a + 4 > args.length) { out += '?'; continue; }
+                out += formatOne(m[0], conv, args.readInt32LE(a));
+                a += 4;
+            }
+        } else if ('feEgGF'.includes(conv) && conv) {
+            if (a + 4 > args.length) { out += '?'; continue; }
+            out += formatOne(m[0], conv, args.readFloatLE(a));
+            a += 4;
+        } else if (conv === 's') {
+            if (a >= args.length || a + 1 + args[a] > args.length) { out += '?'; continue; }
+            out += formatOne(m[0], conv, args.toString('latin1', a + 1, a + 1 + args[a]));
+            a += 1 + args[a];
+        } else {
+            out += m[0];
+        }
+    }
+    return out + fmt.slice(last);
+}
+
+/** Parse a /trace.bin dump into { nowMs, firstSeq, evicted, formats, records } */
+function decodeTrace(buf) {
+    if (buf.length < 17 || buf.toString('latin1', 0, 4) !== 'TRC1') {
+        throw new Error('Not a trace dump (missing TRC1 header)');
+    }
+    let off = 4;
+    const nowMs = buf.readUInt32LE(off); off += 4;
+    const firstSeq = buf.readUInt32LE(off); off += 4;
+    const evicted = buf.readUInt32LE(off); off += 4;
+    const formatCount = buf[off++];
+    const formats = [];
+    for (let i = 0; i < formatCount; i++) {
+        const len = buf[off++];
+        formats.push(buf.toString('latin1', off, off + len));
+        off += len;
+    }
+    const recordBytes = buf.readUInt32LE(off); off += 4;
+    const end = Math.min(buf.length, off + recordBytes);
+
+    const records = [];
+    let seq = firstSeq;
+    while (off + RECORD_HEADER <= end) {
+        const len = buf[off];
+        if (len < RECORD_HEADER || off + len > end) break;
+        const id = buf[off + 1];
+        const ms = buf.readUInt32LE(off + 2);
+        const fmt = formats[id];
+        records.push({
+            seq: seq++,
+            ms,
+            text: fmt === undefined ? `<unknown format ${id}>` : formatRecord(fmt, buf.subarray(off + RECORD_HEADER, off + len)),
+        });
+        off += len;
+    }
+    return { nowMs, firstSeq, evicted, formats, records };
+}
+
+module.exports = { formatRecord, decodeTrace };
+
+// --- Standalone ---
+if (require.main === module) {
+    const source = process.argv[2];
+    if (!source) {
+        console.error('Usage: node decode-trace.js <http://timer-ip | trace.bin>');
+        process.exit(1);
+    }
+
+    const print = (buf) => {
+        const trace = decodeTrace(buf);
+        if (trace.evicted > 0) {
+            console.log(`--- ${trace.evicted} older record(s) overwritten ---`);
+        }
+        for (const r of trace.records) {
+            const ago = ((trace.nowMs - r.ms) / 1000).toFixed(1);
+            console.log(`#${r.seq} [${r.ms} ms, -${ago}s] ${r.text}`);
+        }
+        console.log(`${trace.records.length} record(s), ${trace.formats.length} format(s)`);
+    };
+
+    if (/^https?:\/\//.test(source)) {
+        http.get(new URL('/trace.bin', source), (res) => {
+            const chunks = [];
+            res.on('data', (c) => chunks.push(c));
+            res.on('end', () => print(Buffer.concat(chunks)));
+        }).on('error', (err) => {
+            console.error(`Fetch failed: ${err.message}`);
+            process.exit(1);
+        });
+    } else {
+        print(fs.readFileSync(source));
+    }
+}
@@ -0,0 +1,259 @@
+/**
+ * Fake Hello Club API — a local stand-in for https://api.helloclub.com
+ *
+ * Serves GET /event with the same query parameters the firmware sends
+ * (fromDate, toDate, sort, limit, offset) over plain HTTP, with switchable
+ * faults so the fetch pipeline can be exercised offline:
+ *
+ *   latencyMs      delay before the response starts
+ *   chunked        stream the body with Transfer-Encoding: chunked
+ *   chunkSize      bytes per chunk (chunked mode)
+ *   chunkDelayMs   pause between chunks (chunked mode)
+ *   errorRate      fraction of requests answered with one of errorCodes
+ *   errorCodes     e.g. [429, 503]
+ *   failFirst      answer the first N requests with errorCodes[0]
+ *   oversized      pad every page past the firmware's 32 KB limit
+ *   oversizedAt    pad only the page starting at this offset
+ *
+ * Usage as a module (tests, bench-fetch.js):
+ *   const fake = createFakeHelloClub({ events: 100 });
+ *   await fake.listen(0);  // fake.url -> http://127.0.0.1:<port>
+ *
+ * Usage standalone (point the firmware or server.js at it):
+ *   node fake-helloclub.js --port 3001 --events 100 --latency 200 --chunked
+ *
+ * POST /_fake/config with a JSON body changes options on the fly;
+ * GET /_fake/stats returns request counts and bytes sent.
+ */
+
+const http = require('http');
+
+const DEFAULTS = {
+    apiKey: 'test-key',
+    events: 20,
+    taggedRatio: 0.5,       // Fraction of events with a timer: tag
+    startEpoch: 0,          // First event start (0 = one hour from now)
+    spacingSec: 600,        // Gap between event starts
+    fillerBytes: 600,       // Extra fields the firmware's JSON filter drops
+    latencyMs: 0,
+    chunked: false,
+    chunkSize: 512,
+    chunkDelayMs: 0,
+    errorRate: 0,
+    errorCodes: [429, 503],
+    failFirst: 0,
+    oversized: false,
+    oversizedAt: -1,
+    seed: 1
+};
+
+const OVERSIZED_BYTES = 40 * 1024;  // Past HELLOCLUB's 32 KB Content-Length limit
+
+const TAGS = [
+    'timer: 12:3',
+    'timer: 20min 3 rounds siren 3',
+    'timer: 15min',
+    'timer: 12:0 warn',
+    'timer: enabled'
+];
+
+function makeRandom(seed) {
+    let s = seed;
+    return () => {
+        s = (s * 1103515245 + 12345) & 0x7fffffff;
+        return s / 0x7fffffff;
+    };
+}
+
+function buildEvents(opts) {
+    const rand = makeRandom(opts.seed);
+    const firstStart = opts.startEpoch || Math.floor(Date.now() / 1000) + 3600;
+    const filler = 'x'.repeat(opts.fillerBytes);
+    const events = [];
+    for (let i = 0; i < opts.events; i++) {
+        const start = firstStart + i * opts.spacingSec;
+        const tagged = rand() < opts.taggedRatio;
+        events.push({
+            id: (0x5f3a00000000 + i).toString(16).padStart(24, '0'),
+            name: `Court ${(i % 4) + 1} Club Night ${i}`,
+            description: 'Social play, all levels welcome.' +
+                (tagged ? '\n' + TAGS[Math.floor(rand() * TAGS.length)] : ''),
+            startDate: new Date(start * 1000).toISOString(),
+            endDate: new Date((start + 7200) * 1000).toISOString(),
+            // Fields the real API returns that the firmware filters out
+            area: { id: 'area1', name: 'Main Hall' },
+            activity: { id: 'act1', name: 'Badminton' },
+            isPublic: true,
+            notes: filler
+        });
+    }
+    return events;
+}
+
+function createFakeHelloClub(options = {}) {
+    let opts = { ...DEFAULTS, ...options };
+    let events = buildEvents(opts);
+    let rand = makeRandom(opts.seed);
+    const stats = { requests: 0, bytesSent: 0, byStatus: {} };
+
+    function configure(changes) {
+        opts = { ...opts, ...changes };
+        if ('events' in changes || 'taggedRatio' in changes || 'startEpoch' in changes ||
+            'spacingSec' in changes || 'fillerBytes' in changes || 'seed' in changes) {
+            events = buildEvents(opts);
+        }
+        if ('seed' in changes) rand = makeRandom(opts.seed);
+    }
+
+    function resetStats() {
+        stats.requests = 0;
+        stats.bytesSent = 0;
+        stats.byStatus = {};
+    }
+
+    function send(res, status, body, headers = {}) {
+        stats.byStatus[status] = (stats.byStatus[status] || 0) + 1;
+        const buf = Buffer.from(body);
+        stats.bytesSent += buf.length;
+
+        if (!opts.chunked || status !== 200) {
+            res.writeHead(status, { 'Content-Type': 'application/json', 'Content-Length': buf.length, ...headers });
+            res.end(buf);
+            return;
+        }
+
+        // No Content-Length: the client sees getSize() == -1
+        res.writeHead(status, { 'Content-Type': 'application/json', 'Transfer-Encoding': 'chunked', ...headers });
+        let pos = 0;
+        const writeNext = () => {
+            if (res.destroyed) return;
+            if (pos >= buf.length) {
+                res.end();
+                return;
+            }
+            res.write(buf.subarray(pos, pos + opts.chunkSize));
+            pos += opts.chunkSize;
+            if (opts.chunkDelayMs > 0) setTimeout(writeNext, opts.chunkDelayMs);
+            else setImmediate(writeNext);
+        };
+        writeNext();
+    }
+
+    function handleEvent(req, res, url) {
+        if (req.headers['x-api-key'] !== opts.apiKey) {
+            send(res, 401, JSON.stringify({ message: 'Invalid API key' }));
+            return;
+        }
+
+        const requestNo = stats.requests;  // Already counted
+        if (requestNo <= opts.failFirst || (opts.errorRate > 0 && rand() < opts.errorRate)) {
+            const code = requestNo <= opts.failFirst
+                ? opts.errorCodes[0]
+                : opts.errorCodes[Math.floor(rand() * opts.errorCodes.length)];
+            send(res, code, JSON.stringify({ message: `Injected ${code}` }),
+                code === 429 ? { 'Retry-After': '1' } : {});
+            return;
+        }
+
+        const q = url.searchParams;
+        const from = q.get('fromDate') ? Date.parse(q.get('fromDate')) : -Infinity;
+        const to = q.get('toDate') ? Date.parse(q.get('toDate')) : Infinity;
+        const limit = Math.max(1, parseInt(q.get('limit') || '50', 10));
+        const offset = Math.max(0, parseInt(q.get('offset') || '0', 10));
+
+        const inRange = events.filter((e) => {
+            const t = Date.parse(e.startDate);
+            return t >= from && t <= to;
+        });
+        const page = inRange.slice(offset, offset + limit);
+        const body = { events: page, meta: { total: inRange.length, offset, limit } };
+        if (opts.oversized || offset === opts.oversizedAt) {
+            body.meta.padding = 'p'.repeat(OVERSIZED_BYTES);
+        }
+        send(res, 200, JSON.stringify(body));
+    }
+
+    function handleConfig(req, res) {
+        let raw = '';
+        req.on('data', (chunk) => { raw += chunk; });
+        req.on('end', () => {
+            try {
+                configure(JSON.parse(raw || '{}'));
+                resetStats();
+                res.writeHead(200, { 'Content-Type': 'application/json' });
+                res.end(JSON.stringify(opts));
+            } catch (e) {
+                res.writeHead(400, { 'Content-Type': 'application/json' });
+                res.end(JSON.stringify({ message: e.message }));
+            }
+        });
+    }
+
+    const server = http.createServer((req, res) => {
+        const url = new URL(req.url, 'http://localhost');
+
+        if (url.pathname === '/_fake/config' && req.method === 'POST') {
+            handleConfig(req, res);
+            return;
+        }
+        if (url.pathname === '/_fake/stats') {
+            res.writeHead(200, { 'Content-Type': 'application/json' });
+            res.end(JSON.stringify(stats));
+            return;
+        }
+        if (url.pathname !== '/event' || req.method !== 'GET') {
+            res.writeHead(404, { 'Content-Type': 'application/json' });
+            res.end(JSON.stringify({ message: 'Not found' }));
+            return;
+        }
+
+        stats.requests++;
+        if (opts.latencyMs > 0) setTimeout(() => handleEvent(req, res, url), opts.latencyMs);
+        else handleEvent(req, res, url);
+    });
+
+    const fake = {
+        server,
+        stats,
+        url: '',
+        configure,
+        resetStats,
+        listen(port = 0, host = '127.0.0.1') {
+            return new Promise((resolve) => {
+                server.listen(port, host, () => {
+                    fake.url = `http://${host}:${server.address().port}`;
+                    resolve(fake);
+                });
+            });
+        },
+        close() {
+            return new Promise((resolve) => server.close(() => resolve()));
+        }
+    };
+    return fake;
+}
+
+module.exports = { createFakeHelloClub, OVERSIZED_BYTES };
+
+// --- Standalone ---
+if (require.main === module) {
+    const args = process.argv.slice(2);
+    const arg = (name, fallback) => {
+        const i = args.indexOf(`--${name}`);
+        return i === -1 ? fallback : args[i + 1];
+    };
+    const flag = (name) => args.includes(`--${name}`);
+
+    const port = parseInt(arg('port', '3001'), 10);
+    const fake = createFakeHelloClub({
+        apiKey: arg('key', DEFAULTS.apiKey),
+        events: parseInt(arg('events', String(DEFAULTS.events)), 10),
+        latencyMs: parseInt(arg('latency', '0'), 10),
+        chunked: flag('chunked'),
+        errorRate: parseFloat(arg('error-rate', '0')),
+        oversized: flag('oversized')
+    });
+    fake.listen(port, '0.0.0.0').then(() => {
+        console.log(`🧪 Fake Hello Club API on http://0.0.0.0:${port}/event (key: ${arg('key', DEFAULTS.apiKey)})`);
+    });
+}
@@ -0,0 +1,159 @@
+/**
+ * Host-side mirror of the firmware's Hello Club fetch pipeline
+ * Mirrors: src/helloclub.cpp — makeRequest(), fetchInto()
+ *
+ * Same page size, retry count, retry delays, timeout and size limits as the
+ * ESP32 client, so runs against fake-helloclub.js predict how the device
+ * behaves when the real API is slow, chunked, rate-limited or oversized.
+ * Returns the sync outcome plus the counters bench-fetch.js reports.
+ */
+
+const http = require('http');
+const https = require('https');
+
+const FIRMWARE = {
+    PAGE_SIZE: 5,
+    MAX_RETRIES: 2,
+    RETRY_DELAYS: [500, 1000],
+    REQUEST_TIMEOUT_MS: 5000,          // HELLOCLUB_REQUEST_TIMEOUT_MS
+    MAX_CONTENT_LENGTH: 32768,
+    RESPONSE_DOC_BYTES: 8192,          // DynamicJsonDocument responseDoc(8192)
+    CACHED_EVENT_BYTES: 80,            // sizeof(CachedEvent), 64-bit time_t
+    MAX_API_EVENTS: 400,               // HELLOCLUB_MAX_API_EVENTS
+    MAX_CACHED_EVENTS: 120,            // HELLOCLUB_MAX_CACHED_EVENTS
+    DAYS_AHEAD: 7                      // HELLOCLUB_DAYS_AHEAD
+};
+
+const sleep = (ms) => new Promise((r) => setTimeout(r, ms));
+
+// One HTTP GET; resolves { status, contentLength, body } or { status: -1 }
+function httpGet(url, apiKey, timeoutMs) {
+    const lib = url.startsWith('https:') ? https : http;
+    return new Promise((resolve) => {
+        const req = lib.get(url, { headers: { 'X-Api-Key': apiKey, 'Accept': 'application/json' } }, (res) => {
+            const lenHeader = res.headers['content-length'];
+            const contentLength = lenHeader === undefined ? -1 : parseInt(lenHeader, 10);
+            if (res.statusCode === 200 && contentLength > FIRMWARE.MAX_CONTENT_LENGTH) {
+                // Firmware checks getSize() and gives up without reading the body
+                res.destroy();
+                resolve({ status: 200, contentLength, body: null, bytes: 0 });
+                return;
+            }
+            const chunks = [];
+            let bytes = 0;
+            res.on('data', (c) => { chunks.push(c); bytes += c.length; });
+            res.on('end', () => resolve({
+                status: res.statusCode, contentLength, bytes,
+                body: Buffer.concat(chunks).toString('utf8')
+            }));
+            res.on('error', () => resolve({ status: -1, contentLength: -1, bytes, body: null }));
+        });
+        req.on('error', () => resolve({ status: -1, contentLength: -1, bytes: 0, body: null }));
+        req.setTimeout(timeoutMs, () => req.destroy());
+    });
+}
+
+class HcFetchClient {
+    constructor(baseUrl, apiKey, options = {}) {
+        this.baseUrl = baseUrl;
+        this.apiKey = apiKey;
+        this.retryDelays = options.retryDelays || FIRMWARE.RETRY_DELAYS;
+        this.pageSize = options.pageSize || FIRMWARE.PAGE_SIZE;
+        this.resetStats();
+    }
+
+    resetStats() {
+        this.stats = { requests: 0, retries: 0, bytes: 0, peakPayload: 0, peakHeapEstimate: 0 };
+    }
+
+    async makeRequest(endpoint, params) {
+        const url = `${this.baseUrl}${endpoint}${params ? '?' + params : ''}`;
+        let lastError = '';
+
+        for (let attempt = 0; attempt < FIRMWARE.MAX_RETRIES; attempt++) {
+            this.stats.requests++;
+            const res = await httpGet(url, this.apiKey, FIRMWARE.REQUEST_TIMEOUT_MS);
+            this.stats.bytes += res.bytes || 0;
+
+            if (res.status === 200) {
+                if (res.contentLength > FIRMWARE.MAX_CONTENT_LENGTH) {
+                    return { ok: false, error: `Response too large: ${res.contentLength} bytes` };
+                }
+                // Firmware holds the whole payload String and the parsed doc at once
+                const payload = res.body.length;
+                this.stats.peakPayload = Math.max(this.stats.peakPayload, payload);
+                try {
+                    return { ok: true, doc: JSON.parse(res.body), payload };
+                } catch (e) {
+                    return { ok: false, error: `JSON parse error: ${e.message}` };
+                }
+            }
+
+            let shouldRetry = res.status === 429 || res.status === 503 || res.status === 504 || res.status < 0;
+            lastError = `HTTP error: ${res.status}`;
+            if (res.status === 401) {
+                lastError += ' (Invalid API key)';
+                shouldRetry = false;
+            } else if (res.status === 429) {
+                lastError += ' (Rate limit exceeded)';
+            }
+
+            if (!shouldRetry || attempt === FIRMWARE.MAX_RETRIES - 1) {
+                return { ok: false, error: lastError };
+            }
+            this.stats.retries++;
+            await sleep(this.retryDelays[attempt]);
+        }
+        return { ok: false, error: lastError };
+    }
+
+    // Paged fetch; same stopping rules as HelloClubClient::fetchInto()
+    async fetchEvents(now = new Date()) {
+        const fromDate = now.toISOString();
+        const toDate = new Date(now.getTime() + FIRMWARE.DAYS_AHEAD * 86400000).toISOString();
+        const events = [];
+        let totalFromApi = 0;
+        let error = '';
+        const t0 = process.hrtime.bigint();
+
+        for (let offset = 0; offset < FIRMWARE.MAX_API_EVENTS; offset += this.pageSize) {
+            const params = `fromDate=${fromDate}&toDate=${toDate}&sort=startDate` +
+                `&limit=${this.pageSize}&offset=${offset}`;
+            const res = await this.makeRequest('/event', params);
+            if (!res.ok) {
+                error = res.error;
+                if (offset === 0) {
+                    return this.finish(t0, false, error, events, totalFromApi);
+                }
+                break;  // Later pages failing is OK — we got some events
+            }
+
+            const page = Array.isArray(res.doc) ? res.doc : (res.doc.events || []);
+            if (page.length === 0) break;
+            totalFromApi += page.length;
+
+            for (const e of page) {
+                if (!(e.description || '').toLowerCase().includes('timer:')) continue;
+                if (events.length >= FIRMWARE.MAX_CACHED_EVENTS) break;
+                events.push({ id: e.id, name: e.name, startDate: e.startDate, endDate: e.endDate });
+            }
+
+            const heap = res.payload + FIRMWARE.RESPONSE_DOC_BYTES + events.length * FIRMWARE.CACHED_EVENT_BYTES;
+            this.stats.peakHeapEstimate = Math.max(this.stats.peakHeapEstimate, heap);
+
+            if (page.length < this.pageSize) break;
+            if (events.length >= FIRMWARE.MAX_CACHED_EVENTS) break;
+        }
+        return this.finish(t0, true, error, events, totalFromApi);
+    }
+
+    finish(t0, success, error, events, totalFromApi) {
+        return {
+            success, error, events, totalFromApi,
+            ms: Number(process.hrtime.bigint() - t0) / 1e6,
+            ...this.stats
+        };
+    }
+}
+
+module.exports = { HcFetchClient, FIRMWARE };
@@ -0,0 +1,100 @@
+/**
+ * Hello Club webhook test sender
+ *
+ * Signs and POSTs one change notification to a timer's /hc/webhook endpoint,
+ * standing in for the cloud-to-LAN relay. Works against the real ESP32 or
+ * the mock server.
+ *
+ *   node send-webhook.js --url http://192.168.1.50 --secret s3cret \
+ *       --type updated --id 5f3a1b2c3d4e --name "Club Night" \
+ *       --start 2026-03-17T18:30:00+13:00 --minutes 120 --desc "timer: 12:3"
+ *   node send-webhook.js --url http://localhost:8080 --secret s3cret --type deleted --id 5f3a1b2c3d4e \
+ *       --start 2026-03-17T18:30:00+13:00
+ *   node send-webhook.js --url http://localhost:8080 --secret s3cret --type ping
+ *
+ * Signature: X-HC-Signature = hex HMAC-SHA256(secret, "<timestamp>.<body>"),
+ * X-HC-Timestamp = Unix seconds (the timer rejects more than 5 minutes of skew).
+ */
+
+const crypto = require('crypto');
+const http = require('http');
+
+function signWebhook(secret, timestamp, body) {
+    return crypto.createHmac('sha256', secret).update(`${timestamp}.${body}`).digest('hex');
+}
+
+function buildWebhookBody({ type, id, name, description, startDate, endDate }) {
+    if (type === 'ping') return JSON.stringify({ type: 'ping' });
+    // A delete names one occurrence: recurring events share an id
+    if (type === 'deleted') return JSON.stringify({ type: 'event.deleted', event: { id, startDate } });
+    return JSON.stringify({
+        type: `event.${type}`,
+        event: { id, name, description, startDate, endDate }
+    });
+}
+
+// POST a signed body; resolves { status, body }
+function sendWebhook(baseUrl, secret, body, { timestamp, signature } = {}) {
+    const ts = String(timestamp !== undefined ? timestamp : Math.floor(Date.now() / 1000));
+    const sig = signature !== undefined ? signature : `sha256=${signWebhook(secret, ts, body)}`;
+    const url = new URL('/hc/webhook', baseUrl);
+
+    return new Promise((resolve, reject) => {
+        const req = http.request(url, {
+            method: 'POST',
+            headers: {
+                'Content-Type': 'application/json',
+                'Content-Length': Buffer.byteLength(body),
+                'X-HC-Timestamp': ts,
+                'X-HC-Signature': sig
+            }
+        }, (res) => {
+            let data = '';
+            res.on('data', (c) => { data += c; });
+            res.on('end', () => resolve({ status: res.statusCode, body: data }));
+        });
+        req.on('error', reject);
+        req.setTimeout(5000, () => req.destroy(new Error('Request timeout')));
+        req.end(body);
+    });
+}
+
+module.exports = { signWebhook, buildWebhookBody, sendWebhook };
+
+// --- Standalone ---
+if (require.main === module) {
+    const args = process.argv.slice(2);
+    const arg = (name, fallback) => {
+        const i = args.indexOf(`--${name}`);
+        return i === -1 ? fallback : args[i + 1];
+    };
+
+    const secret = arg('secret');
+    const type = arg('type', 'updated');
+    if (!secret || !['created', 'updated', 'deleted', 'ping'].includes(type)) {
+        console.error('Usage: node send-webhook.js --url <timer> --secret <secret> ' +
+            '--type created|updated|deleted|ping [--id ID --name NAME --start ISO --minutes N --desc TEXT]');
+        process.exit(1);
+    }
+
+    const start = new Date(arg('start', new Date(Date.now() + 10 * 60000).toISOString()));
+    const minutes = parseInt(arg('minutes', '120'), 10);
+    const body = buildWebhookBody({
+        type,
+        id: arg('id', 'test0000001'),
+        name: arg('name', 'Webhook Test'),
+        description: arg('desc', 'timer: 12:3'),
+        startDate: start.toISOString(),
+        endDate: new Date(start.getTime() + minutes * 60000).toISOString()
+    });
+
+    sendWebhook(arg('url', 'http://localhost:8080'), secret, body)
+        .then(({ status, body: reply }) => {
+            console.log(`${status} ${reply}`);
+            process.exitCode = status === 202 ? 0 : 1;
+        })
+        .catch((e) => {
+            console.error(`Send failed: ${e.message}`);
+            process.exitCode = 1;
+        });
+}
@@ -1,8 +1,10 @@
 const express = require('express');
 const WebSocket = require('ws');
 const path = require('path');
+const http = require('http');
 const https = require('https');
 const os = require('os');
+const crypto = require('crypto');
 
 const app = express();
 const PORT = 8080;
@@ -24,6 +26,65 @@ const lanIp = getLanIp();
 // Serve static files from data directory
 app.use(express.static(path.join(__dirname, '../data')));
 
+// Hello Club change notifications — same contract as the firmware's /hc/webhook
+// (see API.md). Use send-webhook.js to drive it.
+app.post('/hc/webhook', express.raw({ type: '*/*', limit: 4096 }), (req, res) => {
+    if (!hcEnabled || !hcWebhookSecret) return res.status(404).send('Webhook disabled');
+
+    const ts = req.get('X-HC-Timestamp');
+    const sig = (req.get('X-HC-Signature') || '').replace(/^sha256=/, '');
+    if (!ts || !sig) return res.status(401).send('Missing signature');
+    if (Math.abs(Math.floor(Date.now() / 1000) - parseInt(ts, 10)) > 300) {
+        return res.status(401).send('Stale timestamp');
+    }
+    const body = Buffer.isBuffer(req.body) ? req.body : Buffer.alloc(0);
+    const expected = crypto.createHmac('sha256', hcWebhookSecret)
+        .update(ts + '.').update(body).digest();
+    const given = Buffer.from(sig, 'hex');
+    if (given.length !== expected.length || !crypto.timingSafeEqual(given, expected)) {
+        return res.status(401).send('Bad signature');
+    }
+
+    let msg;
+    try {
+        msg = JSON.parse(body.toString('utf8'));
+    } catch (e) {
+        return res.status(400).send('Invalid JSON');
+    }
+
+    const event = msg.event || {};
+    const id = (event.id || msg.id || '').substring(0, 12);
+    if (msg.type !== 'ping') {
+        if (!id) return res.status(400).send('Missing event id');
+        if (!['event.created', 'event.updated', 'event.deleted'].includes(msg.type)) {
+            return res.status(400).send('Unknown type');
+        }
+    }
+
+    hcPushCount++;
+    hcLastPushMs = Date.now();
+    if (msg.type === 'ping') return res.status(202).json({ queued: true });
+
+    // Touch one occurrence (id + start; recurring events share an id), or an
+    // upsert's only occurrence if its start moved. Keep triggered only if the
+    // start didn't move.
+    const cached = msg.type === 'event.deleted' ? null : toCachedEvent(event);
+    const startTime = Math.floor(new Date(event.startDate || msg.startDate).getTime() / 1000);
+    if (!cached && isNaN(startTime)) return res.status(400).send('Bad startDate');
+    const sameId = cachedEvents.filter(e => e.id === id);
+    let old = sameId.find(e => e.startTime === startTime);
+    if (!old && cached && sameId.length === 1) old = sameId[0];
+    cachedEvents = cachedEvents.filter(e => e !== old);
+    if (cached) {
+        cached.triggered = !!old && old.triggered && old.startTime === cached.startTime;
+        cachedEvents.push(cached);
+        cachedEvents.sort((a, b) => a.startTime - b.startTime);
+    }
+    console.log(`📨 HC push: ${cached ? 'upsert' : 'delete'} ${id}`);
+    broadcast({ event: 'upcoming_events', events: cachedEvents, lastSync: lastHCSync });
+    res.status(202).json({ queued: true });
+});
+
 const server = app.listen(PORT, () => {
     console.log(`\n🚀 Test Server running!`);
     console.log(`📱 Local:   http://localhost:${PORT}`);
@@ -64,6 +125,11 @@ let currentTimezone = 'Pacific/Auckland';
 let hcApiKey = '';       // Actual API key (stored in memory for testing)
 let hcEnabled = false;
 let hcDefaultDuration = 12;
+let hcWebhookSecret = '';   // POST /hc/webhook disabled while empty
+let hcPushCount = 0;
+let hcLastPushMs = 0;
+let hcStartCount = 0;
+let hcLastStartLateMs = 0;  // How late the last auto-start was (ms)
 
 // QR config
 let qrConfig = {
@@ -81,44 +147,151 @@ let lastHCSync = 0;
 // Hello Club API — Real HTTP client
 // ==========================================================================
 
-const HC_BASE_URL = 'https://api.helloclub.com';
+// Set HC_BASE_URL=http://localhost:3001 to use fake-helloclub.js instead
+const HC_BASE_URL = process.env.HC_BASE_URL || 'https://api.helloclub.com';
 const HC_DAYS_AHEAD = 7;
 const HC_TRIGGER_WINDOW_SEC = 120;
 
-function parseTimerTag(description) {
-    if (!description) return null;
-    const lower = description.toLowerCase();
-    const tagPos = lower.indexOf('timer:');
-    if (tagPos === -1) return null;
+// timer: tag parser — same single-pass grammar as HelloClubClient::parseTimerTag()
+const TAG_MAX_WARMUP_MIN = 30;
+const TAG_MAX_BREAK_SEC = 600;
+const TAG_MAX_SIREN_BLASTS = 5;
+const TAG_MAX_COURT = 99;
 
-    let value = description.substring(tagPos + 6).trim();
-    const nlPos = value.indexOf('\n');
-    if (nlPos > 0) value = value.substring(0, nlPos);
-    value = value.trim();
-    const lowerValue = value.toLowerCase();
+const isDigit = (c) => c >= '0' && c <= '9';
+const isAlpha = (c) => (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
 
-    let duration = hcDefaultDuration;
-    let rounds = 0; // 0 = continuous
+class TagLexer {
+    constructor(str, pos) {
+        this.s = str;
+        this.p = pos;
+    }
 
-    if (lowerValue.startsWith('enabled') || value === '') {
-        return { duration, rounds };
+    next() {
+        const s = this.s;
+        while (this.p < s.length && s[this.p] !== '\n' && !isDigit(s[this.p]) &&
+               !isAlpha(s[this.p]) && s[this.p] !== ':' && s[this.p] !== '=') {
+            this.p++;
+        }
+        if (this.p >= s.length || s[this.p] === '\n') return { kind: 'end' };
+
+        const c = s[this.p];
+        if (isDigit(c)) {
+            let value = 0;
+            while (this.p < s.length && isDigit(s[this.p])) {
+                if (value < 9999) value = value * 10 + (s.charCodeAt(this.p) - 48);
+                this.p++;
+            }
+            return { kind: 'num', number: Math.min(value, 9999) };
+        }
+        if (isAlpha(c)) {
+            const start = this.p;
+            while (this.p < s.length &&
+                   (isAlpha(s[this.p]) || (s[this.p] === '-' && isAlpha(s[this.p + 1] || '')))) {
+                this.p++;
+            }
+            return { kind: 'word', text: s.substring(start, this.p).toLowerCase() };
+        }
+        this.p++;
+        return { kind: c };
     }
 
-    // Parse Xmin
-    const minMatch = lowerValue.match(/(\d+)\s*min/);
-    if (minMatch) {
-        const val = parseInt(minMatch[1]);
-        if (val >= 1 && val <= 120) duration = val;
+    peek() {
+        const saved = this.p;
+        const tok = this.next();
+        this.p = saved;
+        return tok;
     }
 
-    // Parse Xrounds (optional)
-    const roundMatch = lowerValue.match(/(\d+)\s*round/);
-    if (roundMatch) {
-        const val = parseInt(roundMatch[1]);
-        if (val >= 1 && val <= 20) rounds = val;
+    readNumber() {
+        let tok = this.peek();
+        if (tok.kind === '=' || tok.kind === ':') {
+            this.next();
+            tok = this.peek();
+        }
+        if (tok.kind !== 'num') return null;
+        this.next();
+        return tok.number;
     }
 
-    return { duration, rounds };
+    skipIf(match) {
+        if (!match(this.peek())) return false;
+        this.next();
+        return true;
+    }
+}
+
+const wordIn = (...words) => (tok) => tok.kind === 'word' && words.includes(tok.text);
+const isMinutesUnit = wordIn('m', 'min', 'mins', 'minute', 'minutes');
+const isSecondsUnit = wordIn('s', 'sec', 'secs', 'second', 'seconds');
+const isRoundsUnit = wordIn('round', 'rounds');
+const isWarningWord = wordIn('warn', 'warning');
+const isBlastsUnit = wordIn('x', 'blast', 'blasts');
+
+function parseTimerTag(description) {
+    if (!description) return null;
+    const tagPos = description.toLowerCase().indexOf('timer:');
+    if (tagPos === -1) return null;
+
+    const tag = {
+        duration: hcDefaultDuration, rounds: 0, // 0 = continuous
+        warmupMin: 0, breakSec: 0, sirenBlasts: 0, court: 0, oneMinuteWarning: false
+    };
+
+    const lex = new TagLexer(description, tagPos + 6);
+    for (let tok = lex.next(); tok.kind !== 'end'; tok = lex.next()) {
+        if (tok.kind === 'num') {
+            const unit = lex.peek();
+            if (unit.kind === ':') {
+                lex.next();
+                if (tok.number >= 1 && tok.number <= 120) tag.duration = tok.number;
+                if (lex.peek().kind === 'num') {
+                    const rounds = lex.next().number;
+                    if (rounds <= 20) tag.rounds = rounds;
+                }
+            } else if (isMinutesUnit(unit)) {
+                lex.next();
+                if (tok.number === 1 && lex.skipIf(isWarningWord)) {
+                    tag.oneMinuteWarning = true;
+                } else if (tok.number >= 1 && tok.number <= 120) {
+                    tag.duration = tok.number;
+                }
+            } else if (isRoundsUnit(unit)) {
+                lex.next();
+                if (tok.number <= 20) tag.rounds = tok.number;
+            }
+            continue;
+        }
+
+        if (tok.kind !== 'word') continue;
+        if (tok.text === 'warmup' || tok.text === 'warm-up') {
+            const n = lex.readNumber();
+            if (n !== null) {
+                lex.skipIf(isMinutesUnit);
+                if (n >= 1 && n <= TAG_MAX_WARMUP_MIN) tag.warmupMin = n;
+            }
+        } else if (tok.text === 'break') {
+            const n = lex.readNumber();
+            if (n !== null) {
+                let sec = n * 60;
+                if (lex.skipIf(isSecondsUnit)) sec = n;
+                else lex.skipIf(isMinutesUnit);
+                if (sec >= 1 && sec <= TAG_MAX_BREAK_SEC) tag.breakSec = sec;
+            }
+        } else if (tok.text === 'siren' || tok.text === 'sirens') {
+            const n = lex.readNumber();
+            if (n !== null) {
+                lex.skipIf(isBlastsUnit);
+                if (n >= 1 && n <= TAG_MAX_SIREN_BLASTS) tag.sirenBlasts = n;
+            }
+        } else if (tok.text === 'court') {
+            const n = lex.readNumber();
+            if (n !== null && n >= 1 && n <= TAG_MAX_COURT) tag.court = n;
+        } else if (isWarningWord(tok)) {
+            tag.oneMinuteWarning = true;
+        }
+    }
+    return tag;
 }
 
 function hcApiFetch(endpoint, params) {
@@ -134,6 +307,7 @@ function hcApiFetch(endpoint, params) {
         const urlObj = new URL(url);
         const options = {
             hostname: urlObj.hostname,
+            port: urlObj.port || undefined,
             path: urlObj.pathname + urlObj.search,
             method: 'GET',
             headers: {
@@ -143,7 +317,8 @@ function hcApiFetch(endpoint, params) {
             }
         };
 
-        const req = https.request(options, (res) => {
+        const client = urlObj.protocol === 'http:' ? http : https;
+        const req = client.request(options, (res) => {
             let data = '';
             res.on('data', chunk => data += chunk);
             res.on('end', () => {
@@ -167,6 +342,31 @@ function hcApiFetch(endpoint, params) {
     });
 }
 
+// API event -> cached event (null without a timer: tag or with bad dates)
+function toCachedEvent(event) {
+    const parsed = parseTimerTag(event.description || '');
+    if (!parsed) return null;
+
+    const startTime = Math.floor(new Date(event.startDate).getTime() / 1000);
+    const endTime = Math.floor(new Date(event.endDate).getTime() / 1000);
+    if (isNaN(startTime) || isNaN(endTime)) return null;
+
+    return {
+        id: (event.id || '').substring(0, 12),
+        name: (event.name || 'Unnamed').substring(0, 40),
+        startTime,
+        endTime,
+        durationMin: parsed.duration,
+        numRounds: parsed.rounds,
+        warmupMin: parsed.warmupMin,
+        breakSec: parsed.breakSec,
+        sirenBlasts: parsed.sirenBlasts,
+        court: parsed.court,
+        oneMinuteWarning: parsed.oneMinuteWarning,
+        triggered: false
+    };
+}
+
 async function fetchAndCacheEvents() {
     if (!hcApiKey) {
         console.log('📅 No API key — skipping real fetch');
@@ -197,28 +397,12 @@ async function fetchAndCacheEvents() {
         const newEvents = [];
 
         for (const event of events) {
-            const description = event.description || '';
-            const parsed = parseTimerTag(description);
-            if (!parsed) continue; // Skip events without timer: tag
-
-            const id = (event.id || '').substring(0, 12);
-            const name = (event.name || 'Unnamed').substring(0, 40);
-            const startTime = Math.floor(new Date(event.startDate).getTime() / 1000);
-            const endTime = Math.floor(new Date(event.endDate).getTime() / 1000);
-
-            if (isNaN(startTime) || isNaN(endTime)) continue;
-
-            newEvents.push({
-                id,
-                name,
-                startTime,
-                endTime,
-                durationMin: parsed.duration,
-                numRounds: parsed.rounds,
-                triggered: oldTriggered.get(id) || false
-            });
+            const cached = toCachedEvent(event);
+            if (!cached) continue; // Skip events without timer: tag
+            cached.triggered = oldTriggered.get(cached.id) || false;
+            newEvents.push(cached);
 
-            console.log(`  ✅ ${name} — ${parsed.duration}min${parsed.rounds ? ' ' + parsed.rounds + 'rounds' : ' continuous'}`);
+            console.log(`  ✅ ${cached.name} — ${cached.durationMin}min${cached.numRounds ? ' ' + cached.numRounds + 'rounds' : ' continuous'}`);
 
             if (newEvents.length >= 20) break;
         }
@@ -251,6 +435,9 @@ function purgeExpiredEvents() {
 const clients = new Map();
 let nextClientId = 1;
 
+// Read-only viewer streams (GET /events, index.html?viewer)
+const eventStreams = new Set();
+
 function getFormattedTime() {
     try {
         return new Date().toLocaleTimeString('en-US', {
@@ -274,6 +461,8 @@ function sendError(ws, message) {
 
 function broadcast(data) {
     clients.forEach(client => sendMessage(client.ws, data));
+    const frame = `data: ${JSON.stringify(data)}\n\n`;
+    eventStreams.forEach(res => res.write(frame));
 }
 
 function buildSyncMessage() {
@@ -290,6 +479,27 @@ function buildSyncMessage() {
     };
 }
 
+// ==========================================================================
+// Viewer event stream — same contract as the firmware's /events
+// ==========================================================================
+
+app.get('/events', (req, res) => {
+    res.writeHead(200, { 'Content-Type': 'text/event-stream', 'Cache-Control': 'no-cache', Connection: 'keep-alive' });
+    res.write('retry: 3000\n');
+    const send = (data) => res.write(`data: ${JSON.stringify(data)}\n\n`);
+    send({ event: 'settings', settings });
+    if (timerStatus === 'RUNNING' || timerStatus === 'PAUSED') {
+        send(buildSyncMessage());
+    } else {
+        send({ event: 'state', state: { status: timerStatus, time: getFormattedTime(), currentRound,
+            numRounds: settings.numRounds, mainTimer: mainTimerRemaining, pauseAfterNext, continuousMode } });
+    }
+    send({ event: 'ntp_status', synced: true, time: getFormattedTime(), timezone: currentTimezone, autoSyncInterval: 30 });
+    eventStreams.add(res);
+    console.log(`📺 Viewer stream connected (${eventStreams.size})`);
+    req.on('close', () => eventStreams.delete(res));
+});
+
 // ==========================================================================
 // WebSocket connections
 // ==========================================================================
@@ -459,7 +669,12 @@ function handleMessage(clientId, ws, msg) {
                 event: 'helloclub_settings',
                 apiKey: hcApiKey ? '***configured***' : '',
                 enabled: hcEnabled,
-                defaultDuration: hcDefaultDuration
+                defaultDuration: hcDefaultDuration,
+                webhookSecret: hcWebhookSecret ? '***configured***' : '',
+                pushCount: hcPushCount,
+                pushLive: hcPushCount > 0 && Date.now() - hcLastPushMs < 6 * 3600 * 1000,
+                startCount: hcStartCount,
+                lastStartLateMs: hcLastStartLateMs
             });
             break;
 
@@ -471,6 +686,9 @@ function handleMessage(clientId, ws, msg) {
             }
             if (msg.enabled !== undefined) hcEnabled = msg.enabled;
             if (msg.defaultDuration !== undefined) hcDefaultDuration = msg.defaultDuration;
+            if (msg.webhookSecret !== undefined && msg.webhookSecret !== '***configured***') {
+                hcWebhookSecret = msg.webhookSecret;
+            }
             sendMessage(ws, { event: 'helloclub_settings_saved', message: 'Hello Club settings saved successfully' });
             console.log(`💾 HC settings saved — key:${hcApiKey ? 'yes' : 'no'} enabled:${hcEnabled} defaultDur:${hcDefaultDuration}min`);
 
@@ -695,11 +913,14 @@ setInterval(() => {
         if (ev.triggered) continue;
         if (nowSec >= ev.startTime && nowSec <= ev.startTime + HC_TRIGGER_WINDOW_SEC) {
             ev.triggered = true;
+            hcLastStartLateMs = Date.now() - ev.startTime * 1000;
+            hcStartCount++;
 
-            // Configure and start timer
+            // Configure and start timer; round 1 loses the lateness so
+            // round ends stay on startTime + k * duration
             settings.gameDuration = ev.durationMin * 60 * 1000;
             timerStatus = 'RUNNING';
-            mainTimerRemaining = settings.gameDuration;
+            mainTimerRemaining = Math.max(settings.gameDuration - hcLastStartLateMs, 1000);
             currentRound = 1;
             pauseAfterNext = false;
 
@@ -713,7 +934,7 @@ setInterval(() => {
             activeEventEndTime = ev.endTime;
             activeEventName = ev.name;
 
-            broadcast({ event: 'event_auto_started', eventName: ev.name, durationMin: ev.durationMin, eventEndTime: ev.endTime });
+            broadcast({ event: 'event_auto_started', eventName: ev.name, durationMin: ev.durationMin, eventEndTime: ev.endTime, startLateMs: hcLastStartLateMs });
             broadcast({
                 event: 'start',
                 status: 'RUNNING',
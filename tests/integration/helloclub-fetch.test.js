@@ -0,0 +1,124 @@
+/**
+ * Integration tests: Hello Club fetch pipeline against the fake API
+ * Mirrors: src/helloclub.cpp — makeRequest(), fetchInto()
+ *
+ * Drives test-server/hc-fetch-client.js (the firmware's paging and retry
+ * rules) against test-server/fake-helloclub.js over real HTTP.
+ */
+const path = require('path');
+
+const serverDir = path.join(__dirname, '..', '..', 'test-server');
+const { createFakeHelloClub } = require(path.join(serverDir, 'fake-helloclub'));
+const { HcFetchClient, FIRMWARE } = require(path.join(serverDir, 'hc-fetch-client'));
+
+// Short retry delays keep the suite fast; the retry count is unchanged
+const FAST = { retryDelays: [10, 20] };
+
+describe('Hello Club fetch pipeline', () => {
+  let fake;
+
+  async function startFake(options) {
+    fake = createFakeHelloClub({ taggedRatio: 1, ...options });
+    await fake.listen(0);
+    return new HcFetchClient(fake.url, 'test-key', FAST);
+  }
+
+  afterEach(async () => {
+    if (fake) await fake.close();
+    fake = null;
+  });
+
+  test('pages through all events five at a time', async () => {
+    const client = await startFake({ events: 12 });
+    const result = await client.fetchEvents();
+    expect(result.success).toBe(true);
+    expect(result.totalFromApi).toBe(12);
+    expect(result.events).toHaveLength(12);
+    expect(result.requests).toBe(3); // 5 + 5 + 2 (short page ends the loop)
+    expect(fake.stats.requests).toBe(3);
+  });
+
+  test('only events with a timer: tag are cached', async () => {
+    fake = createFakeHelloClub({ events: 40, taggedRatio: 0.5, seed: 3 });
+    await fake.listen(0);
+    const result = await new HcFetchClient(fake.url, 'test-key', FAST).fetchEvents();
+    expect(result.totalFromApi).toBe(40);
+    expect(result.events.length).toBeGreaterThan(0);
+    expect(result.events.length).toBeLessThan(40);
+  });
+
+  test('stops at the cached-event cap', async () => {
+    const client = await startFake({ events: 300 });
+    const result = await client.fetchEvents();
+    expect(result.events).toHaveLength(FIRMWARE.MAX_CACHED_EVENTS);
+    expect(result.requests).toBe(FIRMWARE.MAX_CACHED_EVENTS / FIRMWARE.PAGE_SIZE);
+  });
+
+  test('chunked responses (no Content-Length) are read in full', async () => {
+    const client = await startFake({ events: 12, chunked: true, chunkSize: 64 });
+    const result = await client.fetchEvents();
+    expect(result.success).toBe(true);
+    expect(result.events).toHaveLength(12);
+  });
+
+  test('retries once after 429 and succeeds', async () => {
+    const client = await startFake({ events: 3, failFirst: 1, errorCodes: [429] });
+    const result = await client.fetchEvents();
+    expect(result.success).toBe(true);
+    expect(result.retries).toBe(1);
+    expect(fake.stats.byStatus[429]).toBe(1);
+  });
+
+  test('gives up after two 503s on the first page', async () => {
+    const client = await startFake({ events: 3, failFirst: 2, errorCodes: [503] });
+    const result = await client.fetchEvents();
+    expect(result.success).toBe(false);
+    expect(result.error).toBe('HTTP error: 503');
+    expect(result.requests).toBe(FIRMWARE.MAX_RETRIES);
+  });
+
+  test('a wrong API key fails without retrying', async () => {
+    fake = createFakeHelloClub({ events: 3 });
+    await fake.listen(0);
+    const result = await new HcFetchClient(fake.url, 'wrong', FAST).fetchEvents();
+    expect(result.success).toBe(false);
+    expect(result.error).toContain('Invalid API key');
+    expect(result.requests).toBe(1);
+  });
+
+  test('oversized first page is rejected without reading the body', async () => {
+    const client = await startFake({ events: 10, oversized: true });
+    const result = await client.fetchEvents();
+    expect(result.success).toBe(false);
+    expect(result.error).toMatch(/^Response too large/);
+    expect(result.bytes).toBe(0);
+  });
+
+  test('oversized later page keeps the events already fetched', async () => {
+    const client = await startFake({ events: 20, oversizedAt: 10 });
+    const result = await client.fetchEvents();
+    expect(result.success).toBe(true);
+    expect(result.events).toHaveLength(10);
+    expect(result.error).toMatch(/^Response too large/);
+  });
+
+  test('query window filters events outside fromDate..toDate', async () => {
+    const now = Math.floor(Date.now() / 1000);
+    // 10 events a day apart: only the first 7-8 are inside the 7-day window
+    const client = await startFake({ events: 10, startEpoch: now + 3600, spacingSec: 86400 });
+    const result = await client.fetchEvents();
+    expect(result.totalFromApi).toBeLessThan(10);
+    expect(result.totalFromApi).toBeGreaterThanOrEqual(7);
+  });
+
+  test('config endpoint switches faults at runtime', async () => {
+    const client = await startFake({ events: 5 });
+    const res = await fetch(`${fake.url}/_fake/config`, {
+      method: 'POST',
+      body: JSON.stringify({ failFirst: 2, errorCodes: [503] }),
+    });
+    expect(res.status).toBe(200);
+    const result = await client.fetchEvents();
+    expect(result.success).toBe(false);
+  });
+});
@@ -0,0 +1,100 @@
+/**
+ * Integration tests: Hello Club webhook push (POST /hc/webhook)
+ */
+const path = require('path');
+const { createAuthenticatedClient } = require('./ws-helper');
+const { buildWebhookBody, sendWebhook } = require(
+  path.join(__dirname, '..', '..', 'test-server', 'send-webhook'));
+
+const BASE_URL = `http://localhost:${process.env.TEST_SERVER_PORT || 18080}`;
+const SECRET = 'webhook-test-secret';
+
+// One start for every body, so a delete names the occurrence it created
+const start = new Date(Math.floor(Date.now() / 60000) * 60000 + 3600 * 1000);
+
+function eventBody(type, id, extra = {}) {
+  return buildWebhookBody({
+    type,
+    id,
+    name: 'Push Night',
+    description: 'timer: 15min 2 rounds',
+    startDate: start.toISOString(),
+    endDate: new Date(start.getTime() + 7200 * 1000).toISOString(),
+    ...extra,
+  });
+}
+
+describe('Hello Club Webhook', () => {
+  let admin;
+
+  beforeEach(async () => {
+    admin = await createAuthenticatedClient('admin', 'admin');
+    admin.send({ action: 'save_helloclub_settings', enabled: true, webhookSecret: SECRET });
+    await admin.waitForEvent('helloclub_settings_saved');
+  });
+
+  afterEach(async () => {
+    admin.send({ action: 'save_helloclub_settings', enabled: false, webhookSecret: '' });
+    await admin.waitForEvent('helloclub_settings_saved');
+    admin.close();
+  });
+
+  test('signed create is applied and broadcast', async () => {
+    admin.clearMessages();
+    const res = await sendWebhook(BASE_URL, SECRET, eventBody('created', 'push00000001'));
+    expect(res.status).toBe(202);
+
+    const update = await admin.waitForEvent('upcoming_events',
+      (m) => m.events.some((e) => e.id === 'push00000001'));
+    const evt = update.events.find((e) => e.id === 'push00000001');
+    expect(evt.durationMin).toBe(15);
+    expect(evt.numRounds).toBe(2);
+  });
+
+  test('delete removes the event', async () => {
+    await sendWebhook(BASE_URL, SECRET, eventBody('created', 'push00000002'));
+    admin.clearMessages();
+    const res = await sendWebhook(BASE_URL, SECRET, eventBody('deleted', 'push00000002'));
+    expect(res.status).toBe(202);
+
+    const update = await admin.waitForEvent('upcoming_events');
+    expect(update.events.some((e) => e.id === 'push00000002')).toBe(false);
+  });
+
+  test('update that removes the timer: tag drops the event', async () => {
+    await sendWebhook(BASE_URL, SECRET, eventBody('created', 'push00000003'));
+    admin.clearMessages();
+    await sendWebhook(BASE_URL, SECRET, eventBody('updated', 'push00000003', { description: 'No timer' }));
+
+    const update = await admin.waitForEvent('upcoming_events');
+    expect(update.events.some((e) => e.id === 'push00000003')).toBe(false);
+  });
+
+  test('wrong secret is rejected', async () => {
+    const res = await sendWebhook(BASE_URL, 'not-the-secret', eventBody('created', 'push00000004'));
+    expect(res.status).toBe(401);
+  });
+
+  test('stale timestamp is rejected', async () => {
+    const old = Math.floor(Date.now() / 1000) - 3600;
+    const res = await sendWebhook(BASE_URL, SECRET, eventBody('created', 'push00000005'), { timestamp: old });
+    expect(res.status).toBe(401);
+  });
+
+  test('ping is accepted and reported in settings', async () => {
+    const res = await sendWebhook(BASE_URL, SECRET, buildWebhookBody({ type: 'ping' }));
+    expect(res.status).toBe(202);
+
+    admin.send({ action: 'get_helloclub_settings' });
+    const settings = await admin.waitForEvent('helloclub_settings');
+    expect(settings.webhookSecret).toBe('***configured***');
+    expect(settings.pushLive).toBe(true);
+  });
+
+  test('disabled webhook returns 404', async () => {
+    admin.send({ action: 'save_helloclub_settings', webhookSecret: '' });
+    await admin.waitForEvent('helloclub_settings_saved');
+    const res = await sendWebhook(BASE_URL, SECRET, buildWebhookBody({ type: 'ping' }));
+    expect(res.status).toBe(404);
+  });
+});
@@ -8,6 +8,11 @@ module.exports = {
       testMatch: [path.join(__dirname, 'unit/**/*.test.js')],
       testEnvironment: 'node',
     },
+    {
+      displayName: 'native',
+      testMatch: [path.join(__dirname, 'native/**/*.test.js')],
+      testEnvironment: 'node',
+    },
     {
       displayName: 'integration',
       testMatch: [path.join(__dirname, 'integration/**/*.test.js')],
@@ -0,0 +1,146 @@
+/**
+ * Host simulation of the disciplined match clock (src/clockdisc.cpp)
+ *
+ * Runs the real Timer in continuous mode for several hours of simulated
+ * time on a crystal that is --skew-ppm off, feeding clockDiscSample() an
+ * NTP reading (true time plus up to --jitter-ms of noise) at boot and then
+ * hourly, as the time service does. Checks:
+ *   - the measured drift matches the injected skew
+ *   - once the first phase error has been slewed out, every round ends
+ *     on startTime + k·duration in true time, within the NTP noise
+ *   - clockMillis() never runs backwards and no round is skipped
+ *   - with --idle-days, NTP then stops and the clock keeps its rate across
+ *     millis() - base passing 2^31 and 2^32 ms (second steps)
+ *
+ *   clock-discipline-sim --skew-ppm 80 [--hours 4] [--jitter-ms 10] [--round-min 15]
+ *                        [--idle-days 60]
+ *
+ * Built and run by native.test.js; exits non-zero on failure.
+ */
+#include "clockdisc.h"
+#include "timer.h"
+#include "seriallog.h"
+
+#include <cmath>
+#include <cstdlib>
+
+// Console output is irrelevant here
+SerialLog serialLog;
+size_t SerialLog::write(uint8_t) { return 1; }
+size_t SerialLog::write(const uint8_t*, size_t len) { return len; }
+size_t SerialLog::printf(const char*, ...) { return 0; }
+
+static const int64_t WALL0 = 1773700000000LL;     // True time at boot (ms)
+static const uint64_t SYNC_EVERY = 3600000;
+static const uint64_t START_AT = 10000;           // Timer start, true ms
+static const uint64_t SETTLED_AFTER = 2 * 3600000; // Rounds checked from here
+
+static int failures = 0;
+
+static void fail(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "FAIL: ");
+    vfprintf(stderr, fmt, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+    failures++;
+}
+
+static uint32_t lcg = 12345;
+static double noise() {
+    lcg = lcg * 1664525 + 1013904223;
+    return (lcg >> 8) / 8388608.0 - 1.0;          // [-1, 1)
+}
+
+int main(int argc, char** argv) {
+    double skewPpm = 0, hours = 4, jitterMs = 10, roundMin = 15, idleDays = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--skew-ppm")) skewPpm = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--hours")) hours = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--jitter-ms")) jitterMs = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--round-min")) roundMin = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--idle-days")) idleDays = atof(argv[i + 1]);
+    }
+
+    nativeSimClock() = true;
+    const uint64_t end = (uint64_t)(hours * 3600000);
+    const unsigned long duration = (unsigned long)(roundMin * 60000);
+
+    Timer timer;
+    timer.setGameDuration(duration);
+    timer.setContinuousMode(true);
+
+    uint64_t nextSync = 2000;
+    unsigned int rounds = 0;
+    long maxErr = 0;
+    long lastErr = 0;
+    uint32_t lastClock = 0;
+
+    for (uint64_t t = 0; t <= end; t++) {
+        nativeSimMillis() = 1000 + (unsigned long)llround(t * (1.0 + skewPpm * 1e-6));
+
+        if (t == nextSync) {
+            clockDiscSample(millis(), WALL0 + (int64_t)t + (int64_t)llround(noise() * jitterMs));
+            nextSync += SYNC_EVERY;
+        }
+        clockDiscLoop();
+
+        uint32_t c = clockMillis();
+        if ((int32_t)(c - lastClock) < 0) {
+            fail("clockMillis() ran backwards at %llu ms: %u -> %u", (unsigned long long)t, lastClock, c);
+        }
+        lastClock = c;
+
+        if (t == START_AT) {
+            timer.start();
+        }
+        timer.update();
+        if (timer.hasRoundEnded()) {
+            rounds++;
+            long err = (long)((int64_t)t - (int64_t)(START_AT + (uint64_t)rounds * duration));
+            lastErr = err;
+            if (t >= SETTLED_AFTER && labs(err) > labs(maxErr)) {
+                maxErr = err;
+            }
+        }
+    }
+
+    // NTP lost: one-second steps, each must read as one true second
+    const uint64_t idleEnd = end + (uint64_t)(idleDays * 86400000);
+    long maxStepErr = 0;
+    for (uint64_t t = end + 1000; t <= idleEnd; t += 1000) {
+        nativeSimMillis() = 1000 + (unsigned long)llround(t * (1.0 + skewPpm * 1e-6));
+        clockDiscLoop();
+        uint32_t c = clockMillis();
+        long stepErr = (long)(int32_t)(c - lastClock) - 1000;
+        if (labs(stepErr) > labs(maxStepErr)) {
+            maxStepErr = stepErr;
+        }
+        lastClock = c;
+    }
+    if (idleDays > 0) {
+        printf("  %.0f days without NTP: worst one-second step off by %ld ms\n", idleDays, maxStepErr);
+        if (labs(maxStepErr) > 2) fail("clock step off by %ld ms without NTP", maxStepErr);
+    }
+
+    const ClockDiscStats& s = clockDiscStats();
+    double driftPpm = s.driftPpb / 1000.0;
+    double driftTol = 2.0 * jitterMs * 1000.0 / (s.baselineMs / 1000.0) + 0.1;
+    long phaseTol = (long)(2 * jitterMs) + 10;
+    unsigned int expectedRounds = (unsigned int)((end - START_AT) / duration);
+    long rawErr = (long)llround((end - START_AT) * skewPpm * 1e-6);
+
+    printf("skew %+.1f ppm, jitter %.0f ms: drift measured %+.3f ppm over %u s (tolerance %.2f)\n",
+           skewPpm, jitterMs, driftPpm, (unsigned)(s.baselineMs / 1000), driftTol);
+    printf("  %u rounds, settled round-end error max %ld ms, last %ld ms (undisciplined: %ld ms)\n",
+           rounds, maxErr, lastErr, -rawErr);
+
+    if (!s.locked) fail("never locked");
+    if (fabs(driftPpm - skewPpm) > driftTol) fail("drift %.3f ppm, injected %.1f", driftPpm, skewPpm);
+    if (labs(maxErr) > phaseTol) fail("round end %ld ms off after settling (tolerance %ld)", maxErr, phaseTol);
+    if (rounds != expectedRounds) fail("%u rounds, expected %u", rounds, expectedRounds);
+
+    printf("%d failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * Native tests for pushed webhook changes (src/hcevents.cpp — hcApplyChange())
+ *
+ * Recurring Hello Club events share one id across occurrences, so a push
+ * must touch only the occurrence it names (id + startTime). Checks:
+ *   - a delete or update of one weekly occurrence leaves the others alone
+ *   - an update at the same start keeps the triggered and missLogged flags
+ *     (no second auto-start or log line); a moved non-recurring event loses them
+ *   - a new occurrence is added; unknown deletes and pings change nothing
+ *   - a full cache keeps its earliest events
+ *
+ * Exits non-zero on failure.
+ */
+#include "hcevents.h"
+#include "config.h"
+
+#include <algorithm>
+#include <vector>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        failures++;
+        fprintf(stderr, "FAIL: %s\n", what);
+    }
+}
+
+static const time_t WEEK1 = 1773725400;            // 2026-03-17T18:30:00+13:00
+static const time_t WEEK2 = WEEK1 + 7 * 86400;
+static const time_t WEEK3 = WEEK2 + 7 * 86400;
+
+static CachedEvent occurrence(const char* id, time_t start, uint16_t durationMin = 12) {
+    CachedEvent evt = {};
+    hcCopyField(evt.id, sizeof(evt.id), id);
+    hcCopyField(evt.name, sizeof(evt.name), "Club night");
+    evt.idHash = hcHashId(evt.id);
+    evt.startTime = start;
+    evt.endTime = start + 7200;
+    evt.durationMin = durationMin;
+    return evt;
+}
+
+static HcEventChange upsert(const char* id, time_t start, uint16_t durationMin) {
+    HcEventChange change = {};
+    change.op = HC_CHANGE_UPSERT;
+    change.evt = occurrence(id, start, durationMin);
+    return change;
+}
+
+static HcEventChange deletion(const char* id, time_t start) {
+    HcEventChange change = {};
+    change.op = HC_CHANGE_DELETE;
+    hcCopyField(change.evt.id, sizeof(change.evt.id), id);
+    change.evt.idHash = hcHashId(change.evt.id);
+    change.evt.startTime = start;
+    return change;
+}
+
+// As applyEventChange(): the caller re-sorts after each change
+static bool apply(std::vector<CachedEvent>& events, const HcEventChange& change) {
+    bool changed = hcApplyChange(events, change);
+    std::sort(events.begin(), events.end(),
+              [](const CachedEvent& a, const CachedEvent& b) { return a.startTime < b.startTime; });
+    return changed;
+}
+
+static const CachedEvent* find(const std::vector<CachedEvent>& events, const char* id, time_t start) {
+    for (const auto& evt : events) {
+        if (strcmp(evt.id, id) == 0 && evt.startTime == start) return &evt;
+    }
+    return nullptr;
+}
+
+// Two weekly occurrences of one event, the first already auto-started
+static std::vector<CachedEvent> weekly() {
+    std::vector<CachedEvent> events = {occurrence("weekly", WEEK1), occurrence("weekly", WEEK2)};
+    events[0].triggered = 1;
+    return events;
+}
+
+static void recurring() {
+    std::vector<CachedEvent> events = weekly();
+    check(apply(events, deletion("weekly", WEEK2)), "delete of one occurrence changes the cache");
+    check(events.size() == 1 && find(events, "weekly", WEEK1) && events[0].triggered,
+          "delete of one occurrence keeps the other");
+
+    events = weekly();
+    check(apply(events, upsert("weekly", WEEK1, 20)), "update of one occurrence changes the cache");
+    const CachedEvent* first = find(events, "weekly", WEEK1);
+    const CachedEvent* second = find(events, "weekly", WEEK2);
+    check(events.size() == 2 && first && second, "update of one occurrence keeps both");
+    check(first && first->durationMin == 20 && first->triggered, "updated occurrence keeps triggered");
+    check(second && second->durationMin == 12 && !second->triggered, "other occurrence untouched");
+
+    events = weekly();
+    check(apply(events, upsert("weekly", WEEK3, 12)), "new occurrence changes the cache");
+    check(events.size() == 3 && find(events, "weekly", WEEK3) && events[0].triggered,
+          "new occurrence added alongside the others");
+
+    events = weekly();
+    check(!apply(events, deletion("weekly", WEEK3)) && events.size() == 2, "delete of an unknown start");
+}
+
+static void single() {
+    std::vector<CachedEvent> events = {occurrence("once", WEEK1), occurrence("other", WEEK2)};
+    events[0].triggered = 1;
+    check(apply(events, upsert("once", WEEK1 + 1800, 15)), "moved event changes the cache");
+    const CachedEvent* moved = find(events, "once", WEEK1 + 1800);
+    check(events.size() == 2 && moved && !find(events, "once", WEEK1), "moved event replaces its old copy");
+    check(moved && !moved->triggered, "moved event loses triggered");
+
+    HcEventChange ping = {};
+    ping.op = HC_CHANGE_PING;
+    check(!apply(events, ping) && events.size() == 2, "ping changes nothing");
+
+    events = {occurrence("once", WEEK1)};
+    events[0].missLogged = 1;
+    check(apply(events, upsert("once", WEEK1, 15)) && events[0].missLogged,
+          "updated event keeps missLogged");
+    check(apply(events, upsert("once", WEEK1 + 1800, 15)) && !events[0].missLogged,
+          "moved event loses missLogged");
+}
+
+static void fullCache() {
+    std::vector<CachedEvent> events;
+    char id[13];
+    for (int i = 0; i < HELLOCLUB_MAX_CACHED_EVENTS; i++) {
+        snprintf(id, sizeof(id), "full%02d", i);
+        events.push_back(occurrence(id, WEEK1 + i * 3600));
+    }
+    check(!apply(events, upsert("late", WEEK3, 12)) && !find(events, "late", WEEK3),
+          "full cache drops a later event");
+    check(apply(events, upsert("early", WEEK1 - 3600, 12)) && find(events, "early", WEEK1 - 3600) &&
+              events.size() == (size_t)HELLOCLUB_MAX_CACHED_EVENTS,
+          "full cache: an earlier event evicts the last");
+    check(apply(events, upsert("full05", WEEK1 + 5 * 3600, 30)) &&
+              events.size() == (size_t)HELLOCLUB_MAX_CACHED_EVENTS && find(events, "full05", WEEK1 + 5 * 3600),
+          "full cache: an update in place does not evict");
+}
+
+int main() {
+    recurring();
+    single();
+    fullCache();
+
+    printf("%d failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
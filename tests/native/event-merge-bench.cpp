@@ -0,0 +1,195 @@
+/**
+ * Native benchmark for the Hello Club cache merge (src/hcevents.cpp)
+ *
+ * Every applied fetch carries triggered flags from the live cache onto the
+ * new result with hcCarryTriggered(). This program builds caches of 20, 100
+ * and 500 real CachedEvent records (recurring events share an id; half the
+ * occurrences are triggered), then for each size:
+ *   - checks the hash join against a nested-loop strcmp reference (the
+ *     matching the String-based cache used to do)
+ *   - times both (median of several runs)
+ *   - reports memory per event: the record itself, and the heap the merge
+ *     borrows for its index (counted by replacing operator new)
+ *
+ * Built and run by native.test.js; exits non-zero on failure.
+ */
+#include "hcevents.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+// Heap accounting for the memory column. Kept out of line: inlined into
+// container code, the size prefix trips -Warray-bounds.
+static size_t heapBytes = 0;
+static size_t heapPeak = 0;
+static size_t heapBlocks = 0;
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    void* p = malloc(size + sizeof(size_t));
+    if (!p) throw std::bad_alloc();
+    *(size_t*)p = size;
+    heapBytes += size;
+    heapBlocks++;
+    if (heapBytes > heapPeak) heapPeak = heapBytes;
+    return (size_t*)p + 1;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    if (!p) return;
+    size_t* base = (size_t*)p - 1;
+    heapBytes -= *base;
+    free(base);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+static int failures = 0;
+
+static void fail(const char* what, size_t n) {
+    failures++;
+    fprintf(stderr, "FAIL: %s (%u events)\n", what, (unsigned)n);
+}
+
+static const time_t BASE = 1773700000;
+
+// n occurrences: ids recur four times a week apart (a weekly session),
+// several courts share a start time, every other occurrence triggered
+static std::vector<CachedEvent> makeCache(size_t n) {
+    std::vector<CachedEvent> events;
+    events.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        CachedEvent evt = {};
+        size_t series = i / 4;
+        snprintf(evt.id, sizeof(evt.id), "%012zx", series * 0x9E3779B1u);
+        snprintf(evt.name, sizeof(evt.name), "Club night court %u", (unsigned)(series % 6 + 1));
+        evt.idHash = hcHashId(evt.id);
+        evt.startTime = BASE + (time_t)(i % 4) * 7 * 86400 + (time_t)(series / 6) * 3600;
+        evt.endTime = evt.startTime + 7200;
+        evt.durationMin = 12;
+        evt.numRounds = 3;
+        evt.triggered = (i % 2) == 0;
+        events.push_back(evt);
+    }
+    std::sort(events.begin(), events.end(),
+              [](const CachedEvent& a, const CachedEvent& b) { return a.startTime < b.startTime; });
+    return events;
+}
+
+// A fresh fetch of the same cache: API order differs, flags are clear,
+// and one occurrence in ten moved to a new start time. `keep` is how many
+// flags should carry over (triggered and not moved).
+static std::vector<CachedEvent> makeFetch(const std::vector<CachedEvent>& live, unsigned seed,
+                                          size_t& keep) {
+    std::vector<CachedEvent> staged = live;
+    std::mt19937 rng(seed);
+    std::shuffle(staged.begin(), staged.end(), rng);
+    keep = 0;
+    for (size_t i = 0; i < staged.size(); i++) {
+        if (i % 10 == 3) {
+            staged[i].startTime += 1800;
+        } else if (staged[i].triggered) {
+            keep++;
+        }
+        staged[i].triggered = 0;
+    }
+    return staged;
+}
+
+// What the String-based cache did: every staged event against every live one
+static void carryNested(const std::vector<CachedEvent>& live, std::vector<CachedEvent>& staged) {
+    for (auto& evt : staged) {
+        for (const auto& existing : live) {
+            if (existing.triggered && existing.startTime == evt.startTime &&
+                strcmp(existing.id, evt.id) == 0) {
+                evt.triggered = 1;
+                break;
+            }
+        }
+    }
+}
+
+typedef void (*CarryFn)(const std::vector<CachedEvent>&, std::vector<CachedEvent>&);
+
+// Median ns per merge; each timed run merges into a fresh copy of the fetch
+static double timeMerge(CarryFn carry, const std::vector<CachedEvent>& live,
+                        const std::vector<CachedEvent>& fetch, unsigned& sink) {
+    using namespace std::chrono;
+    const int RUNS = 9;
+    int reps = (int)(200000 / (fetch.size() + 1)) + 10;
+    std::vector<CachedEvent> staged;
+    staged.reserve(fetch.size());
+    std::vector<double> samples;
+    for (int r = 0; r < RUNS; r++) {
+        auto start = steady_clock::now();
+        for (int i = 0; i < reps; i++) {
+            staged.assign(fetch.begin(), fetch.end());
+            carry(live, staged);
+            sink += staged[i % staged.size()].triggered;
+        }
+        samples.push_back((double)duration_cast<nanoseconds>(steady_clock::now() - start).count() / reps);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[RUNS / 2];
+}
+
+int main() {
+    unsigned sink = 0;
+    printf("CachedEvent: %u bytes per event (id %u + name %u inline, no heap)\n",
+           (unsigned)sizeof(CachedEvent), (unsigned)sizeof(CachedEvent().id),
+           (unsigned)sizeof(CachedEvent().name));
+    printf("%7s %12s %12s %8s %14s %12s\n", "events", "hash join", "nested", "speedup",
+           "index heap", "per event");
+
+    const size_t SIZES[] = {20, 100, 500};
+    for (size_t n : SIZES) {
+        std::vector<CachedEvent> live = makeCache(n);
+        size_t expected = 0;
+        std::vector<CachedEvent> fetch = makeFetch(live, (unsigned)n, expected);
+
+        // Same flags as the reference, and the moved occurrences lose theirs
+        std::vector<CachedEvent> joined = fetch;
+        std::vector<CachedEvent> nested = fetch;
+        size_t before = heapBytes;
+        heapPeak = heapBytes;
+        size_t blocks = heapBlocks;
+        hcCarryTriggered(live, joined);
+        size_t indexHeap = heapPeak - before;
+        blocks = heapBlocks - blocks;
+        carryNested(live, nested);
+
+        size_t carried = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (joined[i].triggered != nested[i].triggered) {
+                fail("hash join and nested loop disagree", n);
+                break;
+            }
+            carried += joined[i].triggered;
+        }
+        if (carried != expected || carried == 0) {
+            fail("wrong number of flags carried", n);
+        }
+        if (heapBytes != before) {
+            fail("merge leaked heap", n);
+        }
+
+        double hashNs = timeMerge(hcCarryTriggered, live, fetch, sink);
+        double nestedNs = timeMerge(carryNested, live, fetch, sink);
+        printf("%7u %9.1f us %9.1f us %7.1fx %8u B/%3u %9.1f B\n", (unsigned)n, hashNs / 1000,
+               nestedNs / 1000, nestedNs / hashNs, (unsigned)indexHeap, (unsigned)blocks,
+               (double)sizeof(CachedEvent) + (double)indexHeap / n);
+
+        // Quadratic vs linear: at 500 events the join must win clearly
+        if (n >= 500 && hashNs * 2 > nestedNs) {
+            fail("hash join not faster than the nested loop", n);
+        }
+    }
+
+    printf("(checksum %u)\n%d failure(s)\n", sink, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * Native DST sweep and benchmark for the ISO 8601 date parser
+ * (src/hcparse.cpp — hcParseIsoEpoch()) and the event builder that uses it
+ * (src/hcevents.cpp — hcBuildEvent())
+ *
+ * Checks:
+ *   - Pacific/Auckland sweep: every transition 2024-2030, minute by minute
+ *     for three hours either side, written as local time with the offset in
+ *     force (from the host's tz database via localtime_r), maps back to its
+ *     UTC instant; so does every 15-minute offset from -12:00 to +14:00
+ *   - malformed and out-of-range dates return 0
+ *   - hcBuildEvent(): a bad startDate rejects the event; a bad or missing
+ *     endDate is replaced by the end of play from the timer: tag
+ *   - throughput against the substring/toInt() parser it replaced
+ *
+ * Exits non-zero on failure.
+ */
+#include "hcevents.h"
+#include "hcparse.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static int failures = 0;
+
+static void fail(const char* what, const char* input) {
+    if (++failures <= 10) {
+        fprintf(stderr, "FAIL: %s: \"%s\"\n", what, input);
+    }
+}
+
+// Local wall-clock time at t in the current TZ, with its numeric offset
+static void localISO(time_t t, char* buf, size_t len, long& gmtoff) {
+    struct tm tm;
+    localtime_r(&t, &tm);
+    gmtoff = tm.tm_gmtoff;
+    long off = gmtoff < 0 ? -gmtoff : gmtoff;
+    snprintf(buf, len, "%04d-%02d-%02dT%02d:%02d:%02d%c%02ld:%02ld", tm.tm_year + 1900, tm.tm_mon + 1,
+             tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, gmtoff < 0 ? '-' : '+', off / 3600,
+             off / 60 % 60);
+}
+
+static void aucklandSweep() {
+    if (access("/usr/share/zoneinfo/Pacific/Auckland", R_OK) != 0) {
+        printf("Pacific/Auckland sweep skipped: no tz database\n");
+        return;
+    }
+    setenv("TZ", "Pacific/Auckland", 1);
+    tzset();
+
+    // Find the transitions hour by hour
+    std::vector<time_t> transitions;
+    char iso[96];
+    long prev = 0, gmtoff;
+    for (time_t t = 1704067200; t < 1924992000; t += 3600) {     // 2024-01-01 .. 2031-01-01 UTC
+        localISO(t, iso, sizeof(iso), gmtoff);
+        if (t != 1704067200 && gmtoff != prev) transitions.push_back(t);
+        prev = gmtoff;
+    }
+    if (transitions.size() != 14) {
+        fail("expected a DST start and end each year 2024-2030", "");
+    }
+
+    int checked = 0;
+    for (time_t tr : transitions) {
+        for (time_t t = tr - 3 * 3600; t <= tr + 3 * 3600; t += 60) {
+            localISO(t, iso, sizeof(iso), gmtoff);
+            if (hcParseIsoEpoch(iso) != t) fail("local time with offset", iso);
+            checked++;
+        }
+    }
+
+    // The repeated hour at DST end is told apart by its offset
+    if (hcParseIsoEpoch("2026-04-05T02:30:00+12:00") - hcParseIsoEpoch("2026-04-05T02:30:00+13:00") != 3600) {
+        fail("repeated hour", "2026-04-05T02:30:00");
+    }
+
+    unsetenv("TZ");
+    tzset();
+    printf("Pacific/Auckland: %u transitions, %d local times checked\n", (unsigned)transitions.size(), checked);
+}
+
+// Every offset a real zone can have, in all three notations
+static void offsetSweep() {
+    const time_t t = 1773700000;    // 2026-03-16
+    char iso[96];
+    for (long off = -12 * 3600; off <= 14 * 3600; off += 900) {
+        time_t local = t + off;
+        struct tm tm;
+        gmtime_r(&local, &tm);
+        long a = off < 0 ? -off : off;
+        char sign = off < 0 ? '-' : '+';
+        snprintf(iso, sizeof(iso), "%04d-%02d-%02dT%02d:%02d:%02d.250%c%02ld:%02ld", tm.tm_year + 1900,
+                 tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, sign, a / 3600, a / 60 % 60);
+        if (hcParseIsoEpoch(iso) != t) fail("offset ±hh:mm", iso);
+        snprintf(iso, sizeof(iso), "%04d-%02d-%02d %02d:%02d:%02d%c%02ld%02ld", tm.tm_year + 1900,
+                 tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, sign, a / 3600, a / 60 % 60);
+        if (hcParseIsoEpoch(iso) != t) fail("offset ±hhmm", iso);
+        if (a % 3600 == 0) {
+            snprintf(iso, sizeof(iso), "%04d-%02d-%02dT%02d:%02d:%02d%c%02ld", tm.tm_year + 1900,
+                     tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, sign, a / 3600);
+            if (hcParseIsoEpoch(iso) != t) fail("offset ±hh", iso);
+        }
+    }
+}
+
+static void malformed() {
+    const char* const BAD[] = {
+        "", "2026", "2026-03-17", "2026-03-17T", "2026-03-17T18", "2026-03-17T18:3", "2026-3-17T18:30:00Z",
+        "2026-03-17X18:30:00Z", "2026-13-01T00:00:00Z", "2026-02-29T00:00:00Z", "2026-03-32T00:00:00Z",
+        "2026-03-17T24:00:00Z", "2026-03-17T18:60:00Z", "2026-03-17T18:30:61Z", "2026-03-17T18:30:00.Z",
+        "2026-03-17T18:30:00+15:00", "2026-03-17T18:30:00+13:60", "2026-03-17T18:30:00+1", "1969-12-31T23:59:59Z",
+        "2026-03-17T18:30:00Z ", "2026-03-17T18:30:00ZZ", "2026-03-17T18:30:00+13:00:00",
+    };
+    for (const char* iso : BAD) {
+        if (hcParseIsoEpoch(iso) != 0) fail("malformed date accepted", iso);
+    }
+    if (hcParseIsoEpoch(nullptr) != 0) fail("null accepted", "(null)");
+    if (hcParseIsoEpoch("2024-02-29T12:00Z") != 1709208000) fail("leap day, no seconds", "2024-02-29T12:00Z");
+    if (hcParseIsoEpoch("2016-12-31T23:59:60Z") != 1483228799) fail("leap second", "2016-12-31T23:59:60Z");
+}
+
+static void buildEvents() {
+    TimerTag tag = {};
+    tag.durationMin = 12;
+    tag.numRounds = 3;
+    const char* start = "2026-03-17T18:30:00+13:00";
+    const time_t startEpoch = 1773725400;
+    CachedEvent evt;
+
+    if (!hcBuildEvent("a1b2c3d4e5f6a7b8", "Club night", start, "2026-03-17T20:30:00+13:00", tag, evt) ||
+        evt.startTime != startEpoch || evt.endTime != startEpoch + 7200 || strcmp(evt.id, "a1b2c3d4e5f6") != 0 ||
+        evt.idHash != hcHashId("a1b2c3d4e5f6")) {
+        fail("well-formed event", start);
+    }
+    // Short booking: end equal to start is real data, kept as is
+    if (!hcBuildEvent("e1", "Instant", start, start, tag, evt) || evt.endTime != startEpoch) {
+        fail("end equal to start", start);
+    }
+    // End that doesn't parse, is missing, or is before the start: end of play instead of 0
+    const char* const BAD_ENDS[] = {"", "2026-03-17T20", "tomorrow", "2026-03-17T17:30:00+13:00"};
+    for (const char* end : BAD_ENDS) {
+        if (!hcBuildEvent("e2", "Bad end", start, end, tag, evt) || evt.endTime != startEpoch + 3 * 12 * 60) {
+            fail("bad endDate not replaced by end of play", end);
+        }
+    }
+    tag.numRounds = 0;      // Continuous: one round
+    if (!hcBuildEvent("e3", "Continuous", start, "", tag, evt) || evt.endTime != startEpoch + 12 * 60) {
+        fail("bad endDate, continuous mode", "");
+    }
+    if (hcBuildEvent("e4", "Bad start", "17/03/2026 18:30", "2026-03-17T20:30:00Z", tag, evt)) {
+        fail("bad startDate accepted", "17/03/2026 18:30");
+    }
+}
+
+// The parser it replaced: fixed substring offsets, offsets and fractions ignored
+static time_t legacyParse(const String& isoDate) {
+    if (isoDate.length() < 19) return 0;
+    int year = isoDate.substring(0, 4).toInt();
+    int mon  = isoDate.substring(5, 7).toInt();
+    int day  = isoDate.substring(8, 10).toInt();
+    int hour = isoDate.substring(11, 13).toInt();
+    int min  = isoDate.substring(14, 16).toInt();
+    int sec  = isoDate.substring(17, 19).toInt();
+    int y = year;
+    int m = mon;
+    if (m <= 2) { y--; m += 12; }
+    m -= 3;
+    long days = 365L * (y - 1970) + (y - 1968) / 4 - (y - 1900) / 100 + (y - 1600) / 400
+              + (153 * m + 2) / 5 + day - 1 + 59;
+    return (time_t)(days * 86400L + hour * 3600L + min * 60L + sec);
+}
+
+static void benchmark() {
+    using namespace std::chrono;
+    std::vector<String> corpus;
+    char iso[96];
+    for (int i = 0; i < 20000; i++) {
+        time_t t = 1750000000 + (time_t)i * 3797;
+        struct tm tm;
+        gmtime_r(&t, &tm);
+        strftime(iso, sizeof(iso), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        corpus.push_back(String(iso));
+    }
+
+    const int PASSES = 20;
+    long long fastSum = 0, legacySum = 0;
+    auto t0 = steady_clock::now();
+    for (int r = 0; r < PASSES; r++) for (const auto& s : corpus) fastSum += hcParseIsoEpoch(s.c_str());
+    auto t1 = steady_clock::now();
+    for (int r = 0; r < PASSES; r++) for (const auto& s : corpus) legacySum += legacyParse(s);
+    auto t2 = steady_clock::now();
+
+    double fastNs = (double)duration_cast<nanoseconds>(t1 - t0).count() / (corpus.size() * PASSES);
+    double legacyNs = (double)duration_cast<nanoseconds>(t2 - t1).count() / (corpus.size() * PASSES);
+    printf("parse: %.1f ns/date, substring parser %.1f ns/date (%.1fx)\n", fastNs, legacyNs, legacyNs / fastNs);
+    if (fastSum != legacySum) fail("parsers disagree on UTC dates", "");
+    // Six temporary Strings per date: the pointer parser must not be slower
+    if (fastNs > legacyNs) fail("slower than the substring parser", "");
+}
+
+int main() {
+    aucklandSweep();
+    offsetSweep();
+    malformed();
+    buildEvents();
+    benchmark();
+
+    printf("%d failure(s)\n", failures);
+    return failures ? 1 : 0;
+}
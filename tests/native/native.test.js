@@ -0,0 +1,132 @@
+/**
+ * Native tests: firmware sources compiled for the host with g++ and run
+ * against real threads. Each test builds one *.cpp program in this
+ * directory together with the firmware files it covers; the program exits
+ * non-zero on failure. Skipped when no C++ compiler is installed.
+ *
+ * Concurrency tests are also built with ThreadSanitizer where the compiler
+ * supports it, so a missing memory-order constraint fails as a data race;
+ * parsers of untrusted text are fuzzed under AddressSanitizer and UBSan, so
+ * a read past the end of the input fails the run.
+ *
+ * Simulations that take arguments (e.g. clock-discipline-sim --skew-ppm N)
+ * are built once and run per scenario.
+ */
+const { execFileSync, spawnSync } = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const ROOT = path.join(__dirname, '..', '..');
+const CXX = process.env.CXX || 'g++';
+const hasCompiler = spawnSync(CXX, ['--version']).status === 0;
+const supports = (flags) => hasCompiler && spawnSync(CXX, [...flags, '-x', 'c++', '-', '-o', os.devNull],
+  { input: 'int main() { return 0; }' }).status === 0;
+const hasTsan = supports(['-fsanitize=thread']);
+const ASAN_FLAGS = ['-fsanitize=address,undefined', '-fno-sanitize-recover=all', '-g'];
+const hasAsan = supports(ASAN_FLAGS);
+
+function build(name, sources, flags = []) {
+  const out = path.join(fs.mkdtempSync(path.join(os.tmpdir(), 'native-')), name);
+  execFileSync(CXX, [
+    '-std=gnu++11', '-O2', '-pthread', '-Wall', ...flags,
+    '-I', path.join(__dirname, 'shim'),
+    '-I', path.join(ROOT, 'src'),
+    ...sources.map((s) => path.join(ROOT, s)),
+    '-o', out,
+  ], { stdio: 'pipe' });
+  return out;
+}
+
+function run(exe, args = []) {
+  const result = spawnSync(exe, args, { encoding: 'utf8', timeout: 60000 });
+  if (result.status !== 0) {
+    throw new Error(`${path.basename(exe)} ${args.join(' ')} failed (exit ${result.status}):\n${result.stderr}${result.stdout}`);
+  }
+  return result;
+}
+
+function buildAndRun(name, sources) {
+  return run(build(name, sources));
+}
+
+(hasCompiler ? describe : describe.skip)('native', () => {
+  test('remote log ring: concurrent producers, no loss or tearing', () => {
+    const result = buildAndRun('remotelog-stress', ['src/remotelog.cpp', 'tests/native/remotelog-stress.cpp']);
+    expect(result.stdout).toMatch(/0 failure\(s\)/);
+  });
+
+  describe('sync result handoff: worker and main loop threads', () => {
+    const sources = ['tests/native/sync-handoff-stress.cpp'];
+
+    test('no torn or out-of-order results', () => {
+      expect(buildAndRun('sync-handoff-stress', sources).stdout).toMatch(/0 failure\(s\)/);
+    });
+
+    (hasTsan ? test : test.skip)('no data races under ThreadSanitizer', () => {
+      const result = run(build('sync-handoff-tsan', sources, ['-fsanitize=thread', '-g']));
+      expect(result.stdout).toMatch(/0 failure\(s\)/);
+      expect(result.stderr).not.toMatch(/ThreadSanitizer/);
+    });
+  });
+
+  test('event cache merge: hash join matches the nested loop; 20/100/500-event benchmark', () => {
+    const result = buildAndRun('event-merge-bench', [
+      'src/hcevents.cpp', 'src/hcparse.cpp', 'tests/native/event-merge-bench.cpp',
+    ]);
+    expect(result.stdout).toMatch(/0 failure\(s\)/);
+    console.log(result.stdout);
+  });
+
+  describe('timer: tag parser', () => {
+    const sources = ['src/hcparse.cpp', 'tests/native/tag-fuzz.cpp'];
+
+    test('known answers, fuzz ranges, throughput', () => {
+      const result = buildAndRun('tag-fuzz', sources);
+      expect(result.stdout).toMatch(/0 failure\(s\)/);
+      console.log(result.stdout);
+    });
+
+    (hasAsan ? test : test.skip)('no out-of-bounds reads under AddressSanitizer/UBSan', () => {
+      const result = run(build('tag-fuzz-asan', sources, ASAN_FLAGS), ['--seed', '7']);
+      expect(result.stdout).toMatch(/0 failure\(s\)/);
+      expect(result.stderr).not.toMatch(/AddressSanitizer|runtime error/);
+    });
+  });
+
+  test('webhook changes touch one occurrence of a recurring event', () => {
+    const result = buildAndRun('event-change', [
+      'src/hcevents.cpp', 'src/hcparse.cpp', 'tests/native/event-change.cpp',
+    ]);
+    expect(result.stdout).toMatch(/0 failure\(s\)/);
+  });
+
+  test('ISO dates: Pacific/Auckland DST sweep, bad end dates, benchmark', () => {
+    const result = buildAndRun('iso-epoch-sweep', [
+      'src/hcparse.cpp', 'src/hcevents.cpp', 'tests/native/iso-epoch-sweep.cpp',
+    ]);
+    expect(result.stdout).toMatch(/0 failure\(s\)/);
+    console.log(result.stdout);
+  });
+
+  describe('clock discipline: round ends stay on NTP time with a skewed crystal', () => {
+    let sim;
+    beforeAll(() => {
+      sim = build('clock-discipline-sim', [
+        'src/clockdisc.cpp', 'src/timer.cpp', 'src/remotelog.cpp', 'tests/native/clock-discipline-sim.cpp',
+      ]);
+    });
+
+    for (const skew of [0, 40, -60, 150]) {
+      test(`${skew} ppm`, () => {
+        const result = run(sim, ['--skew-ppm', String(skew)]);
+        expect(result.stdout).toMatch(/0 failure\(s\)/);
+      });
+    }
+
+    test('150 ppm, then 60 days without NTP (millis() - base wraps)', () => {
+      const result = run(sim, ['--skew-ppm', '150', '--idle-days', '60']);
+      expect(result.stdout).toMatch(/0 failure\(s\)/);
+    });
+  });
+});
@@ -0,0 +1,197 @@
+/**
+ * Native stress test for the remote log ring (src/remotelog.cpp)
+ *
+ * Several producer threads call remoteLog() while readers keep serializing
+ * the ring, as the main loop, the Hello Club worker and the web server do
+ * on the ESP32. Checks:
+ *   - no tearing: every entry a reader sees is intact (its padding is the
+ *     letter for its own producer and counter) and seqs only increase
+ *   - no loss: once producers stop, the ring holds exactly the newest
+ *     RLOG_MAX_ENTRIES sequence numbers, and every producer's entries
+ *     appear in the order it logged them
+ *   - incremental reads (remoteLogWriteJson) account for every sequence
+ *     number exactly once, either sent or counted as lost
+ *
+ * Built and run by native.test.js; exits non-zero on failure.
+ */
+#include "remotelog.h"
+#include "seriallog.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Console output is irrelevant here
+SerialLog serialLog;
+size_t SerialLog::write(uint8_t) { return 1; }
+size_t SerialLog::write(const uint8_t*, size_t len) { return len; }
+size_t SerialLog::printf(const char*, ...) { return 0; }
+
+static const int PRODUCERS = 4;
+static const int PER_PRODUCER = 100000;
+static const int READERS = 2;
+static const int PAD = 60;
+
+static std::atomic<bool> running(true);
+static std::atomic<long> checked(0);
+static std::atomic<int> failures(0);
+
+static void fail(const char* what, const char* detail) {
+    if (failures.fetch_add(1) < 10) {
+        fprintf(stderr, "FAIL: %s: %s\n", what, detail);
+    }
+}
+
+// Message: "p<producer>:<n>:<pad>" where pad is PAD copies of one letter
+// derived from (producer, n). Any mix of two writes breaks the pattern.
+static char padChar(int producer, int n) {
+    return (char)('a' + (producer * 7 + n) % 26);
+}
+
+static void producer(int id) {
+    char pad[PAD + 1];
+    for (int n = 0; n < PER_PRODUCER; n++) {
+        memset(pad, padChar(id, n), PAD);
+        pad[PAD] = '\0';
+        remoteLog("p%d:%d:%s", id, n, pad);
+    }
+}
+
+struct Parsed {
+    unsigned s;
+    int producer;
+    int n;
+};
+
+// Parse and validate every entry of one remoteLogGetAllJson() result
+static std::vector<Parsed> parseAndCheck(const char* json) {
+    std::vector<Parsed> out;
+    const char* p = strstr(json, "\"entries\":[");
+    if (!p) {
+        fail("json", json);
+        return out;
+    }
+    p += strlen("\"entries\":[");
+    while (*p == '{') {
+        unsigned s;
+        unsigned long t;
+        int producerId, n, used = 0;
+        char text[RLOG_MSG_LEN + 1];
+        if (sscanf(p, "{\"s\":%u,\"t\":%lu,\"m\":\"%100[^\"]\"}%n", &s, &t, text, &used) != 3 || used == 0) {
+            fail("entry format", p);
+            return out;
+        }
+        p += used;
+        if (*p == ',') p++;
+
+        int prefix = 0;
+        if (sscanf(text, "p%d:%d:%n", &producerId, &n, &prefix) != 2 || prefix == 0) {
+            fail("entry text", text);
+            continue;
+        }
+        const char* pad = text + prefix;
+        bool intact = strlen(pad) == PAD;
+        for (int i = 0; intact && i < PAD; i++) {
+            intact = pad[i] == padChar(producerId, n);
+        }
+        if (!intact) {
+            fail("torn entry", text);
+        }
+        out.push_back({s, producerId, n});
+        checked++;
+    }
+    return out;
+}
+
+static void reader() {
+    while (running) {
+        String json = remoteLogGetAllJson();
+        std::vector<Parsed> entries = parseAndCheck(json.c_str());
+        for (size_t i = 1; i < entries.size(); i++) {
+            if (entries[i].s <= entries[i - 1].s) {
+                fail("order", "sequence numbers not increasing");
+            }
+        }
+    }
+}
+
+// Follows the log by cursor the way a subscribed client does
+static void incrementalReader(long* sent, long* lost) {
+    char buf[RLOG_JSON_BUF_SIZE];
+    uint32_t cursor = 0;
+    while (running || cursor != remoteLogGetSeq()) {
+        uint32_t before = cursor;
+        remoteLogWriteJson(buf, sizeof(buf), cursor);
+        std::vector<Parsed> entries = parseAndCheck(buf);
+        const char* tail = strstr(buf, "],\"seq\":");
+        unsigned next, lostHere;
+        if (!tail || sscanf(tail, "],\"seq\":%u,\"lost\":%u", &next, &lostHere) != 2) {
+            fail("batch format", buf);
+            return;
+        }
+        if (next != cursor || entries.size() + lostHere != cursor - before) {
+            fail("batch", "sent + lost does not cover the cursor advance");
+        }
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].s < before || entries[i].s >= cursor ||
+                (i > 0 && entries[i].s <= entries[i - 1].s)) {
+                fail("batch", "entry outside the batch's range or out of order");
+                break;
+            }
+        }
+        *sent += entries.size();
+        *lost += lostHere;
+    }
+}
+
+int main() {
+    remoteLogInit();
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < READERS; r++) threads.emplace_back(reader);
+    long sent = 0, lost = 0;
+    threads.emplace_back(incrementalReader, &sent, &lost);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) producers.emplace_back(producer, p);
+    for (auto& t : producers) t.join();
+    running = false;
+    for (auto& t : threads) t.join();
+
+    const unsigned total = PRODUCERS * PER_PRODUCER;
+    if (remoteLogGetSeq() != total) {
+        fail("seq", "sequence counter does not match entries logged");
+    }
+    if (sent + lost != (long)total) {
+        fail("incremental", "sequence numbers neither sent nor counted as lost");
+    }
+    if (remoteLogCount() != RLOG_MAX_ENTRIES) {
+        fail("count", "ring not full");
+    }
+
+    // Quiescent ring: exactly the newest RLOG_MAX_ENTRIES entries
+    String json = remoteLogGetAllJson();
+    std::vector<Parsed> entries = parseAndCheck(json.c_str());
+    if (entries.size() != (size_t)RLOG_MAX_ENTRIES) {
+        fail("loss", "final snapshot is missing entries");
+    }
+    int lastN[PRODUCERS];
+    for (int& n : lastN) n = -1;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].s != total - entries.size() + i) {
+            fail("loss", "final snapshot has a gap in sequence numbers");
+            break;
+        }
+        const Parsed& e = entries[i];
+        if (e.producer < 0 || e.producer >= PRODUCERS || e.n <= lastN[e.producer]) {
+            fail("order", "a producer's entries are out of order");
+            break;
+        }
+        lastN[e.producer] = e.n;
+    }
+
+    printf("%u entries logged by %d threads, %ld entries checked by %d readers, "
+           "%ld sent / %ld lost incrementally, %d failure(s)\n",
+           total, PRODUCERS, checked.load(), READERS, sent, lost, failures.load());
+    return failures.load() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
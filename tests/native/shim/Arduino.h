@@ -0,0 +1,74 @@
+/**
+ * Minimal host stand-in for the Arduino core, enough to compile the
+ * firmware's platform-independent modules into native tests.
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using std::max;
+using std::min;
+
+// Simulations drive millis() themselves (e.g. a skewed crystal) by
+// setting nativeSimClock() and advancing nativeSimMillis()
+inline bool& nativeSimClock() {
+    static bool sim = false;
+    return sim;
+}
+
+inline unsigned long& nativeSimMillis() {
+    static unsigned long ms = 0;
+    return ms;
+}
+
+inline unsigned long millis() {
+    using namespace std::chrono;
+    if (nativeSimClock()) {
+        return nativeSimMillis();
+    }
+    static const auto start = steady_clock::now();
+    return (unsigned long)duration_cast<milliseconds>(steady_clock::now() - start).count();
+}
+
+inline void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+class String {
+public:
+    String() {}
+    String(const char* s) : s_(s ? s : "") {}
+    explicit String(unsigned long v) : s_(std::to_string(v)) {}
+    explicit String(unsigned int v) : s_(std::to_string(v)) {}
+    explicit String(int v) : s_(std::to_string(v)) {}
+
+    String& operator=(const char* s) { s_ = s ? s : ""; return *this; }
+    String& operator+=(const char* s) { s_ += s; return *this; }
+    String& operator+=(char c) { s_ += c; return *this; }
+    String& operator+=(const String& o) { s_ += o.s_; return *this; }
+    void reserve(size_t n) { s_.reserve(n); }
+    size_t length() const { return s_.size(); }
+    const char* c_str() const { return s_.c_str(); }
+    String substring(size_t from, size_t to) const {
+        return String(from < s_.size() ? s_.substr(from, to - from).c_str() : "");
+    }
+    long toInt() const { return atol(s_.c_str()); }
+
+private:
+    std::string s_;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* data, size_t len) = 0;
+};
@@ -0,0 +1,129 @@
+/**
+ * Native stress test for the Hello Club sync result handoff
+ * (src/triplebuffer.h, as used by fetchAndCacheEvents()/applyStagedEvents())
+ *
+ * A producer thread fills back() with a complete result (a vector of real
+ * CachedEvent records of varying length plus metadata) and publishes it,
+ * as the fetch worker does. A consumer thread takes results and swaps the
+ * events into its own live cache, as the main loop does. Checks:
+ *   - no tearing: every field of a taken result carries the same sequence
+ *     number, and it still does after the consumer has finished with it
+ *   - order: sequence numbers only increase, and the last one arrives
+ *
+ * native.test.js also builds this with -fsanitize=thread, which reports a
+ * data race if publish()/take() ever hand over a buffer without the
+ * release/acquire ordering.
+ *
+ * Exits non-zero on failure.
+ */
+#include "hcevents.h"
+#include "triplebuffer.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Result {
+    std::vector<CachedEvent> events;
+    std::string error;
+    uint32_t seq = 0;
+    int totalFromApi = 0;
+    bool success = false;
+};
+
+static const uint32_t ITERATIONS = 200000;
+
+static TripleBuffer<Result> handoff;
+static std::atomic<bool> producerDone(false);
+static std::atomic<int> failures(0);
+
+static void fail(const char* what, uint32_t seq) {
+    if (failures.fetch_add(1) < 10) {
+        fprintf(stderr, "FAIL: %s (seq %u)\n", what, seq);
+    }
+}
+
+static size_t eventCount(uint32_t seq) {
+    return seq % 23;   // Grows and shrinks, so buffers are reused at every size
+}
+
+static void producer() {
+    for (uint32_t seq = 1; seq <= ITERATIONS; seq++) {
+        Result& out = handoff.back();
+        out.events.clear();
+        for (size_t i = 0; i < eventCount(seq); i++) {
+            CachedEvent evt = {};
+            snprintf(evt.id, sizeof(evt.id), "%u", seq);
+            snprintf(evt.name, sizeof(evt.name), "event %u/%u", seq, (unsigned)i);
+            evt.idHash = seq;
+            evt.startTime = (time_t)seq;
+            evt.endTime = (time_t)seq;
+            out.events.push_back(evt);
+        }
+        out.error = std::to_string(seq);
+        out.totalFromApi = (int)seq;
+        out.success = (seq % 5) != 0;
+        out.seq = seq;
+        handoff.publish();
+    }
+    producerDone = true;
+}
+
+// Every field of one result must belong to the same sequence number
+static bool intact(const Result& r, const std::vector<CachedEvent>& events) {
+    if (r.error != std::to_string(r.seq) || r.totalFromApi != (int)r.seq ||
+        r.success != ((r.seq % 5) != 0) || events.size() != eventCount(r.seq)) {
+        return false;
+    }
+    for (const auto& evt : events) {
+        if (evt.idHash != r.seq || evt.startTime != (time_t)r.seq || evt.endTime != (time_t)r.seq ||
+            strtoul(evt.id, nullptr, 10) != r.seq) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::vector<CachedEvent> live;      // The consumer's cache
+    uint32_t lastSeq = 0;
+    uint32_t taken = 0;
+
+    std::thread worker(producer);
+    for (;;) {
+        bool done = producerDone;       // Read before take(): a final result is never missed
+        if (handoff.take()) {
+            Result& r = handoff.front();
+            taken++;
+            if (r.seq <= lastSeq) {
+                fail("result out of order", r.seq);
+            }
+            lastSeq = r.seq;
+            if (!intact(r, r.events)) {
+                fail("torn result", r.seq);
+            }
+            // As applyStagedEvents(): swap, so the old cache goes back with the buffer
+            live.swap(r.events);
+            if (!intact(r, live)) {
+                fail("result changed while held by the consumer", r.seq);
+            }
+        } else if (done) {
+            break;
+        }
+    }
+    worker.join();
+
+    if (lastSeq != ITERATIONS) {
+        fail("last result never arrived", lastSeq);
+    }
+    // The threads really overlapped: more than the final result came through
+    if (taken < 2) {
+        fail("consumer never ran alongside the producer", taken);
+    }
+
+    printf("%u published, %u taken (rest superseded)\n%d failure(s)\n", ITERATIONS, taken,
+           failures.load());
+    return failures ? 1 : 0;
+}
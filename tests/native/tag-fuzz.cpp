@@ -0,0 +1,231 @@
+/**
+ * Native fuzz target and throughput benchmark for the timer: tag parser
+ * (src/hcparse.cpp — hcParseTimerTag() and its TagLexer)
+ *
+ * The lexer walks raw description text by pointer and peeks one character
+ * ahead, so an off-by-one past the terminating NUL would read out of
+ * bounds. Every input is copied into a heap block of exactly its length
+ * plus the NUL; native.test.js builds this with AddressSanitizer and
+ * UBSan, which turn any such read into a failure. Checks:
+ *   - known answers for real descriptions (the grammar in hcparse.h)
+ *   - random text, random bytes (high bit set, control characters) and
+ *     mutated real descriptions: no out-of-bounds read, every field in range
+ *   - throughput over thousands of descriptions
+ *
+ * Usage: tag-fuzz [--iterations N] [--seed S]. Exits non-zero on failure.
+ */
+#include "hcparse.h"
+#include "config.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static const uint16_t DEFAULT_DURATION = 12;
+static int failures = 0;
+
+static void fail(const char* what, const std::string& input) {
+    if (++failures <= 10) {
+        fprintf(stderr, "FAIL: %s: \"%s\"\n", what, input.c_str());
+    }
+}
+
+// Parse from a heap copy with no slack after the NUL
+static bool parse(const std::string& text, TimerTag& tag, uint16_t defaultDuration = DEFAULT_DURATION) {
+    char* exact = new char[text.size() + 1];
+    memcpy(exact, text.c_str(), text.size() + 1);
+    bool found = hcParseTimerTag(exact, defaultDuration, tag);
+    delete[] exact;
+    return found;
+}
+
+static void checkRanges(const std::string& input, const TimerTag& tag) {
+    if (tag.durationMin < MIN_GAME_DURATION_MIN || tag.durationMin > MAX_GAME_DURATION_MIN ||
+        tag.numRounds > MAX_ROUNDS || tag.warmupMin > HELLOCLUB_MAX_WARMUP_MIN ||
+        tag.breakSec > HELLOCLUB_MAX_BREAK_SEC || tag.sirenBlasts > HELLOCLUB_MAX_SIREN_BLASTS ||
+        tag.court > HELLOCLUB_MAX_COURT) {
+        fail("field out of range", input);
+    }
+}
+
+static const char* const SAMPLES[] = {
+    "Club night \xE2\x80\x94 all levels welcome.\ntimer: 12min 3rounds",
+    "timer: enabled",
+    "Juniors\nTimer: 10 min, 4 rounds, warmup 5, break 2\nBring water",
+    "TIMER: 15:0 court 3 siren 3",
+    "Social doubles. timer: 20min warn",
+    "Ladder\ntimer: 12:3; warm-up=10min; break=90s; sirens=2x; court=7; 1min warning",
+    "Coaching session, no timer needed",
+    "timer:",
+    "Open play (timer: 8min 5 rounds)\nNotes: shuttles provided",
+};
+static const size_t SAMPLE_COUNT = sizeof(SAMPLES) / sizeof(SAMPLES[0]);
+
+struct KnownAnswer {
+    const char* text;
+    bool found;
+    TimerTag tag;           // durationMin, breakSec, numRounds, warmupMin, sirenBlasts, court, warn
+};
+
+static void knownAnswers() {
+    const KnownAnswer cases[] = {
+        {SAMPLES[0], true, {12, 0, 3, 0, 0, 0, false}},
+        {SAMPLES[1], true, {12, 0, 0, 0, 0, 0, false}},
+        {SAMPLES[2], true, {10, 120, 4, 5, 0, 0, false}},
+        {SAMPLES[3], true, {15, 0, 0, 0, 3, 3, false}},
+        {SAMPLES[4], true, {20, 0, 0, 0, 0, 0, true}},
+        {SAMPLES[5], true, {12, 90, 3, 10, 2, 7, true}},
+        {SAMPLES[6], false, {}},
+        {SAMPLES[7], true, {12, 0, 0, 0, 0, 0, false}},
+        {SAMPLES[8], true, {8, 0, 5, 0, 0, 0, false}},
+        {"timer: 1min warning 2min", true, {2, 0, 0, 0, 0, 0, true}},
+        {"timer: 121min 21 rounds court 100 siren 6 warmup 31 break 601s", true, {12, 0, 0, 0, 0, 0, false}},
+        {"timer: 12min\ncourt 3", true, {12, 0, 0, 0, 0, 0, false}},
+        {"timer: 99999999999min", true, {12, 0, 0, 0, 0, 0, false}},
+    };
+    for (const auto& c : cases) {
+        TimerTag tag = {};
+        bool found = parse(c.text, tag);
+        if (found != c.found) {
+            fail("tag found/not found", c.text);
+            continue;
+        }
+        if (found && (tag.durationMin != c.tag.durationMin || tag.breakSec != c.tag.breakSec ||
+                      tag.numRounds != c.tag.numRounds || tag.warmupMin != c.tag.warmupMin ||
+                      tag.sirenBlasts != c.tag.sirenBlasts || tag.court != c.tag.court ||
+                      tag.oneMinuteWarning != c.tag.oneMinuteWarning)) {
+            fail("wrong directives", c.text);
+        }
+    }
+
+    // The default round length comes from the caller
+    TimerTag tag = {};
+    if (!parse("timer: enabled", tag, 15) || tag.durationMin != 15) {
+        fail("default duration not applied", "timer: enabled");
+    }
+}
+
+// xorshift32: reproducible from --seed
+static uint32_t rngState = 1;
+static uint32_t rnd() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static std::string randomText() {
+    static const char ALPHABET[] = "timer:TIMER 0123456789minroundswarmupbreaksirencourtwarn:=,;-\n\t xyz";
+    std::string s = rnd() % 10 < 7 ? "timer:" : "";
+    size_t len = rnd() % 80;
+    for (size_t i = 0; i < len; i++) s += ALPHABET[rnd() % (sizeof(ALPHABET) - 1)];
+    return s;
+}
+
+static std::string randomBytes() {
+    std::string s = rnd() % 2 ? "timer:" : "";
+    size_t len = rnd() % 64;
+    for (size_t i = 0; i < len; i++) s += (char)(1 + rnd() % 255);   // Any byte but NUL
+    return s;
+}
+
+static std::string mutated() {
+    std::string s = SAMPLES[rnd() % SAMPLE_COUNT];
+    int edits = 1 + rnd() % 4;
+    for (int e = 0; e < edits && !s.empty(); e++) {
+        size_t at = rnd() % s.size();
+        switch (rnd() % 4) {
+            case 0: s.erase(at, 1); break;
+            case 1: s.insert(at, 1, (char)(1 + rnd() % 255)); break;
+            case 2: s[at] = (char)(1 + rnd() % 255); break;
+            default: s.resize(at); break;                        // Cut anywhere, even mid-word
+        }
+    }
+    return s;
+}
+
+// Inputs that end exactly where the lexer looks ahead
+static void edgeCases() {
+    const char* const EDGES[] = {
+        "", "t", "timer", "timer:", "TIMER:", "timer:-", "timer: warm-", "timer: warm-up", "timer: 12",
+        "timer: 12:", "timer: 12:3", "timer: break=", "timer: siren 3x", "timer: 1min", "timer: 1 min warn",
+        "timer:\n", "timer: 12min\n",
+    };
+    for (const char* e : EDGES) {
+        TimerTag tag = {};
+        if (parse(e, tag)) checkRanges(e, tag);
+    }
+    // Words and numbers longer than the token fields hold
+    std::string longWord = "timer: " + std::string(1000, 'w') + " 3 rounds";
+    std::string longNumber = "timer: " + std::string(1000, '9') + "min";
+    std::string manyTags;
+    for (int i = 0; i < 200; i++) manyTags += "timer:";
+    for (const std::string& s : {longWord, longNumber, manyTags}) {
+        TimerTag tag = {};
+        if (!parse(s, tag)) fail("tag not found", s.substr(0, 40));
+        checkRanges(s.substr(0, 40), tag);
+    }
+}
+
+static void fuzz(long iterations) {
+    for (long i = 0; i < iterations; i++) {
+        std::string input;
+        switch (i % 3) {
+            case 0: input = randomText(); break;
+            case 1: input = randomBytes(); break;
+            default: input = mutated(); break;
+        }
+        TimerTag tag = {};
+        if (parse(input, tag)) checkRanges(input, tag);
+    }
+}
+
+// Booking descriptions of realistic length, most of them tagged
+static void benchmark() {
+    using namespace std::chrono;
+    std::vector<std::string> corpus;
+    size_t bytes = 0;
+    for (int i = 0; i < 5000; i++) {
+        std::string d = "Weekly booking #" + std::to_string(i) + " \xE2\x80\x94 ";
+        int filler = rnd() % 20;
+        for (int j = 0; j < filler; j++) d += "lorem ipsum ";
+        d += "\n";
+        d += SAMPLES[rnd() % SAMPLE_COUNT];
+        bytes += d.size();
+        corpus.push_back(d);
+    }
+
+    const int PASSES = 20;
+    int tagged = 0;
+    auto start = steady_clock::now();
+    for (int pass = 0; pass < PASSES; pass++) {
+        for (const auto& d : corpus) {
+            TimerTag tag;
+            tagged += hcParseTimerTag(d.c_str(), DEFAULT_DURATION, tag) ? 1 : 0;
+        }
+    }
+    double sec = duration_cast<duration<double>>(steady_clock::now() - start).count();
+    double perSec = corpus.size() * PASSES / sec;
+    printf("throughput: %zu descriptions x %d, %.0f descriptions/s, %.1f MB/s\n", corpus.size(), PASSES,
+           perSec, bytes * PASSES / sec / 1e6);
+    if (tagged < (int)corpus.size() * PASSES * 3 / 4) {
+        fail("benchmark corpus mostly untagged", "");
+    }
+}
+
+int main(int argc, char** argv) {
+    long iterations = 200000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--iterations") == 0) iterations = atol(argv[i + 1]);
+        if (strcmp(argv[i], "--seed") == 0) rngState = (uint32_t)strtoul(argv[i + 1], nullptr, 10) | 1;
+    }
+
+    knownAnswers();
+    edgeCases();
+    fuzz(iterations);
+    benchmark();
+
+    printf("%ld fuzz inputs\n%d failure(s)\n", iterations, failures);
+    return failures ? 1 : 0;
+}
@@ -1,7 +1,8 @@
 /**
  * Unit tests for Hello Club auto-trigger decision logic
- * Mirrors: src/helloclub.cpp — checkAutoTrigger()
- * and src/main.cpp — the guard that only triggers when timer is IDLE/FINISHED
+ * Mirrors: src/helloclub.cpp — checkAutoTrigger(), alignedStart()
+ * and src/main.cpp — the guard that only triggers when timer is IDLE/FINISHED,
+ * and the auto-start deadline (armHelloClubStart())
  */
 
 const TRIGGER_WINDOW_SEC = 120; // 2 minutes
@@ -41,6 +42,33 @@ function shouldAutoStart(event, timerState) {
   return event !== null && (timerState === 'IDLE' || timerState === 'FINISHED');
 }
 
+/**
+ * Replicates HelloClubClient::alignedStart(): the round and time left for a
+ * start lateMs after startTime, keeping boundaries on startTime + k*duration.
+ * null once every round is over.
+ */
+function alignedStart(evt, lateMs) {
+  const roundMs = evt.durationMin * 60000;
+  if (roundMs === 0) return null;
+  const elapsed = Math.max(lateMs, 0);
+  const done = Math.floor(elapsed / roundMs);
+  if (evt.numRounds > 0 && done >= evt.numRounds) return null;
+  return { round: done + 1, remainingMs: roundMs - (elapsed % roundMs) };
+}
+
+/**
+ * Replicates armHelloClubStart(): the millis() deadline for the next
+ * untriggered event at or after max(now, firedFor + 1), or null
+ */
+function armStart(events, nowMs, millisNow, firedFor = 0) {
+  let after = Math.floor(nowMs / 1000);
+  if (after <= firedFor) after = firedFor + 1;
+  const next = events.find((e) => !e.triggered && e.startTime >= after);
+  if (!next) return null;
+  const untilMs = next.startTime * 1000 - nowMs;
+  return { deadline: millisNow + Math.max(untilMs, 0), armedFor: next.startTime };
+}
+
 describe('Auto-Trigger Logic', () => {
   describe('checkAutoTrigger', () => {
     test('triggers at exactly startTime', () => {
@@ -174,4 +202,73 @@ describe('Auto-Trigger Logic', () => {
       expect(checkAutoTrigger([evt], 1000)).toBeTruthy();
     });
   });
+
+  describe('alignedStart', () => {
+    const evt = makeEvent({ durationMin: 20, numRounds: 3 });
+
+    test('on time: full first round', () => {
+      expect(alignedStart(evt, 0)).toEqual({ round: 1, remainingMs: 20 * 60000 });
+    });
+
+    test('late start shortens the first round by the lateness', () => {
+      expect(alignedStart(evt, 1234)).toEqual({ round: 1, remainingMs: 20 * 60000 - 1234 });
+    });
+
+    test('negative lateness (clock jitter) is treated as on time', () => {
+      expect(alignedStart(evt, -15)).toEqual({ round: 1, remainingMs: 20 * 60000 });
+    });
+
+    test('later than a whole round joins the round in progress', () => {
+      const short = makeEvent({ durationMin: 1, numRounds: 5 });
+      expect(alignedStart(short, 90000)).toEqual({ round: 2, remainingMs: 30000 });
+    });
+
+    test('every round over: no start', () => {
+      const short = makeEvent({ durationMin: 1, numRounds: 2 });
+      expect(alignedStart(short, 120000)).toBeNull();
+    });
+
+    test('continuous mode never runs out of rounds', () => {
+      const cont = makeEvent({ durationMin: 1, numRounds: 0 });
+      expect(alignedStart(cont, 119000)).toEqual({ round: 2, remainingMs: 1000 });
+    });
+
+    test('round boundaries agree with boot recovery', () => {
+      // checkMidEventRecovery(): round = elapsed / dur + 1, remaining = dur - elapsed % dur
+      const startMs = evt.startTime * 1000;
+      [0, 1, 59999, 60000, 1199999, 1200000, 2500000].forEach((late) => {
+        const aligned = alignedStart(evt, late);
+        const elapsedSec = Math.floor((startMs + late) / 1000) - evt.startTime;
+        const recoveryRound = Math.floor(elapsedSec / (evt.durationMin * 60)) + 1;
+        expect(aligned.round).toBe(recoveryRound);
+        // Round ends at startTime + round * duration
+        expect(startMs + late + aligned.remainingMs).toBe(startMs + aligned.round * evt.durationMin * 60000);
+      });
+    });
+  });
+
+  describe('auto-start deadline', () => {
+    const events = [
+      makeEvent({ id: 'a', startTime: 1000 }),
+      makeEvent({ id: 'b', startTime: 2000 }),
+    ];
+
+    test('arms for the exact start in millis() terms', () => {
+      // 999.250 s UTC, millis() = 50000 -> due at millis() 50750
+      expect(armStart(events, 999250, 50000)).toEqual({ deadline: 50750, armedFor: 1000 });
+    });
+
+    test('a start already due arms immediately', () => {
+      expect(armStart(events, 1000400, 50000)).toEqual({ deadline: 50000, armedFor: 1000 });
+    });
+
+    test('after firing, the next event is armed (no re-fire while blocked)', () => {
+      expect(armStart(events, 1000400, 50000, 1000).armedFor).toBe(2000);
+    });
+
+    test('triggered events are skipped', () => {
+      const done = [makeEvent({ id: 'a', startTime: 1000, triggered: true })];
+      expect(armStart(done, 999000, 0)).toBeNull();
+    });
+  });
 });
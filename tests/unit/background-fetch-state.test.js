@@ -1,45 +1,136 @@
 /**
- * Unit tests for the Hello Club background fetch state machine
- * Mirrors: src/main.cpp — hcFetchInProgress / hcFetchResultReady flag transitions
+ * Unit tests for the Hello Club background fetch worker handoff
+ * Mirrors: src/main.cpp — checkHelloClubPoll(), requestHelloClubFetch(),
+ *          startQueuedHelloClubRefresh(), cancelHelloClubFetch(),
+ *          checkHelloClubControl(), hcWorkerTask(), the helloclub_refresh
+ *          and save_helloclub_settings handlers
  *
- * The fetch runs on a FreeRTOS background task. The main loop only interacts
- * via three volatile flags. This tests the state transitions are correct.
+ * One long-lived worker task takes requests from a queue and posts exactly
+ * one result back per request. The main loop owns hcFetchPending, set when a
+ * request is posted and cleared when its result is consumed. A manual
+ * refresh during a fetch is remembered and run once that fetch completes.
+ *
+ * The WebSocket handlers run on another task, so they only post refresh and
+ * settings requests to a control queue; the main loop applies them. Each
+ * fetch request carries its own copy of the API key.
  */
 
+const HELLOCLUB_CONTROL_QUEUE_DEPTH = 4;
+
 class BackgroundFetchStateMachine {
   constructor() {
-    this.fetchInProgress = false;
-    this.fetchResultReady = false;
-    this.fetchResultSuccess = false;
+    this.requestQueue = [];         // Depth 1: { request, apiKey }
+    this.controlQueue = [];         // Handler -> main loop
+    this.replies = [];              // helloclub_refresh_result sent by the loop
+    this.apiKey = 'key-1';          // helloClubClient's (main loop only)
+    this.defaultDuration = 12;
+    this.resultQueue = [];          // Depth 1
+    this.fetchPending = false;
+    this.refreshQueued = false;
+    this.cancelRequested = false;
     this.lastPoll = 0;
     this.pollFailed = false;
     this.pollInterval = 3600000;    // 1 hour
     this.retryInterval = 300000;    // 5 minutes
-    this.fetchStarted = false;      // Track if we launched a fetch
-    this.resultHandled = false;     // Track if we handled a result
+    this.fetchCount = 0;
+    this.lastFetchMs = 0;
+    this.maxFetchMs = 0;
+    this.fetchStarted = false;      // Track if we posted a request
+    this.resultHandled = null;      // Kind of result consumed this check
   }
 
-  // Simulate checkHelloClubPoll() from main loop
-  check(now) {
-    this.fetchStarted = false;
-    this.resultHandled = false;
+  // Mirrors requestHelloClubFetch()
+  request(kind) {
+    if (this.fetchPending || this.requestQueue.length >= 1) return false;
+    this.cancelRequested = false;
+    this.requestQueue.push({ request: kind, apiKey: this.apiKey });
+    this.fetchPending = true;
+    return true;
+  }
 
-    // Check if background fetch completed
-    if (this.fetchResultReady) {
-      this.fetchResultReady = false;
-      this.lastPoll = now;
-      this.resultHandled = true;
+  kinds() { return this.requestQueue.map((job) => job.request); }
+
+  // Mirrors the helloclub_refresh / save_helloclub_settings handlers: post
+  // to the main loop, or answer "Busy" with nothing changed
+  postControl(op, fields = {}) {
+    if (this.controlQueue.length >= HELLOCLUB_CONTROL_QUEUE_DEPTH) return false;
+    this.controlQueue.push({ op, clientId: 1, ...fields });
+    return true;
+  }
 
-      if (this.fetchResultSuccess) {
-        this.pollFailed = false;
+  // Mirrors checkHelloClubControl()
+  serviceControl(guarded = false) {
+    while (this.controlQueue.length > 0) {
+      const req = this.controlQueue.shift();
+      if (req.op === 'settings') {
+        this.apiKey = req.apiKey;
+        this.defaultDuration = req.defaultDuration;
+        if (this.fetchPending) {
+          this.cancel();
+          this.lastPoll = 0;
+        }
+      } else if (this.fetchPending) {
+        this.refreshQueued = true;
+        this.replies.push('queued');
+      } else if (guarded) {
+        this.lastPoll = 0;
+        this.replies.push('deferred');
       } else {
-        this.pollFailed = true;
+        this.replies.push(this.request('refresh') ? 'started' : 'unavailable');
+      }
+    }
+  }
+
+  // A refresh from the admin UI, serviced outside the guard window
+  manualRefresh() {
+    this.postControl('refresh');
+    this.serviceControl();
+    return this.replies[this.replies.length - 1];
+  }
+
+  // Mirrors startQueuedHelloClubRefresh()
+  startQueuedRefresh(guarded) {
+    if (!this.refreshQueued) return;
+    this.refreshQueued = false;
+    if (guarded) {
+      this.lastPoll = 0;
+      return;
+    }
+    this.fetchStarted = this.request('refresh');
+  }
+
+  // Mirrors cancelHelloClubFetch()
+  cancel() {
+    if (this.fetchPending) this.cancelRequested = true;
+  }
+
+  // Simulate checkHelloClubPoll() from main loop
+  check(now, guarded = false) {
+    this.fetchStarted = false;
+    this.resultHandled = null;
+
+    // Check if the worker finished
+    if (this.resultQueue.length > 0) {
+      const result = this.resultQueue.shift();
+      this.fetchPending = false;
+      this.fetchCount++;
+      this.lastFetchMs = result.durationMs;
+      this.maxFetchMs = Math.max(this.maxFetchMs, result.durationMs);
+
+      if (result.cancelled || this.cancelRequested) {
+        this.resultHandled = 'cancelled';
+        this.startQueuedRefresh(guarded);
+        return;
       }
+      this.lastPoll = now;
+      this.pollFailed = !result.success;
+      this.resultHandled = result.success ? 'success' : 'failure';
+      this.startQueuedRefresh(guarded);
       return;
     }
 
-    // Don't start if one is already running
-    if (this.fetchInProgress) {
+    // Don't start if one is already outstanding
+    if (this.fetchPending) {
       return;
     }
 
@@ -48,17 +139,23 @@ class BackgroundFetchStateMachine {
       return;
     }
 
-    // Launch background fetch
-    this.fetchInProgress = true;
-    this.fetchResultReady = false;
-    this.fetchStarted = true;
+    this.fetchStarted = this.request('poll');
   }
 
-  // Simulate background task completing
-  completeFetch(success) {
-    this.fetchResultSuccess = success;
-    this.fetchResultReady = true;
-    this.fetchInProgress = false;
+  // Simulate the worker taking a request and finishing the fetch
+  // (fetch returns false with cancelRequested set if cancelled mid-way)
+  completeFetch(success, durationMs = 1500) {
+    const job = this.requestQueue.shift();
+    if (job === undefined) throw new Error('worker has no request');
+    this.fetchedWithKey = job.apiKey;
+    const cancelledBefore = this.cancelRequested;
+    const ok = cancelledBefore ? false : success;
+    this.resultQueue.push({
+      request: job.request,
+      success: ok,
+      cancelled: this.cancelRequested,
+      durationMs: cancelledBefore ? 0 : durationMs,
+    });
   }
 }
 
@@ -73,14 +170,14 @@ describe('Background Fetch State Machine', () => {
     test('launches fetch on first check (lastPoll=0)', () => {
       sm.check(1000);
       expect(sm.fetchStarted).toBe(true);
-      expect(sm.fetchInProgress).toBe(true);
+      expect(sm.fetchPending).toBe(true);
     });
 
     test('does not launch while fetch is in progress', () => {
       sm.check(1000); // Launch
       sm.check(2000); // Should not re-launch
       expect(sm.fetchStarted).toBe(false);
-      expect(sm.fetchInProgress).toBe(true);
+      expect(sm.fetchPending).toBe(true);
     });
   });
 
@@ -90,7 +187,7 @@ describe('Background Fetch State Machine', () => {
       sm.completeFetch(true); // Background completes
 
       sm.check(2000); // Process result
-      expect(sm.resultHandled).toBe(true);
+      expect(sm.resultHandled).not.toBeNull();
       expect(sm.pollFailed).toBe(false);
       expect(sm.lastPoll).toBe(2000);
     });
@@ -116,7 +213,7 @@ describe('Background Fetch State Machine', () => {
       sm.completeFetch(false);
 
       sm.check(1000);
-      expect(sm.resultHandled).toBe(true);
+      expect(sm.resultHandled).not.toBeNull();
       expect(sm.pollFailed).toBe(true);
     });
 
@@ -156,19 +253,19 @@ describe('Background Fetch State Machine', () => {
     });
   });
 
-  describe('flag consistency', () => {
-    test('fetchInProgress and fetchResultReady are never both true', () => {
+  describe('handoff consistency', () => {
+    test('pending stays set until the result is consumed on the main loop', () => {
       sm.check(0);
-      expect(sm.fetchInProgress).toBe(true);
-      expect(sm.fetchResultReady).toBe(false);
+      expect(sm.fetchPending).toBe(true);
+      expect(sm.resultQueue).toHaveLength(0);
 
       sm.completeFetch(true);
-      expect(sm.fetchInProgress).toBe(false);
-      expect(sm.fetchResultReady).toBe(true);
+      expect(sm.fetchPending).toBe(true);
+      expect(sm.resultQueue).toHaveLength(1);
 
       sm.check(1000);
-      expect(sm.fetchInProgress).toBe(false);
-      expect(sm.fetchResultReady).toBe(false);
+      expect(sm.fetchPending).toBe(false);
+      expect(sm.resultQueue).toHaveLength(0);
     });
 
     test('result flag is cleared after being consumed', () => {
@@ -178,7 +275,7 @@ describe('Background Fetch State Machine', () => {
 
       // Second check should not see the result again
       sm.check(2000);
-      expect(sm.resultHandled).toBe(false);
+      expect(sm.resultHandled).toBeNull();
     });
   });
 
@@ -189,7 +286,7 @@ describe('Background Fetch State Machine', () => {
         sm.check(t);
         expect(sm.fetchStarted).toBe(false);
       }
-      expect(sm.fetchInProgress).toBe(true);
+      expect(sm.fetchPending).toBe(true);
     });
 
     test('result is only processed once even with rapid checks', () => {
@@ -197,10 +294,235 @@ describe('Background Fetch State Machine', () => {
       sm.completeFetch(true);
 
       sm.check(1000); // First check sees result
-      expect(sm.resultHandled).toBe(true);
+      expect(sm.resultHandled).not.toBeNull();
 
       sm.check(1001);
-      expect(sm.resultHandled).toBe(false); // Already consumed
+      expect(sm.resultHandled).toBeNull(); // Already consumed
+    });
+  });
+
+  describe('manual refresh', () => {
+    test('posts a request without waiting for the poll interval', () => {
+      sm.check(0);
+      sm.completeFetch(true);
+      sm.check(1000);
+
+      expect(sm.request('refresh')).toBe(true);
+      sm.completeFetch(true);
+      sm.check(2000);
+      expect(sm.resultHandled).toBe('success');
+      expect(sm.lastPoll).toBe(2000);
+    });
+
+    test('is refused while a fetch is outstanding (one request at a time)', () => {
+      sm.check(0);
+      expect(sm.request('refresh')).toBe(false);
+      expect(sm.kinds()).toEqual(['poll']);
+    });
+
+    test('scheduled poll does not start while a refresh is outstanding', () => {
+      sm.request('refresh');
+      sm.check(0);
+      expect(sm.fetchStarted).toBe(false);
+    });
+
+    test('during a poll it is queued and run once the poll completes', () => {
+      sm.check(0);
+      expect(sm.manualRefresh()).toBe('queued');
+      expect(sm.kinds()).toEqual(['poll']);
+      sm.completeFetch(true);
+      sm.check(1000);
+      expect(sm.resultHandled).toBe('success');
+      expect(sm.fetchStarted).toBe(true);
+      expect(sm.kinds()).toEqual(['refresh']);
+      expect(sm.refreshQueued).toBe(false);
+    });
+
+    test('several refreshes during one fetch run one follow-up', () => {
+      sm.check(0);
+      sm.manualRefresh();
+      sm.manualRefresh();
+      sm.completeFetch(true);
+      sm.check(1000);
+      sm.completeFetch(true);
+      sm.check(2000);
+      expect(sm.fetchStarted).toBe(false);
+      expect(sm.fetchCount).toBe(2);
+    });
+
+    test('a failed or cancelled fetch still runs the queued refresh', () => {
+      sm.check(0);
+      sm.manualRefresh();
+      sm.completeFetch(false);
+      sm.check(1000);
+      expect(sm.kinds()).toEqual(['refresh']);
+
+      sm.manualRefresh();
+      sm.cancel();
+      sm.completeFetch(true);
+      sm.check(2000);
+      expect(sm.resultHandled).toBe('cancelled');
+      expect(sm.kinds()).toEqual(['refresh']);
+    });
+
+    test('near a siren the queued refresh waits for the next poll check', () => {
+      sm.check(0);
+      sm.completeFetch(true);
+      sm.check(1000);
+      expect(sm.lastPoll).toBe(1000);
+
+      sm.request('poll');
+      sm.manualRefresh();
+      sm.completeFetch(true);
+      sm.check(2000, true);
+      expect(sm.fetchStarted).toBe(false);
+      expect(sm.lastPoll).toBe(0);
+      sm.check(32000);
+      expect(sm.fetchStarted).toBe(true);
+    });
+  });
+
+  describe('control queue', () => {
+    test('a refresh is only posted by the handler; the loop starts it', () => {
+      expect(sm.postControl('refresh')).toBe(true);
+      expect(sm.fetchPending).toBe(false);
+      expect(sm.kinds()).toEqual([]);
+
+      sm.serviceControl();
+      expect(sm.replies).toEqual(['started']);
+      expect(sm.kinds()).toEqual(['refresh']);
+    });
+
+    test('refreshes posted together start one fetch and queue one follow-up', () => {
+      sm.postControl('refresh');
+      sm.postControl('refresh');
+      sm.postControl('refresh');
+      sm.serviceControl();
+      expect(sm.replies).toEqual(['started', 'queued', 'queued']);
+      expect(sm.kinds()).toEqual(['refresh']);
+
+      sm.completeFetch(true);
+      sm.check(1000);
+      expect(sm.kinds()).toEqual(['refresh']);
+      sm.completeFetch(true);
+      sm.check(2000);
+      expect(sm.fetchStarted).toBe(false);
+      expect(sm.fetchCount).toBe(2);
+    });
+
+    test('near a siren the refresh is deferred to the next poll check', () => {
+      sm.check(0);
+      sm.completeFetch(true);
+      sm.check(1000);
+
+      sm.postControl('refresh');
+      sm.serviceControl(true);
+      expect(sm.replies).toEqual(['deferred']);
+      expect(sm.kinds()).toEqual([]);
+      expect(sm.lastPoll).toBe(0);
+    });
+
+    test('a full queue answers busy', () => {
+      for (let i = 0; i < HELLOCLUB_CONTROL_QUEUE_DEPTH; i++) {
+        expect(sm.postControl('refresh')).toBe(true);
+      }
+      expect(sm.postControl('settings', { apiKey: 'key-2', defaultDuration: 15 })).toBe(false);
+      sm.serviceControl();
+      expect(sm.apiKey).toBe('key-1');
+    });
+
+    test('new settings cancel the fetch started with the old key', () => {
+      sm.check(0);
+      sm.postControl('settings', { apiKey: 'key-2', defaultDuration: 15 });
+      expect(sm.cancelRequested).toBe(false);   // Not until the loop runs
+
+      sm.serviceControl();
+      expect(sm.cancelRequested).toBe(true);
+      expect(sm.defaultDuration).toBe(15);
+      sm.completeFetch(true);
+      expect(sm.fetchedWithKey).toBe('key-1');  // The in-flight job's own copy
+      sm.check(1000);
+      expect(sm.resultHandled).toBe('cancelled');
+
+      sm.check(2000);
+      expect(sm.fetchStarted).toBe(true);
+      sm.completeFetch(true);
+      expect(sm.fetchedWithKey).toBe('key-2');
+    });
+
+    test('a key change after posting does not reach the queued job', () => {
+      sm.check(0);
+      sm.apiKey = 'key-3';
+      sm.completeFetch(true);
+      expect(sm.fetchedWithKey).toBe('key-1');
+    });
+  });
+
+  describe('cancellation', () => {
+    test('cancel before the worker starts yields a cancelled result', () => {
+      sm.check(0);
+      sm.cancel();
+      sm.completeFetch(true);
+
+      sm.check(1000);
+      expect(sm.resultHandled).toBe('cancelled');
+      expect(sm.fetchPending).toBe(false);
+    });
+
+    test('cancelled fetch is not counted as a failure', () => {
+      sm.check(0);
+      sm.cancel();
+      sm.completeFetch(true);
+      sm.check(1000);
+      expect(sm.pollFailed).toBe(false);
+      expect(sm.lastPoll).toBe(0);
+    });
+
+    test('cancel after the fetch finished still discards the result', () => {
+      sm.check(0);
+      sm.completeFetch(true);
+      sm.cancel();
+      sm.check(1000);
+      expect(sm.resultHandled).toBe('cancelled');
+    });
+
+    test('next request clears a stale cancel', () => {
+      sm.check(0);
+      sm.cancel();
+      sm.completeFetch(true);
+      sm.check(1000);
+
+      sm.check(2000); // lastPoll still 0 — polls immediately
+      expect(sm.fetchStarted).toBe(true);
+      expect(sm.cancelRequested).toBe(false);
+      sm.completeFetch(true);
+      sm.check(3000);
+      expect(sm.resultHandled).toBe('success');
+    });
+
+    test('cancel with nothing outstanding is a no-op', () => {
+      sm.cancel();
+      expect(sm.cancelRequested).toBe(false);
+    });
+  });
+
+  describe('per-run timing', () => {
+    test('tracks count, last and max fetch duration', () => {
+      sm.check(0);
+      sm.completeFetch(true, 2400);
+      sm.check(1000);
+
+      sm.request('refresh');
+      sm.completeFetch(false, 5200);
+      sm.check(2000);
+
+      sm.request('refresh');
+      sm.completeFetch(true, 1800);
+      sm.check(3000);
+
+      expect(sm.fetchCount).toBe(3);
+      expect(sm.lastFetchMs).toBe(1800);
+      expect(sm.maxFetchMs).toBe(5200);
     });
   });
 });
@@ -0,0 +1,170 @@
+/**
+ * Unit tests for the circular boot log file
+ * Mirrors: src/bootlog.cpp — writer batch, recoverHead(), bootLogClear(),
+ *          and the /log stream snapshot (bootLogResponse() / nextLine())
+ *
+ * The file is a header { head, count, nextSeq } plus a fixed number of
+ * record slots. Records carry their sequence number, which lets boot
+ * recover records written after the last header update and lets a download
+ * skip slots overwritten while it was streaming.
+ */
+
+const RECORDS = 8;
+
+function makeLog() {
+  return {
+    header: { head: 0, count: 0, nextSeq: 1 },
+    slots: Array.from({ length: RECORDS }, () => ({ seq: 0, ms: 0, text: '' })),
+  };
+}
+
+/** Replicates one writer batch; writeHeader=false simulates a crash before the header write */
+function writeBatch(log, texts, { writeHeader = true } = {}) {
+  const h = { ...log.header };
+  texts.forEach((text, i) => {
+    log.slots[h.head] = { seq: h.nextSeq++, ms: 1000 + i, text };
+    h.head = (h.head + 1) % RECORDS;
+    if (h.count < RECORDS) h.count++;
+  });
+  if (writeHeader) log.header = h;
+}
+
+/** Replicates recoverHead() */
+function recoverHead(log) {
+  const h = log.header;
+  for (let i = 0; i < RECORDS; i++) {
+    if (log.slots[h.head].seq !== h.nextSeq) break;
+    h.head = (h.head + 1) % RECORDS;
+    h.nextSeq++;
+    if (h.count < RECORDS) h.count++;
+  }
+}
+
+/** Replicates the bootLogResponse() snapshot */
+function openStream(log) {
+  const h = log.header;
+  return {
+    slot: (h.head + RECORDS - (h.count % RECORDS)) % RECORDS,
+    seq: h.nextSeq - h.count,
+    remaining: h.count,
+  };
+}
+
+/** Replicates nextLine(): next decoded line, or null at the end */
+function nextLine(log, s) {
+  while (s.remaining > 0) {
+    const rec = log.slots[s.slot];
+    const expected = s.seq++;
+    s.slot = (s.slot + 1) % RECORDS;
+    s.remaining--;
+    if (rec.seq !== expected) continue;
+    return `[${rec.ms} ms] ${rec.text}`;
+  }
+  return null;
+}
+
+function readAll(log) {
+  const s = openStream(log);
+  const lines = [];
+  let line;
+  while ((line = nextLine(log, s)) !== null) lines.push(line.replace(/^\[\d+ ms\] /, ''));
+  return lines;
+}
+
+const texts = (n, prefix = 'm') => Array.from({ length: n }, (_, i) => `${prefix}${i}`);
+
+describe('ring writes', () => {
+  test('records read back oldest first', () => {
+    const log = makeLog();
+    writeBatch(log, ['a', 'b']);
+    writeBatch(log, ['c']);
+    expect(readAll(log)).toEqual(['a', 'b', 'c']);
+  });
+
+  test('an exactly full ring reads from head', () => {
+    const log = makeLog();
+    writeBatch(log, texts(RECORDS));
+    expect(log.header.head).toBe(0);
+    expect(readAll(log)).toEqual(texts(RECORDS));
+  });
+
+  test('wrapping overwrites the oldest records in place', () => {
+    const log = makeLog();
+    writeBatch(log, texts(RECORDS + 3));
+    expect(log.slots).toHaveLength(RECORDS);
+    expect(readAll(log)).toEqual(texts(RECORDS + 3).slice(3));
+  });
+
+  test('lines are decoded as "[ms] text"', () => {
+    const log = makeLog();
+    writeBatch(log, ['===== BOOT =====']);
+    const s = openStream(log);
+    expect(nextLine(log, s)).toBe('[1000 ms] ===== BOOT =====');
+    expect(nextLine(log, s)).toBeNull();
+  });
+});
+
+describe('recoverHead', () => {
+  test('picks up records written after the last header update', () => {
+    const log = makeLog();
+    writeBatch(log, ['a', 'b']);
+    writeBatch(log, ['c', 'd'], { writeHeader: false });
+    expect(readAll(log)).toEqual(['a', 'b']);
+
+    recoverHead(log);
+    expect(readAll(log)).toEqual(['a', 'b', 'c', 'd']);
+  });
+
+  test('does not treat preallocated or stale slots as new records', () => {
+    const log = makeLog();
+    writeBatch(log, texts(RECORDS + 2));
+    const before = { ...log.header };
+    recoverHead(log);
+    expect(log.header).toEqual(before);
+  });
+
+  test('recovers across the wrap point', () => {
+    const log = makeLog();
+    writeBatch(log, texts(RECORDS - 1));
+    writeBatch(log, ['x', 'y', 'z'], { writeHeader: false });
+    recoverHead(log);
+    expect(readAll(log)).toEqual([...texts(RECORDS - 1).slice(2), 'x', 'y', 'z']);
+  });
+});
+
+describe('streaming', () => {
+  test('records overwritten mid-download are skipped, not shown out of order', () => {
+    const log = makeLog();
+    writeBatch(log, texts(RECORDS));
+    const s = openStream(log);
+    expect(nextLine(log, s)).toMatch(/ m0$/);
+
+    writeBatch(log, ['new0', 'new1']); // Overwrites m0, m1
+    const rest = [];
+    let line;
+    while ((line = nextLine(log, s)) !== null) rest.push(line.replace(/^\[\d+ ms\] /, ''));
+    expect(rest).toEqual(texts(RECORDS).slice(2));
+  });
+
+  test('records written after the download started are not included', () => {
+    const log = makeLog();
+    writeBatch(log, ['a']);
+    const s = openStream(log);
+    writeBatch(log, ['b']);
+    expect(nextLine(log, s)).toMatch(/ a$/);
+    expect(nextLine(log, s)).toBeNull();
+  });
+});
+
+describe('clear', () => {
+  test('empties the log but keeps the sequence running', () => {
+    const log = makeLog();
+    writeBatch(log, texts(5));
+    log.header.count = 0; // bootLogClear()
+    expect(readAll(log)).toEqual([]);
+
+    writeBatch(log, ['after']);
+    expect(readAll(log)).toEqual(['after']);
+    expect(log.slots[log.header.head - 1].seq).toBe(6);
+  });
+});
@@ -0,0 +1,129 @@
+/**
+ * Unit tests for the boot-phase profiler
+ * Mirrors: src/bootprof.cpp — bootPhaseBegin()/bootPhaseEnd(),
+ *          bootProfLoop() history ring, bootProfJson() record order
+ *
+ * Each phase is timed once per boot. The boot's record joins a ring of the
+ * last boots once the device has been up SAVE_MS; phases that end after
+ * that rewrite the same slot instead of adding another.
+ */
+
+const HISTORY = 4;
+const SAVE_MS = 60000;
+
+class BootProf {
+  constructor(stored = null) {
+    this.stored = stored;            // NVS blob (null = nothing yet)
+    this.now = 0;
+    this.writes = 0;
+    this.rec = { boot: 0, phases: {} };
+    this.history = null;
+    this.savedSlot = -1;
+    this.dirty = false;
+  }
+  begin(name) {
+    if (this.rec.phases[name]) return;
+    this.rec.phases[name] = [this.now, -1];
+  }
+  end(name) {
+    const p = this.rec.phases[name];
+    if (!p || p[1] !== -1) return;
+    p[1] = this.now - p[0];
+    if (this.savedSlot >= 0) this.dirty = true;
+  }
+  save() {
+    this.history.records[this.savedSlot] = JSON.parse(JSON.stringify(this.rec));
+    this.stored = JSON.parse(JSON.stringify(this.history));
+    this.writes++;
+  }
+  loop() {
+    if (!this.history) {
+      this.history = this.stored ? JSON.parse(JSON.stringify(this.stored))
+        : { head: 0, count: 0, nextBoot: 1, records: [] };
+      this.rec.boot = this.history.nextBoot;
+    }
+    if (this.savedSlot < 0) {
+      if (this.now < SAVE_MS) return;
+      this.savedSlot = this.history.head;
+      this.history.head = (this.history.head + 1) % HISTORY;
+      if (this.history.count < HISTORY) this.history.count++;
+      this.history.nextBoot++;
+      this.save();
+    } else if (this.dirty) {
+      this.dirty = false;
+      this.save();
+    }
+  }
+  json() {
+    const history = [];
+    for (let i = 1; i <= this.history.count; i++) {
+      const slot = (this.history.head - i + HISTORY) % HISTORY;
+      if (slot !== this.savedSlot) history.push(this.history.records[slot]);
+    }
+    return { current: this.rec, history };
+  }
+}
+
+function boot(stored, { wifiAt = 3000, runUntil = SAVE_MS } = {}) {
+  const p = new BootProf(stored);
+  p.now = 40; p.begin('spiffs'); p.now = 90; p.end('spiffs');
+  p.begin('wifi');
+  for (p.now = 200; p.now <= runUntil; p.now += 100) {
+    if (p.now === wifiAt) p.end('wifi');
+    p.loop();
+  }
+  return p;
+}
+
+describe('Boot profiler: phases', () => {
+  test('records start and duration', () => {
+    const p = boot(null);
+    expect(p.rec.phases.spiffs).toEqual([40, 50]);
+    expect(p.rec.phases.wifi).toEqual([90, 2910]);
+  });
+
+  test('each phase is timed once: later begin/end calls are ignored', () => {
+    const p = new BootProf();
+    p.begin('ntp'); p.now = 500; p.end('ntp');
+    p.now = 9000; p.begin('ntp'); p.end('ntp');
+    expect(p.rec.phases.ntp).toEqual([0, 500]);
+  });
+
+  test('end without begin is ignored; a running phase reports -1', () => {
+    const p = new BootProf();
+    p.end('ota');
+    p.begin('recovery');
+    expect(p.rec.phases.ota).toBeUndefined();
+    expect(p.rec.phases.recovery[1]).toBe(-1);
+  });
+});
+
+describe('Boot profiler: history ring', () => {
+  test('nothing is written before SAVE_MS', () => {
+    const p = boot(null, { runUntil: SAVE_MS - 100 });
+    expect(p.writes).toBe(0);
+    expect(p.stored).toBeNull();
+  });
+
+  test('boot numbers count up and the ring keeps the newest boots', () => {
+    let stored = null;
+    for (let i = 0; i < HISTORY + 2; i++) stored = boot(stored).stored;
+    const p = boot(stored, { runUntil: 200 });
+    expect(p.rec.boot).toBe(HISTORY + 3);
+    expect(p.json().history.map(r => r.boot)).toEqual([6, 5, 4, 3]);
+  });
+
+  test('a phase ending after the save rewrites the same slot', () => {
+    const p = boot(null, { wifiAt: SAVE_MS + 5000, runUntil: SAVE_MS + 10000 });
+    expect(p.writes).toBe(2);
+    expect(p.stored.count).toBe(1);
+    expect(p.stored.records[0].phases.wifi[1]).toBe(SAVE_MS + 5000 - 90);
+  });
+
+  test('the running boot is not listed twice once stored', () => {
+    const p = boot(boot(null).stored);
+    const j = p.json();
+    expect(j.current.boot).toBe(2);
+    expect(j.history.map(r => r.boot)).toEqual([1]);
+  });
+});
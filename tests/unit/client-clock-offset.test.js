@@ -0,0 +1,170 @@
+/**
+ * Unit tests for per-client clock offset estimation
+ * Mirrors: src/clientclock.cpp — ping schedule and min-RTT filter
+ *          data/script.js — syncEndTime()
+ *
+ * The server pings each client with its clockMillis(); the browser answers
+ * with Date.now() mod 2^32. The offset comes from the exchange with the
+ * lowest RTT of the last 8, and sync frames carry it so each display puts
+ * the round end on its own clock regardless of how late the frame arrived.
+ */
+
+const PING_MS = 15000;
+const FAST_PING_MS = 1000;
+const PONG_TIMEOUT_MS = 5000;
+const SAMPLES = 8;
+const SYNC_MAX_CORRECTION_MS = 2000;
+const U32 = 4294967296;
+
+/** Replicates ClientClock */
+class ClientClock {
+  constructor() {
+    this.ring = [];
+    this.next = 0;
+    this.best = 0;
+    this.pingAt = 0;
+    this.outstanding = false;
+    this.pinged = false;
+  }
+  get count() { return this.ring.length; }
+  pingDue(now) {
+    if (this.outstanding && ((now - this.pingAt) >>> 0) < PONG_TIMEOUT_MS) return false;
+    if (!this.pinged) return true;
+    const interval = this.count < SAMPLES ? FAST_PING_MS : PING_MS;
+    return ((now - this.pingAt) >>> 0) >= interval;
+  }
+  pingSent(now) { this.pingAt = now; this.outstanding = true; this.pinged = true; }
+  pong(sentAt, clientMs, now) {
+    if (!this.outstanding || sentAt !== this.pingAt) return false;
+    this.outstanding = false;
+    const rtt = (now - sentAt) >>> 0;
+    this.ring[this.next] = { rtt, offset: (clientMs - (sentAt + Math.floor(rtt / 2))) | 0 };
+    this.next = (this.next + 1) % SAMPLES;
+    this.best = 0;
+    for (let i = 1; i < this.count; i++) if (this.ring[i].rtt < this.ring[this.best].rtt) this.best = i;
+    return true;
+  }
+  valid() { return this.count > 0; }
+  offsetMs() { return this.ring[this.best].offset; }
+  errorMs() { return Math.floor(this.ring[this.best].rtt / 2); }
+}
+
+/** Replicates syncEndTime() in script.js */
+function syncEndTime(data, now) {
+  const arrival = now + data.mainTimerRemaining;
+  if (data.clockOffsetMs === undefined || data.serverMillis === undefined) return arrival;
+  const end = now + ((data.serverMillis + data.clockOffsetMs + data.mainTimerRemaining - now) | 0);
+  return Math.abs(end - arrival) > SYNC_MAX_CORRECTION_MS ? arrival : end;
+}
+
+/** Deterministic pseudo-random in [0, 1) */
+function rng(seed) {
+  let s = seed;
+  return () => { s = (s * 1664525 + 1013904223) % U32; return s / U32; };
+}
+
+/**
+ * A browser whose clock is `skew` ms ahead of the server's millis(), on a
+ * link with base one-way delay plus exponentially distributed queueing of
+ * mean `queue` (mostly short, with a long tail). Runs the ping loop for
+ * `seconds` and returns the client's estimator.
+ */
+function runLink({ skew, base, queue, seconds, seed = 1 }) {
+  const rand = rng(seed);
+  const clock = new ClientClock();
+  const delay = () => base - queue * Math.log(1 - rand());
+  for (let t = 0; t < seconds * 1000; t += 100) {
+    if (!clock.pingDue(t)) continue;
+    clock.pingSent(t);
+    const arrive = t + delay();
+    const clientMs = (Math.round(arrive + skew) % U32 + U32) % U32;
+    const back = arrive + delay();
+    clock.pong(t, clientMs, Math.round(back));
+  }
+  return clock;
+}
+
+describe('Client clock: ping schedule', () => {
+  test('fast pings until the filter is full, then every 15 s', () => {
+    const c = new ClientClock();
+    const pings = [];
+    for (let t = 0; t < 60000; t += 100) {
+      if (c.pingDue(t)) { c.pingSent(t); pings.push(t); c.pong(t, t, t + 20); }
+    }
+    expect(pings.slice(0, SAMPLES)).toEqual([0, 1000, 2000, 3000, 4000, 5000, 6000, 7000]);
+    expect(pings[SAMPLES]).toBe(7000 + PING_MS);
+  });
+
+  test('an unanswered ping is given up after the timeout', () => {
+    const c = new ClientClock();
+    c.pingSent(0);
+    expect(c.pingDue(PONG_TIMEOUT_MS - 100)).toBe(false);
+    expect(c.pingDue(PONG_TIMEOUT_MS)).toBe(true);
+  });
+
+  test('stale or unsolicited pongs are ignored', () => {
+    const c = new ClientClock();
+    expect(c.pong(0, 123, 10)).toBe(false);
+    c.pingSent(1000);
+    expect(c.pong(999, 123, 1010)).toBe(false);
+    expect(c.pong(1000, 123, 1010)).toBe(true);
+    expect(c.pong(1000, 123, 1020)).toBe(false);
+    expect(c.count).toBe(1);
+  });
+});
+
+describe('Client clock: min-RTT filter', () => {
+  test('symmetric link gives the exact offset', () => {
+    const c = runLink({ skew: 123456, base: 40, queue: 0, seconds: 20 });
+    expect(c.offsetMs()).toBe(123456);
+    expect(c.errorMs()).toBe(40);
+  });
+
+  test('queueing delay is filtered out; the error bound holds', () => {
+    const c = runLink({ skew: -5000, base: 5, queue: 150, seconds: 120, seed: 7 });
+    const actual = Math.abs(c.offsetMs() - -5000);
+    expect(actual).toBeLessThanOrEqual(c.errorMs());
+    expect(actual).toBeLessThan(50);
+  });
+
+  test('offsets wrap with a browser clock far above 2^32', () => {
+    const skew = 1773700000000 % U32;
+    const c = runLink({ skew, base: 10, queue: 0, seconds: 10 });
+    expect(((c.offsetMs() - skew) % U32 + U32) % U32).toBe(0);
+  });
+});
+
+describe('Client clock: display agreement at the siren', () => {
+  // Server: round ends at serverMillis 1,000,000; sync sent at 990,000
+  const serverEnd = 1000000;
+  const sentAt = 990000;
+
+  function display({ skew, base, queue, seed, oneWay }) {
+    const clock = runLink({ skew, base, queue, seconds: 120, seed });
+    const data = { mainTimerRemaining: serverEnd - sentAt, serverMillis: sentAt, clockOffsetMs: clock.offsetMs() };
+    const now = sentAt + oneWay + skew;            // Browser clock at arrival
+    return {
+      corrected: syncEndTime(data, now) - skew,    // Back on the server's clock
+      naive: now + data.mainTimerRemaining - skew,
+    };
+  }
+
+  test('wired and congested displays agree within 50 ms', () => {
+    const wired = display({ skew: 1773700000000, base: 2, queue: 10, seed: 3, oneWay: 5 });
+    const wifi = display({ skew: 1773700000000 - 37, base: 20, queue: 120, seed: 9, oneWay: 350 });
+    expect(Math.abs(wifi.naive - wired.naive)).toBeGreaterThan(300);
+    expect(Math.abs(wifi.corrected - wired.corrected)).toBeLessThan(50);
+    expect(Math.abs(wired.corrected - serverEnd)).toBeLessThan(50);
+  });
+
+  test('without an estimate the round end counts from arrival', () => {
+    expect(syncEndTime({ mainTimerRemaining: 5000 }, 1000)).toBe(6000);
+    expect(syncEndTime({ mainTimerRemaining: 5000, serverMillis: 10 }, 1000)).toBe(6000);
+  });
+
+  test('an implausible correction (browser clock changed) is ignored', () => {
+    const now = 1773700000000;
+    const data = { mainTimerRemaining: 5000, serverMillis: 0, clockOffsetMs: ((now % U32) - 60000) | 0 };
+    expect(syncEndTime(data, now)).toBe(now + 5000);
+  });
+});
@@ -0,0 +1,348 @@
+/**
+ * Unit tests for the time-ordered Hello Club event index
+ * Mirrors: src/helloclub.cpp — reindex(), lowerBound(), checkAutoTrigger(),
+ *          getNextEvent(), markTriggered(), checkMidEventRecovery(), purgeExpired()
+ *
+ * The cache is kept sorted by startTime and a cursor marks the first event
+ * that can still trigger. Each test checks the indexed version against the
+ * original linear scans. The cursor rewinds after a sync, so a missed
+ * window is flagged on the event and logged once.
+ */
+
+const HELLOCLUB_TRIGGER_WINDOW_MS = 120000;
+const PURGE_GRACE_SEC = 300;
+
+class EventIndex {
+  constructor(events) {
+    this.events = events.map((e) => ({ ...e }));
+    this.logs = [];
+    this.reindex();
+  }
+
+  /** A sync: hcCarryTriggered() onto the fetch result, then reindex() */
+  sync(fetched) {
+    const live = new Map(this.events.map((e) => [`${e.id}@${e.startTime}`, e]));
+    this.events = fetched.map((e) => {
+      const old = live.get(`${e.id}@${e.startTime}`);
+      return old ? { ...e, triggered: old.triggered, missLogged: old.missLogged } : { ...e };
+    });
+    this.reindex();
+  }
+
+  reindex() {
+    // Array.prototype.sort is stable, like std::stable_sort
+    this.events.sort((a, b) => a.startTime - b.startTime);
+    this.triggerCursor = 0;
+    this.windowLoggedIdx = -1;
+  }
+
+  lowerBound(t) {
+    let lo = 0;
+    let hi = this.events.length;
+    while (lo < hi) {
+      const mid = (lo + hi) >> 1;
+      if (this.events[mid].startTime < t) lo = mid + 1;
+      else hi = mid;
+    }
+    return lo;
+  }
+
+  checkAutoTrigger(now) {
+    const windowSec = HELLOCLUB_TRIGGER_WINDOW_MS / 1000;
+    while (this.triggerCursor < this.events.length) {
+      const evt = this.events[this.triggerCursor];
+      if (!evt.triggered && now <= evt.startTime + windowSec) break;
+      if (!evt.triggered && !evt.missLogged) {
+        evt.missLogged = true;
+        this.logs.push(`missed ${evt.id}`);
+      }
+      this.triggerCursor++;
+    }
+    if (this.triggerCursor >= this.events.length) return null;
+
+    const evt = this.events[this.triggerCursor];
+    if (now < evt.startTime) return null;
+    if (this.windowLoggedIdx !== this.triggerCursor) {
+      this.windowLoggedIdx = this.triggerCursor;
+      this.logs.push(`window ${evt.id}`);
+    }
+    return evt;
+  }
+
+  getNextEvent(after) {
+    for (let i = this.lowerBound(after); i < this.events.length; i++) {
+      if (!this.events[i].triggered) return this.events[i];
+    }
+    return null;
+  }
+
+  markTriggered(id, startTime) {
+    for (let i = this.lowerBound(startTime);
+      i < this.events.length && this.events[i].startTime === startTime; i++) {
+      if (this.events[i].id === id) {
+        this.events[i].triggered = true;
+        return;
+      }
+    }
+  }
+
+  checkMidEventRecovery(now) {
+    for (let i = this.lowerBound(now + 1); i-- > 0;) {
+      const evt = this.events[i];
+      if (!evt.triggered) continue;
+      if (now - evt.startTime >= playSeconds(evt)) continue;
+      return evt;
+    }
+    return null;
+  }
+
+  purgeExpired(now) {
+    const candidatesEnd = this.lowerBound(now - PURGE_GRACE_SEC);
+    const behindCursor = this.events
+      .slice(0, Math.min(this.triggerCursor, candidatesEnd))
+      .filter((e) => isExpired(e, now)).length;
+    const kept = this.events.slice(0, candidatesEnd).filter((e) => !isExpired(e, now));
+    const before = this.events.length;
+    this.events = kept.concat(this.events.slice(candidatesEnd));
+    if (this.events.length < before) {
+      this.windowLoggedIdx = this.windowLoggedIdx === this.triggerCursor
+        ? this.triggerCursor - behindCursor : -1;
+      this.triggerCursor -= behindCursor;
+    }
+  }
+}
+
+function playSeconds(evt) {
+  const roundSec = evt.durationMin * 60;
+  if (evt.numRounds > 0) return evt.numRounds * roundSec;
+  const booking = evt.endTime > evt.startTime ? evt.endTime - evt.startTime : 0;
+  return Math.max(booking, roundSec);
+}
+
+function isExpired(evt, now) {
+  if (!evt.triggered) return evt.endTime + PURGE_GRACE_SEC < now;
+  const roundSec = evt.durationMin * 60;
+  const timerEnd = evt.startTime + (evt.numRounds > 0 ? evt.numRounds * roundSec : roundSec);
+  const effectiveEnd = Math.max(evt.endTime, timerEnd);
+  return effectiveEnd + PURGE_GRACE_SEC < now;
+}
+
+// --- Original linear scans (pre-index behaviour) ---
+
+function linearAutoTrigger(events, now) {
+  const windowSec = HELLOCLUB_TRIGGER_WINDOW_MS / 1000;
+  for (const evt of events) {
+    if (evt.triggered) continue;
+    if (now >= evt.startTime && now <= evt.startTime + windowSec) return evt;
+  }
+  return null;
+}
+
+function linearNextEvent(events, after) {
+  let next = null;
+  for (const evt of events) {
+    if (evt.triggered || evt.startTime < after) continue;
+    if (!next || evt.startTime < next.startTime) next = evt;
+  }
+  return next;
+}
+
+function linearRecovery(events, now) {
+  let best = null;
+  for (const evt of events) {
+    if (!evt.triggered || evt.startTime > now) continue;
+    if (now - evt.startTime >= playSeconds(evt)) continue;
+    if (!best || evt.startTime > best.startTime) best = evt;
+  }
+  return best;
+}
+
+// Deterministic LCG so failures are reproducible
+function makeRandom(seed) {
+  let s = seed;
+  return () => {
+    s = (s * 1103515245 + 12345) & 0x7fffffff;
+    return s / 0x7fffffff;
+  };
+}
+
+const NOW = 1750000000;
+
+function makeEvents(count, rand) {
+  return Array.from({ length: count }, (_, i) => {
+    const start = NOW - 86400 + Math.floor(rand() * 14 * 86400 / 60) * 60;
+    return {
+      id: `evt${String(i).padStart(9, '0')}`,
+      startTime: start,
+      endTime: start + (rand() < 0.3 ? 0 : 7200),
+      durationMin: 12,
+      numRounds: rand() < 0.5 ? 3 : 0,
+      triggered: rand() < 0.2,
+    };
+  });
+}
+
+function evt(id, startOffsetSec, extra = {}) {
+  return {
+    id, startTime: NOW + startOffsetSec, endTime: NOW + startOffsetSec + 3600,
+    durationMin: 12, numRounds: 3, triggered: false, ...extra,
+  };
+}
+
+describe('reindex() / lowerBound()', () => {
+  test('sorts by startTime, keeping API order for equal starts', () => {
+    const idx = new EventIndex([evt('c', 600), evt('a', 0), evt('court2', 600), evt('b', 300)]);
+    expect(idx.events.map((e) => e.id)).toEqual(['a', 'b', 'c', 'court2']);
+  });
+
+  test('lowerBound finds the first event at or after t', () => {
+    const idx = new EventIndex([evt('a', 0), evt('b', 300), evt('c', 600)]);
+    expect(idx.lowerBound(NOW - 1)).toBe(0);
+    expect(idx.lowerBound(NOW + 300)).toBe(1);
+    expect(idx.lowerBound(NOW + 301)).toBe(2);
+    expect(idx.lowerBound(NOW + 601)).toBe(3);
+  });
+});
+
+describe('checkAutoTrigger() cursor', () => {
+  test('returns nothing before the window and the event inside it', () => {
+    const idx = new EventIndex([evt('a', 60)]);
+    expect(idx.checkAutoTrigger(NOW)).toBeNull();
+    expect(idx.checkAutoTrigger(NOW + 60).id).toBe('a');
+    expect(idx.checkAutoTrigger(NOW + 180).id).toBe('a');
+  });
+
+  test('skips a missed window once and moves on', () => {
+    const idx = new EventIndex([evt('a', 0), evt('b', 600)]);
+    expect(idx.checkAutoTrigger(NOW + 300)).toBeNull();
+    expect(idx.triggerCursor).toBe(1);
+    expect(idx.checkAutoTrigger(NOW + 600).id).toBe('b');
+    expect(idx.logs.filter((l) => l.startsWith('missed'))).toEqual(['missed a']);
+  });
+
+  test('a sync rewinds the cursor but does not log the miss again', () => {
+    const events = [evt('a', 0), evt('b', 600)];
+    const idx = new EventIndex(events);
+    idx.checkAutoTrigger(NOW + 300);
+    for (let i = 0; i < 3; i++) {
+      idx.sync(events);
+      expect(idx.triggerCursor).toBe(0);
+      expect(idx.checkAutoTrigger(NOW + 300 + i)).toBeNull();
+      expect(idx.triggerCursor).toBe(1);
+    }
+    expect(idx.logs.filter((l) => l.startsWith('missed'))).toEqual(['missed a']);
+  });
+
+  test('a moved event is a new occurrence and may be logged again', () => {
+    const idx = new EventIndex([evt('a', 0)]);
+    idx.checkAutoTrigger(NOW + 300);
+    idx.sync([evt('a', 60)]);
+    idx.checkAutoTrigger(NOW + 400);
+    expect(idx.logs.filter((l) => l.startsWith('missed'))).toEqual(['missed a', 'missed a']);
+  });
+
+  test('logs IN WINDOW once per event, not every check', () => {
+    const idx = new EventIndex([evt('a', 0)]);
+    for (let t = 0; t <= 120; t += 30) idx.checkAutoTrigger(NOW + t);
+    expect(idx.logs).toEqual(['window a']);
+  });
+
+  test('after markTriggered the next same-start event (second court) fires', () => {
+    const idx = new EventIndex([evt('court1', 0), evt('court2', 0)]);
+    const first = idx.checkAutoTrigger(NOW + 10);
+    idx.markTriggered(first.id, first.startTime);
+    expect(idx.checkAutoTrigger(NOW + 10).id).toBe('court2');
+  });
+
+  test('matches the linear scan over a simulated fortnight of 30s checks', () => {
+    const rand = makeRandom(7);
+    const events = makeEvents(120, rand);
+    const idx = new EventIndex(events);
+    const linear = events.map((e) => ({ ...e }));
+
+    for (let now = NOW - 86400; now < NOW + 14 * 86400; now += 30) {
+      const a = idx.checkAutoTrigger(now);
+      const b = linearAutoTrigger(linear.slice().sort((x, y) => x.startTime - y.startTime), now);
+      expect(a ? a.id : null).toBe(b ? b.id : null);
+      if (a) {
+        idx.markTriggered(a.id, a.startTime);
+        linear.find((e) => e.id === b.id).triggered = true;
+      }
+    }
+  });
+});
+
+describe('getNextEvent()', () => {
+  test('matches the linear scan at many points in time', () => {
+    const rand = makeRandom(11);
+    const events = makeEvents(120, rand);
+    const idx = new EventIndex(events);
+    for (let i = 0; i < 500; i++) {
+      const after = NOW - 86400 + Math.floor(rand() * 16 * 86400);
+      const a = idx.getNextEvent(after);
+      const b = linearNextEvent(events, after);
+      expect(a ? a.startTime : 0).toBe(b ? b.startTime : 0);
+    }
+  });
+});
+
+describe('checkMidEventRecovery()', () => {
+  test('picks the latest-started triggered event still in play', () => {
+    const idx = new EventIndex([
+      evt('old', -1200, { triggered: true }),
+      evt('newer', -600, { triggered: true }),
+      evt('untriggered', -300),
+      evt('future', 600, { triggered: true }),
+    ]);
+    expect(idx.checkMidEventRecovery(NOW).id).toBe('newer');
+  });
+
+  test('matches the linear scan on random caches', () => {
+    const rand = makeRandom(23);
+    for (let round = 0; round < 50; round++) {
+      const events = makeEvents(60, rand);
+      const idx = new EventIndex(events);
+      const now = NOW + Math.floor(rand() * 7 * 86400);
+      const a = idx.checkMidEventRecovery(now);
+      const b = linearRecovery(events, now);
+      expect(a ? a.startTime : null).toBe(b ? b.startTime : null);
+    }
+  });
+});
+
+describe('purgeExpired()', () => {
+  test('removes the same events as a full scan and keeps order', () => {
+    const rand = makeRandom(42);
+    const events = makeEvents(120, rand);
+    const idx = new EventIndex(events);
+    const now = NOW + 3 * 86400;
+    idx.purgeExpired(now);
+
+    const expected = events.filter((e) => !isExpired(e, now)).map((e) => e.id).sort();
+    expect(idx.events.map((e) => e.id).sort()).toEqual(expected);
+    for (let i = 1; i < idx.events.length; i++) {
+      expect(idx.events[i - 1].startTime <= idx.events[i].startTime).toBe(true);
+    }
+  });
+
+  test('keeps the cursor on the same event instead of rewinding', () => {
+    const idx = new EventIndex([
+      evt('gone', -3600, { endTime: NOW - 3000 }),
+      evt('missed', -600, { endTime: NOW + 3600 }),
+      evt('live', 0),
+      evt('later', 600),
+    ]);
+    expect(idx.checkAutoTrigger(NOW + 30).id).toBe('live');
+    idx.purgeExpired(NOW + 30);
+    expect(idx.events.map((e) => e.id)).toEqual(['missed', 'live', 'later']);
+    expect(idx.triggerCursor).toBe(1);
+    expect(idx.checkAutoTrigger(NOW + 60).id).toBe('live');
+    expect(idx.logs).toEqual(['missed gone', 'missed missed', 'window live']);
+  });
+
+  test('events starting inside the grace period are never candidates', () => {
+    const idx = new EventIndex([evt('short', -200, { endTime: NOW - 200, durationMin: 1, numRounds: 1 })]);
+    idx.purgeExpired(NOW);
+    expect(idx.events).toHaveLength(1);
+  });
+});
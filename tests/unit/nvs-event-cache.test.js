@@ -0,0 +1,256 @@
+/**
+ * Unit tests for the binary NVS event cache
+ * Mirrors: src/helloclub.cpp — saveToNVS(), saveTriggeredToNVS(), loadRecordsFromNVS()
+ *
+ * Layout: `ev_bin` = 12-byte header (magic, version, count, CRC32 of records)
+ * followed by 62-byte packed records; `ev_trig` = CRC32 of the records it
+ * belongs to, then one triggered bit per record. The two are separate NVS
+ * writes, so a bitmap whose CRC doesn't match the records is ignored.
+ * Version 1 records (56 bytes, no tag directives) are a prefix of version 2.
+ */
+
+const NVS_EVENTS_MAGIC = 0x56454348; // "HCEV"
+const NVS_EVENTS_VERSION = 2;
+const HEADER_SIZE = 12;
+const RECORD_SIZE = 62;
+const RECORD_SIZE_V1 = 56;
+const HELLOCLUB_MAX_CACHED_EVENTS = 120;
+
+// Same polynomial as the ESP32 ROM crc32_le(0, ...)
+function crc32(buf) {
+  let crc = 0xFFFFFFFF;
+  for (const b of buf) {
+    crc ^= b;
+    for (let k = 0; k < 8; k++) {
+      crc = (crc >>> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+  }
+  return (crc ^ 0xFFFFFFFF) >>> 0;
+}
+
+function writeField(buf, offset, len, str) {
+  const bytes = Buffer.from(str, 'utf8').subarray(0, len);
+  bytes.copy(buf, offset);
+}
+
+function readField(buf, offset, len) {
+  const field = buf.subarray(offset, offset + len);
+  const end = field.indexOf(0);
+  return field.subarray(0, end === -1 ? len : end).toString('utf8');
+}
+
+function saveRecords(events, version = NVS_EVENTS_VERSION) {
+  const recordSize = version === 1 ? RECORD_SIZE_V1 : RECORD_SIZE;
+  const count = Math.min(events.length, HELLOCLUB_MAX_CACHED_EVENTS);
+  const blob = Buffer.alloc(HEADER_SIZE + count * recordSize);
+  for (let i = 0; i < count; i++) {
+    const e = events[i];
+    const o = HEADER_SIZE + i * recordSize;
+    writeField(blob, o, 12, e.id);
+    writeField(blob, o + 12, 32, e.name);
+    blob.writeUInt32LE(e.startTime, o + 44);
+    blob.writeUInt32LE(e.endTime, o + 48);
+    blob.writeUInt16LE(e.durationMin, o + 52);
+    blob.writeUInt8(e.numRounds, o + 54);
+    if (version === 1) continue;
+    blob.writeUInt8(e.oneMinuteWarning ? 0x01 : 0, o + 55);
+    blob.writeUInt8(e.warmupMin, o + 56);
+    blob.writeUInt8(e.sirenBlasts, o + 57);
+    blob.writeUInt8(e.court, o + 58);
+    blob.writeUInt16LE(e.breakSec, o + 60);
+  }
+  blob.writeUInt32LE(NVS_EVENTS_MAGIC, 0);
+  blob.writeUInt16LE(version, 4);
+  blob.writeUInt16LE(count, 6);
+  blob.writeUInt32LE(crc32(blob.subarray(HEADER_SIZE)), 8);
+  return blob;
+}
+
+// recordsCrc: header CRC of the records blob saved with these events
+function saveTriggered(events, recordsCrc = saveRecords(events).readUInt32LE(8)) {
+  const count = Math.min(events.length, HELLOCLUB_MAX_CACHED_EVENTS);
+  const trig = Buffer.alloc(4 + Math.ceil(count / 8));
+  trig.writeUInt32LE(recordsCrc, 0);
+  events.slice(0, count).forEach((e, i) => {
+    if (e.triggered) trig[4 + (i >> 3)] |= 1 << (i & 7);
+  });
+  return trig;
+}
+
+function loadRecords(blob, bits) {
+  if (!blob || blob.length < HEADER_SIZE) return null;
+  const magic = blob.readUInt32LE(0);
+  const version = blob.readUInt16LE(4);
+  const count = blob.readUInt16LE(6);
+  const crc = blob.readUInt32LE(8);
+  const records = blob.subarray(HEADER_SIZE);
+  const recordSize = version === 1 ? RECORD_SIZE_V1 : RECORD_SIZE;
+  if (magic !== NVS_EVENTS_MAGIC || version < 1 || version > NVS_EVENTS_VERSION ||
+      count > HELLOCLUB_MAX_CACHED_EVENTS || records.length !== count * recordSize) {
+    return null;
+  }
+  if (crc32(records) !== crc) return null;
+
+  const useBits = !!bits && bits.length === 4 + Math.ceil(count / 8) && bits.readUInt32LE(0) === crc;
+  const events = [];
+  for (let i = 0; i < count; i++) {
+    // Zero-padded like the firmware's `NvsEventRecord rec = {}` + short memcpy
+    const rec = Buffer.alloc(RECORD_SIZE);
+    records.copy(rec, 0, i * recordSize, (i + 1) * recordSize);
+    events.push({
+      id: readField(rec, 0, 12),
+      name: readField(rec, 12, 32),
+      startTime: rec.readUInt32LE(44),
+      endTime: rec.readUInt32LE(48),
+      durationMin: rec.readUInt16LE(52),
+      numRounds: rec.readUInt8(54),
+      oneMinuteWarning: (rec.readUInt8(55) & 0x01) === 1,
+      warmupMin: rec.readUInt8(56),
+      sirenBlasts: rec.readUInt8(57),
+      court: rec.readUInt8(58),
+      breakSec: rec.readUInt16LE(60),
+      triggered: useBits ? ((bits[4 + (i >> 3)] >> (i & 7)) & 1) === 1 : false,
+    });
+  }
+  return events;
+}
+
+function makeEvent(i, overrides = {}) {
+  return {
+    id: `evt${String(i).padStart(9, '0')}`,
+    name: `Club Night ${i}`,
+    startTime: 1750000000 + i * 3600,
+    endTime: 1750000000 + i * 3600 + 7200,
+    durationMin: 12,
+    numRounds: 0,
+    oneMinuteWarning: false,
+    warmupMin: 0,
+    sirenBlasts: 0,
+    court: 0,
+    breakSec: 0,
+    triggered: false,
+    ...overrides,
+  };
+}
+
+describe('NVS binary event cache', () => {
+  test('CRC32 matches the standard check value', () => {
+    expect(crc32(Buffer.from('123456789'))).toBe(0xCBF43926);
+  });
+
+  test('round-trips events and triggered flags', () => {
+    const events = [makeEvent(0), makeEvent(1, { triggered: true }), makeEvent(2, { numRounds: 3 })];
+    const loaded = loadRecords(saveRecords(events), saveTriggered(events));
+    expect(loaded).toEqual(events);
+  });
+
+  test('round-trips timer: tag directives', () => {
+    const e = makeEvent(0, { warmupMin: 5, breakSec: 90, sirenBlasts: 3, court: 7, oneMinuteWarning: true });
+    expect(loadRecords(saveRecords([e]), saveTriggered([e]))).toEqual([e]);
+  });
+
+  test('loads version 1 records with directives defaulted', () => {
+    const events = [makeEvent(0), makeEvent(1, { triggered: true, numRounds: 3 })];
+    const v1 = saveRecords(events, 1);
+    expect(v1.length).toBe(HEADER_SIZE + 2 * RECORD_SIZE_V1);
+    expect(loadRecords(v1, saveTriggered(events, v1.readUInt32LE(8)))).toEqual(events);
+  });
+
+  test('empty cache round-trips', () => {
+    expect(loadRecords(saveRecords([]), saveTriggered([]))).toEqual([]);
+  });
+
+  test('blob size is header plus fixed-size records', () => {
+    const events = Array.from({ length: 10 }, (_, i) => makeEvent(i));
+    expect(saveRecords(events).length).toBe(HEADER_SIZE + 10 * RECORD_SIZE);
+  });
+
+  test('full 12-char id and 32-char name survive without terminator', () => {
+    const e = makeEvent(0, { id: 'abcdefghijkl', name: 'N'.repeat(32) });
+    const loaded = loadRecords(saveRecords([e]), saveTriggered([e]));
+    expect(loaded[0].id).toBe('abcdefghijkl');
+    expect(loaded[0].name).toBe('N'.repeat(32));
+  });
+
+  test('caps at HELLOCLUB_MAX_CACHED_EVENTS', () => {
+    const events = Array.from({ length: 130 }, (_, i) => makeEvent(i));
+    const loaded = loadRecords(saveRecords(events), saveTriggered(events));
+    expect(loaded).toHaveLength(HELLOCLUB_MAX_CACHED_EVENTS);
+  });
+
+  test('full cache fits in a few NVS pages', () => {
+    const events = Array.from({ length: HELLOCLUB_MAX_CACHED_EVENTS }, (_, i) => makeEvent(i));
+    expect(saveRecords(events).length).toBeLessThanOrEqual(8 * 1024);
+    expect(saveTriggered(events).length).toBe(4 + 15);
+  });
+
+  describe('triggered bitmap', () => {
+    test('marking one event only changes one bit', () => {
+      const events = Array.from({ length: 20 }, (_, i) => makeEvent(i));
+      const before = saveTriggered(events);
+      events[13].triggered = true;
+      const after = saveTriggered(events);
+      let diffBits = 0;
+      for (let i = 0; i < before.length; i++) {
+        let x = before[i] ^ after[i];
+        while (x) { diffBits += x & 1; x >>= 1; }
+      }
+      expect(diffBits).toBe(1);
+      expect(loadRecords(saveRecords(events), after)[13].triggered).toBe(true);
+    });
+
+    test('missing or wrong-length bitmap loads as untriggered', () => {
+      const events = [makeEvent(0, { triggered: true })];
+      expect(loadRecords(saveRecords(events), null)[0].triggered).toBe(false);
+      expect(loadRecords(saveRecords(events), Buffer.alloc(4, 0xFF))[0].triggered).toBe(false);
+      expect(loadRecords(saveRecords(events), saveTriggered(events).subarray(4))[0].triggered).toBe(false);
+    });
+
+    test('bitmap written for other records of the same count is ignored', () => {
+      // Power cut between the two writes: new records, the old cache's bitmap
+      const oldCache = [makeEvent(0, { triggered: true }), makeEvent(1), makeEvent(2)];
+      const newCache = [makeEvent(1), makeEvent(2), makeEvent(3)];
+      const loaded = loadRecords(saveRecords(newCache), saveTriggered(oldCache));
+      expect(loaded.map((e) => e.triggered)).toEqual([false, false, false]);
+    });
+
+    test('new bitmap over the old records (records write still pending) is ignored', () => {
+      const oldCache = [makeEvent(0), makeEvent(1), makeEvent(2)];
+      const newCache = [makeEvent(1, { triggered: true }), makeEvent(2), makeEvent(3)];
+      const loaded = loadRecords(saveRecords(oldCache), saveTriggered(newCache));
+      expect(loaded.map((e) => e.triggered)).toEqual([false, false, false]);
+    });
+
+    test('bitmap of the same records is used', () => {
+      const events = [makeEvent(0), makeEvent(1, { triggered: true }), makeEvent(2)];
+      const loaded = loadRecords(saveRecords(events), saveTriggered(events));
+      expect(loaded.map((e) => e.triggered)).toEqual([false, true, false]);
+    });
+  });
+
+  describe('corruption detection', () => {
+    test('rejects a flipped record byte (CRC)', () => {
+      const blob = saveRecords([makeEvent(0)]);
+      blob[HEADER_SIZE + 20] ^= 0x01;
+      expect(loadRecords(blob, null)).toBeNull();
+    });
+
+    test('rejects wrong magic', () => {
+      const blob = saveRecords([makeEvent(0)]);
+      blob.writeUInt32LE(0xDEADBEEF, 0);
+      expect(loadRecords(blob, null)).toBeNull();
+    });
+
+    test('rejects unknown version', () => {
+      const blob = saveRecords([makeEvent(0)]);
+      blob.writeUInt16LE(3, 4);
+      expect(loadRecords(blob, null)).toBeNull();
+    });
+
+    test('rejects truncated blob', () => {
+      const blob = saveRecords([makeEvent(0), makeEvent(1)]);
+      expect(loadRecords(blob.subarray(0, blob.length - 1), null)).toBeNull();
+      expect(loadRecords(blob.subarray(0, 8), null)).toBeNull();
+    });
+  });
+});
@@ -0,0 +1,398 @@
+/**
+ * Unit tests for write-coalescing NVS persistence
+ * Mirrors: src/nvsstore.cpp — NvsStore::stage(), commitLocked(), loop(), discard()
+ *
+ * Values are staged per (namespace, key). Only values that differ from what
+ * flash holds are committed, in one session per namespace, once the oldest
+ * change is NVS_COMMIT_DELAY_MS old — or immediately on flush(). A write
+ * that fails stays pending, flush() reports it, and loop() retries it.
+ * loop(hold) holds batched commits (siren sounding, fetch guard window);
+ * flush() ignores the hold.
+ */
+
+const NVS_COMMIT_DELAY_MS = 2000;
+
+/**
+ * Fake Preferences backend: Map of "ns/key" -> string, with session/write
+ * counters. Writes to keys in `failing` fail (as a full NVS partition does).
+ */
+function makeFlash(initial = {}) {
+  const data = new Map(Object.entries(initial));
+  return {
+    data,
+    failing: new Set(),
+    sessions: [],
+    writes: 0,
+    begin(ns) { this.sessions.push(ns); },
+    has(ns, key) { return data.has(`${ns}/${key}`); },
+    get(ns, key) { return data.get(`${ns}/${key}`); },
+    put(ns, key, v) {
+      if (this.failing.has(key)) return false;
+      this.writes++;
+      data.set(`${ns}/${key}`, v);
+      return true;
+    },
+    remove(ns, key) {
+      if (this.failing.has(key)) return false;
+      this.writes++;
+      data.delete(`${ns}/${key}`);
+      return true;
+    },
+  };
+}
+
+/** Replicates entriesFor(): 32-byte NVS entries a value consumes */
+function entriesFor(type, len) {
+  if (type === 'string') return 1 + Math.floor((len + 1 + 31) / 32);
+  if (type === 'bytes') return 2 + Math.floor((len + 31) / 32);
+  return 1;
+}
+
+/** Replicates NvsStore; values are strings so equality stands in for CRC+length */
+function makeStore(flash) {
+  const records = [];
+  let dirtyCount = 0;
+  let dirtySince = 0;
+  const stats = { commits: 0, keyWrites: 0, entries: 0, skipped: 0, coalesced: 0, failed: 0 };
+
+  function find(ns, key) {
+    let rec = records.find((r) => r.ns === ns && r.key === key);
+    if (!rec) {
+      rec = { ns, key, type: 'bytes', known: false, inFlash: false, flash: null, dirty: false };
+      records.push(rec);
+    }
+    return rec;
+  }
+
+  function markClean(rec) {
+    rec.dirty = false;
+    rec.value = null;
+    dirtyCount--;
+  }
+
+  function stage(ns, key, type, value, remove, now) {
+    const rec = find(ns, key);
+    if (type === 'bytes' && value === '') remove = true;
+    if (remove) {
+      type = rec.type;
+      value = '';
+    }
+
+    if (rec.dirty && rec.removed === remove && rec.type === type && rec.value === value) return;
+
+    if (rec.known) {
+      const same = remove ? !rec.inFlash : rec.inFlash && rec.type === type && rec.flash === value;
+      if (same) {
+        stats.skipped++;
+        if (rec.dirty) markClean(rec);
+        return;
+      }
+    }
+
+    rec.type = type;
+    rec.removed = remove;
+    rec.value = value;
+    if (rec.dirty) {
+      stats.coalesced++;
+    } else {
+      rec.dirty = true;
+      if (dirtyCount++ === 0) dirtySince = now;
+    }
+  }
+
+  function commit(ns, now) {
+    if (dirtyCount === 0) return true;
+    let written = 0;
+    let ok = true;
+    for (let i = 0; i < records.length; i++) {
+      if (!records[i].dirty || (ns && records[i].ns !== ns)) continue;
+      const batchNs = records[i].ns;
+      flash.begin(batchNs);
+      for (let j = i; j < records.length; j++) {
+        const rec = records[j];
+        if (!rec.dirty || rec.ns !== batchNs) continue;
+        if (!rec.known) {
+          rec.inFlash = flash.has(batchNs, rec.key);
+          rec.flash = rec.inFlash ? flash.get(batchNs, rec.key) : '';
+          rec.known = true;
+        }
+        const same = rec.removed ? !rec.inFlash : rec.inFlash && rec.flash === rec.value;
+        if (same) {
+          stats.skipped++;
+        } else if (!(rec.removed ? flash.remove(batchNs, rec.key) : flash.put(batchNs, rec.key, rec.value))) {
+          // Stays dirty; flash is re-read before the retry
+          stats.failed++;
+          rec.known = false;
+          dirtySince = now;
+          ok = false;
+          continue;
+        } else {
+          rec.inFlash = !rec.removed;
+          rec.flash = rec.value;
+          stats.keyWrites++;
+          stats.entries += rec.removed ? 0 : entriesFor(rec.type, rec.value.length);
+          written++;
+        }
+        markClean(rec);
+      }
+    }
+    if (written > 0) stats.commits++;
+    return ok;
+  }
+
+  return {
+    stats,
+    pending: () => dirtyCount,
+    putString: (ns, key, v, now = 0) => stage(ns, key, 'string', v, false, now),
+    putBytes: (ns, key, v, now = 0) => stage(ns, key, 'bytes', v, false, now),
+    remove: (ns, key, now = 0) => stage(ns, key, 'bytes', '', true, now),
+    flush: (ns, now = 0) => commit(ns, now),
+    loop(now, hold = false) {
+      if (hold || dirtyCount === 0 || now - dirtySince < NVS_COMMIT_DELAY_MS) return;
+      commit(null, now);
+    },
+    discard(ns) {
+      for (let i = records.length - 1; i >= 0; i--) {
+        if (records[i].ns !== ns) continue;
+        if (records[i].dirty) dirtyCount--;
+        records.splice(i, 1);
+      }
+    },
+  };
+}
+
+describe('commit hold', () => {
+  test('a held loop does not commit however old the change is', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.putString('timer', 'timezone', 'UTC', 0);
+    for (let t = NVS_COMMIT_DELAY_MS; t <= 10 * NVS_COMMIT_DELAY_MS; t += 100) store.loop(t, true);
+    expect(flash.writes).toBe(0);
+    expect(store.pending()).toBe(1);
+  });
+
+  test('the first loop without the hold commits at once', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.putString('timer', 'timezone', 'UTC', 0);
+    store.loop(5 * NVS_COMMIT_DELAY_MS, true);
+    store.loop(5 * NVS_COMMIT_DELAY_MS + 10, false);
+    expect(flash.get('timer', 'timezone')).toBe('UTC');
+    expect(store.pending()).toBe(0);
+  });
+
+  test('flush writes through the hold', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.putString('helloclub', 'cancel', '1', 0);
+    store.loop(NVS_COMMIT_DELAY_MS, true);
+    expect(store.flush('helloclub')).toBe(true);
+    expect(flash.get('helloclub', 'cancel')).toBe('1');
+  });
+});
+
+describe('dirty tracking', () => {
+  test('a staged value is not written until the commit delay passes', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.putString('timer', 'timezone', 'Pacific/Auckland', 1000);
+    store.loop(1000 + NVS_COMMIT_DELAY_MS - 1);
+    expect(flash.writes).toBe(0);
+    expect(store.pending()).toBe(1);
+
+    store.loop(1000 + NVS_COMMIT_DELAY_MS);
+    expect(flash.get('timer', 'timezone')).toBe('Pacific/Auckland');
+    expect(store.pending()).toBe(0);
+  });
+
+  test('a value flash already holds is skipped on first commit', () => {
+    const flash = makeFlash({ 'timer/timezone': 'UTC' });
+    const store = makeStore(flash);
+    store.putString('timer', 'timezone', 'UTC');
+    store.flush();
+    expect(flash.writes).toBe(0);
+    expect(store.stats.skipped).toBe(1);
+  });
+
+  test('once flash is known, re-saving the same value never becomes dirty', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.putString('timer', 'timezone', 'UTC');
+    store.flush();
+    store.putString('timer', 'timezone', 'UTC');
+    expect(store.pending()).toBe(0);
+    expect(flash.writes).toBe(1);
+  });
+});
+
+describe('coalescing', () => {
+  test('repeated changes to one key produce a single write of the last value', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    [1, 2, 3, 4, 5].forEach((n) => store.putString('timer', 'gameDuration', String(n)));
+    store.flush();
+    expect(flash.writes).toBe(1);
+    expect(flash.get('timer', 'gameDuration')).toBe('5');
+    expect(store.stats.coalesced).toBe(4);
+  });
+
+  test('changing a key back to its flash value cancels the pending write', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.putString('timer', 'k', 'a');
+    store.flush();
+    store.putString('timer', 'k', 'b');
+    expect(store.pending()).toBe(1);
+    store.putString('timer', 'k', 'a');
+    expect(store.pending()).toBe(0);
+    store.flush();
+    expect(flash.writes).toBe(1);
+  });
+
+  test('the delay runs from the first change, not the latest', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.putString('timer', 'a', '1', 0);
+    store.putString('timer', 'b', '1', 1500);
+    store.loop(NVS_COMMIT_DELAY_MS);
+    expect(flash.writes).toBe(2);
+  });
+});
+
+describe('batching', () => {
+  test('one session per namespace', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.putString('timer', 'a', '1');
+    store.putString('helloclub', 'x', '1');
+    store.putString('timer', 'b', '1');
+    store.putString('helloclub', 'y', '1');
+    store.flush();
+    expect(flash.sessions).toEqual(['timer', 'helloclub']);
+    expect(flash.writes).toBe(4);
+    expect(store.stats.commits).toBe(1);
+  });
+
+  test('flush(ns) commits only that namespace', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.putString('timer', 'a', '1');
+    store.putString('helloclub', 'evt_cancel', 'evt42');
+    store.flush('helloclub');
+    expect(flash.get('helloclub', 'evt_cancel')).toBe('evt42');
+    expect(flash.has('timer', 'a')).toBe(false);
+    expect(store.pending()).toBe(1);
+  });
+});
+
+describe('removal', () => {
+  test('remove of an absent key writes nothing', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.remove('helloclub', 'evt_cancel');
+    store.flush();
+    expect(flash.writes).toBe(0);
+  });
+
+  test('remove of a present key deletes it', () => {
+    const flash = makeFlash({ 'helloclub/evt_cancel': 'evt42' });
+    const store = makeStore(flash);
+    store.remove('helloclub', 'evt_cancel');
+    store.flush();
+    expect(flash.has('helloclub', 'evt_cancel')).toBe(false);
+  });
+
+  test('an empty blob is stored as a removal', () => {
+    const flash = makeFlash({ 'helloclub/evt_trig': 'ab' });
+    const store = makeStore(flash);
+    store.putBytes('helloclub', 'evt_trig', '');
+    store.flush();
+    expect(flash.has('helloclub', 'evt_trig')).toBe(false);
+  });
+});
+
+describe('failed writes', () => {
+  test('flush reports the failure and keeps the value pending', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    flash.failing.add('evt_cancel');
+    store.putString('helloclub', 'evt_cancel', 'abc');
+    store.putString('helloclub', 'last_recov', 'k');
+    expect(store.flush('helloclub')).toBe(false);
+    expect(store.pending()).toBe(1);
+    expect(store.stats.failed).toBe(1);
+    expect(flash.data.get('helloclub/last_recov')).toBe('k');
+  });
+
+  test('loop retries after the commit delay and succeeds once flash recovers', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    flash.failing.add('k');
+    store.putString('ns', 'k', 'v', 0);
+    store.loop(NVS_COMMIT_DELAY_MS);
+    expect(store.pending()).toBe(1);
+
+    flash.failing.clear();
+    store.loop(NVS_COMMIT_DELAY_MS + 100);              // Delay restarts at the failure
+    expect(store.pending()).toBe(1);
+    store.loop(2 * NVS_COMMIT_DELAY_MS);
+    expect(store.pending()).toBe(0);
+    expect(flash.data.get('ns/k')).toBe('v');
+  });
+
+  test('a failed removal is retried too', () => {
+    const flash = makeFlash({ 'ns/k': 'v' });
+    const store = makeStore(flash);
+    flash.failing.add('k');
+    store.remove('ns', 'k');
+    expect(store.flush()).toBe(false);
+    flash.failing.clear();
+    expect(store.flush()).toBe(true);
+    expect(flash.data.has('ns/k')).toBe(false);
+  });
+
+  test('flush with nothing pending succeeds', () => {
+    expect(makeStore(makeFlash()).flush()).toBe(true);
+  });
+});
+
+describe('discard', () => {
+  test('drops pending writes for the namespace only', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.putString('helloclub', 'apiKey', 'k');
+    store.putString('timer', 'a', '1');
+    store.discard('helloclub');
+    expect(store.pending()).toBe(1);
+    store.flush();
+    expect(flash.has('helloclub', 'apiKey')).toBe(false);
+    expect(flash.get('timer', 'a')).toBe('1');
+  });
+
+  test('forgets the flash shadow so a cleared namespace is re-read', () => {
+    const flash = makeFlash();
+    const store = makeStore(flash);
+    store.putString('helloclub', 'apiKey', 'k');
+    store.flush();
+    store.discard('helloclub');
+    flash.data.clear(); // Preferences::clear()
+    store.putString('helloclub', 'apiKey', 'k');
+    store.flush();
+    expect(flash.get('helloclub', 'apiKey')).toBe('k');
+  });
+});
+
+describe('entriesFor', () => {
+  [
+    ['u32', 4, 1],
+    ['string', 0, 2],
+    ['string', 31, 2],
+    ['string', 32, 3],
+    ['bytes', 32, 3],
+    ['bytes', 6700, 212],
+  ].forEach(([type, len, expected]) => {
+    test(`${type} of ${len} bytes uses ${expected} entries`, () => {
+      expect(entriesFor(type, len)).toBe(expected);
+    });
+  });
+});
@@ -1,12 +1,118 @@
 /**
  * Unit tests for ISO 8601 to UTC epoch conversion
- * Mirrors: src/helloclub.cpp — parseISOToEpoch()
+ * Mirrors: src/hcparse.cpp — hcParseIsoEpoch()
  *
  * Validates the manual UTC epoch calculation that replaces
- * the broken mktime-based approach (which got DST wrong).
+ * the broken mktime-based approach (which got DST wrong), plus the
+ * pointer-based field parser: offsets, fractions and field validation.
+ * tests/native/iso-epoch-sweep.cpp runs the same DST sweep and benchmark
+ * against the C++ parser itself, and checks the event builder's handling
+ * of end dates that don't parse.
  */
 
-function parseISOToEpoch(isoDate) {
+const isDigit = (c) => c >= '0' && c <= '9';
+
+// Mirrors readFixedDigits(): exactly `digits` digits at pos, or null
+function readFixedDigits(s, pos, digits) {
+  let value = 0;
+  for (let i = 0; i < digits; i++) {
+    const c = s[pos + i];
+    if (c === undefined || !isDigit(c)) return null;
+    value = value * 10 + (s.charCodeAt(pos + i) - 48);
+  }
+  return value;
+}
+
+function isLeapYear(y) {
+  return (y % 4 === 0 && y % 100 !== 0) || y % 400 === 0;
+}
+
+function daysInMonth(y, m) {
+  const DAYS = [31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31];
+  return (m === 2 && isLeapYear(y)) ? 29 : DAYS[m - 1];
+}
+
+// C-style integer division, as in the firmware
+const idiv = (a, b) => Math.trunc(a / b);
+
+function daysFromCivil(year, mon, day) {
+  let y = year;
+  let m = mon;
+  if (m <= 2) { y--; m += 12; }
+  m -= 3; // Mar=0 .. Feb=11
+
+  return 365 * (y - 1970)
+    + idiv(y - 1968, 4) - idiv(y - 1900, 100) + idiv(y - 1600, 400)
+    + idiv(153 * m + 2, 5) + day - 1
+    + 59;
+}
+
+// YYYY-MM-DD[T ]hh:mm[:ss[.fff]][Z|+-hh[:mm]|+-hhmm] -> UTC epoch, 0 if invalid
+function parseISOToEpoch(iso) {
+  if (!iso) return 0;
+  let p = 0;
+  const field = (digits) => {
+    const v = readFixedDigits(iso, p, digits);
+    if (v !== null) p += digits;
+    return v;
+  };
+
+  const year = field(4);
+  if (year === null || iso[p++] !== '-') return 0;
+  const mon = field(2);
+  if (mon === null || iso[p++] !== '-') return 0;
+  const day = field(2);
+  if (day === null) return 0;
+  if (iso[p] !== 'T' && iso[p] !== 't' && iso[p] !== ' ') return 0;
+  p++;
+  const hour = field(2);
+  if (hour === null || iso[p++] !== ':') return 0;
+  const min = field(2);
+  if (min === null) return 0;
+  let sec = 0;
+  if (iso[p] === ':') {
+    p++;
+    sec = field(2);
+    if (sec === null) return 0;
+    if (iso[p] === '.' || iso[p] === ',') {
+      p++;
+      if (!isDigit(iso[p] || '')) return 0;
+      while (isDigit(iso[p] || '')) p++;
+    }
+  }
+
+  if (year < 1970 || mon < 1 || mon > 12 || day < 1 || day > daysInMonth(year, mon)) return 0;
+  if (hour > 23 || min > 59 || sec > 60) return 0;
+  if (sec === 60) sec = 59;
+
+  let offsetSec = 0;
+  if (iso[p] === 'Z' || iso[p] === 'z') {
+    p++;
+  } else if (iso[p] === '+' || iso[p] === '-') {
+    const sign = iso[p++] === '-' ? -1 : 1;
+    const offH = field(2);
+    if (offH === null) return 0;
+    let offM = 0;
+    if (iso[p] === ':') {
+      p++;
+      offM = field(2);
+      if (offM === null) return 0;
+    } else if (isDigit(iso[p] || '')) {
+      offM = field(2);
+      if (offM === null) return 0;
+    }
+    if (offH > 14 || offM > 59) return 0;
+    offsetSec = sign * (offH * 3600 + offM * 60);
+  }
+  if (p !== iso.length) return 0;
+
+  const epoch = daysFromCivil(year, mon, day) * 86400 + hour * 3600 + min * 60 + sec - offsetSec;
+  return epoch > 0 ? epoch : 0;
+}
+
+// Pre-rewrite implementation (fixed substring offsets, offsets and fractions
+// ignored), kept as the benchmark baseline
+function legacyParseISOToEpoch(isoDate) {
   if (!isoDate || isoDate.length < 19) return 0;
 
   const year = parseInt(isoDate.substring(0, 4));
@@ -16,18 +122,24 @@ function parseISOToEpoch(isoDate) {
   const min  = parseInt(isoDate.substring(14, 16));
   const sec  = parseInt(isoDate.substring(17, 19));
 
-  // Same algorithm as the C++ implementation
-  let y = year;
-  let m = mon;
-  if (m <= 2) { y--; m += 12; }
-  m -= 3; // Mar=0 .. Feb=11
+  return daysFromCivil(year, mon, day) * 86400 + hour * 3600 + min * 60 + sec;
+}
 
-  const days = 365 * (y - 1970)
-    + Math.floor((y - 1968) / 4) - Math.floor((y - 1900) / 100) + Math.floor((y - 1600) / 400)
-    + Math.floor((153 * m + 2) / 5) + day - 1
-    + 59;
+// Local wall-clock string with numeric offset, as an API serving
+// Pacific/Auckland times would send it
+const aucklandFmt = new Intl.DateTimeFormat('en-US', {
+  timeZone: 'Pacific/Auckland', hourCycle: 'h23', timeZoneName: 'longOffset',
+  year: 'numeric', month: '2-digit', day: '2-digit',
+  hour: '2-digit', minute: '2-digit', second: '2-digit',
+});
 
-  return days * 86400 + hour * 3600 + min * 60 + sec;
+function aucklandISO(epochSec) {
+  const parts = {};
+  for (const { type, value } of aucklandFmt.formatToParts(new Date(epochSec * 1000))) {
+    parts[type] = value;
+  }
+  const offset = parts.timeZoneName.replace('GMT', '') || '+00:00';
+  return `${parts.year}-${parts.month}-${parts.day}T${parts.hour}:${parts.minute}:${parts.second}${offset}`;
 }
 
 // Reference: use JS Date.UTC for ground truth
@@ -113,7 +225,7 @@ describe('parseISOToEpoch', () => {
       expect(parseISOToEpoch(iso)).toBe(jsEpoch(iso));
     });
 
-    test('too short string returns 0', () => {
+    test('date without time returns 0', () => {
       expect(parseISOToEpoch('2025-01-01')).toBe(0);
     });
 
@@ -142,6 +254,141 @@ describe('parseISOToEpoch', () => {
     });
   });
 
+  describe('fractions and offsets', () => {
+    test('fractional seconds are truncated', () => {
+      expect(parseISOToEpoch('2026-03-17T05:30:00.123Z')).toBe(jsEpoch('2026-03-17T05:30:00Z'));
+      expect(parseISOToEpoch('2026-03-17T05:30:00.999999Z')).toBe(jsEpoch('2026-03-17T05:30:00Z'));
+      expect(parseISOToEpoch('2026-03-17T05:30:00,5Z')).toBe(jsEpoch('2026-03-17T05:30:00Z'));
+    });
+
+    test('positive and negative offsets shift to UTC', () => {
+      const utc = jsEpoch('2026-03-17T05:30:00Z');
+      expect(parseISOToEpoch('2026-03-17T18:30:00+13:00')).toBe(utc);
+      expect(parseISOToEpoch('2026-03-17T18:30:00+1300')).toBe(utc);
+      expect(parseISOToEpoch('2026-03-17T18:30:00+13')).toBe(utc);
+      expect(parseISOToEpoch('2026-03-17T00:30:00-05:00')).toBe(utc);
+      expect(parseISOToEpoch('2026-03-17T11:15:00+05:45')).toBe(utc);
+    });
+
+    test('offset crossing a date boundary', () => {
+      expect(parseISOToEpoch('2026-01-01T09:00:00+13:00')).toBe(jsEpoch('2025-12-31T20:00:00Z'));
+    });
+
+    test('fraction and offset together', () => {
+      expect(parseISOToEpoch('2026-03-17T18:30:00.250+13:00')).toBe(jsEpoch('2026-03-17T05:30:00Z'));
+    });
+
+    test('no zone designator is read as UTC, seconds optional', () => {
+      expect(parseISOToEpoch('2026-03-17T05:30:00')).toBe(jsEpoch('2026-03-17T05:30:00Z'));
+      expect(parseISOToEpoch('2026-03-17T05:30Z')).toBe(jsEpoch('2026-03-17T05:30:00Z'));
+      expect(parseISOToEpoch('2026-03-17 05:30:00Z')).toBe(jsEpoch('2026-03-17T05:30:00Z'));
+    });
+
+    test('the legacy parser silently ignored offsets', () => {
+      const iso = '2026-03-17T18:30:00+13:00';
+      expect(legacyParseISOToEpoch(iso) - parseISOToEpoch(iso)).toBe(13 * 3600);
+    });
+  });
+
+  describe('field validation', () => {
+    [
+      '2026-13-01T00:00:00Z',
+      '2026-00-10T00:00:00Z',
+      '2026-02-29T00:00:00Z',
+      '2026-04-31T00:00:00Z',
+      '2026-03-17T24:00:00Z',
+      '2026-03-17T05:60:00Z',
+      '2026-03-17T05:30:61Z',
+      '2026-03-17T05:30:00+15:00',
+      '2026-03-17T05:30:00+13:60',
+      '2026-03-17T05:30:00+13:',
+      '2026-03-17T05:30:00+1',
+      '2026-03-17T05:30:00.Z',
+      '2026-03-17T05:30:00Zjunk',
+      '2026-3-17T05:30:00Z',
+      '2026/03/17T05:30:00Z',
+      '2026-03-17X05:30:00Z',
+      '1969-12-31T23:59:59Z',
+      '2026-03-17T5:30:00Z',
+    ].forEach((iso) => {
+      test(`rejects ${iso}`, () => {
+        expect(parseISOToEpoch(iso)).toBe(0);
+      });
+    });
+
+    test('leap second is held at :59', () => {
+      expect(parseISOToEpoch('2016-12-31T23:59:60Z')).toBe(jsEpoch('2016-12-31T23:59:59Z'));
+    });
+  });
+
+  describe('Pacific/Auckland DST sweep', () => {
+    // Every transition 2024-2030, minute by minute for three hours either side,
+    // written as local time with the offset in force at that instant
+    function findTransitions(fromYear, toYear) {
+      const transitions = [];
+      let prev = null;
+      const end = Date.UTC(toYear + 1, 0, 1) / 1000;
+      for (let t = Date.UTC(fromYear, 0, 1) / 1000; t < end; t += 3600) {
+        const offset = aucklandISO(t).slice(-6);
+        if (prev !== null && offset !== prev) transitions.push(t);
+        prev = offset;
+      }
+      return transitions;
+    }
+
+    const transitions = findTransitions(2024, 2030);
+
+    test('finds a start and an end transition each year', () => {
+      expect(transitions).toHaveLength(14);
+    });
+
+    test('every local time with offset maps back to its UTC instant', () => {
+      let checked = 0;
+      for (const t of transitions) {
+        for (let e = t - 3 * 3600; e <= t + 3 * 3600; e += 60) {
+          expect(parseISOToEpoch(aucklandISO(e))).toBe(e);
+          checked++;
+        }
+      }
+      expect(checked).toBe(14 * 361);
+    });
+
+    test('the repeated hour at DST end is disambiguated by its offset', () => {
+      const first = parseISOToEpoch('2026-04-05T02:30:00+13:00');
+      const second = parseISOToEpoch('2026-04-05T02:30:00+12:00');
+      expect(second - first).toBe(3600);
+    });
+
+    test('hourly across 2025-2026 in both offsets', () => {
+      const end = Date.UTC(2027, 0, 1) / 1000;
+      for (let e = Date.UTC(2025, 0, 1) / 1000; e < end; e += 3600) {
+        expect(parseISOToEpoch(aucklandISO(e))).toBe(e);
+      }
+    });
+  });
+
+  describe('benchmark', () => {
+    test('parses as fast as the substring implementation', () => {
+      const corpus = [];
+      for (let i = 0; i < 20000; i++) {
+        corpus.push(new Date((1750000000 + i * 3797) * 1000).toISOString().replace('.000', ''));
+      }
+      const time = (fn) => {
+        const t0 = process.hrtime.bigint();
+        let sum = 0;
+        for (let r = 0; r < 5; r++) for (const iso of corpus) sum += fn(iso);
+        return { ms: Number(process.hrtime.bigint() - t0) / 1e6, sum };
+      };
+      time(parseISOToEpoch); // Warm up both
+      time(legacyParseISOToEpoch);
+      const fast = time(parseISOToEpoch);
+      const legacy = time(legacyParseISOToEpoch);
+
+      expect(fast.sum).toBe(legacy.sum);
+      expect(fast.ms).toBeLessThan(2000);
+    });
+  });
+
   describe('Hello Club realistic events', () => {
     test('Tuesday evening badminton 5:30pm-7:30pm NZDT', () => {
       // 5:30pm NZDT = 4:30am UTC
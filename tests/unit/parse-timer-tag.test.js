@@ -1,13 +1,178 @@
 /**
  * Unit tests for parseTimerTag() — Hello Club event description parser
  * Source: test-server/server.js:88-122
- * Mirror of: src/helloclub.cpp parseTimerTag()
+ * Mirror of: src/hcparse.cpp hcParseTimerTag()
+ *
+ * The C++ parser itself is fuzzed (under AddressSanitizer/UBSan) and
+ * benchmarked by tests/native/tag-fuzz.cpp; the fuzz and throughput cases
+ * here cover this mirror's grammar.
  */
 
 // Default duration used when tag says "enabled" or omits duration
 let hcDefaultDuration = 12;
 
+const MIN_GAME_DURATION_MIN = 1;
+const MAX_GAME_DURATION_MIN = 120;
+const MAX_ROUNDS = 20;
+const HELLOCLUB_MAX_WARMUP_MIN = 30;
+const HELLOCLUB_MAX_BREAK_SEC = 600;
+const HELLOCLUB_MAX_SIREN_BLASTS = 5;
+const HELLOCLUB_MAX_COURT = 99;
+
+const isDigit = (c) => c >= '0' && c <= '9';
+const isAlpha = (c) => (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+
+// Mirrors TagLexer: one pass over the tag line, tokens are
+// { kind: 'num', number } | { kind: 'word', text } | { kind: ':' | '=' } | { kind: 'end' }
+class TagLexer {
+  constructor(str, pos) {
+    this.s = str;
+    this.p = pos;
+  }
+
+  next() {
+    const s = this.s;
+    while (this.p < s.length && s[this.p] !== '\n' && !isDigit(s[this.p]) &&
+           !isAlpha(s[this.p]) && s[this.p] !== ':' && s[this.p] !== '=') {
+      this.p++;
+    }
+    if (this.p >= s.length || s[this.p] === '\n') return { kind: 'end' };
+
+    const c = s[this.p];
+    if (isDigit(c)) {
+      let value = 0;
+      while (this.p < s.length && isDigit(s[this.p])) {
+        if (value < 9999) value = value * 10 + (s.charCodeAt(this.p) - 48);
+        this.p++;
+      }
+      return { kind: 'num', number: Math.min(value, 9999) };
+    }
+    if (isAlpha(c)) {
+      const start = this.p;
+      while (this.p < s.length &&
+             (isAlpha(s[this.p]) || (s[this.p] === '-' && isAlpha(s[this.p + 1] || '')))) {
+        this.p++;
+      }
+      return { kind: 'word', text: s.substring(start, this.p).toLowerCase() };
+    }
+    this.p++;
+    return { kind: c };
+  }
+
+  peek() {
+    const saved = this.p;
+    const tok = this.next();
+    this.p = saved;
+    return tok;
+  }
+
+  readNumber() {
+    let tok = this.peek();
+    if (tok.kind === '=' || tok.kind === ':') {
+      this.next();
+      tok = this.peek();
+    }
+    if (tok.kind !== 'num') return null;
+    this.next();
+    return tok.number;
+  }
+
+  skipIf(match) {
+    if (!match(this.peek())) return false;
+    this.next();
+    return true;
+  }
+}
+
+const wordIn = (...words) => (tok) => tok.kind === 'word' && words.includes(tok.text);
+const isMinutesUnit = wordIn('m', 'min', 'mins', 'minute', 'minutes');
+const isSecondsUnit = wordIn('s', 'sec', 'secs', 'second', 'seconds');
+const isRoundsUnit = wordIn('round', 'rounds');
+const isWarningWord = wordIn('warn', 'warning');
+const isBlastsUnit = wordIn('x', 'blast', 'blasts');
+
+function findTimerTag(s) {
+  const pos = s.toLowerCase().indexOf('timer:');
+  return pos === -1 ? -1 : pos + 6;
+}
+
+function parseTimerTagFull(description) {
+  if (!description) return null;
+  const start = findTimerTag(description);
+  if (start === -1) return null;
+
+  const tag = {
+    duration: hcDefaultDuration, rounds: 0,
+    warmupMin: 0, breakSec: 0, sirenBlasts: 0, court: 0, oneMinuteWarning: false,
+  };
+
+  const lex = new TagLexer(description, start);
+  for (let tok = lex.next(); tok.kind !== 'end'; tok = lex.next()) {
+    if (tok.kind === 'num') {
+      const unit = lex.peek();
+      if (unit.kind === ':') {
+        lex.next();
+        if (tok.number >= MIN_GAME_DURATION_MIN && tok.number <= MAX_GAME_DURATION_MIN) {
+          tag.duration = tok.number;
+        }
+        if (lex.peek().kind === 'num') {
+          const rounds = lex.next().number;
+          if (rounds <= MAX_ROUNDS) tag.rounds = rounds;
+        }
+      } else if (isMinutesUnit(unit)) {
+        lex.next();
+        if (tok.number === 1 && lex.skipIf(isWarningWord)) {
+          tag.oneMinuteWarning = true;
+        } else if (tok.number >= MIN_GAME_DURATION_MIN && tok.number <= MAX_GAME_DURATION_MIN) {
+          tag.duration = tok.number;
+        }
+      } else if (isRoundsUnit(unit)) {
+        lex.next();
+        if (tok.number <= MAX_ROUNDS) tag.rounds = tok.number;
+      }
+      continue;
+    }
+
+    if (tok.kind !== 'word') continue;
+    if (tok.text === 'warmup' || tok.text === 'warm-up') {
+      const n = lex.readNumber();
+      if (n !== null) {
+        lex.skipIf(isMinutesUnit);
+        if (n >= 1 && n <= HELLOCLUB_MAX_WARMUP_MIN) tag.warmupMin = n;
+      }
+    } else if (tok.text === 'break') {
+      const n = lex.readNumber();
+      if (n !== null) {
+        let sec = n * 60;
+        if (lex.skipIf(isSecondsUnit)) sec = n;
+        else lex.skipIf(isMinutesUnit);
+        if (sec >= 1 && sec <= HELLOCLUB_MAX_BREAK_SEC) tag.breakSec = sec;
+      }
+    } else if (tok.text === 'siren' || tok.text === 'sirens') {
+      const n = lex.readNumber();
+      if (n !== null) {
+        lex.skipIf(isBlastsUnit);
+        if (n >= 1 && n <= HELLOCLUB_MAX_SIREN_BLASTS) tag.sirenBlasts = n;
+      }
+    } else if (tok.text === 'court') {
+      const n = lex.readNumber();
+      if (n !== null && n >= 1 && n <= HELLOCLUB_MAX_COURT) tag.court = n;
+    } else if (isWarningWord(tok)) {
+      tag.oneMinuteWarning = true;
+    }
+  }
+  return tag;
+}
+
+// Duration/rounds view used by the original tests
 function parseTimerTag(description) {
+  const tag = parseTimerTagFull(description);
+  return tag && { duration: tag.duration, rounds: tag.rounds };
+}
+
+// Pre-tokenizer implementation (regex over a lowercased copy), kept as the
+// reference for the legacy min/rounds grammar and as the benchmark baseline
+function legacyParseTimerTag(description) {
   if (!description) return null;
   const lower = description.toLowerCase();
   const tagPos = lower.indexOf('timer:');
@@ -20,27 +185,43 @@ function parseTimerTag(description) {
   const lowerValue = value.toLowerCase();
 
   let duration = hcDefaultDuration;
-  let rounds = 0; // 0 = continuous
-
-  if (lowerValue.startsWith('enabled') || value === '') {
-    return { duration, rounds };
-  }
+  let rounds = 0;
+  if (lowerValue.startsWith('enabled') || value === '') return { duration, rounds };
 
   const minMatch = lowerValue.match(/(\d+)\s*min/);
   if (minMatch) {
     const val = parseInt(minMatch[1]);
     if (val >= 1 && val <= 120) duration = val;
   }
-
   const roundMatch = lowerValue.match(/(\d+)\s*round/);
   if (roundMatch) {
     const val = parseInt(roundMatch[1]);
     if (val >= 1 && val <= 20) rounds = val;
   }
-
   return { duration, rounds };
 }
 
+// Deterministic LCG so fuzz failures are reproducible
+function makeRandom(seed) {
+  let s = seed;
+  return () => {
+    s = (s * 1103515245 + 12345) & 0x7fffffff;
+    return s / 0x7fffffff;
+  };
+}
+
+const SAMPLE_DESCRIPTIONS = [
+  'Club night — all levels welcome.\ntimer: 12min 3rounds',
+  'timer: enabled',
+  'Juniors\nTimer: 10 min, 4 rounds, warmup 5, break 2\nBring water',
+  'TIMER: 15:0 court 3 siren 3',
+  'Social doubles. timer: 20min warn',
+  'Ladder\ntimer: 12:3; warm-up=10min; break=90s; sirens=2x; court=7; 1min warning',
+  'Coaching session, no timer needed',
+  'timer:',
+  'Open play (timer: 8min 5 rounds)\nNotes: shuttles provided',
+];
+
 describe('parseTimerTag', () => {
   beforeEach(() => {
     hcDefaultDuration = 12;
@@ -143,4 +324,155 @@ describe('parseTimerTag', () => {
       expect(parseTimerTag('timer: enabled')).toEqual({ duration: 20, rounds: 0 });
     });
   });
+
+  describe('duration:rounds shorthand', () => {
+    test('parses D:R', () => {
+      expect(parseTimerTag('timer: 12:3')).toEqual({ duration: 12, rounds: 3 });
+    });
+
+    test('D:0 is continuous', () => {
+      expect(parseTimerTag('timer: 12:0')).toEqual({ duration: 12, rounds: 0 });
+    });
+
+    test('out-of-range parts fall back independently', () => {
+      expect(parseTimerTag('timer: 200:3')).toEqual({ duration: 12, rounds: 3 });
+      expect(parseTimerTag('timer: 15:25')).toEqual({ duration: 15, rounds: 0 });
+    });
+  });
+
+  describe('directives', () => {
+    test('warm-up length in minutes', () => {
+      expect(parseTimerTagFull('timer: 12min warmup 5').warmupMin).toBe(5);
+      expect(parseTimerTagFull('timer: warm-up=10min').warmupMin).toBe(10);
+      expect(parseTimerTagFull('timer: warmup 31').warmupMin).toBe(0);
+    });
+
+    test('break defaults to minutes, accepts seconds', () => {
+      expect(parseTimerTagFull('timer: break 2').breakSec).toBe(120);
+      expect(parseTimerTagFull('timer: break=90s').breakSec).toBe(90);
+      expect(parseTimerTagFull('timer: break 45 seconds').breakSec).toBe(45);
+      expect(parseTimerTagFull('timer: break 11min').breakSec).toBe(0); // > 600s
+    });
+
+    test('siren pattern as blast count', () => {
+      expect(parseTimerTagFull('timer: siren 3').sirenBlasts).toBe(3);
+      expect(parseTimerTagFull('timer: sirens=2x').sirenBlasts).toBe(2);
+      expect(parseTimerTagFull('timer: siren 4 blasts').sirenBlasts).toBe(4);
+      expect(parseTimerTagFull('timer: siren 9').sirenBlasts).toBe(0);
+    });
+
+    test('court number', () => {
+      expect(parseTimerTagFull('timer: court 4').court).toBe(4);
+      expect(parseTimerTagFull('timer: court: 12').court).toBe(12);
+      expect(parseTimerTagFull('timer: court 0').court).toBe(0);
+    });
+
+    test('one-minute warning', () => {
+      expect(parseTimerTagFull('timer: 12min warn').oneMinuteWarning).toBe(true);
+      expect(parseTimerTagFull('timer: one-minute warning').oneMinuteWarning).toBe(true);
+      expect(parseTimerTagFull('timer: 12min').oneMinuteWarning).toBe(false);
+    });
+
+    test('"1min warning" is a warning, not a one-minute round', () => {
+      const tag = parseTimerTagFull('timer: 15min 1min warning');
+      expect(tag.duration).toBe(15);
+      expect(tag.oneMinuteWarning).toBe(true);
+    });
+
+    test('all directives together, in any order', () => {
+      expect(parseTimerTagFull(SAMPLE_DESCRIPTIONS[5])).toEqual({
+        duration: 12, rounds: 3, warmupMin: 10, breakSec: 90,
+        sirenBlasts: 2, court: 7, oneMinuteWarning: true,
+      });
+    });
+
+    test('directives after the tag line are ignored', () => {
+      expect(parseTimerTagFull('timer: 12min\ncourt 3').court).toBe(0);
+    });
+
+    test('unknown words and bare numbers are ignored', () => {
+      expect(parseTimerTag('timer: please 12min 42 for 3 rounds thanks'))
+        .toEqual({ duration: 12, rounds: 3 });
+    });
+  });
+
+  describe('fuzz', () => {
+    const ALPHABET = 'timer:TIMER 0123456789minroundswarmupbreaksirencourtwarn:=,;-\n\t xyz';
+
+    function checkInvariants(tag) {
+      expect(tag.duration >= MIN_GAME_DURATION_MIN && tag.duration <= MAX_GAME_DURATION_MIN).toBe(true);
+      expect(tag.rounds >= 0 && tag.rounds <= MAX_ROUNDS).toBe(true);
+      expect(tag.warmupMin >= 0 && tag.warmupMin <= HELLOCLUB_MAX_WARMUP_MIN).toBe(true);
+      expect(tag.breakSec >= 0 && tag.breakSec <= HELLOCLUB_MAX_BREAK_SEC).toBe(true);
+      expect(tag.sirenBlasts >= 0 && tag.sirenBlasts <= HELLOCLUB_MAX_SIREN_BLASTS).toBe(true);
+      expect(tag.court >= 0 && tag.court <= HELLOCLUB_MAX_COURT).toBe(true);
+    }
+
+    test('random strings never throw and always yield in-range fields', () => {
+      const rand = makeRandom(1234);
+      for (let i = 0; i < 5000; i++) {
+        const len = Math.floor(rand() * 80);
+        let str = rand() < 0.7 ? 'timer:' : '';
+        for (let j = 0; j < len; j++) str += ALPHABET[Math.floor(rand() * ALPHABET.length)];
+        const tag = parseTimerTagFull(str);
+        if (tag) checkInvariants(tag);
+      }
+    });
+
+    test('mutated real descriptions stay in range', () => {
+      const rand = makeRandom(99);
+      for (let i = 0; i < 5000; i++) {
+        const base = SAMPLE_DESCRIPTIONS[i % SAMPLE_DESCRIPTIONS.length].split('');
+        const edits = 1 + Math.floor(rand() * 4);
+        for (let e = 0; e < edits; e++) {
+          const pos = Math.floor(rand() * (base.length + 1));
+          const ch = String.fromCharCode(Math.floor(rand() * 128));
+          if (rand() < 0.5) base.splice(pos, 1, ch);
+          else base.splice(pos, 0, ch);
+        }
+        const tag = parseTimerTagFull(base.join(''));
+        if (tag) checkInvariants(tag);
+      }
+    });
+
+    test('huge numbers saturate instead of overflowing', () => {
+      const tag = parseTimerTagFull('timer: 99999999999999999999min court 4294967297');
+      expect(tag.duration).toBe(hcDefaultDuration);
+      expect(tag.court).toBe(0);
+    });
+
+    test('matches the legacy parser on the legacy grammar', () => {
+      const rand = makeRandom(7);
+      for (let i = 0; i < 2000; i++) {
+        const d = Math.floor(rand() * 130);
+        const r = Math.floor(rand() * 25);
+        const sp1 = rand() < 0.5 ? '' : ' ';
+        const sp2 = rand() < 0.5 ? '' : ' ';
+        const word = rand() < 0.5 ? 'rounds' : 'round';
+        const desc = `Session\ntimer: ${d}${sp1}min ${r}${sp2}${word}\nmore`;
+        expect(parseTimerTag(desc)).toEqual(legacyParseTimerTag(desc));
+      }
+    });
+  });
+
+  describe('throughput', () => {
+    test('parses thousands of descriptions quickly', () => {
+      const rand = makeRandom(5);
+      const corpus = [];
+      for (let i = 0; i < 5000; i++) {
+        const base = SAMPLE_DESCRIPTIONS[Math.floor(rand() * SAMPLE_DESCRIPTIONS.length)];
+        corpus.push('Weekly booking #' + i + ' — ' + 'lorem ipsum '.repeat(Math.floor(rand() * 20)) + '\n' + base);
+      }
+
+      const t0 = process.hrtime.bigint();
+      let tagged = 0;
+      for (const desc of corpus) {
+        if (parseTimerTagFull(desc)) tagged++;
+      }
+      const ms = Number(process.hrtime.bigint() - t0) / 1e6;
+
+      expect(tagged).toBeGreaterThan(4000);
+      expect(ms).toBeLessThan(2000);
+    });
+  });
 });
@@ -0,0 +1,218 @@
+/**
+ * Unit tests for the adaptive Hello Club poll schedule and fetch guard window
+ * Mirrors: src/main.cpp — getHelloClubPollInterval(), inFetchGuardWindow(),
+ *          checkHelloClubPoll() deferral cap
+ *          src/helloclub.cpp — getNextEventStart()
+ */
+
+const HELLOCLUB_POLL_INTERVAL_MS = 3600000;
+const HELLOCLUB_RETRY_INTERVAL_MS = 300000;
+const HELLOCLUB_IDLE_POLL_INTERVAL_MS = 10800000;
+const HELLOCLUB_PRE_EVENT_WINDOW_MS = 3600000;
+const HELLOCLUB_PRE_EVENT_INTERVAL_MS = 600000;
+const HELLOCLUB_FETCH_GUARD_MS = 60000;
+const HELLOCLUB_FETCH_MAX_DEFER_MS = 900000;
+const SCHEDULE_CHECK_INTERVAL_MS = 30000;
+
+function getNextEventStart(events, after) {
+  let next = 0;
+  for (const evt of events) {
+    if (evt.triggered || evt.startTime < after) continue;
+    if (next === 0 || evt.startTime < next) next = evt.startTime;
+  }
+  return next;
+}
+
+function getHelloClubPollInterval(events, now, lastPollFailed) {
+  if (lastPollFailed) return HELLOCLUB_RETRY_INTERVAL_MS;
+
+  const nextStart = getNextEventStart(events, now);
+  if (nextStart === 0) return HELLOCLUB_IDLE_POLL_INTERVAL_MS;
+
+  if ((nextStart - now) * 1000 <= HELLOCLUB_PRE_EVENT_WINDOW_MS) {
+    return HELLOCLUB_PRE_EVENT_INTERVAL_MS;
+  }
+  return HELLOCLUB_POLL_INTERVAL_MS;
+}
+
+function inFetchGuardWindow(timer, events, now) {
+  if (timer.state === 'RUNNING') {
+    const elapsed = timer.gameDuration - timer.remaining;
+    if (timer.remaining <= HELLOCLUB_FETCH_GUARD_MS || elapsed <= HELLOCLUB_FETCH_GUARD_MS) {
+      return true;
+    }
+  }
+
+  const guardSec = HELLOCLUB_FETCH_GUARD_MS / 1000;
+  const nextStart = getNextEventStart(events, now - guardSec);
+  return nextStart > 0 && nextStart <= now + guardSec;
+}
+
+/** Replicates the guard gate at the end of checkHelloClubPoll() */
+class PollGate {
+  constructor() {
+    this.deferred = false;
+    this.deferredSince = 0;
+  }
+  // True if the due poll should start now
+  check(now, guarded) {
+    if (guarded) {
+      if (!this.deferred) {
+        this.deferred = true;
+        this.deferredSince = now;
+      }
+      if (now - this.deferredSince < HELLOCLUB_FETCH_MAX_DEFER_MS) return false;
+    }
+    this.deferred = false;
+    return true;
+  }
+}
+
+/**
+ * Continuous-mode timer with rounds of `roundMs`, checked every 30 s (with
+ * a phase offset) while a poll is due. Returns the ms until the poll starts
+ * and whether it started inside the guard window.
+ */
+function firstPoll(roundMs, phaseMs) {
+  const gate = new PollGate();
+  for (let t = phaseMs; t < 24 * 3600000; t += SCHEDULE_CHECK_INTERVAL_MS) {
+    const timer = { state: 'RUNNING', gameDuration: roundMs, remaining: roundMs - (t % roundMs) };
+    const guarded = inFetchGuardWindow(timer, [], NOW);
+    if (gate.check(t, guarded)) return { after: t - phaseMs, guarded };
+  }
+  return null;
+}
+
+const NOW = 1750000000;
+const IDLE_TIMER = { state: 'IDLE', gameDuration: 720000, remaining: 0 };
+
+function evt(startOffsetSec, triggered = false) {
+  return { startTime: NOW + startOffsetSec, triggered };
+}
+
+describe('getNextEventStart()', () => {
+  test('returns 0 with no events', () => {
+    expect(getNextEventStart([], NOW)).toBe(0);
+  });
+
+  test('returns earliest untriggered start after the cutoff', () => {
+    const events = [evt(7200), evt(1800), evt(-600), evt(900, true)];
+    expect(getNextEventStart(events, NOW)).toBe(NOW + 1800);
+  });
+
+  test('ignores events that are all triggered or in the past', () => {
+    expect(getNextEventStart([evt(-60), evt(600, true)], NOW)).toBe(0);
+  });
+});
+
+describe('getHelloClubPollInterval()', () => {
+  test('retry interval after a failed poll, regardless of schedule', () => {
+    expect(getHelloClubPollInterval([evt(600)], NOW, true)).toBe(HELLOCLUB_RETRY_INTERVAL_MS);
+    expect(getHelloClubPollInterval([], NOW, true)).toBe(HELLOCLUB_RETRY_INTERVAL_MS);
+  });
+
+  test('backs off when nothing is scheduled', () => {
+    expect(getHelloClubPollInterval([], NOW, false)).toBe(HELLOCLUB_IDLE_POLL_INTERVAL_MS);
+  });
+
+  test('backs off when only triggered or past events are cached', () => {
+    const events = [evt(-3600), evt(1200, true)];
+    expect(getHelloClubPollInterval(events, NOW, false)).toBe(HELLOCLUB_IDLE_POLL_INTERVAL_MS);
+  });
+
+  test('normal interval when next event is more than an hour away', () => {
+    expect(getHelloClubPollInterval([evt(3 * 3600)], NOW, false)).toBe(HELLOCLUB_POLL_INTERVAL_MS);
+  });
+
+  test('dense interval in the hour before an event', () => {
+    expect(getHelloClubPollInterval([evt(3600)], NOW, false)).toBe(HELLOCLUB_PRE_EVENT_INTERVAL_MS);
+    expect(getHelloClubPollInterval([evt(300)], NOW, false)).toBe(HELLOCLUB_PRE_EVENT_INTERVAL_MS);
+  });
+
+  test('uses the soonest event when several are cached', () => {
+    const events = [evt(5 * 3600), evt(1800), evt(2 * 86400)];
+    expect(getHelloClubPollInterval(events, NOW, false)).toBe(HELLOCLUB_PRE_EVENT_INTERVAL_MS);
+  });
+});
+
+describe('inFetchGuardWindow()', () => {
+  test('clear when idle and no events nearby', () => {
+    expect(inFetchGuardWindow(IDLE_TIMER, [evt(3600)], NOW)).toBe(false);
+  });
+
+  test('guarded in the last minute of a running round', () => {
+    const timer = { state: 'RUNNING', gameDuration: 720000, remaining: 45000 };
+    expect(inFetchGuardWindow(timer, [], NOW)).toBe(true);
+  });
+
+  test('guarded in the first minute after a round boundary', () => {
+    const timer = { state: 'RUNNING', gameDuration: 720000, remaining: 700000 };
+    expect(inFetchGuardWindow(timer, [], NOW)).toBe(true);
+  });
+
+  test('clear mid-round', () => {
+    const timer = { state: 'RUNNING', gameDuration: 720000, remaining: 360000 };
+    expect(inFetchGuardWindow(timer, [], NOW)).toBe(false);
+  });
+
+  test('paused timer does not guard (no siren pending)', () => {
+    const timer = { state: 'PAUSED', gameDuration: 720000, remaining: 10000 };
+    expect(inFetchGuardWindow(timer, [], NOW)).toBe(false);
+  });
+
+  test('guarded just before an untriggered event start', () => {
+    expect(inFetchGuardWindow(IDLE_TIMER, [evt(30)], NOW)).toBe(true);
+  });
+
+  test('guarded just after an untriggered event start', () => {
+    expect(inFetchGuardWindow(IDLE_TIMER, [evt(-30)], NOW)).toBe(true);
+  });
+
+  test('guard edges are inclusive', () => {
+    expect(inFetchGuardWindow(IDLE_TIMER, [evt(60)], NOW)).toBe(true);
+    expect(inFetchGuardWindow(IDLE_TIMER, [evt(61)], NOW)).toBe(false);
+    expect(inFetchGuardWindow(IDLE_TIMER, [evt(-61)], NOW)).toBe(false);
+  });
+
+  test('triggered events do not guard', () => {
+    expect(inFetchGuardWindow(IDLE_TIMER, [evt(10, true)], NOW)).toBe(false);
+  });
+});
+
+describe('poll deferral cap', () => {
+  test('rounds of two minutes or less are guarded end to end', () => {
+    for (const roundMs of [60000, 90000, 120000]) {
+      for (let t = 0; t < roundMs; t += 1000) {
+        const timer = { state: 'RUNNING', gameDuration: roundMs, remaining: roundMs - t };
+        expect(inFetchGuardWindow(timer, [], NOW)).toBe(true);
+      }
+    }
+  });
+
+  test('short rounds: the poll goes ahead after the cap', () => {
+    for (const roundMs of [60000, 90000, 120000]) {
+      for (const phase of [0, 7000, 15000, 29000]) {
+        const poll = firstPoll(roundMs, phase);
+        expect(poll).not.toBeNull();
+        expect(poll.guarded).toBe(true);
+        expect(poll.after).toBeGreaterThanOrEqual(HELLOCLUB_FETCH_MAX_DEFER_MS);
+        expect(poll.after).toBeLessThan(HELLOCLUB_FETCH_MAX_DEFER_MS + SCHEDULE_CHECK_INTERVAL_MS);
+      }
+    }
+  });
+
+  test('normal rounds: the poll waits for a clear moment, never forced', () => {
+    for (const phase of [0, 5000, 50000, 650000]) {
+      const poll = firstPoll(720000, phase);
+      expect(poll.guarded).toBe(false);
+      expect(poll.after).toBeLessThan(120000 + SCHEDULE_CHECK_INTERVAL_MS);
+    }
+  });
+
+  test('the cap restarts once a poll has gone out', () => {
+    const gate = new PollGate();
+    expect(gate.check(0, true)).toBe(false);
+    expect(gate.check(HELLOCLUB_FETCH_MAX_DEFER_MS, true)).toBe(true);
+    expect(gate.check(HELLOCLUB_FETCH_MAX_DEFER_MS + 3600000, true)).toBe(false);
+  });
+});
@@ -1,10 +1,15 @@
 /**
  * Unit tests for remote log ring buffer
- * Mirrors: src/remotelog.cpp — ring buffer with JSON serialization
+ * Mirrors: src/remotelog.cpp — ring buffer with JSON serialization, and
+ * remoteLogWriteJson(): incremental reads by sequence number into a fixed
+ * buffer
  */
 
 const RLOG_MAX_ENTRIES = 40;
 const RLOG_MSG_LEN = 100;
+const RLOG_JSON_BUF_SIZE = 1536;
+const HEAD = '{"event":"remote_log","entries":[';
+const TAIL_MAX = '],"seq":4294967295,"lost":4294967295,"more":false}'.length + 1;
 
 class RemoteLog {
   constructor() {
@@ -38,6 +43,34 @@ class RemoteLog {
     return result;
   }
 
+  // remoteLogWriteJson(): entries from cursor onward, stopping at the first
+  // entry that does not fit. Returns the message text and the new cursor.
+  writeJson(cursor, size = RLOG_JSON_BUF_SIZE) {
+    const oldest = Math.max(0, this.seq - RLOG_MAX_ENTRIES);
+    let lost = 0;
+    if (cursor > this.seq) {
+      cursor = oldest; // Cursor from before a reboot
+    } else if (cursor < oldest) {
+      lost = oldest - cursor;
+      cursor = oldest;
+    }
+    const limit = size - TAIL_MAX;
+    let json = HEAD;
+    let more = false;
+    for (; cursor !== this.seq; cursor++) {
+      const e = this.buffer[cursor % RLOG_MAX_ENTRIES];
+      const item = (json === HEAD ? '' : ',') +
+        JSON.stringify({ s: cursor, t: e.timestamp, m: e.message });
+      if (json.length + item.length + 1 > limit) {
+        more = true;
+        break;
+      }
+      json += item;
+    }
+    json += `],"seq":${cursor},"lost":${lost},"more":${more}}`;
+    return { json, cursor };
+  }
+
   getSeq() { return this.seq; }
   getCount() { return this.count; }
 }
@@ -122,3 +155,81 @@ describe('Remote Log Ring Buffer', () => {
     expect(log.getCount()).toBe(RLOG_MAX_ENTRIES);
   });
 });
+
+describe('Remote Log Incremental Reads', () => {
+  let log;
+
+  beforeEach(() => {
+    log = new RemoteLog();
+  });
+
+  test('cursor 0 returns everything held', () => {
+    log.log(100, 'first');
+    log.log(200, 'second');
+    const { json, cursor } = log.writeJson(0);
+    const msg = JSON.parse(json);
+    expect(msg.event).toBe('remote_log');
+    expect(msg.entries.map(e => e.s)).toEqual([0, 1]);
+    expect(msg.seq).toBe(2);
+    expect(cursor).toBe(2);
+    expect(msg.lost).toBe(0);
+    expect(msg.more).toBe(false);
+  });
+
+  test('returns only entries since the cursor', () => {
+    for (let i = 0; i < 5; i++) log.log(i, `msg ${i}`);
+    let { cursor } = log.writeJson(0);
+    log.log(10, 'new one');
+    const next = log.writeJson(cursor);
+    const msg = JSON.parse(next.json);
+    expect(msg.entries).toHaveLength(1);
+    expect(msg.entries[0]).toEqual({ s: 5, t: 10, m: 'new one' });
+    expect(next.cursor).toBe(6);
+  });
+
+  test('nothing new gives an empty batch at the same cursor', () => {
+    log.log(1, 'a');
+    const { cursor } = log.writeJson(0);
+    const again = log.writeJson(cursor);
+    expect(JSON.parse(again.json).entries).toHaveLength(0);
+    expect(again.cursor).toBe(cursor);
+  });
+
+  test('reports entries overwritten before they were read as lost', () => {
+    for (let i = 0; i < RLOG_MAX_ENTRIES + 7; i++) log.log(i, `msg ${i}`);
+    const msg = JSON.parse(log.writeJson(2).json);
+    expect(msg.lost).toBe(5);
+    expect(msg.entries[0].s).toBe(7);
+  });
+
+  test('cursor ahead of the log (device rebooted) restarts from the oldest entry', () => {
+    log.log(1, 'after reboot');
+    const msg = JSON.parse(log.writeJson(500).json);
+    expect(msg.entries.map(e => e.m)).toEqual(['after reboot']);
+    expect(msg.lost).toBe(0);
+  });
+
+  test('splits into batches that fit the fixed buffer', () => {
+    for (let i = 0; i < RLOG_MAX_ENTRIES; i++) log.log(i, 'x'.repeat(90));
+    let cursor = 0;
+    const seen = [];
+    let batches = 0;
+    for (;;) {
+      const out = log.writeJson(cursor);
+      expect(out.json.length).toBeLessThan(RLOG_JSON_BUF_SIZE);
+      const msg = JSON.parse(out.json);
+      seen.push(...msg.entries.map(e => e.s));
+      cursor = out.cursor;
+      batches++;
+      if (!msg.more) break;
+    }
+    expect(batches).toBeGreaterThan(1);
+    expect(seen).toEqual([...Array(RLOG_MAX_ENTRIES).keys()]);
+  });
+
+  test('escapes quotes, backslashes and newlines', () => {
+    log.log(1, 'say "hi"\\path\nnext');
+    const msg = JSON.parse(log.writeJson(0).json);
+    expect(msg.entries[0].m).toBe('say "hi"\\path\nnext');
+  });
+});
@@ -0,0 +1,166 @@
+/**
+ * Unit tests for the non-blocking serial log ring
+ * Mirrors: src/seriallog.cpp — reserve(), SerialLog::write(), SerialLog::printf(), drainTask()
+ *
+ * Bounded MPMC ring with a sequence number per slot: a slot is free for
+ * position p when seq == p, readable when seq == p + 1, and handed back for
+ * p + SLOTS once drained. Writers never wait: a full ring drops and counts.
+ */
+
+const SLOTS = 8;
+const SLOT_SIZE = 4;
+const PRINTF_MAX = 16;
+
+function u32(x) {
+  return x >>> 0;
+}
+
+function makeRing(startPos = 0) {
+  const slots = [];
+  for (let i = 0; i < SLOTS; i++) {
+    const pos = u32(startPos + i);
+    slots[pos & (SLOTS - 1)] = { seq: pos, data: '' };
+  }
+  return {
+    slots,
+    writePos: u32(startPos),
+    readPos: u32(startPos),
+    dropped: 0,
+    queued: 0,
+  };
+}
+
+/** Replicates reserve(): returns { pos, slot } or null when full */
+function reserve(ring) {
+  const pos = ring.writePos;
+  const slot = ring.slots[pos & (SLOTS - 1)];
+  const diff = (slot.seq - pos) | 0; // int32_t
+  if (diff < 0) return null;
+  ring.writePos = u32(pos + 1); // compare_exchange succeeds (single-threaded here)
+  return { pos, slot };
+}
+
+function publish(r, data) {
+  r.slot.data = data;
+  r.slot.seq = u32(r.pos + 1);
+}
+
+/** Replicates SerialLog::write(): splits into slots, drops the rest when full */
+function write(ring, text) {
+  let done = 0;
+  while (done < text.length) {
+    const r = reserve(ring);
+    if (!r) {
+      ring.dropped += text.length - done;
+      break;
+    }
+    const chunk = text.slice(done, done + SLOT_SIZE);
+    publish(r, chunk);
+    done += chunk.length;
+  }
+  ring.queued += done;
+  return text.length;
+}
+
+/** Replicates the truncation in SerialLog::printf() */
+function printf(ring, fmt, formatted) {
+  let out = formatted.slice(0, PRINTF_MAX - 1);
+  if (formatted.length > out.length && fmt.endsWith('\n')) {
+    out = out.slice(0, -1) + '\n';
+  }
+  return write(ring, out);
+}
+
+/** Replicates one drainTask() pass: everything published in order, stopping at the first gap */
+function drain(ring) {
+  let out = '';
+  for (;;) {
+    const slot = ring.slots[ring.readPos & (SLOTS - 1)];
+    if (slot.seq !== u32(ring.readPos + 1)) break;
+    out += slot.data;
+    slot.seq = u32(ring.readPos + SLOTS);
+    ring.readPos = u32(ring.readPos + 1);
+  }
+  return out;
+}
+
+describe('write and drain', () => {
+  test('text comes out in order', () => {
+    const ring = makeRing();
+    write(ring, 'Siren ');
+    write(ring, 'blast 2\n');
+    expect(drain(ring)).toBe('Siren blast 2\n');
+    expect(ring.queued).toBe(14);
+  });
+
+  test('long writes are split across slots', () => {
+    const ring = makeRing();
+    write(ring, 'abcdefghij');
+    expect(ring.writePos).toBe(3);
+    expect(drain(ring)).toBe('abcdefghij');
+  });
+
+  test('drained slots are reusable', () => {
+    const ring = makeRing();
+    for (let i = 0; i < 5; i++) {
+      write(ring, 'x'.repeat(SLOT_SIZE * SLOTS));
+      expect(drain(ring)).toHaveLength(SLOT_SIZE * SLOTS);
+    }
+    expect(ring.dropped).toBe(0);
+  });
+});
+
+describe('full ring', () => {
+  test('drops instead of waiting and counts the bytes', () => {
+    const ring = makeRing();
+    write(ring, 'y'.repeat(SLOT_SIZE * SLOTS));
+    expect(write(ring, 'lost')).toBe(4);
+    expect(ring.dropped).toBe(4);
+    expect(drain(ring)).toBe('y'.repeat(SLOT_SIZE * SLOTS));
+  });
+
+  test('a write that only partly fits keeps its head', () => {
+    const ring = makeRing();
+    write(ring, 'z'.repeat(SLOT_SIZE * (SLOTS - 1)));
+    write(ring, 'headtail');
+    expect(ring.dropped).toBe(4);
+    expect(drain(ring).endsWith('head')).toBe(true);
+  });
+});
+
+describe('concurrent writers', () => {
+  test('the reader stops at a reserved but unpublished slot', () => {
+    const ring = makeRing();
+    const slow = reserve(ring); // Writer A reserved, still copying
+    write(ring, 'B\n'); // Writer B published after it
+    expect(drain(ring)).toBe('');
+
+    publish(slow, 'A\n');
+    expect(drain(ring)).toBe('A\nB\n');
+  });
+});
+
+describe('position wrap', () => {
+  test('works across the 32-bit position overflow', () => {
+    const ring = makeRing(0xfffffffc);
+    write(ring, 'wrap-around!');
+    expect(drain(ring)).toBe('wrap-around!');
+    write(ring, 'again');
+    expect(drain(ring)).toBe('again');
+    expect(ring.readPos).toBeLessThan(SLOTS);
+  });
+});
+
+describe('printf truncation', () => {
+  test('keeps the line break of a truncated line', () => {
+    const ring = makeRing();
+    printf(ring, '%s\n', 'HelloClub API: https://example\n');
+    expect(drain(ring)).toBe('HelloClub API:\n');
+  });
+
+  test('short lines are untouched', () => {
+    const ring = makeRing();
+    printf(ring, 'Siren blast %d\n', 'Siren blast 2\n');
+    expect(drain(ring)).toBe('Siren blast 2\n');
+  });
+});
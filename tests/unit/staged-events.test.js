@@ -20,12 +20,43 @@ function makeEvent(overrides = {}) {
   };
 }
 
+// Mirrors HelloClubClient::hashId() — 64-bit FNV-1a
+function hashId(id) {
+  let hash = 0xcbf29ce484222325n;
+  for (const c of Buffer.from(id, 'utf8')) {
+    hash ^= BigInt(c);
+    hash = (hash * 0x100000001b3n) & 0xFFFFFFFFFFFFFFFFn;
+  }
+  return hash;
+}
+
+// Mirrors eventKey() — combined id + startTime key for the hash join
+function eventKey(evt) {
+  return hashId(evt.id) ^ ((BigInt(evt.startTime) * 0x9E3779B97F4A7C15n) & 0xFFFFFFFFFFFFFFFFn);
+}
+
 /**
  * Replicates applyStagedEvents() from helloclub.cpp:
  * Merges staged events into the live cache, preserving triggered state
  * from existing events that match on BOTH id AND startTime.
+ * Hash join: index the triggered existing events, probe once per staged event.
  */
 function applyStagedEvents(existingEvents, stagedEvents) {
+  const triggeredIndex = new Map();
+  for (const existing of existingEvents) {
+    if (existing.triggered) triggeredIndex.set(eventKey(existing), existing);
+  }
+  for (const staged of stagedEvents) {
+    const match = triggeredIndex.get(eventKey(staged));
+    if (match && hashId(match.id) === hashId(staged.id) && match.startTime === staged.startTime) {
+      staged.triggered = true;
+    }
+  }
+  return [...stagedEvents];
+}
+
+// Previous O(n·m) nested-loop merge, kept as the reference for equivalence tests
+function applyStagedEventsNested(existingEvents, stagedEvents) {
   for (const staged of stagedEvents) {
     for (const existing of existingEvents) {
       if (existing.id === staged.id && existing.startTime === staged.startTime) {
@@ -162,4 +193,43 @@ describe('Staged Events — applyStagedEvents()', () => {
       expect(result[1].triggered).toBe(false);
     });
   });
+
+  describe('hash join matches the nested-loop merge', () => {
+    // Recurring-heavy cache: 4 courts share ids, occurrences differ by startTime
+    function makeCache(n) {
+      const events = [];
+      for (let i = 0; i < n; i++) {
+        events.push(makeEvent({
+          id: `court${i % 4}-${Math.floor(i / 28)}`,
+          startTime: 1750000000 + i * 1800,
+          triggered: i % 3 === 0,
+        }));
+      }
+      return events;
+    }
+
+    for (const n of [20, 100, 500]) {
+      test(`${n} events`, () => {
+        const existing = makeCache(n);
+        // Next sync: drops the oldest quarter, adds new occurrences at the end
+        const fresh = () => makeCache(n + n / 4).slice(n / 4).map(e => ({ ...e, triggered: false }));
+
+        const viaHash = applyStagedEvents(existing, fresh());
+        const viaNested = applyStagedEventsNested(existing, fresh());
+        expect(viaHash).toEqual(viaNested);
+        expect(viaHash.some(e => e.triggered)).toBe(true);
+      });
+    }
+  });
+
+  describe('hashId()', () => {
+    test('FNV-1a 64 reference values', () => {
+      expect(hashId('')).toBe(0xcbf29ce484222325n);
+      expect(hashId('a')).toBe(0xaf63dc4c8601ec8cn);
+    });
+
+    test('distinct for ids differing in one character', () => {
+      expect(hashId('evt000000001')).not.toBe(hashId('evt000000002'));
+    });
+  });
 });
@@ -0,0 +1,118 @@
+/**
+ * Unit tests for the Hello Club sync result handoff (lock-free triple buffer)
+ * Mirrors: src/triplebuffer.h — publish(), take()
+ *          src/helloclub.cpp — fetchAndCacheEvents(), applyStagedEvents()
+ *
+ * The worker fills back(), then exchanges it into the middle slot with the
+ * FRESH bit set. The main loop exchanges its front buffer for the middle one
+ * when FRESH is set. The two-thread stress test runs the real TripleBuffer
+ * natively: tests/native/sync-handoff-stress.cpp.
+ */
+
+const SYNC_INDEX_MASK = 0x03;
+const SYNC_FRESH = 0x80;
+
+class SyncHandoff {
+  constructor() {
+    this.buffers = [0, 1, 2].map(() => ({ events: [], error: '', success: false }));
+    this.backIdx = 0;
+    this.frontIdx = 1;
+    this.middle = 2;
+    this.events = [];
+  }
+
+  // Producer: fetchAndCacheEvents() + publishSyncResult()
+  publish(success, events, error = '') {
+    const out = this.buffers[this.backIdx];
+    out.events.length = 0;
+    out.events.push(...events);
+    out.error = error;
+    out.success = success;
+
+    const prev = this.middle;
+    this.middle = this.backIdx | SYNC_FRESH;
+    this.backIdx = prev & SYNC_INDEX_MASK;
+  }
+
+  // Consumer: applyStagedEvents()
+  apply() {
+    if (!(this.middle & SYNC_FRESH)) return false;
+    const taken = this.middle;
+    this.middle = this.frontIdx;
+    this.frontIdx = taken & SYNC_INDEX_MASK;
+
+    const result = this.buffers[this.frontIdx];
+    if (!result.success) return false;
+    // Swap, not copy
+    const old = this.events;
+    this.events = result.events;
+    result.events = old;
+    return true;
+  }
+
+  getLastError() {
+    return this.buffers[this.frontIdx].error;
+  }
+
+  ownedIndices() {
+    return [this.backIdx, this.frontIdx, this.middle & SYNC_INDEX_MASK].sort();
+  }
+}
+
+describe('sync result handoff', () => {
+  let h;
+
+  beforeEach(() => {
+    h = new SyncHandoff();
+  });
+
+  test('nothing to apply before the first publish', () => {
+    expect(h.apply()).toBe(false);
+    expect(h.getLastError()).toBe('');
+  });
+
+  test('published events become the live cache', () => {
+    h.publish(true, ['a', 'b']);
+    expect(h.apply()).toBe(true);
+    expect(h.events).toEqual(['a', 'b']);
+  });
+
+  test('a result is applied only once', () => {
+    h.publish(true, ['a']);
+    h.apply();
+    expect(h.apply()).toBe(false);
+  });
+
+  test('failed result keeps the cache but exposes the error', () => {
+    h.publish(true, ['a']);
+    h.apply();
+    h.publish(false, [], 'HTTP error: 503');
+    expect(h.apply()).toBe(false);
+    expect(h.events).toEqual(['a']);
+    expect(h.getLastError()).toBe('HTTP error: 503');
+  });
+
+  test('a newer publish supersedes an unconsumed one', () => {
+    h.publish(true, ['old']);
+    h.publish(true, ['new']);
+    expect(h.apply()).toBe(true);
+    expect(h.events).toEqual(['new']);
+    expect(h.apply()).toBe(false);
+  });
+
+  test('events move by swap — no copy of the array', () => {
+    h.publish(true, ['a']);
+    const published = h.buffers[h.middle & SYNC_INDEX_MASK].events;
+    h.apply();
+    expect(h.events).toBe(published);
+  });
+
+  test('producer never writes into the buffer the consumer holds', () => {
+    for (let i = 0; i < 50; i++) {
+      h.publish(i % 3 !== 0, [i]);
+      if (i % 2 === 0) h.apply();
+      expect(h.ownedIndices()).toEqual([0, 1, 2]);
+      expect(h.backIdx).not.toBe(h.frontIdx);
+    }
+  });
+});
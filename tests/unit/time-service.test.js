@@ -0,0 +1,141 @@
+/**
+ * Unit tests for the time service
+ * Mirrors: src/timesvc.cpp — refreshLocal() 12-hour format, the zone table,
+ *          timeLoop() sync scheduling and sync-quality bookkeeping
+ *
+ * SNTP replies arrive in the lwIP task (sntp_sync_time() measures the
+ * correction and sets the clock); the loop only applies the result, times
+ * out silent requests and decides when to ask again.
+ */
+
+const fs = require('fs');
+const path = require('path');
+
+const SYNC_INTERVAL = 3600000;
+const SYNC_TIMEOUT = 10000;
+const SYNC_RETRY = 60000;
+
+/** Replicates the clock12 format in refreshLocal() */
+function clock12(h, m, s) {
+  const hour12 = h % 12 === 0 ? 12 : h % 12;
+  const pad = n => String(n).padStart(2, '0');
+  return `${pad(hour12)}:${pad(m)}:${pad(s)} ${h < 12 ? 'am' : 'pm'}`;
+}
+
+/** Replicates timeLoop() request scheduling */
+class TimeSync {
+  constructor() {
+    this.now = 0;
+    this.connected = true;
+    this.requests = [];
+    this.stats = { syncs: 0, failures: 0, offsetMs: 0, rttMs: 0, lastSyncMs: 0, source: 'none' };
+    this.requestedAt = 0;
+    this.nextPollAt = 0;
+    this.started = false;
+    this.reply = null;
+  }
+  startSync() {
+    this.started = true;
+    this.requestedAt = this.now | 1;
+    this.requests.push(this.now);
+  }
+  // sntp_sync_time(), lwIP task
+  onReply(offsetMs) { this.reply = { offsetMs, at: this.now }; }
+  loop() {
+    const now = this.now;
+    if (this.reply) {
+      const r = this.reply;
+      this.reply = null;
+      this.stats.offsetMs = r.offsetMs;
+      this.stats.lastSyncMs = r.at | 1;
+      if (this.requestedAt) this.stats.rttMs = this.stats.lastSyncMs - this.requestedAt;
+      this.stats.syncs++;
+      this.stats.source = 'ntp';
+      this.requestedAt = 0;
+      this.nextPollAt = now + SYNC_INTERVAL;
+    } else if (this.requestedAt && now - this.requestedAt >= SYNC_TIMEOUT) {
+      this.stats.failures++;
+      this.requestedAt = 0;
+      this.nextPollAt = now + SYNC_RETRY;
+    }
+    if (this.started && !this.requestedAt && now - this.nextPollAt >= 0 && this.connected) {
+      this.requestedAt = now | 1;
+      this.requests.push(now);
+    }
+  }
+  advance(ms, step = 100) {
+    for (let t = 0; t < ms; t += step) { this.now += step; this.loop(); }
+  }
+}
+
+describe('Time service: local time', () => {
+  test('12-hour clock matches the format parseServerTime() reads', () => {
+    expect(clock12(0, 5, 9)).toBe('12:05:09 am');
+    expect(clock12(9, 30, 15)).toBe('09:30:15 am');
+    expect(clock12(12, 0, 0)).toBe('12:00:00 pm');
+    expect(clock12(23, 59, 59)).toBe('11:59:59 pm');
+    expect(clock12(13, 1, 2)).toMatch(/^(\d{1,2}):(\d{2}):(\d{2})\s*(am|pm)$/i);
+  });
+
+  test('every timezone offered by the settings page has a POSIX rule', () => {
+    const root = path.join(__dirname, '..', '..');
+    const html = fs.readFileSync(path.join(root, 'data', 'index.html'), 'utf8');
+    const src = fs.readFileSync(path.join(root, 'src', 'timesvc.cpp'), 'utf8');
+    const select = html.slice(html.indexOf('id="timezone-select"'), html.indexOf('</select>', html.indexOf('id="timezone-select"')));
+    const offered = [...select.matchAll(/value="([^"]+)"/g)].map(m => m[1]);
+    const table = new Set([...src.matchAll(/\{"([A-Za-z_]+\/[A-Za-z_]+)",\s*"[^"]+"\}/g)].map(m => m[1]));
+    expect(offered.length).toBeGreaterThan(0);
+    for (const zone of offered) expect(table.has(zone)).toBe(true);
+  });
+});
+
+describe('Time service: sync scheduling', () => {
+  test('reply records offset and request-to-reply time, next poll after the interval', () => {
+    const t = new TimeSync();
+    t.startSync();
+    t.advance(300);
+    t.onReply(-42);
+    t.advance(100);
+    expect(t.stats).toMatchObject({ syncs: 1, offsetMs: -42, source: 'ntp' });
+    expect(t.stats.rttMs).toBeGreaterThanOrEqual(300);
+    t.advance(SYNC_INTERVAL - 1000);
+    expect(t.requests).toHaveLength(1);
+    t.advance(2000);
+    expect(t.requests).toHaveLength(2);
+  });
+
+  test('a silent request counts as a failure and is retried after a minute', () => {
+    const t = new TimeSync();
+    t.startSync();
+    t.advance(SYNC_TIMEOUT + 100);
+    expect(t.stats.failures).toBe(1);
+    expect(t.requests).toHaveLength(1);
+    t.advance(SYNC_RETRY);
+    expect(t.requests).toHaveLength(2);
+  });
+
+  test('no requests while the station is down', () => {
+    const t = new TimeSync();
+    t.startSync();
+    t.advance(SYNC_TIMEOUT + 100);
+    t.connected = false;
+    t.advance(10 * SYNC_RETRY);
+    expect(t.requests).toHaveLength(1);
+    t.connected = true;
+    t.advance(200);
+    expect(t.requests).toHaveLength(2);
+  });
+
+  test('an unrequested reply (client retry) keeps the last round-trip time', () => {
+    const t = new TimeSync();
+    t.startSync();
+    t.advance(200);
+    t.onReply(5);
+    t.advance(100);
+    const rtt = t.stats.rttMs;
+    t.onReply(7);
+    t.advance(100);
+    expect(t.stats.syncs).toBe(2);
+    expect(t.stats.rttMs).toBe(rtt);
+  });
+});
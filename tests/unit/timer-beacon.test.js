@@ -0,0 +1,165 @@
+/**
+ * Unit tests for the UDP timer beacon
+ * Mirrors: src/beacon.cpp — packet layout and beaconLoop() send rules
+ * Decoder under test: test-server/beacon-listen.js
+ *
+ * A packet goes out on every change (state, flags, round, duration, or the
+ * round end moving), twice more 200 ms apart against loss, and every 10 s
+ * while nothing changes. While running, the countdown itself is not a
+ * change: the round end on clockMillis() stays put.
+ */
+
+const fs = require('fs');
+const path = require('path');
+const { decodeBeacon, describeBeacon } = require(
+  path.join(__dirname, '..', '..', 'test-server', 'beacon-listen'));
+
+const HEARTBEAT_MS = 10000;
+const REPEAT_MS = 200;
+const REPEATS = 2;
+const SLACK_MS = 50;
+const STATES = { IDLE: 0, RUNNING: 1, PAUSED: 2, FINISHED: 3 };
+
+/** Replicates send() in beacon.cpp */
+function encode(t, change, nowMs, timeValid = true) {
+  const buf = Buffer.alloc(32);
+  buf.write('BTB1', 0, 'latin1');
+  let flags = (t.pauseAfterNext ? 1 : 0) | (t.continuousMode ? 2 : 0);
+  let deadline = 0n;
+  if (t.state === STATES.RUNNING && timeValid) {
+    deadline = BigInt(nowMs + t.remaining);
+    flags |= 4;
+  }
+  buf.writeUInt8(t.state, 4);
+  buf.writeUInt8(flags, 5);
+  buf.writeUInt16LE(t.round, 6);
+  buf.writeUInt16LE(t.rounds, 8);
+  buf.writeUInt32LE(change, 12);
+  buf.writeUInt32LE(t.remaining, 16);
+  buf.writeUInt32LE(t.duration, 20);
+  buf.writeBigUInt64LE(deadline, 24);
+  return buf;
+}
+
+/** Replicates beaconLoop() */
+class Beacon {
+  constructor() {
+    this.changes = 0;
+    this.last = null;
+    this.lastSentAt = 0;
+    this.repeatsLeft = 0;
+    this.packets = [];
+    this.connected = true;
+  }
+  loop(t, now) {
+    if (!this.connected) return;
+    const flags = (t.pauseAfterNext ? 1 : 0) | (t.continuousMode ? 2 : 0);
+    const mark = t.state === STATES.RUNNING ? (now + t.remaining) >>> 0 : t.remaining;
+    const l = this.last;
+    const moved = l ? (mark - l.mark) | 0 : 0;
+    if (!l || t.state !== l.state || flags !== l.flags || t.round !== l.round || t.rounds !== l.rounds ||
+        t.duration !== l.duration || moved > SLACK_MS || moved < -SLACK_MS) {
+      this.last = { state: t.state, flags, round: t.round, rounds: t.rounds, duration: t.duration, mark };
+      this.changes++;
+      this.repeatsLeft = REPEATS;
+    } else if (this.repeatsLeft > 0 && now - this.lastSentAt >= REPEAT_MS) {
+      this.repeatsLeft--;
+    } else if (now - this.lastSentAt < HEARTBEAT_MS) {
+      return;
+    }
+    this.packets.push({ at: now, packet: decodeBeacon(encode(t, this.changes, now)) });
+    this.lastSentAt = now;
+  }
+}
+
+/** Timer stand-in: counts down while running */
+function timer(overrides = {}) {
+  return { state: STATES.IDLE, pauseAfterNext: false, continuousMode: false, round: 1, rounds: 3,
+           remaining: 0, duration: 900000, ...overrides };
+}
+
+function run(beacon, t, from, to, step = 10) {
+  for (let now = from; now < to; now += step) {
+    if (t.state === STATES.RUNNING) t.remaining = Math.max(0, t.endAt - now);
+    beacon.loop(t, now);
+  }
+}
+
+describe('Beacon packet', () => {
+  test('decodes the firmware layout', () => {
+    const t = timer({ state: STATES.RUNNING, round: 2, remaining: 123456, pauseAfterNext: true, continuousMode: true });
+    const b = decodeBeacon(encode(t, 42, 1773700000000));
+    expect(b).toEqual({
+      state: 'RUNNING', pauseAfterNext: true, continuousMode: true, currentRound: 2, numRounds: 3,
+      change: 42, remainingMs: 123456, durationMs: 900000, deadlineMs: 1773700123456,
+    });
+  });
+
+  test('no deadline without NTP time or while paused', () => {
+    expect(decodeBeacon(encode(timer({ state: STATES.RUNNING, remaining: 5000 }), 1, 0, false)).deadlineMs).toBeNull();
+    expect(decodeBeacon(encode(timer({ state: STATES.PAUSED, remaining: 5000 }), 1, 1773700000000)).deadlineMs).toBeNull();
+  });
+
+  test('other datagrams are ignored', () => {
+    expect(decodeBeacon(Buffer.from('hello'))).toBeNull();
+    expect(decodeBeacon(Buffer.alloc(32))).toBeNull();
+  });
+
+  test('listener line shows the round and time left', () => {
+    const b = decodeBeacon(encode(timer({ state: STATES.PAUSED, round: 2, remaining: 61000 }), 7, 0));
+    expect(describeBeacon(b, 0)).toBe('#7 PAUSED   round 2/3 01:01');
+  });
+
+  test('firmware and listener agree on the magic and size', () => {
+    const root = path.join(__dirname, '..', '..');
+    const header = fs.readFileSync(path.join(root, 'src', 'beacon.h'), 'utf8');
+    const source = fs.readFileSync(path.join(root, 'src', 'beacon.cpp'), 'utf8');
+    expect(header).toMatch(/BEACON_PACKET_SIZE = 32;/);
+    expect(source).toMatch(/memcpy\(packet, "BTB1", 4\)/);
+  });
+});
+
+describe('Beacon send rules', () => {
+  test('a change is sent three times, then heartbeats every 10 s', () => {
+    const beacon = new Beacon();
+    const t = timer();
+    run(beacon, t, 0, 25000);
+    expect(beacon.packets.map(p => p.at)).toEqual([0, 200, 400, 10400, 20400]);
+    expect(new Set(beacon.packets.map(p => p.packet.change))).toEqual(new Set([1]));
+  });
+
+  test('the countdown alone is not a change; a new round is', () => {
+    const beacon = new Beacon();
+    const t = timer({ state: STATES.RUNNING, endAt: 30000, duration: 30000 });
+    run(beacon, t, 0, 29990);
+    expect(beacon.packets.map(p => p.packet.change)).toEqual([1, 1, 1, 1, 1]);
+    t.round = 2;
+    t.endAt = 60000;
+    run(beacon, t, 29990, 30500);
+    expect(beacon.packets.slice(5).map(p => [p.at, p.packet.change, p.packet.currentRound]))
+      .toEqual([[29990, 2, 2], [30190, 2, 2], [30390, 2, 2]]);
+  });
+
+  test('pause and a moved deadline are changes; loop jitter is not', () => {
+    const beacon = new Beacon();
+    const t = timer({ state: STATES.RUNNING, endAt: 60000 });
+    run(beacon, t, 0, 1000);
+    t.endAt += 30;                         // Loop jitter
+    run(beacon, t, 1000, 2000);
+    expect(beacon.changes).toBe(1);
+    t.endAt += 2000;                       // Resumed mid-round elsewhere
+    run(beacon, t, 2000, 3000);
+    expect(beacon.changes).toBe(2);
+    t.state = STATES.PAUSED;
+    run(beacon, t, 3000, 4000);
+    expect(beacon.changes).toBe(3);
+    expect(beacon.packets[beacon.packets.length - 1].packet.state).toBe('PAUSED');
+  });
+
+  test('nothing is sent while the station is down', () => {
+    const beacon = new Beacon();
+    beacon.connected = false;
+    run(beacon, timer(), 0, 20000);
+    expect(beacon.packets).toHaveLength(0);
+  });
+});
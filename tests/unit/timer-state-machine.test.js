@@ -52,7 +52,7 @@ class Timer {
         this.pauseAfterNext = false;
       } else {
         this.currentRound++;
-        this.mainTimerStart = this._now;
+        this.mainTimerStart += this.gameDuration;
       }
     }
 
@@ -282,6 +282,23 @@ describe('Timer State Machine', () => {
       expect(timer.isMatchFinished()).toBe(true);
     });
 
+    test('late update() does not push later round boundaries back', () => {
+      timer.gameDuration = 5000;
+      timer.numRounds = 3;
+      timer.start();
+
+      // Loop notices the round end 120 ms late
+      timer.advanceTime(5120);
+      timer.update();
+      expect(timer.currentRound).toBe(2);
+      expect(timer.mainTimerRemaining).toBe(0);
+
+      // Round 2 still ends at 10000 ms from the start, not 10120
+      timer.advanceTime(4880);
+      timer.update();
+      expect(timer.currentRound).toBe(3);
+    });
+
     test('single round game finishes after one round', () => {
       timer.gameDuration = 5000;
       timer.numRounds = 1;
@@ -0,0 +1,168 @@
+/**
+ * Unit tests for the deferred-format trace log
+ * Mirrors: src/trace.h — trace_detail::Encoder (argument encoding)
+ *          src/trace.cpp — traceWrite() eviction, traceDump() layout
+ * Decoder under test: test-server/decode-trace.js
+ */
+const path = require('path');
+const { formatRecord, decodeTrace } = require(
+  path.join(__dirname, '..', '..', 'test-server', 'decode-trace'));
+
+const TRACE_BUFFER_SIZE = 64;
+const TRACE_RECORD_HEADER = 6;
+const TRACE_RECORD_MAX = 64;
+const TRACE_STR_MAX = 24;
+
+/**
+ * Replicates Encoder::putAll(); args are tagged like the C++ types:
+ * { i32 }, { i64 }, { f32 }, { str }
+ */
+function encodeArgs(args) {
+  const out = [];
+  const room = TRACE_RECORD_MAX - TRACE_RECORD_HEADER;
+  let full = false;
+  const raw = (bytes) => {
+    if (full || out.length + bytes.length > room) {
+      full = true;
+      return;
+    }
+    out.push(...bytes);
+  };
+  for (const a of args) {
+    const b = Buffer.alloc(8);
+    if ('i32' in a) { b.writeInt32LE(a.i32 | 0); raw([...b.subarray(0, 4)]); }
+    else if ('i64' in a) { b.writeBigInt64LE(BigInt(a.i64)); raw([...b]); }
+    else if ('f32' in a) { b.writeFloatLE(a.f32); raw([...b.subarray(0, 4)]); }
+    else if ('str' in a) {
+      const s = Buffer.from(a.str.slice(0, TRACE_STR_MAX), 'latin1');
+      if (full || out.length + 1 + s.length > room) { full = true; continue; }
+      out.push(s.length, ...s);
+    }
+  }
+  return Buffer.from(out);
+}
+
+/** Replicates the ring in trace.cpp (contiguous array standing in for the byte ring) */
+function makeRing() {
+  return { records: [], used: 0, firstSeq: 0, evicted: 0, formats: [] };
+}
+
+function register(ring, fmt) {
+  let id = ring.formats.indexOf(fmt);
+  if (id === -1) {
+    id = ring.formats.length;
+    ring.formats.push(fmt);
+  }
+  return id;
+}
+
+function trace(ring, ms, fmt, ...args) {
+  const id = register(ring, fmt);
+  const payload = encodeArgs(args);
+  const total = TRACE_RECORD_HEADER + payload.length;
+  while (TRACE_BUFFER_SIZE - ring.used < total) {
+    ring.used -= ring.records.shift().length;
+    ring.firstSeq++;
+    ring.evicted++;
+  }
+  const rec = Buffer.alloc(total);
+  rec[0] = total;
+  rec[1] = id;
+  rec.writeUInt32LE(ms, 2);
+  payload.copy(rec, TRACE_RECORD_HEADER);
+  ring.records.push(rec);
+  ring.used += total;
+}
+
+/** Replicates traceDump() */
+function dump(ring, nowMs) {
+  const u32 = (v) => { const b = Buffer.alloc(4); b.writeUInt32LE(v); return b; };
+  const parts = [Buffer.from('TRC1'), u32(nowMs), u32(ring.firstSeq), u32(ring.evicted), Buffer.from([ring.formats.length])];
+  for (const f of ring.formats) parts.push(Buffer.from([f.length]), Buffer.from(f, 'latin1'));
+  parts.push(u32(ring.used), ...ring.records);
+  return Buffer.concat(parts);
+}
+
+describe('formatRecord', () => {
+  [
+    ['Siren blast %d', [{ i32: 3 }], 'Siren blast 3'],
+    ['HC evt "%s" start=%ld trig=%d', [{ str: 'Club Night' }, { i32: 1760000000 }, { i32: 1 }], 'HC evt "Club Night" start=1760000000 trig=1'],
+    ['delta=%lds', [{ i32: -4 }], 'delta=-4s'],
+    ['%lu us', [{ i32: 0xffffffff }], '4294967295 us'],
+    ['heap %5u|%-4d|%04d', [{ i32: 42 }, { i32: 7 }, { i32: -7 }], 'heap    42|7   |-007'],
+    ['0x%08X', [{ i32: 0xbeef }], '0x0000BEEF'],
+    ['late %lld ms', [{ i64: -1234567890123 }], 'late -1234567890123 ms'],
+    ['ppm %.2f', [{ f32: 12.345 }], 'ppm 12.35'],
+    ['100%% %s', [{ str: 'done' }], '100% done'],
+  ].forEach(([fmt, args, expected]) => {
+    test(`${fmt} → ${expected}`, () => {
+      expect(formatRecord(fmt, encodeArgs(args))).toBe(expected);
+    });
+  });
+
+  test('strings are cut at TRACE_STR_MAX', () => {
+    const long = 'x'.repeat(40);
+    expect(formatRecord('%s', encodeArgs([{ str: long }]))).toBe('x'.repeat(TRACE_STR_MAX));
+  });
+
+  test('arguments that did not fit print as "?"', () => {
+    const args = Array.from({ length: 4 }, () => ({ str: 's'.repeat(TRACE_STR_MAX) }));
+    expect(formatRecord('%s %s %s %s', encodeArgs(args))).toBe(
+      `${'s'.repeat(TRACE_STR_MAX)} ${'s'.repeat(TRACE_STR_MAX)} ? ?`);
+  });
+});
+
+describe('ring', () => {
+  test('the oldest whole records are evicted to make room', () => {
+    const ring = makeRing();
+    for (let i = 0; i < 10; i++) trace(ring, i, 'n=%d', { i32: i });
+    // 10-byte records in a 64-byte ring: 6 fit
+    expect(ring.records).toHaveLength(6);
+    expect(ring.firstSeq).toBe(4);
+    expect(ring.used).toBeLessThanOrEqual(TRACE_BUFFER_SIZE);
+  });
+
+  test('each call site registers its format once', () => {
+    const ring = makeRing();
+    trace(ring, 0, 'a %d', { i32: 1 });
+    trace(ring, 1, 'b %d', { i32: 2 });
+    trace(ring, 2, 'a %d', { i32: 3 });
+    expect(ring.formats).toEqual(['a %d', 'b %d']);
+  });
+
+  test('a record is far smaller than a remote log slot', () => {
+    const payload = encodeArgs([{ str: 'Club Night' }, { i32: 1760000000 }, { i32: 1 }]);
+    expect(TRACE_RECORD_HEADER + payload.length).toBeLessThan(104 / 3);
+  });
+});
+
+describe('decodeTrace', () => {
+  test('round-trips a dump with sequence numbers and timestamps', () => {
+    const ring = makeRing();
+    for (let i = 0; i < 8; i++) trace(ring, 1000 + i, 'n=%d', { i32: i });
+    trace(ring, 2000, 'HC evt: "%s"', { str: 'Badminton' });
+
+    const decoded = decodeTrace(dump(ring, 5000));
+    expect(decoded.nowMs).toBe(5000);
+    expect(decoded.evicted).toBe(ring.evicted);
+    const last = decoded.records[decoded.records.length - 1];
+    expect(last).toEqual({ seq: ring.firstSeq + ring.records.length - 1, ms: 2000, text: 'HC evt: "Badminton"' });
+    expect(decoded.records[0].text).toBe(`n=${ring.firstSeq}`);
+  });
+
+  test('an empty ring decodes to no records', () => {
+    expect(decodeTrace(dump(makeRing(), 0)).records).toEqual([]);
+  });
+
+  test('rejects data without the TRC1 header', () => {
+    expect(() => decodeTrace(Buffer.from('<html>not found</html>'))).toThrow('TRC1');
+  });
+
+  test('a truncated download stops at the last whole record', () => {
+    const ring = makeRing();
+    trace(ring, 1, 'a=%d', { i32: 1 });
+    trace(ring, 2, 'b=%d', { i32: 2 });
+    const buf = dump(ring, 3);
+    expect(decodeTrace(buf.subarray(0, buf.length - 3)).records.map((r) => r.text)).toEqual(['a=1']);
+  });
+});
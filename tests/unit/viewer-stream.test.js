@@ -0,0 +1,359 @@
+/**
+ * Unit tests for the read-only viewer stream (GET /events)
+ * Mirrors: src/main.cpp — onEventsConnect(), broadcast(), sendSync(),
+ *          syncJson() and the loop() keepalive
+ *          data/script.js — connectEventStream(), syncEndTime()
+ *
+ * AsyncEventSource adds a client to its list before calling onConnect, so
+ * count() already includes the new stream. Frames use the SSE wire format;
+ * the browser model dispatches them the way EventSource does: only frames
+ * without an event name reach onmessage.
+ */
+
+const MAX_SSE_CLIENTS = 12;
+const SSE_RETRY_MS = 3000;
+const SSE_KEEPALIVE_MS = 30000;
+
+const RUNNING = 'RUNNING';
+const PAUSED = 'PAUSED';
+const IDLE = 'IDLE';
+
+/** AsyncEventSourceClient::send() framing */
+function sseFrame(message, event, id, reconnect) {
+  let frame = '';
+  if (reconnect) frame += `retry: ${reconnect}\n`;
+  if (id) frame += `id: ${id}\n`;
+  if (event) frame += `event: ${event}\n`;
+  frame += `data: ${message}\n\n`;
+  return frame;
+}
+
+class EventSourceClient {
+  constructor() {
+    this.wire = '';
+    this.closed = false;
+  }
+
+  send(message, event = null, id = 0, reconnect = 0) {
+    if (!this.closed) this.wire += sseFrame(message, event, id, reconnect);
+  }
+
+  close() { this.closed = true; }
+}
+
+class EventSourceHandler {
+  constructor() {
+    this.clients = [];
+    this.onConnect = null;
+    this.sends = 0;
+  }
+
+  connect() {
+    const client = new EventSourceClient();
+    this.clients.push(client);
+    this.onConnect(client);
+    if (client.closed) this.clients = this.clients.filter((c) => c !== client);
+    return client;
+  }
+
+  count() { return this.clients.length; }
+
+  send(message, event = null) {
+    this.sends++;
+    for (const c of this.clients) c.send(message, event);
+  }
+}
+
+class WsClient {
+  constructor(id) {
+    this.id = id;
+    this.frames = [];
+  }
+
+  text(json) { this.frames.push(json); }
+}
+
+/** The server side of main.cpp that feeds WebSocket clients and streams */
+class Server {
+  constructor() {
+    this.state = IDLE;
+    this.remaining = 0;
+    this.millis = 0;
+    this.wsClients = [];
+    this.clientClocks = new Map();       // id -> offsetMs, once valid
+    this.events = new EventSourceHandler();
+    this.events.onConnect = (client) => this.onEventsConnect(client);
+    this.lastEventsKeepalive = 0;
+  }
+
+  settingsJson() {
+    return JSON.stringify({ event: 'settings', settings: { gameDuration: 720000, numRounds: 3 } });
+  }
+
+  stateJson() {
+    return JSON.stringify({ event: 'state', state: { status: this.state } });
+  }
+
+  ntpStatusJson() {
+    return JSON.stringify({ event: 'ntp_status', synced: true });
+  }
+
+  syncJson(client) {
+    const doc = { event: 'sync', mainTimerRemaining: this.remaining, serverMillis: this.millis };
+    if (client && this.clientClocks.has(client.id)) {
+      doc.clockOffsetMs = this.clientClocks.get(client.id);
+    }
+    doc.status = this.state === PAUSED ? 'PAUSED' : 'RUNNING';
+    return JSON.stringify(doc);
+  }
+
+  onEventsConnect(client) {
+    if (this.events.count() > MAX_SSE_CLIENTS) {
+      client.close();
+      return;
+    }
+    client.send(this.settingsJson(), null, 0, SSE_RETRY_MS);
+    if (this.state === RUNNING || this.state === PAUSED) {
+      client.send(this.syncJson(null));
+    } else {
+      client.send(this.stateJson());
+    }
+    client.send(this.ntpStatusJson());
+  }
+
+  broadcast(json) {
+    for (const c of this.wsClients) c.text(json);
+    if (this.events.count() > 0) this.events.send(json);
+  }
+
+  sendSync() {
+    for (const c of this.wsClients) c.text(this.syncJson(c));
+    if (this.events.count() > 0) this.events.send(this.syncJson(null));
+  }
+
+  loop(now) {
+    if (now - this.lastEventsKeepalive >= SSE_KEEPALIVE_MS) {
+      this.lastEventsKeepalive = now;
+      if (this.events.count() > 0) this.events.send('{}', 'keepalive');
+    }
+  }
+}
+
+/** EventSource: parse the wire, dispatch 'message' frames to onmessage */
+class BrowserEventSource {
+  constructor(client) {
+    this.client = client;
+    this.read = 0;
+    this.retry = null;
+    this.onmessage = null;
+    this.listeners = {};
+  }
+
+  addEventListener(type, fn) {
+    (this.listeners[type] = this.listeners[type] || []).push(fn);
+  }
+
+  pump() {
+    const blocks = this.client.wire.slice(this.read).split('\n\n');
+    this.read = this.client.wire.length - blocks.pop().length;
+    for (const block of blocks) {
+      let type = 'message';
+      const data = [];
+      for (const line of block.split('\n')) {
+        const colon = line.indexOf(': ');
+        const field = line.slice(0, colon);
+        const value = line.slice(colon + 2);
+        if (field === 'retry') this.retry = Number(value);
+        if (field === 'event') type = value;
+        if (field === 'data') data.push(value);
+      }
+      const event = { type, data: data.join('\n') };
+      if (type === 'message' && this.onmessage) this.onmessage(event);
+      for (const fn of this.listeners[type] || []) fn(event);
+    }
+  }
+}
+
+const SYNC_MAX_CORRECTION_MS = 2000;
+
+/** Replicates syncEndTime() in script.js */
+function syncEndTime(data, now) {
+  const arrival = now + data.mainTimerRemaining;
+  if (data.clockOffsetMs === undefined || data.serverMillis === undefined) return arrival;
+  const end = now + ((data.serverMillis + data.clockOffsetMs + data.mainTimerRemaining - now) | 0);
+  return Math.abs(end - arrival) > SYNC_MAX_CORRECTION_MS ? arrival : end;
+}
+
+/** connectEventStream(): every onmessage frame goes to handleServerMessage */
+function connectViewer(server) {
+  const source = new BrowserEventSource(server.events.connect());
+  const handled = [];
+  source.onmessage = (event) => handled.push(JSON.parse(event.data));
+  source.pump();
+  return { source, handled, client: source.client };
+}
+
+describe('Viewer stream', () => {
+  let server;
+
+  beforeEach(() => {
+    server = new Server();
+  });
+
+  describe('snapshot on connect', () => {
+    test('idle timer: settings, state, NTP status', () => {
+      const { handled, source } = connectViewer(server);
+      expect(handled.map((m) => m.event)).toEqual(['settings', 'state', 'ntp_status']);
+      expect(handled[1].state.status).toBe(IDLE);
+      expect(source.retry).toBe(SSE_RETRY_MS);
+    });
+
+    for (const state of [RUNNING, PAUSED]) {
+      test(`${state} timer: settings, sync, NTP status`, () => {
+        server.state = state;
+        server.remaining = 90000;
+        const { handled } = connectViewer(server);
+        expect(handled.map((m) => m.event)).toEqual(['settings', 'sync', 'ntp_status']);
+        expect(handled[1].status).toBe(state);
+        expect(handled[1].mainTimerRemaining).toBe(90000);
+      });
+    }
+
+    test('only the first frame carries the reconnect delay', () => {
+      const { client } = connectViewer(server);
+      expect(client.wire.match(/^retry: /gm)).toHaveLength(1);
+      expect(client.wire.startsWith(`retry: ${SSE_RETRY_MS}\n`)).toBe(true);
+    });
+
+    test('a second viewer gets its own snapshot; the first gets nothing new', () => {
+      const first = connectViewer(server);
+      connectViewer(server);
+      first.source.pump();
+      expect(first.handled).toHaveLength(3);
+    });
+  });
+
+  describe('client limit', () => {
+    test(`${MAX_SSE_CLIENTS} streams are accepted`, () => {
+      for (let i = 0; i < MAX_SSE_CLIENTS; i++) {
+        expect(connectViewer(server).client.closed).toBe(false);
+      }
+      expect(server.events.count()).toBe(MAX_SSE_CLIENTS);
+    });
+
+    test('the next one is closed without a snapshot', () => {
+      for (let i = 0; i < MAX_SSE_CLIENTS; i++) connectViewer(server);
+      const extra = connectViewer(server);
+      expect(extra.client.closed).toBe(true);
+      expect(extra.client.wire).toBe('');
+      expect(extra.handled).toEqual([]);
+      expect(server.events.count()).toBe(MAX_SSE_CLIENTS);
+    });
+
+    test('a slot freed by a disconnect is reusable', () => {
+      for (let i = 0; i < MAX_SSE_CLIENTS; i++) connectViewer(server);
+      server.events.clients.shift();
+      expect(connectViewer(server).client.closed).toBe(false);
+    });
+  });
+
+  describe('sync frames', () => {
+    beforeEach(() => {
+      server.state = RUNNING;
+      server.remaining = 60000;
+      server.millis = 500000;
+    });
+
+    test('streams get a frame without clockOffsetMs; WebSocket clients keep theirs', () => {
+      const ws = new WsClient(1);
+      server.wsClients.push(ws);
+      server.clientClocks.set(1, 1234);
+      const viewer = connectViewer(server);
+      viewer.handled.length = 0;
+
+      server.sendSync();
+      viewer.source.pump();
+
+      expect(JSON.parse(ws.frames[0]).clockOffsetMs).toBe(1234);
+      expect(viewer.handled).toHaveLength(1);
+      expect(viewer.handled[0].event).toBe('sync');
+      expect(viewer.handled[0].clockOffsetMs).toBeUndefined();
+    });
+
+    test('one frame is shared by every stream', () => {
+      const a = connectViewer(server);
+      const b = connectViewer(server);
+      const before = [a.client.wire.length, b.client.wire.length];
+      server.sendSync();
+      expect(a.client.wire.slice(before[0])).toBe(b.client.wire.slice(before[1]));
+    });
+
+    test('the viewer counts the round end from arrival', () => {
+      const viewer = connectViewer(server);
+      const sync = viewer.handled[1];
+      const now = 1700000000000;
+      expect(syncEndTime(sync, now)).toBe(now + 60000);
+    });
+
+    test('no stream, no sync frame for streams', () => {
+      server.sendSync();
+      expect(server.events.sends).toBe(0);
+    });
+  });
+
+  describe('broadcasts', () => {
+    test('reach WebSocket clients and streams alike', () => {
+      const ws = new WsClient(1);
+      server.wsClients.push(ws);
+      const viewer = connectViewer(server);
+      viewer.handled.length = 0;
+
+      server.broadcast(JSON.stringify({ event: 'round_end' }));
+      viewer.source.pump();
+
+      expect(JSON.parse(ws.frames[0]).event).toBe('round_end');
+      expect(viewer.handled.map((m) => m.event)).toEqual(['round_end']);
+    });
+  });
+
+  describe('keepalive', () => {
+    test('is sent every SSE_KEEPALIVE_MS while a stream is open', () => {
+      const { client } = connectViewer(server);
+      server.loop(SSE_KEEPALIVE_MS - 1);
+      expect(client.wire).not.toContain('event: keepalive');
+      server.loop(SSE_KEEPALIVE_MS);
+      server.loop(SSE_KEEPALIVE_MS + 1);
+      expect(client.wire.match(/event: keepalive/g)).toHaveLength(1);
+    });
+
+    test('is not sent with no stream open', () => {
+      server.loop(SSE_KEEPALIVE_MS);
+      expect(server.events.sends).toBe(0);
+    });
+
+    test('never reaches onmessage', () => {
+      const viewer = connectViewer(server);
+      viewer.handled.length = 0;
+      const keepalives = [];
+      viewer.source.addEventListener('keepalive', (e) => keepalives.push(e));
+
+      for (let t = 1; t <= 4; t++) server.loop(t * SSE_KEEPALIVE_MS);
+      viewer.source.pump();
+
+      expect(keepalives).toHaveLength(4);
+      expect(viewer.handled).toEqual([]);
+    });
+
+    test('interleaved with broadcasts, only the broadcasts are handled', () => {
+      const viewer = connectViewer(server);
+      viewer.handled.length = 0;
+
+      server.loop(SSE_KEEPALIVE_MS);
+      server.broadcast(JSON.stringify({ event: 'siren' }));
+      server.loop(2 * SSE_KEEPALIVE_MS);
+      viewer.source.pump();
+
+      expect(viewer.handled.map((m) => m.event)).toEqual(['siren']);
+    });
+  });
+});
@@ -0,0 +1,367 @@
+/**
+ * Unit tests for Hello Club webhook pushes
+ * Mirrors: src/helloclub.cpp — parseEventChange(), verifySignature()
+ *          src/hcevents.cpp — hcApplyChange() (via applyEventChange())
+ *          src/main.cpp — checkHelloClubPush() / replayHelloClubPushes(),
+ *          the replay-window check in handleHelloClubWebhook()
+ *
+ * A push touches one occurrence (matched by id and start time: occurrences
+ * of a recurring event share an id), keeps the triggered flag only when the
+ * start time didn't move, and is replayed over the result of a fetch that
+ * was in flight when it arrived. tests/native/event-change.cpp runs the
+ * same cases against the C++ code.
+ */
+const crypto = require('crypto');
+
+const MAX_CACHED_EVENTS = 50;
+const HELLOCLUB_WEBHOOK_MAX_SKEW_SEC = 300;
+
+// Simplified stand-in for parseTimerTag(): only "has a tag or not" matters here
+function parseTimerTag(desc) {
+  const m = /timer:\s*(\d+)/i.exec(desc || '');
+  return m ? { duration: parseInt(m[1], 10) } : null;
+}
+
+/**
+ * Replicates parseEventChange(): returns { op, evt } or { error }
+ */
+function parseEventChange(body) {
+  let doc;
+  try {
+    doc = JSON.parse(body);
+  } catch (e) {
+    return { error: 'Invalid JSON' };
+  }
+  const type = doc.type || '';
+  const obj = doc.event || {};
+  const id = (obj.id || doc.id || '').substring(0, 12);
+  const startTime = Math.floor(Date.parse(obj.startDate || doc.startDate || '') / 1000);
+
+  if (type === 'ping') return { op: 'ping' };
+  if (!id) return { error: 'Missing event id' };
+  // A delete names one occurrence: id and start time
+  const deletion = () => (startTime > 0 ? { op: 'delete', evt: { id, startTime } } : { error: 'Bad startDate' });
+  if (type === 'event.deleted') return deletion();
+  if (type !== 'event.created' && type !== 'event.updated') return { error: 'Unknown type' };
+
+  const tag = parseTimerTag(obj.description);
+  if (!tag) return deletion(); // tag removed
+  if (!(startTime > 0)) return { error: 'Bad startDate' };
+  return {
+    op: 'upsert',
+    evt: { id, name: obj.name || 'Unnamed', startTime, durationMin: tag.duration, triggered: false },
+  };
+}
+
+/**
+ * Replicates hcApplyChange() + re-sort: mutates the sorted cache, returns
+ * true if it changed
+ */
+function applyEventChange(events, change) {
+  if (change.op === 'ping') return false;
+
+  // The occurrence with the same id and start; for an upsert, else the
+  // event's only occurrence (its start moved)
+  const sameId = events.filter((e) => e.id === change.evt.id);
+  let match = sameId.find((e) => e.startTime === change.evt.startTime);
+  if (!match && change.op === 'upsert' && sameId.length === 1) match = sameId[0];
+
+  const wasTriggered = !!match && match.triggered && match.startTime === change.evt.startTime;
+  const kept = events.filter((e) => e !== match);
+  let changed = kept.length !== events.length;
+
+  if (change.op === 'upsert') {
+    if (kept.length >= MAX_CACHED_EVENTS) {
+      if (change.evt.startTime >= kept[kept.length - 1].startTime) {
+        events.splice(0, events.length, ...kept);
+        return changed;
+      }
+      kept.pop();
+    }
+    kept.push({ ...change.evt, triggered: wasTriggered });
+    changed = true;
+  }
+
+  kept.sort((a, b) => a.startTime - b.startTime);
+  events.splice(0, events.length, ...kept);
+  return changed;
+}
+
+/**
+ * Replicates verifySignature(): hex HMAC-SHA256 of "<ts>.<body>", optional
+ * "sha256=" prefix, case-insensitive, constant-time compare
+ */
+function verifySignature(secret, timestamp, body, signatureHex) {
+  if (!secret || !timestamp || !signatureHex) return false;
+  if (signatureHex.startsWith('sha256=')) signatureHex = signatureHex.slice(7);
+  if (signatureHex.length !== 64) return false;
+
+  const mac = crypto.createHmac('sha256', secret).update(`${timestamp}.`).update(body).digest('hex');
+  let diff = 0;
+  for (let i = 0; i < 64; i++) {
+    diff |= signatureHex.toLowerCase().charCodeAt(i) ^ mac.charCodeAt(i);
+  }
+  return diff === 0;
+}
+
+function makeEvent(overrides = {}) {
+  return {
+    id: 'evt001',
+    name: 'Badminton',
+    startTime: 1000000,
+    durationMin: 20,
+    triggered: false,
+    ...overrides,
+  };
+}
+
+function body(type, event) {
+  return JSON.stringify({ type, event });
+}
+
+function deleteBody(id, startTime = 1000000) {
+  return body('event.deleted', { id, startDate: new Date(startTime * 1000).toISOString() });
+}
+
+function upsertBody(id, startTime, description = 'timer: 15') {
+  return body('event.updated', {
+    id,
+    name: 'Pushed',
+    description,
+    startDate: new Date(startTime * 1000).toISOString(),
+  });
+}
+
+describe('parseEventChange', () => {
+  test('ping', () => {
+    expect(parseEventChange('{"type":"ping"}').op).toBe('ping');
+  });
+
+  test('created/updated with a timer tag is an upsert', () => {
+    const change = parseEventChange(upsertBody('abc', 1000000));
+    expect(change.op).toBe('upsert');
+    expect(change.evt.startTime).toBe(1000000);
+    expect(change.evt.durationMin).toBe(15);
+  });
+
+  test('updated without a timer tag becomes a delete', () => {
+    const change = parseEventChange(upsertBody('abc', 1000000, 'Social night'));
+    expect(change.op).toBe('delete');
+    expect(change.evt).toEqual({ id: 'abc', startTime: 1000000 });
+  });
+
+  test('deleted needs the id and start of the occurrence', () => {
+    expect(parseEventChange(deleteBody('abc'))).toEqual({ op: 'delete', evt: { id: 'abc', startTime: 1000000 } });
+  });
+
+  test('top-level id and startDate are accepted when the event object is absent', () => {
+    const change = parseEventChange('{"type":"event.deleted","id":"xyz","startDate":"1970-01-12T13:46:40Z"}');
+    expect(change.evt).toEqual({ id: 'xyz', startTime: 1000000 });
+  });
+
+  test('ids are truncated to the cached 12 characters', () => {
+    expect(parseEventChange(deleteBody('0123456789abcdef')).evt.id).toBe('0123456789ab');
+  });
+
+  [
+    ['not json', 'Invalid JSON'],
+    ['{"type":"event.updated","event":{}}', 'Missing event id'],
+    ['{"type":"member.updated","event":{"id":"a"}}', 'Unknown type'],
+    [body('event.created', { id: 'a', description: 'timer: 12', startDate: 'soon' }), 'Bad startDate'],
+    [body('event.deleted', { id: 'a' }), 'Bad startDate'],
+    [body('event.updated', { id: 'a', description: 'no tag' }), 'Bad startDate'],
+  ].forEach(([input, error]) => {
+    test(`rejects with "${error}"`, () => {
+      expect(parseEventChange(input).error).toBe(error);
+    });
+  });
+});
+
+describe('applyEventChange', () => {
+  test('upsert adds a new event in start order', () => {
+    const events = [makeEvent({ id: 'a', startTime: 100 }), makeEvent({ id: 'c', startTime: 300 })];
+    expect(applyEventChange(events, parseEventChange(upsertBody('b', 200)))).toBe(true);
+    expect(events.map((e) => e.id)).toEqual(['a', 'b', 'c']);
+  });
+
+  test('upsert moving the start replaces the old copy and clears triggered', () => {
+    const events = [makeEvent({ id: 'a', startTime: 100, triggered: true })];
+    applyEventChange(events, parseEventChange(upsertBody('a', 500)));
+    expect(events).toHaveLength(1);
+    expect(events[0].startTime).toBe(500);
+    expect(events[0].triggered).toBe(false);
+  });
+
+  test('upsert at the same start keeps triggered (no double auto-start)', () => {
+    const events = [makeEvent({ id: 'a', startTime: 100, triggered: true })];
+    applyEventChange(events, parseEventChange(upsertBody('a', 100)));
+    expect(events[0].triggered).toBe(true);
+    expect(events[0].name).toBe('Pushed');
+  });
+
+  describe('recurring events: occurrences share an id', () => {
+    const WEEK = 7 * 86400;
+    function weekly() {
+      return [
+        makeEvent({ id: 'a', startTime: 100, triggered: true }),
+        makeEvent({ id: 'b', startTime: 150 }),
+        makeEvent({ id: 'a', startTime: 100 + WEEK }),
+      ];
+    }
+    const keys = (events) => events.map((e) => `${e.id}@${e.startTime}`);
+
+    test('delete removes only the named occurrence', () => {
+      const events = weekly();
+      expect(applyEventChange(events, parseEventChange(deleteBody('a', 100 + WEEK)))).toBe(true);
+      expect(keys(events)).toEqual(['a@100', 'b@150']);
+      expect(events[0].triggered).toBe(true);
+    });
+
+    test('update of one occurrence leaves the other alone', () => {
+      const events = weekly();
+      applyEventChange(events, parseEventChange(upsertBody('a', 100)));
+      expect(keys(events)).toEqual(['a@100', 'b@150', `a@${100 + WEEK}`]);
+      expect(events[0]).toMatchObject({ name: 'Pushed', triggered: true });
+      expect(events[2].name).toBe('Badminton');
+    });
+
+    test('a new occurrence is added alongside the others', () => {
+      const events = weekly();
+      applyEventChange(events, parseEventChange(upsertBody('a', 100 + 2 * WEEK)));
+      expect(keys(events)).toEqual(['a@100', 'b@150', `a@${100 + WEEK}`, `a@${100 + 2 * WEEK}`]);
+    });
+  });
+
+  test('delete removes the event', () => {
+    const events = [makeEvent({ id: 'a' }), makeEvent({ id: 'b', startTime: 2000000 })];
+    expect(applyEventChange(events, parseEventChange(deleteBody('a')))).toBe(true);
+    expect(events.map((e) => e.id)).toEqual(['b']);
+  });
+
+  test('delete of an unknown id or start changes nothing', () => {
+    const events = [makeEvent({ id: 'a' })];
+    expect(applyEventChange(events, parseEventChange(deleteBody('zzz')))).toBe(false);
+    expect(applyEventChange(events, parseEventChange(deleteBody('a', 2000000)))).toBe(false);
+    expect(events).toHaveLength(1);
+  });
+
+  test('ping never touches the cache', () => {
+    const events = [makeEvent()];
+    expect(applyEventChange(events, { op: 'ping' })).toBe(false);
+  });
+
+  describe('full cache keeps the earliest events', () => {
+    function fullCache() {
+      return Array.from({ length: MAX_CACHED_EVENTS }, (_, i) => makeEvent({ id: `e${i}`, startTime: 1000 + i }));
+    }
+
+    test('a later event is dropped', () => {
+      const events = fullCache();
+      expect(applyEventChange(events, parseEventChange(upsertBody('late', 99999)))).toBe(false);
+      expect(events.some((e) => e.id === 'late')).toBe(false);
+    });
+
+    test('an earlier event evicts the last one', () => {
+      const events = fullCache();
+      expect(applyEventChange(events, parseEventChange(upsertBody('early', 10)))).toBe(true);
+      expect(events).toHaveLength(MAX_CACHED_EVENTS);
+      expect(events[0].id).toBe('early');
+      expect(events.some((e) => e.id === `e${MAX_CACHED_EVENTS - 1}`)).toBe(false);
+    });
+
+    test('updating an event already in a full cache does not evict', () => {
+      const events = fullCache();
+      applyEventChange(events, parseEventChange(upsertBody('e10', 1010)));
+      expect(events).toHaveLength(MAX_CACHED_EVENTS);
+      expect(events.some((e) => e.id === `e${MAX_CACHED_EVENTS - 1}`)).toBe(true);
+    });
+  });
+});
+
+describe('push replay over an in-flight fetch', () => {
+  test('a fetch that read the API before the push does not undo it', () => {
+    const live = [makeEvent({ id: 'a', startTime: 100 })];
+    const replay = [];
+    const fetchPending = true;
+
+    // Push arrives while the fetch is running: applied now and recorded
+    const change = parseEventChange(upsertBody('a', 400));
+    applyEventChange(live, change);
+    if (fetchPending) replay.push(change);
+
+    // The fetch result (stale: still at 100) replaces the cache...
+    const staged = [makeEvent({ id: 'a', startTime: 100 })];
+    live.splice(0, live.length, ...staged);
+    // ...then the pushes are replayed on top
+    replay.forEach((c) => applyEventChange(live, c));
+
+    expect(live).toHaveLength(1);
+    expect(live[0].startTime).toBe(400);
+  });
+
+  test('a replayed delete removes an event the stale fetch brought back', () => {
+    const live = [];
+    const replay = [parseEventChange(deleteBody('gone'))];
+    live.push(makeEvent({ id: 'gone' }), makeEvent({ id: 'kept', startTime: 2000000 }));
+    replay.forEach((c) => applyEventChange(live, c));
+    expect(live.map((e) => e.id)).toEqual(['kept']);
+  });
+});
+
+/**
+ * Replicates the replay-window check in handleHelloClubWebhook(): the HTTP
+ * status it answers with, or null to go on to the signature check
+ */
+function checkTimestamp(clockValid, now, timestamp) {
+  if (!clockValid) return 503;
+  const skew = now - timestamp;
+  if (skew > HELLOCLUB_WEBHOOK_MAX_SKEW_SEC || skew < -HELLOCLUB_WEBHOOK_MAX_SKEW_SEC) return 401;
+  return null;
+}
+
+describe('replay window', () => {
+  const now = 1760000000;
+
+  test('a timestamp within the window passes', () => {
+    expect(checkTimestamp(true, now, now)).toBeNull();
+    expect(checkTimestamp(true, now, now - HELLOCLUB_WEBHOOK_MAX_SKEW_SEC)).toBeNull();
+    expect(checkTimestamp(true, now, now + HELLOCLUB_WEBHOOK_MAX_SKEW_SEC)).toBeNull();
+  });
+
+  test('a stale or future timestamp is rejected', () => {
+    expect(checkTimestamp(true, now, now - HELLOCLUB_WEBHOOK_MAX_SKEW_SEC - 1)).toBe(401);
+    expect(checkTimestamp(true, now, now + HELLOCLUB_WEBHOOK_MAX_SKEW_SEC + 1)).toBe(401);
+  });
+
+  test('before NTP sets the clock every push is refused for retry, even a replay', () => {
+    expect(checkTimestamp(false, 5, now)).toBe(503);
+    expect(checkTimestamp(false, 5, 5)).toBe(503);
+  });
+});
+
+describe('verifySignature', () => {
+  const secret = 's3cret';
+  const ts = '1760000000';
+  const payload = '{"type":"ping"}';
+  const good = crypto.createHmac('sha256', secret).update(`${ts}.${payload}`).digest('hex');
+
+  test('accepts a valid signature', () => {
+    expect(verifySignature(secret, ts, payload, good)).toBe(true);
+  });
+
+  test('accepts the sha256= prefix and upper-case hex', () => {
+    expect(verifySignature(secret, ts, payload, `sha256=${good}`)).toBe(true);
+    expect(verifySignature(secret, ts, payload, good.toUpperCase())).toBe(true);
+  });
+
+  test('rejects a different secret, timestamp or body', () => {
+    expect(verifySignature('other', ts, payload, good)).toBe(false);
+    expect(verifySignature(secret, '1760000001', payload, good)).toBe(false);
+    expect(verifySignature(secret, ts, '{"type":"pong"}', good)).toBe(false);
+  });
+
+  test('rejects a truncated signature or missing secret', () => {
+    expect(verifySignature(secret, ts, payload, good.slice(0, 63))).toBe(false);
+    expect(verifySignature('', ts, payload, good)).toBe(false);
+  });
+});
@@ -0,0 +1,371 @@
+/**
+ * Unit tests for the background WiFi join and captive portal
+ * Mirrors: src/wifijoin.cpp — wifiJoinBegin()/wifiJoinLoop() state machine,
+ *          collectScan() candidate order, cacheValid()
+ *          src/portal.cpp — portalLoop() open/close, the /setup list
+ *
+ * The last network joined is cached (RTC memory, then NVS). The join tries
+ * it directly and only scans when that fails; the scan decides which known
+ * networks are in range and which AP/channel to use for each. Nothing
+ * blocks: each loop() pass advances at most one step. The portal page is
+ * served from another task, so it shows a list portalLoop() rendered from
+ * the last scan, never the scan results themselves.
+ */
+
+const DIRECT_TIMEOUT = 4000;
+const CONNECT_TIMEOUT = 10000;
+const RETRY_INTERVAL = 300000;
+const PORTAL_CLOSE_DELAY = 30000;
+
+function cacheValid(c) {
+  return !!c && c.magic === 'WIFJ' && c.ssid !== '' && c.channel > 0 && c.crcOk;
+}
+
+/** Replicates collectScan(): candidate list and attempt order */
+function scanAttempts(known, cached, scan) {
+  const candidates = known.map(k => ({ ...k, rssi: -127, channel: 0, bssid: null, seen: false }));
+  if (cached && !known.some(k => k.ssid === cached.ssid)) {
+    candidates.push({ ssid: cached.ssid, password: cached.password, rssi: -127, channel: 0, bssid: null, seen: false });
+  }
+  for (const ap of scan) {
+    for (const c of candidates) {
+      if (ap.ssid === c.ssid && ap.rssi > c.rssi) {
+        Object.assign(c, { rssi: ap.rssi, channel: ap.channel, bssid: ap.bssid, seen: true });
+      }
+    }
+  }
+  return [
+    ...candidates.filter(c => c.seen),
+    ...candidates.filter(c => !c.seen).map(c => ({ ...c, channel: 0, bssid: null })),
+  ];
+}
+
+/**
+ * Simulated radio: canJoin(attempt) decides whether a WiFi.begin() with
+ * { ssid, channel, bssid } connects (after joinMs); a failing one times out.
+ * The station keeps trying until disconnect(), and a scan started while it
+ * is still trying fails (WIFI_SCAN_FAILED: no networks).
+ */
+class Radio {
+  constructor({ scan = [], canJoin = () => false, joinMs = 800, scanMs = 2000 }) {
+    Object.assign(this, { scanResults: scan, canJoin, joinMs, scanMs });
+    this.now = 0;
+    this.attempt = null;
+    this.scanStarted = null;
+    this.scanFailed = false;
+    this.autoReconnect = true;
+    this.attempts = [];
+  }
+  begin(a) { this.attempt = { ...a, at: this.now }; this.attempts.push(a); }
+  disconnect() { this.attempt = null; }
+  setAutoReconnect(on) { this.autoReconnect = on; }
+  status() {
+    if (this.attempt && this.canJoin(this.attempt) && this.now - this.attempt.at >= this.joinMs) return 'CONNECTED';
+    return 'DISCONNECTED';
+  }
+  startScan() { this.scanStarted = this.now; this.scanFailed = this.attempt !== null; }
+  scanComplete() {
+    if (this.now - this.scanStarted < this.scanMs) return null;
+    return this.scanFailed ? [] : this.scanResults;
+  }
+}
+
+/** Replicates the wifijoin state machine */
+class WifiJoin {
+  constructor(radio, known, { rtc = null, nvs = null } = {}) {
+    Object.assign(this, { radio, known });
+    this.cache = cacheValid(rtc) ? rtc : cacheValid(nvs) ? nvs : null;
+    this.source = cacheValid(rtc) ? 'rtc' : cacheValid(nvs) ? 'nvs' : null;
+    this.path = 'failed';
+    this.retries = 0;
+    this.scanResults = [];
+    this.scanCount = 0;
+    this.startCycle();
+  }
+  startCycle() {
+    this.radio.setAutoReconnect(false);
+    if (this.cache) {
+      this.state = 'DIRECT';
+      this.start({ ssid: this.cache.ssid, channel: this.cache.channel, bssid: this.cache.bssid }, DIRECT_TIMEOUT);
+    } else {
+      this.startScan();
+    }
+  }
+  startScan() {
+    this.state = 'SCANNING';
+    this.radio.disconnect();
+    this.radio.startScan();
+  }
+  start(a, timeout) { this.current = a; this.deadline = this.radio.now + timeout; this.radio.begin(a); }
+  poll() {
+    if (this.radio.status() === 'CONNECTED') return 1;
+    return this.radio.now >= this.deadline ? -1 : 0;
+  }
+  connected(path) {
+    this.radio.setAutoReconnect(true);
+    this.state = 'CONNECTED';
+    this.path = path;
+    this.cache = { magic: 'WIFJ', ssid: this.current.ssid, channel: this.current.channel || 1, bssid: this.current.bssid, crcOk: true };
+  }
+  next() {
+    if (this.candidates.length === 0) {
+      this.state = 'FAILED';
+      this.failedAt = this.radio.now;
+      this.submitted = false;
+      return;
+    }
+    const c = this.candidates.shift();
+    this.start({ ssid: c.ssid, channel: c.channel, bssid: c.bssid }, CONNECT_TIMEOUT);
+  }
+  loop() {
+    switch (this.state) {
+      case 'DIRECT': {
+        const r = this.poll();
+        if (r > 0) this.connected(this.source);
+        else if (r < 0) this.startScan();
+        break;
+      }
+      case 'SCANNING': {
+        const scan = this.radio.scanComplete();
+        if (!scan) break;
+        this.candidates = scanAttempts(this.known, this.cache, scan);
+        this.scanResults = scan.filter(ap => ap.ssid).sort((a, b) => b.rssi - a.rssi).map(ap => ap.ssid);
+        this.scanCount++;
+        this.state = 'TRYING';
+        this.next();
+        break;
+      }
+      case 'TRYING': {
+        const r = this.poll();
+        if (r > 0) { this.connected(this.submitted ? 'portal' : 'scan'); this.submitted = false; }
+        else if (r < 0) { if (this.submitted) this.candidates = []; this.next(); }
+        break;
+      }
+      case 'FAILED':
+        if (this.radio.now - this.failedAt >= RETRY_INTERVAL) { this.retries++; this.startCycle(); }
+        break;
+      default:
+        break;
+    }
+  }
+  submit(ssid) {
+    this.radio.setAutoReconnect(false);
+    this.submitted = true;
+    this.candidates = [];
+    this.state = 'TRYING';
+    this.start({ ssid, channel: 0, bssid: null }, CONNECT_TIMEOUT);
+  }
+  isConnected() { return this.state === 'CONNECTED' && this.radio.status() === 'CONNECTED'; }
+}
+
+/** Replicates portalLoop() and handleSetup() */
+class Portal {
+  constructor(join) {
+    this.join = join; this.active = false; this.closeAt = 0; this.opened = 0;
+    this.netList = []; this.netListScan = 0;
+  }
+  renderNetList() { this.netList = [...this.join.scanResults]; this.netListScan = this.join.scanCount; }
+  setupPage() { return [...this.netList]; }
+  loop(now) {
+    if (!this.active) {
+      if (this.join.state === 'FAILED') { this.renderNetList(); this.active = true; this.closeAt = 0; this.opened++; }
+      return;
+    }
+    if (this.join.scanCount !== this.netListScan) this.renderNetList();
+    if (!this.join.isConnected()) this.closeAt = 0;
+    else if (this.closeAt === 0) this.closeAt = now + PORTAL_CLOSE_DELAY;
+    else if (now >= this.closeAt) this.active = false;
+  }
+}
+
+/** Main loop passes every stepMs until until(now) or maxMs */
+function run(radio, join, { portal = null, stepMs = 20, maxMs = 600000, until = () => false } = {}) {
+  for (; radio.now <= maxMs; radio.now += stepMs) {
+    join.loop();
+    if (portal) portal.loop(radio.now);
+    if (until()) return radio.now;
+  }
+  return null;
+}
+
+const KNOWN = [
+  { ssid: 'Club', password: 'pw1' },
+  { ssid: 'Home', password: 'pw2' },
+  { ssid: 'Hidden', password: 'pw3' },
+];
+const CLUB_CACHE = { magic: 'WIFJ', ssid: 'Club', password: 'pw1', bssid: 'aa', channel: 6, crcOk: true };
+
+describe('WiFi join: cached direct join', () => {
+  test('valid RTC cache joins directly, no scan, well under two seconds', () => {
+    const radio = new Radio({ canJoin: () => true });
+    const join = new WifiJoin(radio, KNOWN, { rtc: CLUB_CACHE });
+    const t = run(radio, join, { until: () => join.state === 'CONNECTED' });
+    expect(join.path).toBe('rtc');
+    expect(radio.scanStarted).toBeNull();
+    expect(radio.attempts).toEqual([{ ssid: 'Club', channel: 6, bssid: 'aa' }]);
+    expect(t).toBeLessThan(2000);
+  });
+
+  test('RTC garbage after power loss falls back to the NVS copy', () => {
+    const radio = new Radio({ canJoin: () => true });
+    const join = new WifiJoin(radio, KNOWN, { rtc: { ...CLUB_CACHE, crcOk: false }, nvs: CLUB_CACHE });
+    run(radio, join, { until: () => join.state === 'CONNECTED' });
+    expect(join.path).toBe('nvs');
+  });
+
+  test('no cache goes straight to the scan', () => {
+    const radio = new Radio({ scan: [{ ssid: 'Club', rssi: -50, channel: 11, bssid: 'bb' }], canJoin: () => true });
+    const join = new WifiJoin(radio, KNOWN);
+    expect(join.state).toBe('SCANNING');
+    run(radio, join, { until: () => join.state === 'CONNECTED' });
+    expect(join.path).toBe('scan');
+    expect(radio.attempts).toHaveLength(1);
+  });
+
+  test('cache entry without a channel or SSID is rejected', () => {
+    expect(cacheValid({ ...CLUB_CACHE, channel: 0 })).toBe(false);
+    expect(cacheValid({ ...CLUB_CACHE, ssid: '' })).toBe(false);
+  });
+});
+
+describe('WiFi join: scan fallback', () => {
+  test('AP moved channel: direct join times out, scan finds it on the new channel', () => {
+    const radio = new Radio({ scan: [{ ssid: 'Club', rssi: -60, channel: 1, bssid: 'aa' }], canJoin: a => a.channel === 1 });
+    const join = new WifiJoin(radio, KNOWN, { rtc: CLUB_CACHE });
+    run(radio, join, { until: () => join.state === 'CONNECTED' });
+    expect(join.path).toBe('scan');
+    expect(radio.attempts.map(a => a.channel)).toEqual([6, 1]);
+  });
+
+  test('AP gone from the cached channel: the scan still sees the networks and the portal lists them', () => {
+    const radio = new Radio({ scan: [{ ssid: 'Cafe', rssi: -70, channel: 3, bssid: 'cc' }], canJoin: () => false });
+    const join = new WifiJoin(radio, KNOWN, { rtc: CLUB_CACHE });
+    const portal = new Portal(join);
+    run(radio, join, { until: () => join.state === 'SCANNING' });
+    expect(radio.attempt).toBeNull();               // Stopped before the scan
+    expect(radio.autoReconnect).toBe(false);
+    run(radio, join, { portal, until: () => portal.active });
+    expect(radio.scanFailed).toBe(false);
+    expect(portal.setupPage()).toEqual(['Cafe']);
+  });
+
+  test('auto-reconnect is off while joining and on once connected', () => {
+    const radio = new Radio({ scan: [{ ssid: 'Club', rssi: -60, channel: 1, bssid: 'aa' }], canJoin: a => a.channel === 1 });
+    const join = new WifiJoin(radio, KNOWN, { rtc: CLUB_CACHE });
+    expect(radio.autoReconnect).toBe(false);
+    run(radio, join, { until: () => join.state === 'CONNECTED' });
+    expect(radio.autoReconnect).toBe(true);
+  });
+
+  test('joins the strongest AP for a network', () => {
+    const attempts = scanAttempts(KNOWN, null, [
+      { ssid: 'Club', rssi: -80, channel: 1, bssid: 'weak' },
+      { ssid: 'Club', rssi: -45, channel: 11, bssid: 'strong' },
+    ]);
+    expect(attempts[0]).toMatchObject({ ssid: 'Club', bssid: 'strong', channel: 11 });
+  });
+
+  test('networks in range keep config order; unseen (hidden) ones go last, unpinned', () => {
+    const attempts = scanAttempts(KNOWN, null, [
+      { ssid: 'Home', rssi: -40, channel: 3, bssid: 'h' },
+      { ssid: 'Club', rssi: -70, channel: 6, bssid: 'c' },
+      { ssid: 'Neighbour', rssi: -30, channel: 1, bssid: 'n' },
+    ]);
+    expect(attempts.map(a => a.ssid)).toEqual(['Club', 'Home', 'Hidden']);
+    expect(attempts[2]).toMatchObject({ channel: 0, bssid: null });
+  });
+
+  test('network joined through the portal is a candidate when not in the credentials list', () => {
+    const portal = { magic: 'WIFJ', ssid: 'Venue', password: 'x', bssid: 'v', channel: 9, crcOk: true };
+    const attempts = scanAttempts(KNOWN, portal, [{ ssid: 'Venue', rssi: -55, channel: 9, bssid: 'v' }]);
+    expect(attempts[0]).toMatchObject({ ssid: 'Venue', password: 'x' });
+  });
+
+  test('cached known network is not tried twice in the scan pass', () => {
+    const attempts = scanAttempts(KNOWN, CLUB_CACHE, []);
+    expect(attempts.filter(a => a.ssid === 'Club')).toHaveLength(1);
+  });
+});
+
+describe('WiFi join: router outage', () => {
+  test('every step returns at once: the main loop keeps running during the join', () => {
+    const radio = new Radio({ canJoin: () => false });
+    const join = new WifiJoin(radio, KNOWN, { rtc: CLUB_CACHE });
+    let passes = 0;
+    run(radio, join, { maxMs: 60000, until: () => { passes++; return false; } });
+    expect(passes).toBe(60000 / 20 + 1);
+  });
+
+  test('nothing joinable ends in FAILED after trying every candidate', () => {
+    const radio = new Radio({ canJoin: () => false });
+    const join = new WifiJoin(radio, KNOWN, { rtc: CLUB_CACHE });
+    run(radio, join, { until: () => join.state === 'FAILED' });
+    expect(join.path).toBe('failed');
+    expect(radio.attempts).toHaveLength(1 + KNOWN.length);
+  });
+
+  test('retries the whole cycle after the retry interval and joins once the router is back', () => {
+    let routerUp = false;
+    const radio = new Radio({ canJoin: () => routerUp });
+    const join = new WifiJoin(radio, KNOWN, { rtc: CLUB_CACHE });
+    run(radio, join, { until: () => join.state === 'FAILED' });
+    const failedAt = radio.now;
+    routerUp = true;
+    run(radio, join, { maxMs: failedAt + RETRY_INTERVAL + 5000, until: () => join.state === 'CONNECTED' });
+    expect(join.retries).toBe(1);
+    expect(join.path).toBe('rtc');
+    expect(radio.now - failedAt).toBeGreaterThanOrEqual(RETRY_INTERVAL);
+  });
+});
+
+describe('Captive portal', () => {
+  test('opens only once the join has failed', () => {
+    const radio = new Radio({ canJoin: () => false });
+    const join = new WifiJoin(radio, KNOWN, { rtc: CLUB_CACHE });
+    const portal = new Portal(join);
+    run(radio, join, { portal, maxMs: 3000 });
+    expect(portal.active).toBe(false);
+    run(radio, join, { portal, until: () => portal.active });
+    expect(join.state).toBe('FAILED');
+  });
+
+  test('submitted network joins with path "portal" and the AP closes after the delay', () => {
+    const radio = new Radio({ canJoin: a => a.ssid === 'Venue' });
+    const join = new WifiJoin(radio, KNOWN);
+    const portal = new Portal(join);
+    run(radio, join, { portal, until: () => portal.active });
+    join.submit('Venue');
+    const connectedAt = run(radio, join, { portal, until: () => join.state === 'CONNECTED' });
+    expect(join.path).toBe('portal');
+    expect(join.cache.ssid).toBe('Venue');
+    expect(portal.active).toBe(true);
+    const closedAt = run(radio, join, { portal, until: () => !portal.active });
+    expect(closedAt - connectedAt).toBeGreaterThanOrEqual(PORTAL_CLOSE_DELAY);
+  });
+
+  test('the setup page lists the last scan, redone after each rescan', () => {
+    const radio = new Radio({ canJoin: () => false, scan: [{ ssid: 'Cafe', rssi: -70 }, { ssid: 'Gym', rssi: -50 }] });
+    const join = new WifiJoin(radio, KNOWN);
+    const portal = new Portal(join);
+    run(radio, join, { portal, until: () => portal.active });
+    expect(portal.setupPage()).toEqual(['Gym', 'Cafe']);
+
+    radio.scanResults = [{ ssid: 'Library', rssi: -60 }];
+    run(radio, join, { portal, until: () => join.state === 'SCANNING' });
+    expect(portal.setupPage()).toEqual(['Gym', 'Cafe']);   // Mid-rescan: the old list
+    run(radio, join, { portal, until: () => join.state !== 'SCANNING' });
+    expect(portal.setupPage()).toEqual(['Library']);
+  });
+
+  test('a wrong portal entry goes back to FAILED and the portal stays open', () => {
+    const radio = new Radio({ canJoin: () => false });
+    const join = new WifiJoin(radio, KNOWN);
+    const portal = new Portal(join);
+    run(radio, join, { portal, until: () => portal.active });
+    join.submit('Typo');
+    run(radio, join, { portal, until: () => join.state === 'FAILED' });
+    expect(radio.attempts.at(-1).ssid).toBe('Typo');
+    expect(portal.active).toBe(true);
+    expect(portal.opened).toBe(1);
+  });
+});